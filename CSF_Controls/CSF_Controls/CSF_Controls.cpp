@@ -1,235 +1,3898 @@
-
-
- 
- 
-#include "CSF_Controls.h"
-#include "Arduino.h"
-#include "HardwareSerial.h"
-
-
-using namespace Sensors;
-using namespace Switches;
-
-//ControlUnit
-
-ControlUnit::ControlUnit(int but, int lin, int sig){
-	isSensorOn = false;
-	powerButton = but;
-	powerLine = lin;
-	sensorLine = sig;
-	interval = 250;
-	previousTime = millis();
-}//end construtor
-
-ControlUnit::ControlUnit(int but, int lin, int sig, int val){
-	isSensorOn = false;
-	powerButton = but;
-	powerLine = lin;
-	sensorLine = sig;
-	interval = val;
-	previousTime = millis();
-}//end construtor
-
-
-void ControlUnit::toggleIsSensorOn(){
-	isSensorOn = !isSensorOn;
-}//end toggleIsSensorOn()
-
-
-bool ControlUnit::getIsSensorOn(){
-	return isSensorOn;
-}//end getIsSensorOn()
-
-
-void ControlUnit::activateControl(){
-	digitalWrite(powerLine, HIGH);
-}//end activateControl()
-
-
-void ControlUnit::deactivateControl(){
-	digitalWrite(powerLine, LOW);
-}//end deactivateControl()
-
-
-void ControlUnit::isButtonPressed(){
-	long currentTime = millis();
-	if( (currentTime - previousTime) >= interval){
-		int power = digitalRead(powerButton);
-		if(power == HIGH){
-			toggleIsSensorOn();
-		}
-		previousTime = millis();
-	}
-}//end isButtonPressed()
-
-
-
-
-
-
-
-// Pot
-
-void Pot::begin(){
-	mappingMode = 0;
-	minValueInt = 0;
-	maxValueInt = 0;
-	minValueFloat = 0.0;
-	maxValueFloat = 0.0;
-	pinMode(powerButton, INPUT);
-	pinMode(powerLine, OUTPUT);
-	pinMode(sensorLine, INPUT);
-}//end begin()
-
-
-int Pot::getSensorValue(){
-	int reading = analogRead(sensorLine);
-	return reading;
-}
-
-
-float Pot::mapData(float min, float max){
-	mappingMode = 2;
-	minValueFloat = min;
-	maxValueFloat = max;
-	int signal = getSensorValue();
-	signal = map(signal, 0, 1024, (int)(min * 10000), (int)(max * 10000));
-	float fSignal = signal / 10000.0;
-	
-	return fSignal;
-}//end mapData(floats)
-
-
-int Pot::mapData(int min, int max){
-	mappingMode = 1;
-	minValueInt = min;
-	maxValueInt = max;
-	int signal = getSensorValue();
-	signal = map(signal, 0, 1024, min, max);
-	return signal;
-}//end mapData(ints)
-
-
-void Pot::toSerial(){
-		//check type of mapped data
-	if(mappingMode == 0){
-		if(isSensorOn){
-			Serial.println(getSensorValue());
-		}
-		else{
-			Serial.println(0);
-		}
-	}
-	else if(mappingMode == 1){
-		//it's an integer
-		if(isSensorOn){
-			int output = mapData(minValueInt, maxValueInt);
-			Serial.println(output);
-		}
-		else{
-			Serial.println(0);
-		}
-	}
-	else if(mappingMode == 2){
-		//it's a float
-		if(isSensorOn){
-			float output = mapData(minValueFloat, maxValueFloat);
-			Serial.println(output);
-		}
-		else{
-			Serial.println(0.0);
-		}
-	}
-}//end toSerial()
-
-
-
-
-
-// Button
-
-Button::Button(int p){
-	pin = p;
-}//end constructor()
-
-
-void Button::begin(){
-	pinMode(pin, INPUT);
-}//end begin()
-
-
-int Button::getState(){
-	return digitalRead(pin);
-}//end getButtonState()
-
-
-int Button::getState(bool condition){
-	if(condition){
-		return digitalRead(pin);
-	}
-}//end getButtonState(bool)
-
-
-void Button::toSerial(){
-	Serial.println(getState());
-}//end toSerial()
-
-
-void Button::toSerial(bool condition){
-	Serial.println(getState(condition));
-}//end toSerial(bool);
-
-
-
-
-
-
-
-//Momentary
-
-int Momentary::getState(){
-	long currentTime = millis();
-	if( (currentTime - previousTime) >= interval){
-		previousTime = millis();
-		return digitalRead(pin);
-	}
-}//end getState()
-
-int Momentary::getState(bool condition){
-	long currentTime = millis();
-	if( (currentTime - previousTime) >= interval){
-		previousTime = millis();
-		if(condition){
-			return digitalRead(pin);
-		}
-	}
-}//end getState(bool)
-
-
-
-
-
-
-
-// Touch
-
-int Touch::getState(){
-	long currentTime = millis();
-	if( (currentTime - previousTime) >= interval){
-		previousTime = millis();
-		return digitalRead(pin);
-	}
-}//end getState()
-
-int Touch::getState(bool condition){
-	long currentTime = millis();
-	if( (currentTime - previousTime) >= interval){
-		previousTime = millis();
-		if(condition){
-			return digitalRead(pin);
-		}
-	}
-}//end getState(bool)
-
-
-
+
+
+ 
+ 
+#include "CSF_Controls.h"
+#include "Arduino.h"
+#include "HardwareSerial.h"
+#if defined(__has_include)
+#if __has_include(<EEPROM.h>)
+#include <EEPROM.h>
+#define CSF_HAS_EEPROM 1	///< Calibration::save\(\) and load\(\) only work on boards with the EEPROM library
+#endif
+#endif
+
+
+using namespace Sensors;
+using namespace Switches;
+using namespace Comms;
+using namespace Scheduling;
+using namespace Expansion;
+
+//ChangeTracker
+
+Utility::ChangeTracker::ChangeTracker(){
+	lastValue = 0;
+	deadband = 1;
+	heartbeat = 1000;
+	lastTime = 0;
+	sequence = 0;
+	lastFlag = false;
+	primed = false;
+}//end constructor
+
+
+void Utility::ChangeTracker::configure(int band, unsigned int beat){
+	deadband = band > 0 ? band : 1;
+	heartbeat = beat;
+	primed = false;
+}//end configure()
+
+
+bool Utility::ChangeTracker::check(int value, bool flag, unsigned long now){
+	bool send = !primed || flag != lastFlag;
+	if(!send){
+		long delta = (long)value - lastValue;
+		send = delta >= deadband || -delta >= deadband;
+	}
+	if(!send && heartbeat > 0){
+		send = (now - lastTime) >= heartbeat;
+	}
+	if(send){
+		lastValue = value;
+		lastFlag = flag;
+		lastTime = now;
+		sequence++;
+		primed = true;
+	}
+	return send;
+}//end check()
+
+
+void Utility::ChangeTracker::reset(){
+	primed = false;
+}//end reset()
+
+
+uint8_t Utility::ChangeTracker::getSequence(){
+	return sequence;
+}//end getSequence()
+
+
+
+
+
+//RateController
+
+Utility::RateController::RateController(){
+	reference = 0;
+	threshold = 3;
+	fast = 10;
+	idle = 100;
+	quiet = 1000;
+	interval = idle;
+	lastActivity = 0;
+	lastReport = 0;
+	lastFlag = false;
+	primed = false;
+	active = false;
+	reported = false;
+}//end constructor
+
+
+void Utility::RateController::configure(unsigned int fastMs, unsigned int idleMs, unsigned int quietMs, int band){
+	fast = fastMs > 0 ? fastMs : 1;
+	idle = idleMs > fast ? idleMs : fast;
+	quiet = quietMs;
+	threshold = band > 0 ? band : 1;
+	interval = active ? fast : idle;
+}//end configure()
+
+
+unsigned int Utility::RateController::update(int value, bool flag, unsigned long now){
+	long delta = (long)value - reference;
+	if(!primed){
+		reference = value;	//the first sample is only something to measure from, starting up isn't activity
+		lastFlag = flag;
+		primed = true;
+	}
+	else if(flag != lastFlag || delta >= threshold || -delta >= threshold){
+		reference = value;
+		lastFlag = flag;
+		wake(now);
+	}
+	else if(now - lastActivity >= quiet){
+		active = false;
+		interval = interval >= idle / 2 ? idle : interval * 2;	//slows down by halves rather than jumping, in case it's about to move again
+	}
+	return interval;
+}//end update()
+
+
+void Utility::RateController::wake(unsigned long now){
+	lastActivity = now;
+	active = true;
+	interval = fast;
+}//end wake()
+
+
+bool Utility::RateController::isActive(){
+	return active;
+}//end isActive()
+
+
+unsigned int Utility::RateController::getInterval(){
+	return interval;
+}//end getInterval()
+
+
+unsigned int Utility::RateController::getReportWait(unsigned long now, unsigned int spacing){
+	unsigned long since = now - lastReport;
+	return (!reported || since >= spacing) ? 0 : spacing - since;
+}//end getReportWait()
+
+
+void Utility::RateController::markReport(unsigned long now){
+	lastReport = now;
+	reported = true;
+}//end markReport()
+
+
+
+
+
+//Debouncer
+
+Utility::Debouncer::Debouncer(){
+	lastChange = millis() - 0xFFFF;	//so the first press isn't held off
+	lastPress = lastChange;
+	holdOff = CSF_DEBOUNCE_HOLDOFF;
+	lockout = 0;
+	seenAt = 0;
+	confirmTime = CSF_DEBOUNCE_CONFIRM;
+	clickTime = 400;
+	doubleGap = 300;
+	longTime = 800;
+	flags = 0;
+}//end constructor
+
+
+uint8_t Utility::Debouncer::update(int level, unsigned long now){
+	uint8_t events = 0;
+	bool raw = level != 0;
+	bool state = (flags & FLAG_STATE) != 0;
+	unsigned long since = now - lastChange;
+	bool ignored = raw != ((flags & FLAG_RAW) != 0);	//a change of level that isn't taken is a bounce
+	bool taken = false;
+	if(flags & FLAG_PENDING){
+		if((uint16_t)((uint16_t)now - seenAt) >= confirmTime){
+			flags &= ~FLAG_PENDING;
+			taken = raw != state;
+			ignored = ignored || !taken;	//gone again, a spike of noise
+		}
+	}
+	else if(raw != state && since >= holdOff && !(raw && now - lastPress < lockout)){
+		if(confirmTime > 0){
+			flags |= FLAG_PENDING;
+			seenAt = (uint16_t)now;
+			ignored = false;
+		}
+		else{
+			taken = true;
+		}
+	}
+	if(taken){
+		lastChange = now;
+		if(raw){
+			lastPress = now;
+			events |= PRESSED;
+			bool quick = (flags & FLAG_ARMED) && since <= doubleGap;	//since is the gap since the last release here
+			flags = (flags & ~(FLAG_LONG | FLAG_ARMED | FLAG_DOUBLE)) | FLAG_STATE | (quick ? FLAG_DOUBLE : 0);
+		}
+		else{
+			events |= RELEASED;
+			bool click = !(flags & FLAG_LONG) && since < clickTime;
+			bool second = click && (flags & FLAG_DOUBLE);
+			if(click){
+				events |= second ? (CLICKED | DOUBLE_CLICKED) : CLICKED;
+			}
+			flags = (flags & ~(FLAG_STATE | FLAG_ARMED | FLAG_DOUBLE)) | (click && !second && doubleGap > 0 ? FLAG_ARMED : 0);	//a third quick click starts a new double
+		}
+	}
+	else if(ignored){
+		events |= BOUNCED;
+	}
+	flags = raw ? (flags | FLAG_RAW) : (flags & ~FLAG_RAW);
+	if((flags & (FLAG_STATE | FLAG_LONG)) == FLAG_STATE && longTime > 0 && now - lastChange >= longTime){
+		events |= LONG_PRESSED;
+		flags |= FLAG_LONG;
+	}
+	return events;
+}//end update()
+
+
+int Utility::Debouncer::getState(){
+	return (flags & FLAG_STATE) ? 1 : 0;
+}//end getState()
+
+
+void Utility::Debouncer::setHoldOff(unsigned int ms){
+	holdOff = ms;
+}//end setHoldOff()
+
+
+void Utility::Debouncer::setConfirm(unsigned int ms){
+	confirmTime = ms > 255 ? 255 : ms;
+}//end setConfirm()
+
+
+void Utility::Debouncer::setLockout(unsigned int ms){
+	lockout = ms;
+}//end setLockout()
+
+
+void Utility::Debouncer::setClick(unsigned int maxPress, unsigned int gap){
+	clickTime = maxPress;
+	doubleGap = gap;
+}//end setClick()
+
+
+void Utility::Debouncer::setLongPress(unsigned int ms){
+	longTime = ms;
+}//end setLongPress()
+
+
+
+
+
+#if CSF_CONTROLS_STATS
+//ControlStats
+
+Utility::ControlStats::ControlStats(){
+	reads = 0;
+	suppressed = 0;
+	toggles = 0;
+	emitted = 0;
+	pressedAt = 0;
+	waiting = false;
+	level = 0;
+}//end constructor
+
+
+void Utility::ControlStats::sample(int state){
+	reads++;
+	uint8_t now = state != 0 ? 1 : 0;
+	if(now != level){
+		level = now;
+		toggle();
+	}
+}//end sample()
+
+
+void Utility::ControlStats::toggle(){
+	toggles++;
+	if(!waiting){
+		pressedAt = micros();	//the first toggle since the last report, that's the one kept waiting longest
+		waiting = true;
+	}
+}//end toggle()
+
+
+void Utility::ControlStats::emit(){
+	emitted++;
+	if(waiting){
+		Utility::Stats::noteLatency(micros() - pressedAt);
+		waiting = false;
+	}
+}//end emit()
+
+
+
+
+//Stats
+
+uint16_t Utility::Stats::loopBuckets[Utility::Stats::LOOP_BUCKETS];
+unsigned long Utility::Stats::lastLoop = 0;
+bool Utility::Stats::looping = false;
+unsigned long Utility::Stats::maxLoop = 0;
+unsigned long Utility::Stats::maxLate = 0;
+unsigned long Utility::Stats::maxLatency = 0;
+
+
+void Utility::Stats::markLoop(){
+	unsigned long now = micros();
+	if(looping){
+		unsigned long pass = now - lastLoop;
+		uint8_t bucket = 0;
+		for(unsigned long rest = pass; rest > 1 && bucket < LOOP_BUCKETS - 1; rest >>= 1){
+			bucket++;
+		}
+		if(loopBuckets[bucket] != 0xFFFF){
+			loopBuckets[bucket]++;
+		}
+		if(pass > maxLoop){
+			maxLoop = pass;
+		}
+	}
+	lastLoop = now;
+	looping = true;
+}//end markLoop()
+
+
+void Utility::Stats::noteLate(unsigned long ms){
+	if(ms > maxLate){
+		maxLate = ms;
+	}
+}//end noteLate()
+
+
+void Utility::Stats::noteLatency(unsigned long us){
+	if(us > maxLatency){
+		maxLatency = us;
+	}
+}//end noteLatency()
+
+
+uint16_t Utility::Stats::getLoopBucket(uint8_t bucket){
+	return bucket < LOOP_BUCKETS ? loopBuckets[bucket] : 0;
+}//end getLoopBucket()
+
+
+unsigned long Utility::Stats::getMaxLoop(){
+	return maxLoop;
+}//end getMaxLoop()
+
+
+unsigned long Utility::Stats::getMaxLate(){
+	return maxLate;
+}//end getMaxLate()
+
+
+unsigned long Utility::Stats::getMaxLatency(){
+	return maxLatency;
+}//end getMaxLatency()
+
+
+void Utility::Stats::reset(){
+	for(uint8_t i = 0; i < LOOP_BUCKETS; i++){
+		loopBuckets[i] = 0;
+	}
+	looping = false;
+	maxLoop = 0;
+	maxLate = 0;
+	maxLatency = 0;
+}//end reset()
+#endif
+
+
+
+
+//Expander
+
+int Expander::pin(uint8_t index){
+	if(basePin < 0 || index >= getPinCount()){
+		return -1;
+	}
+	return basePin + index;
+}//end pin()
+
+
+
+
+//AnalogMux
+
+AnalogMux::AnalogMux(uint8_t common, uint8_t s0, uint8_t s1, uint8_t s2){
+	commonPin = common;
+	selectPins[0] = s0;
+	selectPins[1] = s1;
+	selectPins[2] = s2;
+	selectPins[3] = s2;
+	selectCount = 3;
+	selected = 0;
+	settle = 5;
+	for(uint8_t i = 0; i < 16; i++){
+		values[i] = 0;
+	}
+}//end constructor
+
+
+AnalogMux::AnalogMux(uint8_t common, uint8_t s0, uint8_t s1, uint8_t s2, uint8_t s3){
+	commonPin = common;
+	selectPins[0] = s0;
+	selectPins[1] = s1;
+	selectPins[2] = s2;
+	selectPins[3] = s3;
+	selectCount = 4;
+	selected = 0;
+	settle = 5;
+	for(uint8_t i = 0; i < 16; i++){
+		values[i] = 0;
+	}
+}//end constructor
+
+
+void AnalogMux::begin(){
+	pinMode(commonPin, INPUT);
+	for(uint8_t i = 0; i < selectCount; i++){
+		pinMode(selectPins[i], OUTPUT);
+		digitalWrite(selectPins[i], LOW);
+	}
+	selected = 0;
+}//end begin()
+
+
+void AnalogMux::select(uint8_t channel){
+	uint8_t changed = channel ^ selected;
+	for(uint8_t i = 0; i < selectCount; i++){
+		if(changed & (1 << i)){
+			digitalWrite(selectPins[i], (channel >> i) & 0x01);
+		}
+	}
+	selected = channel;
+}//end select()
+
+
+void AnalogMux::scan(){
+	if(Sampler::isInterruptDriven()){
+		return;	//the ADC interrupt owns the ADC, an analogRead() or a conversion started here would take one of its readings
+	}
+	uint8_t count = getPinCount();
+	#if defined(__AVR__) && defined(ADC_vect)
+		uint8_t analogChannel = (commonPin >= A0) ? commonPin - A0 : commonPin;
+		#if defined(analogPinToChannel)
+			analogChannel = analogPinToChannel(analogChannel);
+		#endif
+		#if defined(MUX5)
+			ADCSRB = (ADCSRB & ~(1 << MUX5)) | (((analogChannel >> 3) & 0x01) << MUX5);
+		#endif
+		ADMUX = (1 << REFS0) | (analogChannel & 0x07);	//AVcc reference, the same as analogRead() with DEFAULT
+		uint8_t prescale = ADCSRA & 0x07;
+		unsigned int hold = ((2U << prescale) + (F_CPU / 1000000UL) - 1) / (F_CPU / 1000000UL);	//the sample is taken 1.5 ADC clocks into a conversion, rounded up to 2
+		unsigned int tail = (11U << prescale) / (F_CPU / 1000000UL);	//what's left of the conversion once the sample is taken
+		select(0);
+		delayMicroseconds(settle);
+		for(uint8_t k = 0; k < count; k++){
+			uint8_t channel = k ^ (k >> 1);
+			ADCSRA |= (1 << ADSC);
+			if(k + 1 < count){
+				delayMicroseconds(hold);
+				select((k + 1) ^ ((k + 1) >> 1));	//the next channel settles while this one converts
+			}
+			while(ADCSRA & (1 << ADSC));
+			values[channel] = ADC;
+			if(k + 1 < count && settle > tail){
+				delayMicroseconds(settle - tail);
+			}
+		}
+	#else
+		select(0);
+		unsigned long selectedAt = micros();
+		for(uint8_t k = 0; k < count; k++){
+			uint8_t channel = k ^ (k >> 1);
+			unsigned long waited = micros() - selectedAt;
+			if(waited < settle){
+				delayMicroseconds(settle - waited);
+			}
+			int reading = analogRead(commonPin);
+			if(k + 1 < count){
+				select((k + 1) ^ ((k + 1) >> 1));	//the next channel starts settling before this reading is stored
+				selectedAt = micros();
+			}
+			values[channel] = reading;
+		}
+	#endif
+}//end scan()
+
+
+int AnalogMux::read(uint8_t index){
+	return readAnalog(index) > 511 ? HIGH : LOW;
+}//end read()
+
+
+int AnalogMux::readAnalog(uint8_t index){
+	if(index >= getPinCount()){
+		return 0;
+	}
+	return values[index];
+}//end readAnalog()
+
+
+uint8_t AnalogMux::getPinCount(){
+	return 1 << selectCount;
+}//end getPinCount()
+
+
+void AnalogMux::setSettle(uint8_t us){
+	settle = us;
+}//end setSettle()
+
+
+
+
+//ShiftIn
+
+ShiftIn::ShiftIn(uint8_t load, uint8_t clock, uint8_t data, uint8_t chips){
+	loadPin = load;
+	clockPin = clock;
+	dataPin = data;
+	chipCount = constrain(chips, 1, 4);
+	inverted = false;
+	bits = 0;
+}//end constructor
+
+
+void ShiftIn::begin(){
+	pinMode(loadPin, OUTPUT);
+	pinMode(clockPin, OUTPUT);
+	pinMode(dataPin, INPUT);
+	digitalWrite(loadPin, HIGH);
+	digitalWrite(clockPin, LOW);
+	#if defined(__AVR__)
+		loadRegister = portOutputRegister(digitalPinToPort(loadPin));
+		clockRegister = portOutputRegister(digitalPinToPort(clockPin));
+		dataRegister = portInputRegister(digitalPinToPort(dataPin));
+		loadMask = digitalPinToBitMask(loadPin);
+		clockMask = digitalPinToBitMask(clockPin);
+		dataMask = digitalPinToBitMask(dataPin);
+	#endif
+}//end begin()
+
+
+void ShiftIn::scan(){
+	uint32_t shifted = 0;
+	uint8_t count = chipCount * 8;
+	#if defined(__AVR__)
+		uint8_t oldSREG = SREG;
+		cli();	//the registers are shared with other pins, an interrupt writing them mid-burst would be undone
+		*loadRegister &= ~loadMask;	//parallel load every chip
+		*loadRegister |= loadMask;
+		for(uint8_t i = 0; i < count; i++){
+			shifted = (shifted << 1) | ((*dataRegister & dataMask) ? 1 : 0);
+			*clockRegister |= clockMask;
+			*clockRegister &= ~clockMask;
+		}
+		SREG = oldSREG;
+	#else
+		digitalWrite(loadPin, LOW);
+		digitalWrite(loadPin, HIGH);
+		for(uint8_t i = 0; i < count; i++){
+			shifted = (shifted << 1) | (digitalRead(dataPin) == HIGH ? 1 : 0);
+			digitalWrite(clockPin, HIGH);
+			digitalWrite(clockPin, LOW);
+		}
+	#endif
+	//each chip comes out H first, so the first bit read is D7 of the nearest chip
+	uint32_t ordered = 0;
+	for(uint8_t chip = 0; chip < chipCount; chip++){
+		uint8_t chipBits = (shifted >> (8 * (chipCount - 1 - chip))) & 0xFF;
+		ordered |= (uint32_t)chipBits << (8 * chip);
+	}
+	bits = inverted ? ~ordered : ordered;
+	if(count < 32){
+		bits &= ((uint32_t)1 << count) - 1;
+	}
+}//end scan()
+
+
+int ShiftIn::read(uint8_t index){
+	if(index >= getPinCount()){
+		return LOW;
+	}
+	return (bits >> index) & 0x01 ? HIGH : LOW;
+}//end read()
+
+
+int ShiftIn::readAnalog(uint8_t index){
+	return read(index) == HIGH ? 1023 : 0;
+}//end readAnalog()
+
+
+uint8_t ShiftIn::getPinCount(){
+	return chipCount * 8;
+}//end getPinCount()
+
+
+uint32_t ShiftIn::getBits(){
+	return bits;
+}//end getBits()
+
+
+void ShiftIn::setActiveLow(bool activeLow){
+	inverted = activeLow;
+}//end setActiveLow()
+
+
+
+
+//CapSense
+
+CapSense::CapSense(){
+	sendPin = -1;
+	sendRegister = NULL;
+	sendMask = 0;
+	channelCount = 0;
+	laneCount = 0;
+	touched = 0;
+	samples = 16;
+	timeout = 300;
+	touchShare = 40 * 256 / 100;	//the pull-ups only count a few passes, it takes a finger right on the electrode
+	releaseShare = 25 * 256 / 100;
+	drift = 6;
+	scanMicros = 0;
+	worstMicros = 0;
+	timeouts = 0;
+}//end constructor
+
+
+CapSense::CapSense(uint8_t send): CapSense(){
+	sendPin = send;
+	touchShare = 6 * 256 / 100;	//the resistors give enough resolution to see a light touch
+	releaseShare = 4 * 256 / 100;
+}//end constructor(send)
+
+
+int8_t CapSense::add(uint8_t p){
+	if(channelCount >= CSF_CAPSENSE_CHANNELS || channelCount >= 16 || VirtualPins::isVirtual(p)){
+		return -1;
+	}
+	uint8_t port = digitalPinToPort(p);
+	if(port == NOT_A_PORT){
+		return -1;
+	}
+	uint8_t lane = 0;
+	while(lane < laneCount && portNumbers[lane] != port){
+		lane++;
+	}
+	if(lane == laneCount){
+		portNumbers[lane] = port;
+		laneMasks[lane] = 0;
+		laneCount++;
+	}
+	uint8_t i = channelCount++;
+	lanes[i] = lane;
+	masks[i] = digitalPinToBitMask(p);
+	laneMasks[lane] |= masks[i];
+	raws[i] = 0;
+	baselines[i] = 0;
+	return i;
+}//end add()
+
+
+void CapSense::begin(){
+	if(sendPin >= 0){
+		pinMode(sendPin, OUTPUT);
+		digitalWrite(sendPin, LOW);
+		sendRegister = portOutputRegister(digitalPinToPort(sendPin));
+		sendMask = digitalPinToBitMask(sendPin);
+	}
+	for(uint8_t lane = 0; lane < laneCount; lane++){
+		volatile uint8_t* mode = portModeRegister(portNumbers[lane]);
+		volatile uint8_t* output = portOutputRegister(portNumbers[lane]);
+		noInterrupts();
+		*output &= ~laneMasks[lane];
+		*mode |= laneMasks[lane];
+		interrupts();
+	}
+	for(uint8_t i = 0; i < channelCount; i++){
+		baselines[i] = 0;
+	}
+	for(uint8_t pass = 0; pass < 8; pass++){	//the first baselines are the average of 8 scans
+		measure();
+		for(uint8_t i = 0; i < channelCount; i++){
+			baselines[i] += (uint32_t)raws[i] << (BASELINE_BITS - 3);
+		}
+	}
+	touched = 0;
+	worstMicros = 0;
+	timeouts = 0;
+}//end begin()
+
+
+void CapSense::charge(uint8_t lane){
+	volatile uint8_t* mode = portModeRegister(portNumbers[lane]);
+	volatile uint8_t* output = portOutputRegister(portNumbers[lane]);
+	volatile uint8_t* input = portInputRegister(portNumbers[lane]);
+	uint8_t mask = laneMasks[lane];
+	uint8_t pending = mask;
+	uint16_t passes = 0;
+	uint16_t risenAt[8];
+	uint8_t risenBits[8];
+	uint8_t changes = 0;
+	noInterrupts();
+	*mode &= ~mask;	//inputs first, so turning the pull-ups on can't drive the pins high
+	if(sendRegister != NULL){
+		*sendRegister |= sendMask;	//every electrode starts charging through its resistor here
+	}
+	else{
+		*output |= mask;	//every pull-up on together, the charging starts here
+	}
+	do{
+		uint8_t risen = CSF_PORT_READ(input) & pending;
+		if(risen){	//only note the pass here, sorting out which electrode it was waits until after the timing
+			pending &= ~risen;
+			risenAt[changes] = passes;
+			risenBits[changes++] = risen;
+		}
+		passes++;
+	}while(pending != 0 && passes < timeout);
+	if(sendRegister != NULL){
+		*sendRegister &= ~sendMask;
+	}
+	*output &= ~mask;	//driven low again to discharge for the next one
+	*mode |= mask;
+	for(uint8_t settle = 0; settle < 4; settle++){	//a few passes of port reads for the discharge, cycle exact where delayMicroseconds(1) isn't
+		CSF_PORT_READ(input);
+	}
+	interrupts();
+	for(uint8_t i = 0; i < channelCount; i++){
+		if(lanes[i] != lane){
+			continue;
+		}
+		uint16_t count = timeout;
+		for(uint8_t c = 0; c < changes; c++){
+			if(risenBits[c] & masks[i]){
+				count = risenAt[c];
+				break;
+			}
+		}
+		if(count == timeout){
+			timeouts++;
+		}
+		raws[i] = (raws[i] + count > 0xFFFF) ? 0xFFFF : raws[i] + count;
+	}
+}//end charge()
+
+
+void CapSense::measure(){
+	unsigned long started = micros();
+	for(uint8_t i = 0; i < channelCount; i++){
+		raws[i] = 0;
+	}
+	for(uint8_t sample = 0; sample < samples; sample++){
+		for(uint8_t lane = 0; lane < laneCount; lane++){
+			charge(lane);
+		}
+	}
+	scanMicros = micros() - started;
+	if(scanMicros > worstMicros){
+		worstMicros = scanMicros;
+	}
+}//end measure()
+
+
+void CapSense::scan(){
+	measure();
+	for(uint8_t i = 0; i < channelCount; i++){
+		uint16_t bit = (uint16_t)1 << i;
+		uint32_t reading = (uint32_t)raws[i] << BASELINE_BITS;
+		uint16_t base = baselines[i] >> BASELINE_BITS;
+		long over = (long)raws[i] - base;
+		if(touched & bit){
+			long release = ((uint32_t)base * releaseShare) >> 8;
+			if(over < (release > 0 ? release : 1)){
+				touched &= ~bit;
+			}
+		}
+		else{
+			long touch = ((uint32_t)base * touchShare) >> 8;
+			if(over >= (touch > 1 ? touch : 2)){
+				touched |= bit;
+			}
+		}
+		if(reading >= baselines[i]){	//16 times slower while touched, or a long touch would become the new baseline
+			baselines[i] += (reading - baselines[i]) >> ((touched & bit) ? drift + 4 : drift);
+		}
+		else{
+			baselines[i] -= (baselines[i] - reading) >> (drift > 2 ? drift - 2 : 0);
+		}
+	}
+}//end scan()
+
+
+int CapSense::read(uint8_t index){
+	if(index >= channelCount){
+		return LOW;
+	}
+	return (touched >> index) & 0x01 ? HIGH : LOW;
+}//end read()
+
+
+int CapSense::readAnalog(uint8_t index){
+	if(index >= channelCount){
+		return 0;
+	}
+	long over = (long)raws[index] - (long)(baselines[index] >> BASELINE_BITS);
+	return constrain(over, 0, 1023);
+}//end readAnalog()
+
+
+uint8_t CapSense::getPinCount(){
+	return channelCount;
+}//end getPinCount()
+
+
+void CapSense::setSamples(uint8_t count){
+	samples = constrain(count, 1, 64);
+}//end setSamples()
+
+
+void CapSense::setTimeout(uint16_t passes){
+	timeout = passes > 0 ? passes : 1;
+}//end setTimeout()
+
+
+void CapSense::setThresholds(uint8_t touch, uint8_t release){
+	touch = constrain(touch, 1, 99);
+	release = release < touch ? release : touch - 1;
+	touchShare = (uint16_t)touch * 256 / 100;
+	releaseShare = (uint16_t)release * 256 / 100;
+}//end setThresholds()
+
+
+void CapSense::setDrift(uint8_t shift){
+	drift = shift > 12 ? 12 : shift;
+}//end setDrift()
+
+
+void CapSense::recalibrate(){
+	for(uint8_t i = 0; i < channelCount; i++){
+		baselines[i] = (uint32_t)raws[i] << BASELINE_BITS;
+	}
+	touched = 0;
+}//end recalibrate()
+
+
+uint16_t CapSense::getRaw(uint8_t index){
+	return index < channelCount ? raws[index] : 0;
+}//end getRaw()
+
+
+uint16_t CapSense::getBaseline(uint8_t index){
+	return index < channelCount ? (uint16_t)(baselines[index] >> BASELINE_BITS) : 0;
+}//end getBaseline()
+
+
+unsigned long CapSense::getScanMicros(){
+	return scanMicros;
+}//end getScanMicros()
+
+
+unsigned long CapSense::getWorstScanMicros(){
+	return worstMicros;
+}//end getWorstScanMicros()
+
+
+unsigned long CapSense::getTimeouts(){
+	return timeouts;
+}//end getTimeouts()
+
+
+
+
+//VirtualPins
+
+uint8_t VirtualPins::expanderCount = 0;
+int VirtualPins::nextPin = CSF_VIRTUAL_PIN_BASE;
+Expander* VirtualPins::expanders[CSF_EXPANDERS];
+
+
+int VirtualPins::attach(Expander& expander){
+	if(expander.basePin >= 0){
+		return expander.basePin;
+	}
+	if(expanderCount >= CSF_EXPANDERS || nextPin + expander.getPinCount() > 256){	//controls keep their pins in a byte
+		return -1;
+	}
+	expander.begin();
+	expander.basePin = nextPin;
+	nextPin += expander.getPinCount();
+	expanders[expanderCount++] = &expander;
+	return expander.basePin;
+}//end attach()
+
+
+void VirtualPins::detachAll(){
+	for(uint8_t i = 0; i < expanderCount; i++){
+		expanders[i]->basePin = -1;
+	}
+	expanderCount = 0;
+	nextPin = CSF_VIRTUAL_PIN_BASE;
+}//end detachAll()
+
+
+void VirtualPins::scanAll(){
+	for(uint8_t i = 0; i < expanderCount; i++){
+		expanders[i]->scan();
+	}
+}//end scanAll()
+
+
+int VirtualPins::readVirtual(int p, bool analog){
+	for(uint8_t i = 0; i < expanderCount; i++){
+		Expander* expander = expanders[i];
+		int index = p - expander->basePin;
+		if(index >= 0 && index < expander->getPinCount()){
+			return analog ? expander->readAnalog(index) : expander->read(index);
+		}
+	}
+	return analog ? 0 : LOW;
+}//end readVirtual()
+
+
+
+
+//ControlUnit
+
+ControlUnit::ControlUnit(int but, int lin, int sig){
+	isSensorOn = false;
+	powerButton = but;
+	powerLine = lin;
+	sensorLine = sig;
+	interval = 250;
+	powerDebouncer.setLockout(interval);
+}//end construtor
+
+ControlUnit::ControlUnit(int but, int lin, int sig, int val){
+	isSensorOn = false;
+	powerButton = but;
+	powerLine = lin;
+	sensorLine = sig;
+	interval = val;
+	powerDebouncer.setLockout(interval);
+}//end construtor
+
+
+void ControlUnit::toggleIsSensorOn(){
+	isSensorOn = !isSensorOn;
+	CSF_STAT(stats.toggle());
+}//end toggleIsSensorOn()
+
+
+bool ControlUnit::getIsSensorOn(){
+	return isSensorOn;
+}//end getIsSensorOn()
+
+
+void ControlUnit::activateControl(){
+	digitalWrite(powerLine, HIGH);
+}//end activateControl()
+
+
+void ControlUnit::deactivateControl(){
+	digitalWrite(powerLine, LOW);
+}//end deactivateControl()
+
+
+void ControlUnit::isButtonPressed(){
+	pollButton();
+}//end isButtonPressed()
+
+
+void ControlUnit::pollButton(){
+	debounceButton(VirtualPins::readDigital(powerButton));
+}//end pollButton()
+
+
+long ControlUnit::getInterval(){
+	return interval;
+}//end getInterval()
+
+
+bool ControlUnit::toSerialOnChange(){
+	return toSerialOnChange(isSensorOn ? getSensorValue() : 0);
+}//end toSerialOnChange()
+
+
+bool ControlUnit::toSerialOnChange(int reading){
+	if(!tracker.check(reading, isSensorOn, millis())){
+		return false;
+	}
+	Serial.print(tracker.getSequence());
+	Serial.print(' ');
+	printValue(reading);
+	CSF_STAT(stats.emit());
+	return true;
+}//end toSerialOnChange()
+
+
+void ControlUnit::setReportByException(int deadband, unsigned int heartbeat){
+	tracker.configure(deadband, heartbeat);
+}//end setReportByException()
+
+
+void ControlUnit::printValue(int reading){
+	Serial.println(reading);
+}//end printValue()
+
+
+void ControlUnit::debounceButton(int level){
+	uint8_t events = powerDebouncer.update(level, millis());
+	if(events & Utility::Debouncer::PRESSED){
+		toggleIsSensorOn();
+	}
+	#if CSF_CONTROLS_STATS
+	if(events & Utility::Debouncer::BOUNCED){
+		stats.suppressed++;
+	}
+	#endif
+}//end debounceButton()
+
+
+#if CSF_CONTROLS_STATS
+Utility::ControlStats& ControlUnit::getStats(){
+	return stats;
+}//end getStats()
+#endif
+
+
+
+
+
+
+
+// PotReader
+
+void PotReader::setFilter(FilterChain& chain){
+	filter = &chain;
+	filter->reset();
+}//end setFilter()
+
+
+void PotReader::clearFilter(){
+	filter = NULL;
+}//end clearFilter()
+
+
+void PotReader::setOversampling(uint8_t bits){
+	if(bits > 3){
+		bits = 3;
+	}
+	if(samplerChannel >= 0 && bits > Sampler::OVERSAMPLING){
+		bits = Sampler::OVERSAMPLING;	//the history only holds so many real readings
+	}
+	oversampling = bits;
+	long inMax = 1023L << bits;
+	if(mappingMode == 1){
+		mapping.setWhole(minValueInt, maxValueInt, inMax);
+	}
+	else if(mappingMode == 2){
+		mapping.set(minValueFloat, maxValueFloat, inMax);
+	}
+	if(filter != NULL){
+		filter->reset();
+	}
+}//end setOversampling()
+
+
+int PotReader::getLastValue(){
+	return lastValue;
+}//end getLastValue()
+
+
+int8_t PotReader::getSamplerChannel(){
+	return samplerChannel;
+}//end getSamplerChannel()
+
+
+void PotReader::clearMapping(){
+	mappingMode = 0;
+	minValueInt = 0;
+	maxValueInt = 0;
+	minValueFloat = 0.0;
+	maxValueFloat = 0.0;
+}//end clearMapping()
+
+
+int PotReader::readSensor(int pin){
+	int reading;
+	if(oversampling == 0){
+		reading = readRaw(pin);
+	}
+	else if(samplerChannel >= 0){
+		uint16_t readings[CSF_SAMPLER_DEPTH];
+		uint8_t count = Sampler::recent(samplerChannel, readings, 1 << (2 * oversampling));
+		long sum = 0;
+		for(uint8_t i = 0; i < count; i++){
+			sum += readings[i];
+		}
+		reading = count > 0 ? (int)((sum << oversampling) / count) : 0;	//scaled up from fewer only until the history fills
+	}
+	else{
+		uint8_t count = 1 << (2 * oversampling);
+		long sum = 0;
+		for(uint8_t i = 0; i < count; i++){
+			sum += VirtualPins::readAnalog(pin);
+		}
+		reading = (int)(sum >> oversampling);
+	}
+	if(filter != NULL){
+		reading = filter->process(reading);
+	}
+	lastValue = reading;
+	return reading;
+}//end readSensor()
+
+
+int PotReader::readRaw(int pin){
+	if(samplerChannel >= 0){
+		return Sampler::latest(samplerChannel);
+	}
+	return VirtualPins::readAnalog(pin);
+}//end readRaw()
+
+
+float PotReader::mapReading(float min, float max, int reading){
+	if(mappingMode != 2 || min != minValueFloat || max != maxValueFloat){
+		mappingMode = 2;
+		minValueFloat = min;
+		maxValueFloat = max;
+		mapping.set(min, max, 1023L << oversampling);
+	}
+	return mapping.toFloat(reading);
+}//end mapReading(floats)
+
+
+int PotReader::mapReading(int min, int max, int reading){
+	if(mappingMode != 1 || min != minValueInt || max != maxValueInt){
+		mappingMode = 1;
+		minValueInt = min;
+		maxValueInt = max;
+		mapping.setWhole(min, max, 1023L << oversampling);
+	}
+	return mapping.toInt(reading);
+}//end mapReading(ints)
+
+
+int PotReader::mapReading(const CurveTable& table, int reading){
+	mappingMode = 3;
+	curve = &table;
+	return curve->lookup(reading, oversampling);
+}//end mapReading(table)
+
+
+void PotReader::printReading(int reading, bool on){
+		//check type of mapped data
+	if(mappingMode == 0){
+		if(on){
+			Serial.println(reading);
+		}
+		else{
+			Serial.println(0);
+		}
+	}
+	else if(mappingMode == 1){
+		//it's an integer
+		if(on){
+			int output = mapping.toInt(reading);
+			Serial.println(output);
+		}
+		else{
+			Serial.println(0);
+		}
+	}
+	else if(mappingMode == 2){
+		//it's a float
+		if(on){
+			float output = mapping.toFloat(reading);
+			Serial.println(output);
+		}
+		else{
+			Serial.println(0.0);
+		}
+	}
+	else if(mappingMode == 3){
+		//it's a CurveTable, with or without decimals
+		if(on && curve->getDecimals() > 0){
+			Serial.println(curve->toFloat(reading, oversampling), curve->getDecimals());
+		}
+		else{
+			Serial.println(on ? curve->lookup(reading, oversampling) : 0L);
+		}
+	}
+}//end printReading()
+
+
+
+
+
+
+
+// Pot
+
+void Pot::begin(){
+	clearMapping();
+	VirtualPins::setMode(powerButton, INPUT);
+	VirtualPins::setMode(powerLine, OUTPUT);
+	VirtualPins::setMode(sensorLine, INPUT);
+}//end begin()
+
+
+int Pot::getSensorValue(){
+	int reading = readSensor(sensorLine);
+	CSF_STAT(stats.reads++);
+	return reading;
+}//end getSensorValue()
+
+
+int Pot::getRawValue(){
+	return readRaw(sensorLine);
+}//end getRawValue()
+
+
+float Pot::mapData(float min, float max){
+	return mapReading(min, max, getSensorValue());
+}//end mapData(floats)
+
+
+int Pot::mapData(int min, int max){
+	return mapReading(min, max, getSensorValue());
+}//end mapData(ints)
+
+
+int Pot::mapData(const CurveTable& table){
+	return mapReading(table, getSensorValue());
+}//end mapData(table)
+
+
+void Pot::toSerial(){
+	printValue(isSensorOn ? getSensorValue() : 0);
+	CSF_STAT(stats.emit());
+}//end toSerial()
+
+
+void Pot::printValue(int reading){
+	printReading(reading, isSensorOn);
+}//end printValue()
+
+
+
+
+
+
+
+// LinearMap
+
+LinearMap::LinearMap(){
+	set(0, 1023);
+}//end constructor
+
+
+bool LinearMap::set(float outMin, float outMax, long inMax){
+	const float limit = (float)(1LL << WIDE_BITS) / 2;	//the span between the ends has to fit as well
+	bool fits = true;
+	if(fabs(outMin) > limit || fabs(outMax) > limit){
+		outMin = constrain(outMin, -limit, limit);
+		outMax = constrain(outMax, -limit, limit);
+		fits = false;
+	}
+	float span = outMax - outMin;
+	float largest = fabs(span) > fabs(outMin) ? fabs(span) : fabs(outMin);
+	largest = fabs(outMax) > largest ? fabs(outMax) : largest;
+	uint8_t needed = 0;	//enough bits for the slope to be good to 1 part in 2^18, a few millionths of the range at the far end
+	while(needed < MAX_SHIFT && fabs(span) * (float)(1LL << needed) < (float)inMax * (float)(1L << 18)){
+		needed++;
+	}
+	pickShift((int64_t)largest + 1, needed);
+	float one = (float)(1LL << shift);
+	float slopeReal = span * one / inMax;
+	slope = (int64_t)(slopeReal < 0 ? slopeReal - 0.5 : slopeReal + 0.5);
+	float offsetReal = outMin * one;
+	offset = (int64_t)(offsetReal < 0 ? offsetReal - 0.5 : offsetReal + 0.5);
+	finish();
+	return fits;
+}//end set()
+
+
+void LinearMap::setWhole(long outMin, long outMax, long inMax){
+	int64_t span = (int64_t)outMax - outMin;
+	int64_t largest = span < 0 ? -span : span;
+	largest = (outMin < 0 ? -(int64_t)outMin : outMin) > largest ? (outMin < 0 ? -(int64_t)outMin : outMin) : largest;
+	largest = (outMax < 0 ? -(int64_t)outMax : outMax) > largest ? (outMax < 0 ? -(int64_t)outMax : outMax) : largest;
+	uint8_t needed = 0;	//the slope's error over inMax steps has to stay under the 1/(2 inMax) the nearest half can be from a reading, so 2^shift > inMax^2
+	while((1LL << needed) <= (int64_t)inMax * inMax){
+		needed++;
+	}
+	pickShift(largest, needed);
+	int64_t scaled = span << shift;
+	slope = (scaled >= 0 ? scaled + inMax / 2 : scaled - inMax / 2) / inMax;
+	offset = (int64_t)outMin << shift;
+	finish();
+}//end setWhole()
+
+
+void LinearMap::pickShift(int64_t largest, uint8_t needed){
+	shift = 0;
+	while(shift < NARROW_BITS && (largest << (shift + 1)) < (1LL << NARROW_BITS)){
+		shift++;
+	}
+	wide = shift < needed;
+	if(wide){
+		while(shift < MAX_SHIFT && (largest << (shift + 1)) < (1LL << WIDE_BITS)){
+			shift++;
+		}
+	}
+}//end pickShift()
+
+
+void LinearMap::finish(){
+	half = (shift > 0) ? (1LL << (shift - 1)) : 0;
+	scale = 1.0 / (float)(1LL << shift);
+}//end finish()
+
+
+uint8_t LinearMap::getShift() const{
+	return shift;
+}//end getShift()
+
+
+bool LinearMap::isWide() const{
+	return wide;
+}//end isWide()
+
+
+
+
+
+
+// Calibration
+
+Calibration::Calibration(){
+	reset();
+}//end constructor
+
+
+void Calibration::reset(){
+	count = 2;
+	points[0] = 0;
+	points[1] = 1023;
+	current = 0;
+	samples = 0;
+	sum = 0;
+}//end reset()
+
+
+void Calibration::startSweep(){
+	count = 2;
+	points[0] = 1023;
+	points[1] = 0;
+}//end startSweep()
+
+
+void Calibration::sweep(int reading){
+	reading = constrain(reading, 0, 1023);
+	if(reading < points[0]){
+		points[0] = reading;
+	}
+	if(reading > points[1]){
+		points[1] = reading;
+	}
+}//end sweep()
+
+
+bool Calibration::endSweep(uint8_t margin){
+	if(points[1] < points[0] + 2 * margin + 16){	//the pot hardly moved, or never moved at all
+		reset();
+		return false;
+	}
+	points[0] += margin;
+	points[1] -= margin;
+	return true;
+}//end endSweep()
+
+
+bool Calibration::start(uint8_t marks){
+	if(marks < 2 || marks > CSF_CALIBRATION_POINTS){
+		return false;
+	}
+	count = marks;
+	for(uint8_t i = 0; i < count; i++){
+		points[i] = (uint16_t)((1023L * i) / (count - 1));
+	}
+	current = 0;
+	samples = 0;
+	sum = 0;
+	return true;
+}//end start()
+
+
+bool Calibration::capture(uint8_t point, int reading){
+	if(point >= count){
+		return false;
+	}
+	if(point != current){
+		current = point;
+		samples = 0;
+		sum = 0;
+	}
+	else if(samples == 255){	//keep the average going at half weight rather than overflow the count
+		sum = sum * 127 / 255;
+		samples = 127;
+	}
+	sum += constrain(reading, 0, 1023);
+	samples++;
+	points[point] = (uint16_t)((sum + samples / 2) / samples);
+	return true;
+}//end capture()
+
+
+bool Calibration::setPoint(uint8_t point, int reading){
+	if(point >= count){
+		return false;
+	}
+	points[point] = constrain(reading, 0, 1023);
+	return true;
+}//end setPoint()
+
+
+int Calibration::getPoint(uint8_t point) const{
+	return point < count ? points[point] : 0;
+}//end getPoint()
+
+
+uint8_t Calibration::getPointCount() const{
+	return count;
+}//end getPointCount()
+
+
+bool Calibration::isValid() const{
+	bool rising = points[count - 1] > points[0];
+	for(uint8_t i = 1; i < count; i++){
+		if(rising ? points[i] <= points[i - 1] : points[i] >= points[i - 1]){
+			return false;
+		}
+	}
+	return true;
+}//end isValid()
+
+
+float Calibration::toPosition(float reading) const{
+	bool rising = points[count - 1] > points[0];
+	uint8_t i = 0;
+	while(i < count - 2 && (rising ? reading > points[i + 1] : reading < points[i + 1])){
+		i++;
+	}
+	float low = points[i];
+	float high = points[i + 1];
+	float along = (high != low) ? (reading - low) / (high - low) : 0.0;
+	return (i + along) / (count - 1);
+}//end toPosition()
+
+
+bool Calibration::save(int address) const{
+	#ifdef CSF_HAS_EEPROM
+	if(address < 0 || address + STORAGE_SIZE > (int)EEPROM.length()){
+		return false;
+	}
+	uint8_t block[STORAGE_SIZE];
+	block[0] = 0xCA;
+	block[1] = count;
+	for(uint8_t i = 0; i < CSF_CALIBRATION_POINTS; i++){
+		uint16_t point = i < count ? points[i] : 0;
+		block[2 + 2 * i] = point & 0xFF;
+		block[3 + 2 * i] = point >> 8;
+	}
+	uint16_t crc = Comms::crc16(block, STORAGE_SIZE - 2);
+	block[STORAGE_SIZE - 2] = crc & 0xFF;
+	block[STORAGE_SIZE - 1] = crc >> 8;
+	for(int i = 0; i < STORAGE_SIZE; i++){
+		#if defined(ESP8266) || defined(ESP32)
+		EEPROM.write(address + i, block[i]);
+		#else
+		EEPROM.update(address + i, block[i]);	//leaves bytes that haven't changed alone, they wear out
+		#endif
+	}
+	#if defined(ESP8266) || defined(ESP32)
+	EEPROM.commit();
+	#endif
+	return true;
+	#else
+	(void)address;
+	return false;
+	#endif
+}//end save()
+
+
+bool Calibration::load(int address){
+	#ifdef CSF_HAS_EEPROM
+	if(address < 0 || address + STORAGE_SIZE > (int)EEPROM.length()){
+		return false;
+	}
+	uint8_t block[STORAGE_SIZE];
+	for(int i = 0; i < STORAGE_SIZE; i++){
+		block[i] = EEPROM.read(address + i);
+	}
+	uint16_t crc = block[STORAGE_SIZE - 2] | ((uint16_t)block[STORAGE_SIZE - 1] << 8);
+	if(block[0] != 0xCA || block[1] < 2 || block[1] > CSF_CALIBRATION_POINTS || Comms::crc16(block, STORAGE_SIZE - 2) != crc){
+		return false;
+	}
+	count = block[1];
+	for(uint8_t i = 0; i < count; i++){
+		points[i] = block[2 + 2 * i] | ((uint16_t)block[3 + 2 * i] << 8);
+	}
+	return true;
+	#else
+	(void)address;
+	return false;
+	#endif
+}//end load()
+
+
+
+
+
+
+
+// CurveTable
+
+CurveTable::CurveTable(const int16_t* table, uint8_t bits, uint8_t decimals, bool flash){
+	this->table = table;
+	this->bits = constrain(bits, 1, 8);
+	this->decimals = decimals;
+	this->flash = flash;
+	scale = 1.0;
+	for(uint8_t i = 0; i < decimals; i++){
+		scale /= 10.0;
+	}
+}//end constructor
+
+
+float CurveTable::evaluate(float reading, float outMin, float outMax, float taper, const Calibration* calibration){
+	float position = (calibration != NULL) ? calibration->toPosition(reading) : reading / 1023.0;
+	position = constrain(position, 0.0, 1.0);
+	if(taper > 0.0 && taper < 1.0 && taper != TAPER_LINEAR){
+		//the reading of a log pot at travel t is (b^t - 1) / (b - 1), with b picked so half travel reads the taper, this undoes it
+		float base = ((1.0 - taper) / taper) * ((1.0 - taper) / taper);
+		position = log(1.0 + position * (base - 1.0)) / log(base);
+	}
+	return outMin + position * (outMax - outMin);
+}//end evaluate()
+
+
+bool CurveTable::generate(int16_t* table, uint8_t bits, float outMin, float outMax, uint8_t decimals, float taper, const Calibration* calibration){
+	bits = constrain(bits, 1, 8);
+	float unit = 1.0;
+	for(uint8_t i = 0; i < decimals; i++){
+		unit *= 10.0;
+	}
+	uint16_t segments = 1 << bits;
+	float width = 1024.0 / segments;
+	bool fits = true;
+	for(uint16_t i = 0; i <= segments; i++){
+		float value;
+		if(i < segments){
+			value = evaluate(i * width, outMin, outMax, taper, calibration) * unit;
+		}
+		else{
+			//the last entry sits at 1024, one past the top reading, so it's stretched for 1023 to land exactly on the end of the curve
+			float end = evaluate(1023.0, outMin, outMax, taper, calibration) * unit;
+			value = table[i - 1] + (end - table[i - 1]) * width / (width - 1.0);
+		}
+		if(value > 32767.0 || value < -32768.0){
+			fits = false;
+			value = constrain(value, -32768.0, 32767.0);
+		}
+		table[i] = (int16_t)(value < 0 ? value - 0.5 : value + 0.5);
+	}
+	return fits;
+}//end generate()
+
+
+long CurveTable::lookup(long reading, uint8_t extraBits) const{
+	uint8_t shift = 10 + extraBits - bits;
+	if(reading < 0){
+		reading = 0;
+	}
+	uint16_t i = reading >> shift;
+	if(i >= (1 << bits)){
+		return entry(1 << bits);
+	}
+	long below = entry(i);
+	long fraction = reading & ((1L << shift) - 1);
+	return below + (((entry(i + 1) - below) * fraction + (1L << (shift - 1))) >> shift);
+}//end lookup()
+
+
+float CurveTable::toFloat(long reading, uint8_t extraBits) const{
+	return lookup(reading, extraBits) * scale;
+}//end toFloat()
+
+
+uint8_t CurveTable::getDecimals() const{
+	return decimals;
+}//end getDecimals()
+
+
+uint8_t CurveTable::getBits() const{
+	return bits;
+}//end getBits()
+
+
+
+
+
+
+// FilterChain
+
+FilterChain::FilterChain(){
+	stageCount = 0;
+}//end constructor
+
+
+bool FilterChain::addStage(uint8_t type, uint8_t param){
+	if(stageCount >= CSF_FILTER_STAGES){
+		return false;
+	}
+	stages[stageCount].type = type;
+	stages[stageCount].param = param;
+	stages[stageCount].index = 0;
+	stages[stageCount].filled = 0;
+	stageCount++;
+	return true;
+}//end addStage()
+
+
+bool FilterChain::addEMA(uint8_t k){
+	return addStage(FILTER_EMA, constrain(k, 1, 8));
+}//end addEMA()
+
+
+bool FilterChain::addMedian(uint8_t width){
+	if(width != 3 && width != 5){
+		return false;
+	}
+	return addStage(FILTER_MEDIAN, width);
+}//end addMedian()
+
+
+bool FilterChain::addDeadband(uint8_t width){
+	return addStage(FILTER_DEADBAND, width);
+}//end addDeadband()
+
+
+void FilterChain::reset(){
+	for(uint8_t i = 0; i < stageCount; i++){
+		stages[i].index = 0;
+		stages[i].filled = 0;
+	}
+}//end reset()
+
+
+int FilterChain::process(int reading){
+	for(uint8_t i = 0; i < stageCount; i++){
+		Stage& stage = stages[i];
+		if(stage.type == FILTER_EMA){
+			if(stage.filled == 0){
+				stage.accumulator = (long)reading << stage.param;
+				stage.filled = 1;
+			}
+			else{
+				stage.accumulator += reading - (stage.accumulator >> stage.param);
+			}
+			reading = (int)((stage.accumulator + (1L << (stage.param - 1))) >> stage.param);
+		}
+		else if(stage.type == FILTER_MEDIAN){
+			if(stage.filled == 0){
+				for(uint8_t j = 0; j < stage.param; j++){
+					stage.window[j] = reading;	//start the window full of the first reading so the first outputs aren't skewed
+				}
+				stage.filled = 1;
+			}
+			stage.window[stage.index] = reading;
+			stage.index = (stage.index + 1 < stage.param) ? stage.index + 1 : 0;
+			int sorted[FILTER_MEDIAN_MAX];
+			for(uint8_t j = 0; j < stage.param; j++){
+				int value = stage.window[j];
+				int8_t k = j - 1;
+				while(k >= 0 && sorted[k] > value){
+					sorted[k + 1] = sorted[k];
+					k--;
+				}
+				sorted[k + 1] = value;
+			}
+			reading = sorted[stage.param / 2];
+		}
+		else if(stage.type == FILTER_DEADBAND){
+			if(stage.filled == 0 || reading - stage.output >= stage.param || stage.output - reading >= stage.param){
+				stage.output = reading;
+				stage.filled = 1;
+			}
+			reading = stage.output;
+		}
+	}
+	return reading;
+}//end process()
+
+
+uint8_t FilterChain::getStageCount(){
+	return stageCount;
+}//end getStageCount()
+
+
+
+
+
+// Sampler
+
+uint8_t Sampler::channelCount = 0;
+volatile uint8_t Sampler::current = 0;
+volatile bool Sampler::running = false;
+bool Sampler::hooked = false;
+volatile unsigned long Sampler::conversions = 0;
+uint8_t Sampler::pins[CSF_SAMPLER_CHANNELS];
+uint8_t Sampler::adcChannels[CSF_SAMPLER_CHANNELS];
+PotReader* Sampler::pots[CSF_SAMPLER_CHANNELS];
+Utility::HistoryBuffer<uint16_t, CSF_SAMPLER_DEPTH> Sampler::history[CSF_SAMPLER_CHANNELS];
+
+
+int8_t Sampler::attach(Pot& pot){
+	return attachReader(pot, pot.sensorLine);
+}//end attach()
+
+
+int8_t Sampler::attachReader(PotReader& pot, int sensorLine){
+	if(pot.samplerChannel >= 0){
+		return pot.samplerChannel;
+	}
+	if(channelCount >= CSF_SAMPLER_CHANNELS || VirtualPins::isVirtual(sensorLine)){
+		return -1;
+	}
+	bool wasRunning = running;
+	end();
+	uint8_t channel = channelCount;
+	uint8_t pin = sensorLine;
+	pins[channel] = pin;
+	uint8_t analogChannel = (pin >= A0) ? pin - A0 : pin;
+	#if defined(analogPinToChannel)
+		analogChannel = analogPinToChannel(analogChannel);
+	#endif
+	adcChannels[channel] = analogChannel;
+	pots[channel] = &pot;
+	history[channel].clear();
+	history[channel].put(analogRead(pin));	//so there's a real reading before the first conversion finishes
+	channelCount++;
+	pot.samplerChannel = channel;
+	pot.setOversampling(pot.oversampling);
+	if(wasRunning){
+		begin();
+	}
+	return channel;
+}//end attachReader()
+
+
+void Sampler::begin(){
+	if(channelCount == 0 || running){
+		return;
+	}
+	current = 0;
+	conversions = 0;
+	running = true;
+	#if defined(__AVR__) && defined(ADC_vect)
+		if(hooked){
+			ADCSRA |= (1 << ADIE);
+		}
+	#endif
+	startConversion();
+}//end begin()
+
+
+void Sampler::end(){
+	running = false;
+	#if defined(__AVR__) && defined(ADC_vect)
+		if(hooked){
+			ADCSRA &= ~(1 << ADIE);
+			while(ADCSRA & (1 << ADSC));	//let a conversion already started finish so analogRead() finds the ADC idle
+		}
+	#endif
+}//end end()
+
+
+void Sampler::detachAll(){
+	end();
+	for(uint8_t i = 0; i < channelCount; i++){
+		pots[i]->samplerChannel = -1;
+	}
+	channelCount = 0;
+}//end detachAll()
+
+
+int Sampler::latest(uint8_t channel){
+	return history[channel].latest();
+}//end latest()
+
+
+uint8_t Sampler::recent(uint8_t channel, uint16_t* out, uint8_t n){
+	return history[channel].recent(out, n);
+}//end recent()
+
+
+void Sampler::onConversion(uint16_t reading){
+	uint8_t channel = current;
+	history[channel].put(reading);
+	conversions++;
+	channel++;
+	if(channel >= channelCount){
+		channel = 0;
+	}
+	current = channel;
+	if(running){
+		startConversion();
+	}
+}//end onConversion()
+
+
+void Sampler::startConversion(){
+	#if defined(__AVR__) && defined(ADC_vect)
+		if(!hooked){
+			return;
+		}
+		uint8_t analogChannel = adcChannels[current];
+		#if defined(MUX5)
+			ADCSRB = (ADCSRB & ~(1 << MUX5)) | (((analogChannel >> 3) & 0x01) << MUX5);
+		#endif
+		ADMUX = (1 << REFS0) | (analogChannel & 0x07);	//AVcc reference, the same as analogRead() with DEFAULT
+		ADCSRA |= (1 << ADSC);
+	#endif
+}//end startConversion()
+
+
+bool Sampler::hookInterrupt(bool hook){
+	end();
+	hooked = hook;
+	return hook;
+}//end hookInterrupt()
+
+
+void Sampler::service(){
+	if(running && !hooked){
+		onConversion(analogRead(pins[current]));
+	}
+}//end service()
+
+
+bool Sampler::isRunning(){
+	return running;
+}//end isRunning()
+
+
+bool Sampler::isInterruptDriven(){
+	return running && hooked;
+}//end isInterruptDriven()
+
+
+unsigned long Sampler::getConversions(){
+	unsigned long count;
+	noInterrupts();
+	count = conversions;
+	interrupts();
+	return count;
+}//end getConversions()
+
+
+
+
+
+// Button
+
+Button::Button(int p){
+	pin = p;
+	lastState = 0;
+	events = 0;
+}//end constructor()
+
+
+void Button::begin(){
+	VirtualPins::setMode(pin, INPUT);
+}//end begin()
+
+
+int Button::getState(){
+	int state = VirtualPins::readDigital(pin);
+	CSF_STAT(stats.sample(state));
+	return state;
+}//end getButtonState()
+
+
+int Button::getState(bool condition){
+	return condition ? getState() : 0;
+}//end getButtonState(bool)
+
+
+void Button::toSerial(){
+	Serial.println(getState());
+	CSF_STAT(stats.emit());
+}//end toSerial()
+
+
+void Button::toSerial(bool condition){
+	Serial.println(getState(condition));
+	CSF_STAT(stats.emit());
+}//end toSerial(bool);
+
+
+void Button::poll(){
+	lastState = debounce(VirtualPins::readDigital(pin));
+}//end poll()
+
+
+int Button::getLastState(){
+	return lastState;
+}//end getLastState()
+
+
+int Button::getPin(){
+	return pin;
+}//end getPin()
+
+
+bool Button::toSerialOnChange(){
+	return toSerialOnChange(getState());
+}//end toSerialOnChange()
+
+
+bool Button::toSerialOnChange(int state){
+	if(!tracker.check(state, state != 0, millis())){
+		return false;
+	}
+	Serial.print(tracker.getSequence());
+	Serial.print(' ');
+	Serial.println(state);
+	CSF_STAT(stats.emit());
+	return true;
+}//end toSerialOnChange()
+
+
+void Button::setReportByException(unsigned int heartbeat){
+	tracker.configure(1, heartbeat);
+}//end setReportByException()
+
+
+uint8_t Button::getEvents(){
+	uint8_t taken = events;
+	events = 0;
+	return taken;
+}//end getEvents()
+
+
+Utility::Debouncer& Button::getDebouncer(){
+	return debouncer;
+}//end getDebouncer()
+
+
+int Button::debounce(int level){
+	uint8_t now = debouncer.update(level, millis());
+	events |= now;
+	int state = debouncer.getState();
+	lastState = state;
+	#if CSF_CONTROLS_STATS
+	stats.sample(state);
+	if(now & Utility::Debouncer::BOUNCED){
+		stats.suppressed++;
+	}
+	#endif
+	return state;
+}//end debounce()
+
+
+#if CSF_CONTROLS_STATS
+Utility::ControlStats& Button::getStats(){
+	return stats;
+}//end getStats()
+#endif
+
+
+
+
+
+
+
+//Momentary
+
+int Momentary::getState(){
+	return debounce(VirtualPins::readDigital(pin));
+}//end getState()
+
+
+int Momentary::getState(bool condition){
+	int state = getState();	//read even when the condition is false, so no edge is missed
+	return condition ? state : 0;
+}//end getState(bool)
+
+
+
+
+
+
+
+// Touch
+
+int Touch::getState(){
+	return debounce(VirtualPins::readDigital(pin));
+}//end getState()
+
+
+int Touch::getState(bool condition){
+	int state = getState();	//read even when the condition is false, so no edge is missed
+	return condition ? state : 0;
+}//end getState(bool)
+
+
+
+
+
+
+// ButtonBank
+
+namespace{
+	static_assert(CSF_BANK_PORTS >= 1 && CSF_BANK_PORTS <= 4, "a ButtonBank's bits have to fit the 32 bits takePressed() returns");
+}
+
+
+ButtonBank::ButtonBank(){
+	laneCount = 0;
+}//end constructor
+
+
+int8_t ButtonBank::laneFor(uint8_t port){
+	for(uint8_t lane = 0; lane < laneCount; lane++){
+		if(portNumbers[lane] == port){
+			return lane;
+		}
+	}
+	if(laneCount >= CSF_BANK_PORTS){
+		return -1;
+	}
+	uint8_t lane = laneCount++;
+	portNumbers[lane] = port;
+	inputs[lane] = portInputRegister(port);
+	masks[lane] = 0;
+	inverts[lane] = 0;
+	states[lane] = 0;
+	counts0[lane] = 0xFF;
+	counts1[lane] = 0xFF;
+	pressed[lane] = 0;
+	released[lane] = 0;
+	return lane;
+}//end laneFor()
+
+
+int8_t ButtonBank::attach(uint8_t p){
+	return attach(p, false);
+}//end attach(pin)
+
+
+int8_t ButtonBank::attach(uint8_t p, bool activeLow){
+	if(VirtualPins::isVirtual(p)){
+		return -1;
+	}
+	uint8_t port = digitalPinToPort(p);
+	if(port == NOT_A_PORT){
+		return -1;
+	}
+	int8_t lane = laneFor(port);
+	if(lane < 0){
+		return -1;
+	}
+	uint8_t mask = digitalPinToBitMask(p);
+	masks[lane] |= mask;
+	if(activeLow){
+		inverts[lane] |= mask;
+	}
+	else{
+		inverts[lane] &= ~mask;
+	}
+	uint8_t bit = 0;
+	while((mask >> bit) != 1){
+		bit++;
+	}
+	return lane * 8 + bit;
+}//end attach(pin, activeLow)
+
+
+int8_t ButtonBank::attach(Button& button){
+	return attach(button.getPin(), false);
+}//end attach(Button)
+
+
+void ButtonBank::begin(){
+	for(uint8_t lane = 0; lane < laneCount; lane++){
+		volatile uint8_t* mode = portModeRegister(portNumbers[lane]);
+		volatile uint8_t* output = portOutputRegister(portNumbers[lane]);
+		noInterrupts();
+		*mode &= ~masks[lane];
+		*output = (*output & ~masks[lane]) | inverts[lane];	//pull-ups on for the active low buttons
+		interrupts();
+	}
+	for(uint8_t lane = 0; lane < laneCount; lane++){
+		states[lane] = (*inputs[lane] ^ inverts[lane]) & masks[lane];
+		counts0[lane] = 0xFF;
+		counts1[lane] = 0xFF;
+		pressed[lane] = 0;
+		released[lane] = 0;
+	}
+}//end begin()
+
+
+void ButtonBank::tick(){
+	for(uint8_t lane = 0; lane < laneCount; lane++){
+		uint8_t changed = ((*inputs[lane] ^ inverts[lane]) & masks[lane]) ^ states[lane];
+		counts0[lane] = ~(counts0[lane] & changed);
+		counts1[lane] = counts0[lane] ^ (counts1[lane] & changed);
+		changed &= counts0[lane] & counts1[lane];	//only the bits whose counters rolled over
+		states[lane] ^= changed;
+		pressed[lane] |= states[lane] & changed;
+		released[lane] |= ~states[lane] & changed;
+	}
+}//end tick()
+
+
+int8_t ButtonBank::bitOf(uint8_t p){
+	uint8_t port = digitalPinToPort(p);
+	uint8_t mask = digitalPinToBitMask(p);
+	for(uint8_t lane = 0; lane < laneCount; lane++){
+		if(portNumbers[lane] == port && (masks[lane] & mask)){
+			uint8_t bit = 0;
+			while((mask >> bit) != 1){
+				bit++;
+			}
+			return lane * 8 + bit;
+		}
+	}
+	return -1;
+}//end bitOf()
+
+
+uint32_t ButtonBank::getState(){
+	uint32_t state = 0;
+	for(uint8_t lane = 0; lane < laneCount; lane++){
+		state |= (uint32_t)states[lane] << (lane * 8);
+	}
+	return state;
+}//end getState()
+
+
+bool ButtonBank::isPressed(uint8_t bit){
+	uint8_t lane = bit >> 3;
+	return lane < laneCount && (states[lane] & (1 << (bit & 0x07)));
+}//end isPressed()
+
+
+uint32_t ButtonBank::takePressed(){
+	uint32_t edges = 0;
+	noInterrupts();	//in case tick() runs from a timer
+	for(uint8_t lane = 0; lane < laneCount && lane < CSF_BANK_PORTS; lane++){	//bounded by the array too, so the compiler can see the writes stay inside it
+		edges |= (uint32_t)pressed[lane] << (lane * 8);
+		pressed[lane] = 0;
+	}
+	interrupts();
+	return edges;
+}//end takePressed()
+
+
+uint32_t ButtonBank::takeReleased(){
+	uint32_t edges = 0;
+	noInterrupts();	//in case tick() runs from a timer
+	for(uint8_t lane = 0; lane < laneCount && lane < CSF_BANK_PORTS; lane++){	//bounded by the array too, so the compiler can see the writes stay inside it
+		edges |= (uint32_t)released[lane] << (lane * 8);
+		released[lane] = 0;
+	}
+	interrupts();
+	return edges;
+}//end takeReleased()
+
+
+
+
+
+// BankButton
+
+void BankButton::begin(){
+	bankBit = bank.attach(pin);
+	debouncer.setHoldOff(0);	//the bank has already debounced it
+	debouncer.setConfirm(0);
+}//end begin()
+
+
+int BankButton::getState(){
+	int state = (bankBit >= 0 && bank.isPressed(bankBit)) ? 1 : 0;
+	CSF_STAT(stats.sample(state));
+	return state;
+}//end getState()
+
+
+int BankButton::getState(bool condition){
+	return condition ? getState() : 0;
+}//end getState(bool)
+
+
+void BankButton::toSerial(){
+	Serial.println(getState());
+	CSF_STAT(stats.emit());
+}//end toSerial()
+
+
+void BankButton::poll(){
+	lastState = debounce(getState());
+}//end poll()
+
+
+
+
+
+
+// EventCapture
+
+uint8_t EventCapture::pinCount = 0;
+uint8_t EventCapture::pins[CSF_EVENT_PINS];
+Utility::RingBuffer<EdgeEvent, CSF_EVENT_QUEUE> EventCapture::queue;
+
+namespace{
+	static_assert(CSF_EVENT_PINS >= 1 && CSF_EVENT_PINS <= 8, "EventCapture has interrupt handlers for 1 to 8 pins");
+
+	template<uint8_t Slot>
+	void edgeHandler(){
+		static_assert(Slot < CSF_EVENT_PINS, "an edge handler for a slot EventCapture doesn't have");
+		EventCapture::onInterrupt(Slot);
+	}//end edgeHandler()
+
+	//exactly one handler per slot, so none of them can index past pins[]
+	void (* const edgeHandlers[CSF_EVENT_PINS])(void) = {
+		edgeHandler<0>
+#if CSF_EVENT_PINS > 1
+		, edgeHandler<1>
+#endif
+#if CSF_EVENT_PINS > 2
+		, edgeHandler<2>
+#endif
+#if CSF_EVENT_PINS > 3
+		, edgeHandler<3>
+#endif
+#if CSF_EVENT_PINS > 4
+		, edgeHandler<4>
+#endif
+#if CSF_EVENT_PINS > 5
+		, edgeHandler<5>
+#endif
+#if CSF_EVENT_PINS > 6
+		, edgeHandler<6>
+#endif
+#if CSF_EVENT_PINS > 7
+		, edgeHandler<7>
+#endif
+	};
+}
+
+
+bool EventCapture::attach(Button& button){
+	return attach(button.getPin());
+}//end attach(Button)
+
+
+bool EventCapture::attach(uint8_t p){
+	if(VirtualPins::isVirtual(p)){
+		return false;
+	}
+	int interrupt = digitalPinToInterrupt(p);
+	if(interrupt == NOT_AN_INTERRUPT || pinCount >= CSF_EVENT_PINS){
+		return false;
+	}
+	uint8_t slot = pinCount++;
+	pins[slot] = p;
+	attachInterrupt(interrupt, edgeHandlers[slot], CHANGE);
+	return true;
+}//end attach(pin)
+
+
+void EventCapture::detachAll(){
+	for(uint8_t slot = 0; slot < pinCount; slot++){
+		detachInterrupt(digitalPinToInterrupt(pins[slot]));
+	}
+	pinCount = 0;
+	queue.clear();
+}//end detachAll()
+
+
+void EventCapture::onInterrupt(uint8_t slot){
+	if(slot >= pinCount){
+		return;
+	}
+	uint8_t p = pins[slot];
+	capture(p, digitalRead(p));
+}//end onInterrupt()
+
+
+void EventCapture::capture(uint8_t p, uint8_t level){
+	EdgeEvent event;
+	event.pin = p;
+	event.level = level;
+	event.time = micros();
+	queue.push(event);
+}//end capture()
+
+
+uint8_t EventCapture::drain(EdgeEvent* events, uint8_t max){
+	uint8_t count = 0;
+	while(count < max && queue.pop(events[count])){
+		count++;
+	}
+	return count;
+}//end drain()
+
+
+uint8_t EventCapture::available(){
+	return queue.available();
+}//end available()
+
+
+uint16_t EventCapture::getOverflows(){
+	noInterrupts();
+	uint16_t overflows = queue.getOverflows();
+	interrupts();
+	return overflows;
+}//end getOverflows()
+
+
+
+
+
+
+// KeyMatrix
+
+namespace{
+	static_assert(CSF_MATRIX_COLUMNS <= 16, "KeyMatrix keeps a row of columns in 16 bits");
+}
+
+
+KeyMatrix::KeyMatrix(){
+	rowCount = 0;
+	columnCount = 0;
+	laneCount = 0;
+	interval = 5;
+	lastScan = 0;
+	settle = 0;
+	diodes = false;
+	ghosted = false;
+	ghostedScans = 0;
+	scanMicros = 0;
+	maxScanMicros = 0;
+}//end constructor
+
+
+int8_t KeyMatrix::addRow(uint8_t p){
+	if(rowCount >= CSF_MATRIX_ROWS || VirtualPins::isVirtual(p)){
+		return -1;
+	}
+	rowPins[rowCount] = p;
+	return rowCount++;
+}//end addRow()
+
+
+int8_t KeyMatrix::addColumn(uint8_t p){
+	if(columnCount >= CSF_MATRIX_COLUMNS || VirtualPins::isVirtual(p)){
+		return -1;
+	}
+	uint8_t port = digitalPinToPort(p);
+	if(port == NOT_A_PORT){
+		return -1;
+	}
+	uint8_t lane = 0;
+	while(lane < laneCount && lanePorts[lane] != port){
+		lane++;
+	}
+	if(lane == laneCount){
+		lanePorts[lane] = port;
+		laneInputs[lane] = portInputRegister(port);
+		laneCount++;
+	}
+	columnLanes[columnCount] = lane;
+	columnMasks[columnCount] = digitalPinToBitMask(p);
+	return columnCount++;
+}//end addColumn()
+
+
+void KeyMatrix::begin(){
+	for(uint8_t row = 0; row < rowCount; row++){
+		digitalWrite(rowPins[row], LOW);	//so the row pulls low whenever it's made an output
+		pinMode(rowPins[row], INPUT);
+		states[row] = 0;
+		counts0[row] = 0xFFFF;
+		counts1[row] = 0xFFFF;
+	}
+	for(uint8_t column = 0; column < columnCount; column++){
+		uint8_t port = lanePorts[columnLanes[column]];
+		volatile uint8_t* mode = portModeRegister(port);
+		volatile uint8_t* output = portOutputRegister(port);
+		noInterrupts();
+		*mode &= ~columnMasks[column];
+		*output |= columnMasks[column];	//pull-up on
+		interrupts();
+	}
+	queue.clear();
+	ghosted = false;
+	ghostedScans = 0;
+	lastScan = millis();
+	resetScanMicros();
+}//end begin()
+
+
+bool KeyMatrix::update(){
+	unsigned long now = millis();
+	if((now - lastScan) < interval){
+		return false;
+	}
+	lastScan = now;
+	scan();
+	return true;
+}//end update()
+
+
+uint16_t KeyMatrix::readColumns(){
+	uint8_t levels[CSF_MATRIX_COLUMNS];
+	for(uint8_t lane = 0; lane < laneCount; lane++){
+		levels[lane] = *laneInputs[lane];
+	}
+	uint16_t low = 0;
+	for(uint8_t column = 0; column < columnCount; column++){
+		if(!(levels[columnLanes[column]] & columnMasks[column])){
+			low |= (uint16_t)1 << column;
+		}
+	}
+	return low;
+}//end readColumns()
+
+
+void KeyMatrix::scan(){
+	unsigned long start = micros();
+	uint16_t raw[CSF_MATRIX_ROWS];
+	for(uint8_t row = 0; row < rowCount; row++){
+		pinMode(rowPins[row], OUTPUT);
+		if(settle > 0){
+			delayMicroseconds(settle);
+		}
+		raw[row] = readColumns();
+		pinMode(rowPins[row], INPUT);
+	}
+
+	//two rows sharing two columns is a rectangle, and any corner of it could be a ghost
+	uint16_t blocked[CSF_MATRIX_ROWS];
+	bool blocking = false;
+	for(uint8_t row = 0; row < rowCount; row++){
+		blocked[row] = 0;
+	}
+	if(!diodes){
+		for(uint8_t a = 0; a < rowCount; a++){
+			if(!(raw[a] & (raw[a] - 1))){
+				continue;	//fewer than two keys, it can't be one side of a rectangle
+			}
+			for(uint8_t b = a + 1; b < rowCount; b++){
+				uint16_t shared = raw[a] & raw[b];
+				if(shared & (shared - 1)){
+					blocked[a] |= shared;
+					blocked[b] |= shared;
+					blocking = true;
+				}
+			}
+		}
+	}
+	ghosted = blocking;
+	if(blocking){
+		ghostedScans++;
+	}
+
+	for(uint8_t row = 0; row < rowCount; row++){
+		uint16_t changed = (raw[row] ^ states[row]) & ~blocked[row];
+		counts0[row] = ~(counts0[row] & changed);
+		counts1[row] = counts0[row] ^ (counts1[row] & changed);
+		changed &= counts0[row] & counts1[row];	//only the keys whose counters rolled over
+		states[row] ^= changed;
+		for(uint8_t column = 0; changed != 0; column++, changed >>= 1){
+			if(changed & 0x01){
+				KeyEvent event;
+				event.key = row * columnCount + column;
+				event.pressed = (states[row] >> column) & 0x01;
+				event.time = start;
+				queue.push(event);
+			}
+		}
+	}
+
+	scanMicros = micros() - start;
+	if(scanMicros > maxScanMicros){
+		maxScanMicros = scanMicros;
+	}
+}//end scan()
+
+
+void KeyMatrix::setInterval(unsigned int ms){
+	interval = ms;
+}//end setInterval()
+
+
+void KeyMatrix::setSettle(uint8_t us){
+	settle = us;
+}//end setSettle()
+
+
+void KeyMatrix::setDiodes(bool fitted){
+	diodes = fitted;
+}//end setDiodes()
+
+
+uint8_t KeyMatrix::keyOf(uint8_t row, uint8_t column){
+	return row * columnCount + column;
+}//end keyOf()
+
+
+bool KeyMatrix::isPressed(uint8_t key){
+	if(columnCount == 0){
+		return false;
+	}
+	uint8_t row = key / columnCount;
+	return row < rowCount && (states[row] & ((uint16_t)1 << (key % columnCount)));
+}//end isPressed()
+
+
+uint16_t KeyMatrix::getRow(uint8_t row){
+	return row < rowCount ? states[row] : 0;
+}//end getRow()
+
+
+uint8_t KeyMatrix::drain(KeyEvent* events, uint8_t max){
+	uint8_t count = 0;
+	while(count < max && queue.pop(events[count])){
+		count++;
+	}
+	return count;
+}//end drain()
+
+
+uint8_t KeyMatrix::available(){
+	return queue.available();
+}//end available()
+
+
+uint16_t KeyMatrix::getOverflows(){
+	noInterrupts();	//in case scan() runs from a timer
+	uint16_t overflows = queue.getOverflows();
+	interrupts();
+	return overflows;
+}//end getOverflows()
+
+
+bool KeyMatrix::isGhosted(){
+	return ghosted;
+}//end isGhosted()
+
+
+uint16_t KeyMatrix::getGhostedScans(){
+	return ghostedScans;
+}//end getGhostedScans()
+
+
+unsigned long KeyMatrix::getScanMicros(){
+	return scanMicros;
+}//end getScanMicros()
+
+
+unsigned long KeyMatrix::getMaxScanMicros(){
+	return maxScanMicros;
+}//end getMaxScanMicros()
+
+
+void KeyMatrix::resetScanMicros(){
+	scanMicros = 0;
+	maxScanMicros = 0;
+}//end resetScanMicros()
+
+
+
+
+
+
+// MatrixKey
+
+void MatrixKey::begin(){
+	pin = matrix.keyOf(row, column);
+	debouncer.setHoldOff(0);	//the matrix has already debounced it
+	debouncer.setConfirm(0);
+}//end begin()
+
+
+int MatrixKey::getState(){
+	int state = matrix.isPressed(matrix.keyOf(row, column)) ? 1 : 0;
+	CSF_STAT(stats.sample(state));
+	return state;
+}//end getState()
+
+
+int MatrixKey::getState(bool condition){
+	return condition ? getState() : 0;
+}//end getState(bool)
+
+
+void MatrixKey::toSerial(){
+	Serial.println(getState());
+	CSF_STAT(stats.emit());
+}//end toSerial()
+
+
+void MatrixKey::poll(){
+	lastState = debounce(getState());
+}//end poll()
+
+
+
+
+
+
+
+// ControlManager
+
+namespace{
+	const uint8_t SLOT_CONTROL = 0;
+	const uint8_t SLOT_BUTTON = 1;
+	const uint8_t SLOT_TASK = 2;
+}
+
+
+ControlManager::ControlManager(){
+	count = 0;
+	currentTime = millis();
+	budget = 0;
+	activeCount = 0;
+}//end constructor
+
+
+bool ControlManager::add(ControlUnit& control){
+	return addSlot(SLOT_CONTROL, &control, POLL_INTERVAL);	//the control's interval is the lockout between presses, not how often to look
+}//end add(ControlUnit)
+
+
+bool ControlManager::add(Button& button){
+	return addSlot(SLOT_BUTTON, &button, POLL_INTERVAL);
+}//end add(Button)
+
+
+bool ControlManager::add(Button& button, unsigned int val){
+	return addSlot(SLOT_BUTTON, &button, val);
+}//end add(Button, interval)
+
+
+bool ControlManager::add(ControlUnit& control, Utility::RateController& rate){
+	if(!addSlot(SLOT_CONTROL, &control, POLL_INTERVAL)){
+		return false;
+	}
+	rates[count - 1] = &rate;
+	sampleTimes[count - 1] = currentTime + rate.getInterval();
+	return true;
+}//end add(ControlUnit, RateController)
+
+
+bool ControlManager::add(Button& button, Utility::RateController& rate){
+	if(!addSlot(SLOT_BUTTON, &button, POLL_INTERVAL)){
+		return false;
+	}
+	rates[count - 1] = &rate;
+	sampleTimes[count - 1] = currentTime + rate.getInterval();
+	return true;
+}//end add(Button, RateController)
+
+
+bool ControlManager::add(Task task, unsigned int val){
+	return addSlot(SLOT_TASK, (void*)task, val);
+}//end add(Task)
+
+
+bool ControlManager::addSlot(uint8_t kind, void* target, unsigned int val){
+	if(count >= CSF_MANAGER_CONTROLS){
+		return false;
+	}
+	uint8_t slot = count;
+	kinds[slot] = kind;
+	targets[slot] = target;
+	intervals[slot] = val;
+	rates[slot] = NULL;
+	heap[slot] = slot;
+	deadlines[slot] = currentTime + val;
+	count++;
+	siftUp(slot);
+	return true;
+}//end addSlot()
+
+
+void ControlManager::begin(){
+	currentTime = millis();
+	for(uint8_t i = 0; i < count; i++){
+		uint8_t slot = heap[i];
+		deadlines[i] = currentTime + intervals[slot];
+		if(rates[slot] != NULL){
+			sampleTimes[slot] = currentTime + rates[slot]->getInterval();
+		}
+		if(kinds[slot] == SLOT_CONTROL){
+			ControlUnit* control = (ControlUnit*)targets[slot];
+			if(control->getIsSensorOn()){
+				control->activateControl();
+			}
+			else{
+				control->deactivateControl();
+			}
+		}
+	}
+	for(int8_t i = count / 2 - 1; i >= 0; i--){
+		siftDown(i);
+	}
+}//end begin()
+
+
+uint8_t ControlManager::tick(){
+	CSF_STAT(Utility::Stats::markLoop());
+	currentTime = millis();
+	uint8_t ran = 0;
+	while(count > 0 && (long)(currentTime - deadlines[0]) >= 0){
+		uint8_t slot = heap[0];
+		CSF_STAT(Utility::Stats::noteLate(currentTime - deadlines[0]));
+		dispatch(slot);
+		ran++;
+		unsigned long next = (rates[slot] != NULL ? currentTime : deadlines[0]) + intervals[slot];	//a RateController's interval changes run to run, so it counts from now
+		if((long)(currentTime - next) >= 0){
+			next = currentTime + intervals[slot];	//fell behind, skip the missed runs rather than bursting through them
+		}
+		deadlines[0] = next;
+		siftDown(0);
+	}
+	return ran;
+}//end tick()
+
+
+void ControlManager::dispatch(uint8_t slot){
+	if(kinds[slot] == SLOT_CONTROL){
+		ControlUnit* control = (ControlUnit*)targets[slot];
+		bool wasOn = control->getIsSensorOn();
+		control->pollButton();
+		bool toggled = control->getIsSensorOn() != wasOn;
+		if(toggled){
+			if(control->getIsSensorOn()){
+				control->activateControl();
+			}
+			else{
+				control->deactivateControl();
+			}
+		}
+		if(rates[slot] != NULL && (toggled || isSampleDue(slot))){
+			int reading = control->getIsSensorOn() ? control->getSensorValue() : 0;
+			if(adapt(slot, reading, control->getIsSensorOn()) && control->toSerialOnChange(reading)){
+				rates[slot]->markReport(currentTime);
+			}
+		}
+	}
+	else if(kinds[slot] == SLOT_BUTTON){
+		Button* button = (Button*)targets[slot];
+		int before = button->getLastState();
+		button->poll();
+		if(rates[slot] != NULL && (button->getLastState() != before || isSampleDue(slot))){
+			int state = button->getLastState();
+			if(adapt(slot, state, state != 0) && button->toSerialOnChange(state)){
+				rates[slot]->markReport(currentTime);
+			}
+		}
+	}
+	else{
+		((Task)targets[slot])();
+	}
+	if(rates[slot] != NULL){
+		unsigned long untilSample = sampleTimes[slot] - currentTime;
+		intervals[slot] = untilSample < 1 ? 1 : (untilSample < POLL_INTERVAL ? untilSample : POLL_INTERVAL);	//back in time to read the button, or for the sample if that's sooner
+	}
+}//end dispatch()
+
+
+bool ControlManager::isSampleDue(uint8_t slot){
+	return (long)(currentTime - sampleTimes[slot]) >= 0;
+}//end isSampleDue()
+
+
+bool ControlManager::adapt(uint8_t slot, int value, bool flag){
+	Utility::RateController* rate = rates[slot];
+	bool wasActive = rate->isActive();
+	unsigned int next = rate->update(value, flag, currentTime);
+	if(rate->isActive() != wasActive){
+		activeCount += rate->isActive() ? 1 : -1;
+	}
+	unsigned int wait = 0;
+	if(budget > 0){
+		unsigned long spacing = (unsigned long)REPORT_BYTES * 1000 * (activeCount > 0 ? activeCount : 1) / budget;	//an even share each
+		wait = rate->getReportWait(currentTime, spacing);
+		if(wait > next && rate->isActive()){
+			next = wait;	//sampling again before it may report would only be thrown away
+		}
+	}
+	sampleTimes[slot] = currentTime + next;
+	return wait == 0;
+}//end adapt()
+
+
+void ControlManager::setSerialBudget(unsigned int bytesPerSecond){
+	budget = bytesPerSecond;
+}//end setSerialBudget()
+
+
+bool ControlManager::wake(Utility::RateController& rate){
+	unsigned long now = millis();
+	for(uint8_t i = 0; i < count; i++){
+		if(rates[heap[i]] == &rate){
+			if(!rate.isActive()){
+				activeCount++;
+			}
+			rate.wake(now);
+			sampleTimes[heap[i]] = now;
+			deadlines[i] = now;
+			siftUp(i);
+			return true;
+		}
+	}
+	return false;
+}//end wake()
+
+
+uint8_t ControlManager::getActiveCount(){
+	return activeCount;
+}//end getActiveCount()
+
+
+bool ControlManager::isBefore(uint8_t a, uint8_t b){
+	return (long)(deadlines[a] - deadlines[b]) < 0;
+}//end isBefore()
+
+
+void ControlManager::siftUp(uint8_t index){
+	while(index > 0){
+		uint8_t parent = (index - 1) / 2;
+		if(!isBefore(index, parent)){
+			break;
+		}
+		uint8_t slot = heap[index];
+		heap[index] = heap[parent];
+		heap[parent] = slot;
+		unsigned long deadline = deadlines[index];
+		deadlines[index] = deadlines[parent];
+		deadlines[parent] = deadline;
+		index = parent;
+	}
+}//end siftUp()
+
+
+void ControlManager::siftDown(uint8_t index){
+	while(true){
+		uint8_t smallest = index;
+		uint8_t left = 2 * index + 1;
+		uint8_t right = left + 1;
+		if(left < count && isBefore(left, smallest)){
+			smallest = left;
+		}
+		if(right < count && isBefore(right, smallest)){
+			smallest = right;
+		}
+		if(smallest == index){
+			break;
+		}
+		uint8_t slot = heap[index];
+		heap[index] = heap[smallest];
+		heap[smallest] = slot;
+		unsigned long deadline = deadlines[index];
+		deadlines[index] = deadlines[smallest];
+		deadlines[smallest] = deadline;
+		index = smallest;
+	}
+}//end siftDown()
+
+
+unsigned long ControlManager::getTime(){
+	return currentTime;
+}//end getTime()
+
+
+uint8_t ControlManager::getCount(){
+	return count;
+}//end getCount()
+
+
+
+
+
+// FrameStreamer
+
+FrameStreamer::FrameStreamer(){
+	channelCount = 0;
+	sequence = 0;
+	interval = 50;
+	previousTime = millis();
+	output = NULL;
+}//end constructor
+
+
+FrameStreamer::FrameStreamer(int val){
+	channelCount = 0;
+	sequence = 0;
+	interval = val;
+	previousTime = millis();
+	output = NULL;
+}//end constructor
+
+
+void FrameStreamer::begin(){
+	sequence = 0;
+	previousTime = millis();
+}//end begin()
+
+
+bool FrameStreamer::add(ControlUnit& control){
+	if(channelCount >= CSF_STREAM_CHANNELS){
+		return false;
+	}
+	kinds[channelCount] = FRAME_KIND_SENSOR;
+	channels[channelCount] = &control;
+	channelCount++;
+	return true;
+}//end add(ControlUnit)
+
+
+bool FrameStreamer::add(Button& button){
+	if(channelCount >= CSF_STREAM_CHANNELS){
+		return false;
+	}
+	kinds[channelCount] = FRAME_KIND_BUTTON;
+	channels[channelCount] = &button;
+	channelCount++;
+	return true;
+}//end add(Button)
+
+
+void FrameStreamer::update(){
+	long currentTime = millis();
+	if( (currentTime - previousTime) >= interval){
+		previousTime = currentTime;
+		sendFrame();
+	}
+}//end update()
+
+
+size_t FrameStreamer::buildPayload(uint8_t* payload){
+	payload[0] = FRAME_VERSION;
+	putU16(payload + 1, sequence);
+	putU32(payload + 3, millis());
+	payload[7] = channelCount;
+	uint8_t* channel = payload + FRAME_HEADER_SIZE;
+	for(uint8_t i = 0; i < channelCount; i++){
+		uint8_t flags = kinds[i];
+		int value = 0;
+		if(kinds[i] == FRAME_KIND_SENSOR){
+			ControlUnit* control = (ControlUnit*)channels[i];
+			if(control->getIsSensorOn()){
+				flags |= FRAME_FLAG_ON;
+				value = control->getSensorValue();
+			}
+			CSF_STAT(control->getStats().emit());
+		}
+		else{
+			Button* button = (Button*)channels[i];
+			value = button->getState();
+			if(value){
+				flags |= FRAME_FLAG_ON;
+			}
+			CSF_STAT(button->getStats().emit());
+		}
+		channel[0] = flags;
+		putU16(channel + 1, (uint16_t)value);
+		channel += FRAME_CHANNEL_SIZE;
+	}
+	size_t size = channel - payload;
+	putU16(channel, crc16(payload, size));
+	return size + FRAME_CRC_SIZE;
+}//end buildPayload()
+
+
+void FrameStreamer::sendFrame(){
+	uint8_t payload[FRAME_HEADER_SIZE + CSF_STREAM_CHANNELS * FRAME_CHANNEL_SIZE + FRAME_CRC_SIZE];
+	uint8_t encoded[sizeof(payload) + sizeof(payload) / 254 + 2];
+	size_t size = cobsEncode(payload, buildPayload(payload), encoded);
+	encoded[size++] = FRAME_DELIMITER;
+	if(output != NULL){
+		output->write(encoded, size);	//a frame that doesn't fit is dropped whole, the receiver sees the gap in the sequence
+	}
+	else{
+		Serial.write(encoded, size);
+	}
+	sequence++;
+}//end sendFrame()
+
+
+void FrameStreamer::setInterval(int val){
+	interval = val;
+}//end setInterval()
+
+
+uint8_t FrameStreamer::getChannelCount(){
+	return channelCount;
+}//end getChannelCount()
+
+
+uint16_t FrameStreamer::getSequence(){
+	return sequence;
+}//end getSequence()
+
+
+void FrameStreamer::setOutput(TxQueue& queue){
+	output = &queue;
+}//end setOutput()
+
+
+
+
+
+
+// TxQueue
+
+TxQueue::TxQueue(){
+	highWater = 0;
+	dropped = 0;
+	overwritten = 0;
+	split = 0;
+	written = 0;
+	drained = 0;
+	lineEnd = 0;
+	channelCount = 0;
+	for(uint8_t i = 0; i < sizeof(pending); i++){
+		pending[i] = 0;
+	}
+	interval = 50;
+	previousTime = millis();
+}//end constructor
+
+
+TxQueue::TxQueue(int val){
+	highWater = 0;
+	dropped = 0;
+	overwritten = 0;
+	split = 0;
+	written = 0;
+	drained = 0;
+	lineEnd = 0;
+	channelCount = 0;
+	for(uint8_t i = 0; i < sizeof(pending); i++){
+		pending[i] = 0;
+	}
+	interval = val;
+	previousTime = millis();
+}//end constructor
+
+
+int TxQueue::add(ControlUnit& control){
+	int channel = addChannel();
+	if(channel >= 0){
+		kinds[channel] = TX_KIND_SENSOR;
+		controls[channel] = &control;
+	}
+	return channel;
+}//end add(ControlUnit)
+
+
+int TxQueue::add(Button& button){
+	int channel = addChannel();
+	if(channel >= 0){
+		kinds[channel] = TX_KIND_BUTTON;
+		controls[channel] = &button;
+	}
+	return channel;
+}//end add(Button)
+
+
+int TxQueue::addChannel(){
+	if(channelCount >= CSF_TX_CHANNELS){
+		return -1;
+	}
+	uint8_t channel = channelCount++;
+	kinds[channel] = TX_KIND_NONE;
+	controls[channel] = NULL;
+	values[channel] = 0;
+	sentValues[channel] = 0;
+	pending[channel >> 3] |= (1 << (channel & 0x07));	//so every channel goes out once to start with
+	return channel;
+}//end addChannel()
+
+
+void TxQueue::set(uint8_t channel, int value){
+	if(channel >= channelCount){
+		return;
+	}
+	uint8_t mask = 1 << (channel & 0x07);
+	if(pending[channel >> 3] & mask){
+		if(values[channel] != value){
+			overwritten++;
+		}
+	}
+	else if(value == sentValues[channel]){
+		return;
+	}
+	values[channel] = value;
+	pending[channel >> 3] |= mask;
+}//end set()
+
+
+bool TxQueue::write(const uint8_t* data, size_t len){
+	if(len > (size_t)(CSF_TX_BUFFER - 1 - bytes.available())){
+		dropped++;
+		return false;
+	}
+	for(size_t i = 0; i < len; i++){
+		bytes.push(data[i]);
+	}
+	written += len;
+	uint8_t waiting = bytes.available();
+	if(waiting > highWater){
+		highWater = waiting;
+	}
+	return true;
+}//end write()
+
+
+bool TxQueue::println(const char* text){
+	size_t len = strlen(text);
+	if(len + 2 > (size_t)(CSF_TX_BUFFER - 1 - bytes.available())){
+		dropped++;
+		return false;
+	}
+	write((const uint8_t*)text, len);
+	return write((const uint8_t*)"\r\n", 2);
+}//end println()
+
+
+void TxQueue::update(){
+	drain();
+	long currentTime = millis();
+	if( (currentTime - previousTime) >= interval){
+		previousTime = currentTime;
+		sample();
+		flush();
+	}
+	drain();
+}//end update()
+
+
+void TxQueue::sample(){
+	for(uint8_t channel = 0; channel < channelCount; channel++){
+		if(kinds[channel] == TX_KIND_SENSOR){
+			ControlUnit* control = (ControlUnit*)controls[channel];
+			set(channel, control->getIsSensorOn() ? control->getSensorValue() : 0);
+		}
+		else if(kinds[channel] == TX_KIND_BUTTON){
+			set(channel, ((Button*)controls[channel])->getState());
+		}
+	}
+}//end sample()
+
+
+bool TxQueue::flush(){
+	bool any = false;
+	for(uint8_t i = 0; i < sizeof(pending); i++){
+		any = any || pending[i] != 0;
+	}
+	if(!any){
+		return true;
+	}
+	if((int16_t)(drained - lineEnd) < 0){
+		return false;	//the last line is still waiting, these values would only queue up behind it
+	}
+	uint8_t room = CSF_TX_BUFFER - 1 - bytes.available();
+	if(room > TX_LINE_MAX){
+		room = TX_LINE_MAX;
+	}
+	if(room < 2){
+		return false;
+	}
+	room -= 2;	//for the line ending
+	char line[TX_LINE_MAX];
+	uint8_t length = 0;
+	bool left = false;
+	for(uint8_t channel = 0; channel < channelCount; channel++){
+		uint8_t mask = 1 << (channel & 0x07);
+		if(!(pending[channel >> 3] & mask)){
+			continue;
+		}
+		char entry[TX_ENTRY_MAX];	//" 255:-2147483648" at the most
+		uint8_t size = 0;
+		if(length > 0){
+			entry[size++] = ' ';
+		}
+		size += formatNumber(entry + size, channel);
+		entry[size++] = ':';
+		size += formatNumber(entry + size, values[channel]);
+		if(size > room - length){
+			left = true;	//no room, it waits in its slot for the next line and gets replaced by newer values meanwhile
+			continue;
+		}
+		memcpy(line + length, entry, size);
+		length += size;
+		sentValues[channel] = values[channel];
+		pending[channel >> 3] &= ~mask;
+		#if CSF_CONTROLS_STATS
+		if(kinds[channel] == TX_KIND_SENSOR){
+			((ControlUnit*)controls[channel])->getStats().emit();
+		}
+		else if(kinds[channel] == TX_KIND_BUTTON){
+			((Button*)controls[channel])->getStats().emit();
+		}
+		#endif
+	}
+	if(length == 0){
+		return false;
+	}
+	line[length++] = '\r';
+	line[length++] = '\n';
+	write((const uint8_t*)line, length);
+	lineEnd = written;
+	if(left){
+		split++;
+	}
+	return !left;
+}//end flush()
+
+
+uint8_t TxQueue::drain(){
+	int room = Serial.availableForWrite();
+	uint8_t sent = 0;
+	uint8_t chunk[16];
+	while(room > 0 && bytes.available() > 0){
+		uint8_t count = 0;
+		while(count < sizeof(chunk) && count < room && bytes.pop(chunk[count])){
+			count++;
+		}
+		Serial.write(chunk, count);
+		room -= count;
+		sent += count;
+		drained += count;
+	}
+	return sent;
+}//end drain()
+
+
+uint8_t TxQueue::formatNumber(char* out, long value){
+	char digits[11];
+	uint8_t count = 0;
+	uint8_t length = 0;
+	unsigned long magnitude = value < 0 ? -(unsigned long)value : value;
+	do{
+		digits[count++] = '0' + magnitude % 10;
+		magnitude /= 10;
+	}while(magnitude > 0);
+	if(value < 0){
+		out[length++] = '-';
+	}
+	while(count > 0){
+		out[length++] = digits[--count];
+	}
+	return length;
+}//end formatNumber()
+
+
+void TxQueue::setInterval(int val){
+	interval = val;
+}//end setInterval()
+
+
+uint8_t TxQueue::getPending(){
+	return bytes.available();
+}//end getPending()
+
+
+uint8_t TxQueue::getHighWater(){
+	return highWater;
+}//end getHighWater()
+
+
+uint16_t TxQueue::getDropped(){
+	return dropped;
+}//end getDropped()
+
+
+uint16_t TxQueue::getOverwritten(){
+	return overwritten;
+}//end getOverwritten()
+
+
+uint16_t TxQueue::getSplit(){
+	return split;
+}//end getSplit()
+
+
+
+
+
+
+// CommandParser
+
+CommandParser::CommandParser(){
+	length = 0;
+	overflow = false;
+	bindingCount = 0;
+	streamer = NULL;
+	errors = 0;
+}//end constructor
+
+
+bool CommandParser::bind(const char* name, Pot& pot){
+	return addBinding(name, COMMAND_POT, &pot);
+}//end bind(Pot)
+
+
+bool CommandParser::bind(const char* name, ControlUnit& control){
+	return addBinding(name, COMMAND_SENSOR, &control);
+}//end bind(ControlUnit)
+
+
+bool CommandParser::bind(const char* name, Button& button){
+	return addBinding(name, COMMAND_BUTTON, &button);
+}//end bind(Button)
+
+
+bool CommandParser::on(const char* name, CommandHandler handler){
+	return addBinding(name, COMMAND_HANDLER, (void*)handler);
+}//end on()
+
+
+bool CommandParser::addBinding(const char* name, uint8_t kind, void* target){
+	if(bindingCount >= CSF_COMMAND_BINDINGS){
+		return false;
+	}
+	hashes[bindingCount] = commandHash(name);
+	kinds[bindingCount] = kind;
+	names[bindingCount] = name;
+	targets[bindingCount] = target;
+	bindingCount++;
+	return true;
+}//end addBinding()
+
+
+void CommandParser::attach(FrameStreamer& s){
+	streamer = &s;
+}//end attach()
+
+
+uint8_t CommandParser::update(){
+	uint8_t ran = 0;
+	while(Serial.available() > 0){	//only what's already in the receive buffer, never waits for more
+		if(push((char)Serial.read())){
+			ran++;
+		}
+	}
+	return ran;
+}//end update()
+
+
+bool CommandParser::push(char c){
+	if(c == '\r'){
+		return false;
+	}
+	if(c != '\n'){
+		if(length < CSF_COMMAND_LENGTH){
+			buffer[length++] = c;
+		}
+		else{
+			overflow = true;
+		}
+		return false;
+	}
+	buffer[length] = 0;
+	bool complete = length > 0;
+	if(overflow){
+		char* space = strchr(buffer, ' ');
+		if(space != NULL){
+			*space = 0;
+		}
+		reject(buffer);
+	}
+	else if(complete){
+		execute(buffer);
+	}
+	else{
+		reject("");	//an empty line still gets its one line back
+	}
+	length = 0;
+	overflow = false;
+	return complete;
+}//end push()
+
+
+void CommandParser::execute(char* line){
+	char* words[COMMAND_MAX_WORDS];
+	uint8_t count = 0;
+	char* cursor = line;
+	while(count < COMMAND_MAX_WORDS){
+		while(*cursor == ' ' || *cursor == '\t'){
+			cursor++;
+		}
+		if(*cursor == 0){
+			break;
+		}
+		words[count++] = cursor;
+		while(*cursor != 0 && *cursor != ' ' && *cursor != '\t'){
+			cursor++;
+		}
+		if(*cursor != 0){
+			*cursor++ = 0;
+		}
+	}
+	if(count == 0){
+		reject("");	//nothing but spaces
+		return;
+	}
+	uint8_t argc = count - 1;
+	char** argv = words + 1;
+	uint16_t hash = commandHash(words[0]);
+
+	//the built in commands, strcmp() only runs once the hash has matched
+	switch(hash){
+		case commandHash("get"):
+			if(strcmp(words[0], "get") == 0){
+				int index = argc == 1 ? find(argv[0]) : -1;
+				if(index < 0 || !print(index)){
+					reject(words[0]);
+				}
+				return;
+			}
+			break;
+		case commandHash("map"):
+			if(strcmp(words[0], "map") == 0){
+				int index = argc == 3 ? find(argv[0]) : -1;
+				if(index < 0 || kinds[index] != COMMAND_POT){
+					reject(words[0]);
+					return;
+				}
+				char* minEnd;
+				char* maxEnd;
+				Pot* pot = (Pot*)targets[index];
+				if(strchr(argv[1], '.') != NULL || strchr(argv[2], '.') != NULL){
+					float min = strtod(argv[1], &minEnd);
+					float max = strtod(argv[2], &maxEnd);
+					if(*minEnd != 0 || *maxEnd != 0){
+						reject(words[0]);
+						return;
+					}
+					pot->mapData(min, max);
+				}
+				else{
+					long min = strtol(argv[1], &minEnd, 10);
+					long max = strtol(argv[2], &maxEnd, 10);
+					if(*minEnd != 0 || *maxEnd != 0){
+						reject(words[0]);
+						return;
+					}
+					pot->mapData((int)min, (int)max);
+				}
+				pot->toSerial();
+				return;
+			}
+			break;
+		case commandHash("rate"):
+			if(strcmp(words[0], "rate") == 0){
+				char* end;
+				long hz = argc == 1 ? strtol(argv[0], &end, 10) : 0;
+				if(streamer == NULL || hz <= 0 || *end != 0){
+					reject(words[0]);
+					return;
+				}
+				streamer->setInterval(hz >= 1000 ? 1 : (int)(1000 / hz));
+				Serial.println("ok");
+				return;
+			}
+			break;
+		case commandHash("list"):
+			if(strcmp(words[0], "list") == 0){
+				bool first = true;
+				for(uint8_t i = 0; i < bindingCount; i++){
+					if(kinds[i] != COMMAND_HANDLER){
+						if(!first){
+							Serial.print(' ');
+						}
+						Serial.print(names[i]);
+						first = false;
+					}
+				}
+				Serial.println();
+				return;
+			}
+			break;
+		#if CSF_CONTROLS_STATS
+		case commandHash("stats"):
+			if(strcmp(words[0], "stats") == 0){
+				if(argc == 0){
+					printStats();
+				}
+				else if(argc == 1 && strcmp(argv[0], "reset") == 0){
+					Utility::Stats::reset();
+					for(uint8_t i = 0; i < bindingCount; i++){
+						Utility::ControlStats* stats = statsOf(i);
+						if(stats != NULL){
+							*stats = Utility::ControlStats();
+						}
+					}
+					Serial.println("ok");
+				}
+				else{
+					reject(words[0]);
+				}
+				return;
+			}
+			break;
+		#endif
+	}
+
+	//a bound name or a command added with on()
+	for(uint8_t i = 0; i < bindingCount; i++){
+		if(hashes[i] == hash && strcmp(names[i], words[0]) == 0){
+			if(kinds[i] == COMMAND_HANDLER){
+				((CommandHandler)targets[i])(argc, argv);
+			}
+			else if(argc > 0 || !print(i)){
+				reject(words[0]);
+			}
+			return;
+		}
+	}
+	reject(words[0]);
+}//end execute()
+
+
+int CommandParser::find(const char* word){
+	char* end;
+	long number = strtol(word, &end, 10);
+	if(*word != 0 && *end == 0){
+		return (number >= 0 && number < bindingCount && kinds[number] != COMMAND_HANDLER) ? (int)number : -1;
+	}
+	uint16_t hash = commandHash(word);
+	for(uint8_t i = 0; i < bindingCount; i++){
+		if(kinds[i] != COMMAND_HANDLER && hashes[i] == hash && strcmp(names[i], word) == 0){
+			return i;
+		}
+	}
+	return -1;
+}//end find()
+
+
+bool CommandParser::print(uint8_t index){
+	if(kinds[index] == COMMAND_POT){
+		((Pot*)targets[index])->toSerial();
+	}
+	else if(kinds[index] == COMMAND_SENSOR){
+		((ControlUnit*)targets[index])->toSerial();
+	}
+	else if(kinds[index] == COMMAND_BUTTON){
+		((Button*)targets[index])->toSerial();
+	}
+	else{
+		return false;
+	}
+	return true;
+}//end print()
+
+
+void CommandParser::reject(const char* word){
+	errors++;
+	Serial.print("? ");
+	Serial.println(word);
+}//end reject()
+
+
+unsigned int CommandParser::getErrors(){
+	return errors;
+}//end getErrors()
+
+
+#if CSF_CONTROLS_STATS
+Utility::ControlStats* CommandParser::statsOf(uint8_t index){
+	if(kinds[index] == COMMAND_POT || kinds[index] == COMMAND_SENSOR){
+		return &((ControlUnit*)targets[index])->getStats();
+	}
+	else if(kinds[index] == COMMAND_BUTTON){
+		return &((Button*)targets[index])->getStats();
+	}
+	return NULL;
+}//end statsOf()
+
+
+void CommandParser::printStats(){
+	for(uint8_t i = 0; i < bindingCount; i++){
+		Utility::ControlStats* stats = statsOf(i);
+		if(stats != NULL){
+			Serial.print(names[i]);
+			Serial.print('=');
+			Serial.print(stats->reads);
+			Serial.print('/');
+			Serial.print(stats->suppressed);
+			Serial.print('/');
+			Serial.print(stats->toggles);
+			Serial.print('/');
+			Serial.print(stats->emitted);
+			Serial.print(' ');
+		}
+	}
+	Serial.print("loop=");
+	for(uint8_t bucket = 0; bucket < Utility::Stats::LOOP_BUCKETS; bucket++){
+		if(bucket > 0){
+			Serial.print(',');
+		}
+		Serial.print(Utility::Stats::getLoopBucket(bucket));
+	}
+	Serial.print(" loopmax=");
+	Serial.print(Utility::Stats::getMaxLoop());
+	Serial.print(" late=");
+	Serial.print(Utility::Stats::getMaxLate());
+	Serial.print(" press=");
+	Serial.println(Utility::Stats::getMaxLatency());
+}//end printStats()
+#endif
+
+
+
+
+
+
+// TraceCapture
+
+uint8_t TraceCapture::channelCount = 0;
+uint8_t TraceCapture::kinds[CSF_CAPTURE_CHANNELS];
+void* TraceCapture::channels[CSF_CAPTURE_CHANNELS];
+Utility::RingBuffer<TraceRow, CSF_CAPTURE_DEPTH> TraceCapture::rows;
+volatile unsigned long TraceCapture::samples = 0;
+volatile bool TraceCapture::running = false;
+bool TraceCapture::hooked = false;
+unsigned long TraceCapture::period = 0;
+unsigned long TraceCapture::nextDue = 0;
+unsigned long TraceCapture::nextIndex = 0;
+uint16_t TraceCapture::sequence = 0;
+TxQueue* TraceCapture::output = NULL;
+
+namespace{
+	static_assert(CSF_CAPTURE_CHANNELS <= TRACE_MAX_CHANNELS, "TraceCapture can't have more channels than a trace block carries");
+	static_assert(CSF_CAPTURE_BLOCK > 0 && CSF_CAPTURE_BLOCK <= 255, "a trace block holds 1 to 255 rows");
+}
+
+
+bool TraceCapture::add(Pot& pot){
+	if(channelCount >= CSF_CAPTURE_CHANNELS || running){
+		return false;
+	}
+	kinds[channelCount] = FRAME_KIND_SENSOR;
+	channels[channelCount] = &pot;
+	channelCount++;
+	return true;
+}//end add(Pot)
+
+
+bool TraceCapture::add(Button& button){
+	if(channelCount >= CSF_CAPTURE_CHANNELS || running){
+		return false;
+	}
+	kinds[channelCount] = FRAME_KIND_BUTTON;
+	channels[channelCount] = &button;
+	channelCount++;
+	return true;
+}//end add(Button)
+
+
+bool TraceCapture::begin(unsigned long periodMicros){
+	if(channelCount == 0 || periodMicros == 0){
+		return false;
+	}
+	if(hooked){
+		for(uint8_t i = 0; i < channelCount; i++){
+			if(kinds[i] == FRAME_KIND_SENSOR && ((Pot*)channels[i])->getSamplerChannel() < 0){
+				return false;	//the interrupt would sit in analogRead() for a whole conversion
+			}
+		}
+	}
+	end();
+	period = periodMicros;
+	#if defined(__AVR__) && defined(TIMER1_COMPA_vect)
+		const uint16_t prescales[] = {1, 8, 64, 256, 1024};
+		uint8_t select = 0;
+		unsigned long ticks = 0;
+		if(hooked){
+			unsigned long cycles = (F_CPU / 1000000UL) * periodMicros;
+			while(select < 5 && cycles / prescales[select] > 65536UL){
+				select++;
+			}
+			if(select == 5){
+				return false;
+			}
+			ticks = cycles / prescales[select];
+			period = ticks * prescales[select] / (F_CPU / 1000000UL);
+		}
+	#endif
+	rows.clear();
+	noInterrupts();
+	samples = 0;
+	interrupts();
+	nextIndex = 0;
+	sequence = 0;
+	nextDue = micros();
+	running = true;
+	#if defined(__AVR__) && defined(TIMER1_COMPA_vect)
+		if(hooked){
+			noInterrupts();
+			TCCR1A = 0;
+			TCCR1B = (1 << WGM12) | (select + 1);	//clear on compare match, CS1x picks the prescaler
+			TCNT1 = 0;
+			OCR1A = ticks - 1;
+			TIFR1 = (1 << OCF1A);
+			TIMSK1 |= (1 << OCIE1A);
+			interrupts();
+		}
+	#endif
+	return true;
+}//end begin()
+
+
+void TraceCapture::end(){
+	running = false;
+	#if defined(__AVR__) && defined(TIMER1_COMPA_vect)
+		if(hooked){
+			TIMSK1 &= ~(1 << OCIE1A);
+			TCCR1B = 0;
+		}
+	#endif
+}//end end()
+
+
+void TraceCapture::detachAll(){
+	end();
+	channelCount = 0;
+	rows.clear();
+}//end detachAll()
+
+
+bool TraceCapture::hookInterrupt(bool hook){
+	end();
+	hooked = hook;
+	return hooked;
+}//end hookInterrupt()
+
+
+void TraceCapture::service(){
+	if(hooked){
+		return;
+	}
+	unsigned long now = micros();
+	while(running && (long)(now - nextDue) >= 0){
+		onTick();
+		nextDue += period;
+	}
+}//end service()
+
+
+void TraceCapture::onTick(){
+	TraceRow row;
+	unsigned long sample = samples;
+	row.index = (uint16_t)sample;
+	for(uint8_t i = 0; i < channelCount; i++){
+		if(kinds[i] == FRAME_KIND_SENSOR){
+			row.values[i] = ((Pot*)channels[i])->getRawValue();
+		}
+		else{
+			Button* button = (Button*)channels[i];
+			row.values[i] = hooked ? button->getLastState() : button->getState();	//from the interrupt the debouncer is left to loop()
+		}
+	}
+	rows.push(row);	//a full ring turns the row away and counts it
+	samples = sample + 1;
+}//end onTick()
+
+
+size_t TraceCapture::buildBlock(uint8_t* payload, uint8_t& count){
+	payload[0] = TRACE_VERSION;
+	putU16(payload + 1, sequence);
+	putU32(payload + 3, period);
+	payload[11] = channelCount;
+	for(uint8_t i = 0; i < channelCount; i++){
+		payload[TRACE_HEADER_SIZE + i] = kinds[i];
+	}
+	uint8_t* write = payload + TRACE_HEADER_SIZE + channelCount;
+	int16_t previous[CSF_CAPTURE_CHANNELS];
+	for(uint8_t i = 0; i < channelCount; i++){
+		previous[i] = 0;
+	}
+	TraceRow row;
+	unsigned long first = 0;
+	count = 0;
+	while(count < CSF_CAPTURE_BLOCK && rows.peek(row)){
+		unsigned long index = nextIndex + (uint16_t)(row.index - (uint16_t)nextIndex);	//back to the full sample number
+		if(count == 0){
+			first = index;
+		}
+		else if(index != first + count){
+			break;	//rows were lost here, the next block starts after the gap
+		}
+		rows.pop(row);
+		for(uint8_t i = 0; i < channelCount; i++){
+			write += putVarint(write, zigzagEncode((int32_t)row.values[i] - previous[i]));
+			previous[i] = row.values[i];
+		}
+		nextIndex = index + 1;
+		count++;
+	}
+	putU32(payload + 7, first);
+	payload[12] = count;
+	size_t size = write - payload;
+	putU16(write, crc16(payload, size));
+	return size + FRAME_CRC_SIZE;
+}//end buildBlock()
+
+
+uint8_t TraceCapture::dump(){
+	if(rows.available() == 0){
+		return 0;
+	}
+	uint8_t payload[traceMaxPayloadSize(CSF_CAPTURE_CHANNELS, CSF_CAPTURE_BLOCK)];
+	uint8_t encoded[sizeof(payload) + sizeof(payload) / 254 + 2];
+	uint8_t count = 0;
+	size_t size = cobsEncode(payload, buildBlock(payload, count), encoded);
+	encoded[size++] = FRAME_DELIMITER;
+	if(output != NULL){
+		output->write(encoded, size);
+	}
+	else{
+		Serial.write(encoded, size);
+	}
+	sequence++;
+	return count;
+}//end dump()
+
+
+uint8_t TraceCapture::available(){
+	return rows.available();
+}//end available()
+
+
+uint16_t TraceCapture::getOverflows(){
+	noInterrupts();
+	uint16_t overflows = rows.getOverflows();
+	interrupts();
+	return overflows;
+}//end getOverflows()
+
+
+unsigned long TraceCapture::getSamples(){
+	noInterrupts();
+	unsigned long count = samples;
+	interrupts();
+	return count;
+}//end getSamples()
+
+
+unsigned long TraceCapture::getPeriod(){
+	return period;
+}//end getPeriod()
+
+
+bool TraceCapture::isRunning(){
+	return running;
+}//end isRunning()
+
+
+bool TraceCapture::isInterruptDriven(){
+	return running && hooked;
+}//end isInterruptDriven()
+
+
+void TraceCapture::setOutput(TxQueue& queue){
+	output = &queue;
+}//end setOutput()
+
@@ -1,373 +1,4718 @@
-
-
-/**
- * @mainpage CSF_Controls
- * @section description Summary
- * CSF_Controls is a C++ library designed to consolidate the coding for some common components in Arduino projects. At least things I have found get used in a lot of projects and often get connected and coded the same way over and over again. Such as potentiometers (with a power-indicator LED) for input sensors, or tactile-momentary-switches and capacitive-touch sensors which wire up differently but are used in essentially the same way --for me typically an On/Off button for both with code to prevent spamming the button.\n
- * While the library is currently pretty small, I do have a number of things in mind to include here, hence the need to organize the library into namespaces, for example there are other common ways that I set up Pots as output level control or adjusting input thresholds and I'd like to use the name Pot to indicate it goes with a potentiometer there too.\n
- * @section author Author
- * Developed By: Christopher S. Francis, 19 June 2020 to ...
- */
-
-
-#ifndef CSF_Controls_h
-#define CSF_Controls_h
-
-#include "Arduino.h"
-
-
-
-/**
- * The Sensors namespace is for circuits normally used as primary inputs to a project
- */
-namespace Sensors{
-
-
-	/**
-	 * @section description Description
-	 * ControlUnit is the parent class for sensor controls.\n
-	 * Each "Control" typically consists of a tactile-momentary-switch or capacitive touch-sensor for a power button, a power indicator LED, and a sensor to input the control data\n
-	 */
-	class ControlUnit{
-		public:
-			/**
-			 * The constructor for the sensor.\n
-			 * With only three arguments it sets the reuired time interval that must pass between registering button clicks to 250 milliseconds\n
-			 * @param but -the power button connected to the sensor
-			 * @param lin -the power line coming from the Arduino
-			 * @param sig -the Arduino pin the sensor signal will be sent to
-			 */
-			ControlUnit(int but, int lin, int sig);
-			
-			
-			
-			/**
-			 * The constructor for the sensor.\n
-			 * @param but -the power button connected to the sensor
-			 * @param lin -the power line coming from the Arduino
-			 * @param sig -the Arduino pin the sensor signal will be sent to
-			 * @param val -the required time interval that must pass between registering button clicks -in milliseconds
-			 */
-			ControlUnit(int but, int lin, int sig, int val);
-			
-			
-			
-			/**
-			 * Initializes all variables and assigns INPUT/OUTPUT to the connections on the scale controls, i.e. the pinMode\(i, m\) method for Arduino\n
-			 * Call this method in the setup\(\) method in the .ino file
-			 */
-			virtual void begin(void) = 0;
-			
-			
-			/**
-			 * Gets the current value of this control's sensor
-			 * 
-			 * @return int
-			 */
-			virtual int getSensorValue(void) = 0;
-			
-			
-			/**
-			 * Toggles the On/Off state of this control
-			 */
-			void toggleIsSensorOn(void);
-			
-			
-			/**
-			 * Getter for the On/Off state data of this control
-			 * @return bool
-			 */
-			bool getIsSensorOn(void);
-			
-			
-			/**
-			 * Activates the power to this control
-			 */
-			void activateControl(void);
-			
-			
-			/**
-			 * Deactivates the power to this control
-			 */
-			void deactivateControl(void);
-			
-			
-			/**
-			 * Called when ready to check if the Activation Button for this control is currently being pressed \(I chose not to put interupts in this library\)\n
-			 * Place in loop\(\) somewhere to determine if the power button for this control is currently being pressed
-			 */
-			void isButtonPressed(void);
-			
-			
-			/**
-			 * I often find my ideas for Arduino projects are input devices (essentially a customized keyboard or mouse override) for software running on my PC. This is typically handled with bits of code written in python making use of the libraries pyserial and pyautogui.\n
-			 * This method is encapsulates sending the sensor data to the serial port for that purpose.\n
-			 */
-			virtual void toSerial(void) = 0;
-		protected:
-			bool isSensorOn;			///<On/Off State of this control
-			int powerButton;		///<Power button for this control
-			int powerLine; 		///<Power Line for this control's sensor and power indicator LED
-			int sensorLine;		///<Input line feeding back from the sesnsor in this control
-			long interval;	///< The amount of time to wait between checking presses of buttons
-			long previousTime;	///< The unix epoch timestamp on last pass of the program's main loop
-	};
-
-
-
-
-	/**
-	 * The Pot class is for potentiometer input to an Arduino, I use it for both rotary and sliding potentiometers.\n
-	 * I also usually include a Power-Indicator-LED with each particular sensor, so the power-line variable actually activates a NPN transistor to supply the VCC voltage to both the LED and Potentiometer from the +5V or +3.3V rail.\n
-	 * The extra pin on there is a supplemental power In/Out to bypass the button and LED. For example a recent project I put together contained two pots wired up in this fashion, originally one sent values ranging from -5.12 to +5.12 to the computer and the other sent the range -3.14 to +3.14. By connecting their supplemental pins I was able to use the other as a strength control \(without the LED confusing which sensor was active\) so that the values sent to the computer could be refined from \(+-\)0.0512 to \(+-\)512.0 and \(+-\)0.0314 to \(+-\)314. 0, allowing for much finer or broader control with ease.
-	 * Here are the prototypes of the Rotary-Pot-Module and Slider-Pot-Module to go with classes in this library. The thought of smaller and smaller electronics is nice, but I like the size of these controls with my chubby-stubby-northern-european-ancestory fingers when mocking up ideas so the Pot-Module-R and Pot-Module-S Gerber files don't include components, just holes for them to go in and I plan to solder the full size components in myself, but might as well share those here too, if you want to update a copy of the gerber file most any factory wouldn't have any trouble stamping these common parts on there for you \(that may not be the case with the dual output slide pots I use, but everything else... definitely\).\n
-	 * <IMG src="../images/pot_circuit.PNG">
-	 * <IMG src="../images/tactile_button_circuit.PNG">\n
-	 * <IMG src="../images/Pot_Module-R.jpg" width="500">
-	 * <A href="../pcb/Gerber_Rotary Pot Module.zip"> Download Gerber Files for Pot-Module-R</A>\n\n
-	 * <IMG src="../images/Pot_Module-S.jpg" width="500">
-	 * <A href="../pcb/Gerber_Slider Pot Module.zip"> Download Gerber Files for Pot-Module-S</A>\n
-	 * @htmlonly
-	 * <iframe src="../pcb/pcb_rotary.html" width="900" height="700">
-	 * </iframe>
-	 <iframe src="../pcb/pcb_slider.html" width="900" height="700">
-	 * </iframe>
-	 * @endhtmlonly
-	 */
-	class Pot: public ControlUnit{
-		public:
-			/**
-			 * The constructor for the sensor.\n
-			 * @param but -the power button connected to the sensor
-			 * @param lin -the power line coming from the Arduino
-			 * @param sig -the Arduino pin the sensor signal will be sent to
-			 */
-			Pot(int but, int lin, int sig): ControlUnit(but, lin, sig){};
-			
-			
-			
-			/**
-			 * The constructor for the sensor.\n
-			 * @param but -the power button connected to the sensor
-			 * @param lin -the power line coming from the Arduino
-			 * @param sig -the Arduino pin the sensor signal will be sent to
-			 * @param val -the reuired time interval that must pass between registering button clicks -in milliseconds
-			 */
-			Pot(int but, int lin, int sig, int val): ControlUnit(but, lin, sig, val){};
-			
-			
-			void begin(void);
-			
-			
-			
-			int getSensorValue(void);
-			
-			
-			/**
-			 * Remaps the potentiometer data to the desired values. \n
-			 * 0 to 1024 is presumed here, as circuits grow more complicated and draw more current these values may change, expanding the range between min and max can adjust for such a drop in input.
-			 * @param min -the minimum value the potentiometer input should be mapped to
-			 * @param max -the maximum value the potentiometer input should be mapped to
-			 * @return float -to five decimal places
-			 */
-			float mapData(float min, float max);
-			
-			
-			
-			/**
-			 * Remaps the potentiometer data to the desired values. \n
-			 * 0 to 1024 is presumed here, as circuits grow more complicated and draw more current these values may change, expanding the range between min and max can adjust for such a drop in input.
-			 * @param min -the minimum value the potentiometer input should be mapped to
-			 * @param max -the maximum value the potentiometer input should be mapped to
-			 * @return int 
-			 */
-			int mapData(int min, int max);
-			
-			
-			
-			void toSerial(void);
-		protected:
-			int mappingMode; ///< If the mapData\(\) function has been called this will be track whether it should be an int or a float for toSerial\(\) with the same range.\n 0 is unmapped, 1 is int, 2 is float.
-			int minValueInt;	///< hold the mapped data from the sensor
-			int maxValueInt;	///< hold the mapped data from the sensor
-			float minValueFloat;	///< hold the mapped data from the sensor
-			float maxValueFloat;	///< hold the mapped data from the sensor
-	};
-
-
-}
-
-
-
-
-
-
-
-
-
-
-
-/**
- * The Switches namesapce is for activation/deactivation controls which typically require more than merely reading the level coming to an Arduino pin
- */
-namespace Switches{
-	
-	
-	/**
-	 * This is the parent object for tactile switches and touch sensors which will essentially be used as On/Off switches.\n
-	 * Essentially this just returns the On/Off state of the switch/sensor as an int \(1 when pressed, 0 otherwise\).
-	 */
-	class Button{
-		public:
-			/**
-			 * The constructor for ControlButton class
-			 * @param p -The Arduino pin the momentary-switch/touch-sensor is connected to
-			 */
-			Button(int p);
-			
-			
-			/**
-			 * Initializes all variables and assigns INPUT/OUTPUT to the connections on the scale controls, i.e. the pinMode\(i, m\) method for Arduino\n
-			 * Call this method in the setup\(\) method in the .ino file
-			 */
-			void begin(void);
-			
-			
-			
-			/**
-			 * gets the current state of the button 
-			 * @return int -a 1 if currently being pressed/touched, and 0 otherwise
-			 */
-			int getState();
-			
-			
-			
-			/**
-			 * gets the current state of the button 
-			 * @param condition -a boolean approving the activation of this button \(for example, I often combine features to a common potentiometer, and want to be certain that the other use of the sensor is not running before I turn this one on\). In most cases just pass in the word true though.
-			 * @return int -a 1 if currently being pressed/touched, and 0 otherwise
-			 */
-			int getState(bool condition);
-			
-			
-			/**
-			 * I often find my ideas for Arduino projects are input devices (essentially a customized keyboard or mouse override) for software running on my PC. This is typically handled with bits of code written in python making use of the libraries pyserial and pyautogui.\n
-			 * This method is encapsulates sending the data to the serial port for that purpose, in this case it sends a true/false value to represent whether the button is currently activated \(pressed or touched, etc.\) or not.\n
-			 * see getState\(\) about the overloading
-			 */
-			void toSerial(void);
-			
-			
-			/**
-			 * I often find my ideas for Arduino projects are input devices (essentially a customized keyboard or mouse override) for software running on my PC. This is typically handled with bits of code written in python making use of the libraries pyserial and pyautogui.\n
-			 * This method is encapsulates sending the data to the serial port for that purpose, in this case it sends a true/false value to represent whether the button is currently activated \(pressed or touched, etc.\) or not.\n
-			 * see getState\(\) about the overloading
-			 */
-			void toSerial(bool condition);
-		protected:
-			int pin;	///<The arduino pin the button/touch-sensor is connected to
-	};
-
-
-
-
-
-
-
-
-
-
-	/**
-	 * The subclass of Button specialized for Taactile-Momentary-Switches. If such a setup is used as a regular "Button" make sure to include a timer to avoid spamming the On/Off states at every pulse of the processor's clock.\n
-	 * <IMG src="../images/tactile_button_circuit.png">
-	 */
-	class Momentary: public Button{
-		public:
-			/**
-			 * The constructor for Momentary objects.
-			 * @param p -the Arduino pin the signal from the tactile-momentary-switch will be received on
-			 */
-			Momentary(int p): Button(p){};
-			
-			
-			/**
-			 * The constructor for Momentary objects.
-			 * @param p -the Arduino pin the signal from the tactile-momentary-switch will be received on
-			 * @param val -the time interval in milliseconds that must pass between reading the state of the button
-			 */
-			Momentary(int p, int val): Button(p){interval = val;};
-			
-			
-			
-			/**
-			 * Overrides getState\(\) from Button class with a timer to avoid spamming the tactile momentary switch and toggling the On/Off state with every pusle of the processor's clock the button is held down for.
-			 * @return int -a 1 if currently being pressed/touched, and 0 otherwise
-			 */
-			 int getState();
-			
-			
-			
-			/**
-			 * Overrides getState\(\) from Button class with a timer to avoid spamming the tactile momentary switch with every pusle of the processor's clock the button is held down for.
-			 * @param condition -a boolean approving the activation of this button \(for example, I often combine features to a common sensor when they won't overlap, and want to be certain that the other use of the sensor is not running before I turn this one on\). In most cases just pass in the word true though.
-			 * @return int -a 1 if currently being pressed/touched, and 0 otherwise
-			 */
-			 int getState(bool condition);
-			 
-			 
-	
-
-		protected:
-			int interval;	///< The amount of time to wait between checking presses of buttons
-			long previousTime;	///< The unix epoch timestamp on last pass of the program's main loop
-	};
-
-
-	/**
-	 * The subclass of Button specialized for Capacitive-Touch-Sensor-Modules. If such a setup is used as a regular "Button" make sure to include a timer to avoid spamming the On/Off states at every pulse of the processor's clock.\n
-	 * This is what I use this with the prebuilt capacitive touch sensor modules, and not a custom capacitive touch sensor
-	 */
-	class Touch: public Button{
-		public:
-			/**
-			 * The constructor for Touch objects.
-			 * @param p -the Arduino pin the signal from the capacitive-touch-sensor-module will be received on
-			 */
-			Touch(int p): Button(p){};
-			
-			
-			
-			/**
-			 * The constructor for Touch objects.
-			 * @param p -the Arduino pin the signal from the tactile-momentary-switch will be received on
-			 * @param val -the time interval in milliseconds that must pass between reading the state of the tuch sensor
-			 */
-			Touch(int p, int val): Button(p){interval = val;};
-			
-			
-			/**
-			 * Overrides getState\(\) from Button class with a timer to avoid spamming the touch sensor and toggling the On/Off state with every pusle of the processor's clock the button is held down for.
-			 * @return int -a 1 if currently being pressed/touched, and 0 otherwise
-			 */
-			 int getState();
-			
-			
-			
-			/**
-			 * Overrides getState\(\) from Button class with a timer to avoid spamming the tactile momentary switch with every pusle of the processor's clock the button is held down for.
-			 * @param condition -a boolean approving the activation of this button \(for example, I often combine features to a common sensor when they shouldn't overlap, and want to be certain that the other use of the sensor is not running before I turn this one on\). In most cases just pass in the word true though.
-			 * @return int -a 1 if currently being pressed/touched, and 0 otherwise
-			 */
-			 int getState(bool condition);
-
-		protected:
-			int interval;	///< The amount of time to wait between checking presses of buttons
-			long previousTime;	///< The unix epoch timestamp on last pass of the program's main loop
-	};
-
-	
-	
-	
-}
-
+
+
+/**
+ * @mainpage CSF_Controls
+ * @section description Summary
+ * CSF_Controls is a C++ library designed to consolidate the coding for some common components in Arduino projects. At least things I have found get used in a lot of projects and often get connected and coded the same way over and over again. Such as potentiometers (with a power-indicator LED) for input sensors, or tactile-momentary-switches and capacitive-touch sensors which wire up differently but are used in essentially the same way --for me typically an On/Off button for both with code to prevent spamming the button.\n
+ * While the library is currently pretty small, I do have a number of things in mind to include here, hence the need to organize the library into namespaces, for example there are other common ways that I set up Pots as output level control or adjusting input thresholds and I'd like to use the name Pot to indicate it goes with a potentiometer there too.\n
+ * @section author Author
+ * Developed By: Christopher S. Francis, 19 June 2020 to ...
+ */
+
+
+#ifndef CSF_Controls_h
+#define CSF_Controls_h
+
+#include "Arduino.h"
+#include "CSF_Protocol.h"
+
+
+#ifndef CSF_STREAM_CHANNELS
+#define CSF_STREAM_CHANNELS 16	///< The most controls one Comms::FrameStreamer will carry, each costs 3 bytes per frame and 4 bytes of RAM
+#endif
+
+#ifndef CSF_MANAGER_CONTROLS
+#define CSF_MANAGER_CONTROLS 24	///< The most controls and tasks one Scheduling::ControlManager will run, each costs 16 bytes of RAM
+#endif
+
+#ifndef CSF_DEBOUNCE_HOLDOFF
+#define CSF_DEBOUNCE_HOLDOFF 20	///< Milliseconds Utility::Debouncer and Sensors::ControlBank leave a switch to settle after each change
+#endif
+
+#ifndef CSF_DEBOUNCE_CONFIRM
+#define CSF_DEBOUNCE_CONFIRM 0	///< Milliseconds a new level has to hold before Utility::Debouncer takes it, up to 255, 0 to take it on the first edge
+#endif
+
+#ifndef CSF_BANK_PORTS
+#define CSF_BANK_PORTS 3	///< The most GPIO ports one Switches::ButtonBank reads, 8 buttons each, up to 4
+#endif
+
+#ifndef CSF_EVENT_PINS
+#define CSF_EVENT_PINS 4	///< The most pins Switches::EventCapture attaches interrupts to, up to 8
+#endif
+
+#ifndef CSF_EVENT_QUEUE
+#define CSF_EVENT_QUEUE 16	///< Slots in Switches::EventCapture's queue, a power of two, 6 bytes each, it holds one edge less than this between drains
+#endif
+
+#ifndef CSF_MATRIX_ROWS
+#define CSF_MATRIX_ROWS 8	///< The most rows in one Switches::KeyMatrix, each costs 7 bytes of RAM
+#endif
+
+#ifndef CSF_MATRIX_COLUMNS
+#define CSF_MATRIX_COLUMNS 16	///< The most columns in one Switches::KeyMatrix, up to 16
+#endif
+
+#ifndef CSF_MATRIX_QUEUE
+#define CSF_MATRIX_QUEUE 16	///< Key events one Switches::KeyMatrix can hold between drains, a power of two, 6 bytes each on AVR
+#endif
+
+#ifndef CSF_FILTER_STAGES
+#define CSF_FILTER_STAGES 3	///< The most stages in one Sensors::FilterChain, each costs 14 bytes of RAM on AVR
+#endif
+
+#ifndef CSF_CALIBRATION_POINTS
+#define CSF_CALIBRATION_POINTS 9	///< The most points one Sensors::Calibration captures, each costs 2 bytes of RAM and 2 of EEPROM
+#endif
+
+#ifndef CSF_SAMPLER_CHANNELS
+#define CSF_SAMPLER_CHANNELS 8	///< The most Pots the Sensors::Sampler will cycle through
+#endif
+
+#ifndef CSF_SAMPLER_DEPTH
+#define CSF_SAMPLER_DEPTH 4	///< Readings kept per Sensors::Sampler channel, must be a power of two
+#endif
+
+#ifndef CSF_EXPANDERS
+#define CSF_EXPANDERS 4	///< The most Expansion::Expander chips attached to Expansion::VirtualPins
+#endif
+
+#ifndef CSF_CAPSENSE_CHANNELS
+#define CSF_CAPSENSE_CHANNELS 8	///< The most electrodes one Expansion::CapSense measures, up to 16
+#endif
+
+#ifndef CSF_VIRTUAL_PIN_BASE
+#define CSF_VIRTUAL_PIN_BASE 128	///< The first pin number Expansion::VirtualPins gives out, above every real pin on the boards the library runs on
+#endif
+
+#ifndef CSF_CAPTURE_CHANNELS
+#define CSF_CAPTURE_CHANNELS 4	///< The most controls Comms::TraceCapture samples, up to TRACE_MAX_CHANNELS
+#endif
+
+#ifndef CSF_CAPTURE_DEPTH
+#define CSF_CAPTURE_DEPTH 32	///< Rows Comms::TraceCapture holds between dumps, a power of two up to 128, each costs 2 bytes plus 2 per channel
+#endif
+
+#ifndef CSF_CAPTURE_BLOCK
+#define CSF_CAPTURE_BLOCK 8	///< The most rows in one block Comms::TraceCapture sends, the block is built on the stack in dump\(\)
+#endif
+
+#ifndef CSF_TX_BUFFER
+#define CSF_TX_BUFFER 128	///< Bytes one Comms::TxQueue holds for the serial port, a power of two up to 128, one byte is always left empty
+#endif
+
+#ifndef CSF_TX_CHANNELS
+#define CSF_TX_CHANNELS 8	///< The most channels in one Comms::TxQueue, up to 255, a line too long for CSF_TX_BUFFER goes out in parts
+#endif
+
+#ifndef CSF_COMMAND_LENGTH
+#define CSF_COMMAND_LENGTH 32	///< The longest line a Comms::CommandParser takes
+#endif
+
+#ifndef CSF_COMMAND_BINDINGS
+#define CSF_COMMAND_BINDINGS 8	///< The most names one Comms::CommandParser knows, controls and commands together, each costs 7 bytes of RAM on AVR
+#endif
+
+#ifndef CSF_CONTROLS_STATS
+#define CSF_CONTROLS_STATS 0	///< 1 to count reads, polls and reports for Utility::Stats and the stats command, each control then costs 14 more bytes of RAM. At 0 all of it compiles away
+#endif
+
+
+
+/**
+ * Stops the compiler moving memory reads and writes across this point, so a value is stored before the index that publishes it
+ */
+#define CSF_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+
+
+/**
+ * Reads a port's input register inside Expansion::CapSense's timed loop, a core or simulator that needs something other than a plain read can define it first
+ */
+#ifndef CSF_PORT_READ
+#define CSF_PORT_READ(reg) (*(reg))
+#endif
+
+
+
+/**
+ * Keeps a statement only when CSF_CONTROLS_STATS is on, e.g. CSF_STAT\(Utility::Stats::markLoop\(\)\); at the top of loop\(\)
+ */
+#if CSF_CONTROLS_STATS
+#define CSF_STAT(statement) statement
+#else
+#define CSF_STAT(statement)
+#endif
+
+
+
+/**
+ * Installs the ADC interrupt for Sensors::Sampler, written once at the top level of the sketch. The library leaves the vector alone otherwise so another library can have it, and the Sampler is then served from loop\(\) with Sampler::service\(\). It's empty on boards without the AVR ADC interrupt
+ */
+#if defined(__AVR__) && defined(ADC_vect)
+#define CSF_SAMPLER_ISR() ISR(ADC_vect){ Sensors::Sampler::onConversion(ADC); } static const bool csfSamplerHooked = Sensors::Sampler::hookInterrupt();
+#else
+#define CSF_SAMPLER_ISR()
+#endif
+
+
+/**
+ * Installs the Timer1 compare interrupt for Comms::TraceCapture, written once at the top level of the sketch. The library leaves Timer1 alone otherwise so the Servo library or PWM on pins 9 and 10 can have it, and the capture is then taken from loop\(\) with TraceCapture::service\(\). It's empty on boards without the AVR Timer1
+ */
+#if defined(__AVR__) && defined(TIMER1_COMPA_vect)
+#define CSF_TRACE_ISR() ISR(TIMER1_COMPA_vect){ Comms::TraceCapture::onTick(); } static const bool csfTraceHooked = Comms::TraceCapture::hookInterrupt();
+#else
+#define CSF_TRACE_ISR()
+#endif
+
+
+
+/**
+ * The Utility namespace is for the small building blocks the controls share, rather than controls themselves
+ */
+namespace Utility{
+
+
+	/**
+	 * A fixed size first-in-first-out queue for one writer and one reader, e.g. an interrupt pushing and loop\(\) popping, without turning interrupts off.\n
+	 * The writer only moves head and the reader only moves tail, each a single byte, so neither can catch the other half way through. When it's full new values are turned away and counted rather than overwriting ones not yet read.
+	 * @tparam T -the type of value stored
+	 * @tparam N -the number of slots, a power of two up to 128, one slot is always left empty
+	 */
+	template<typename T, uint8_t N>
+	class RingBuffer{
+		static_assert(N > 1 && N <= 128 && (N & (N - 1)) == 0, "RingBuffer size must be a power of two up to 128");
+		public:
+			/**
+			 * The constructor for RingBuffer, it starts out empty
+			 */
+			RingBuffer(void): head(0), tail(0), overflows(0){};
+
+
+			/**
+			 * Adds a value to the back of the queue, only call this from the writer
+			 * @param value -the value
+			 * @return bool -false if the queue was full and the value was dropped
+			 */
+			bool push(const T& value){
+				uint8_t index = head;
+				uint8_t next = (index + 1) & (N - 1);
+				if(next == tail){
+					overflows++;
+					return false;
+				}
+				data[index] = value;
+				CSF_BARRIER();
+				head = next;
+				return true;
+			};
+
+
+			/**
+			 * Takes the value off the front of the queue, only call this from the reader
+			 * @param value -filled in with the value
+			 * @return bool -false if the queue was empty
+			 */
+			bool pop(T& value){
+				uint8_t index = tail;
+				if(index == head){
+					return false;
+				}
+				value = data[index];
+				CSF_BARRIER();
+				tail = (index + 1) & (N - 1);
+				return true;
+			};
+
+
+			/**
+			 * Looks at the value on the front of the queue without taking it, only call this from the reader
+			 * @param value -filled in with the value
+			 * @return bool -false if the queue was empty
+			 */
+			bool peek(T& value) const{
+				uint8_t index = tail;
+				if(index == head){
+					return false;
+				}
+				value = data[index];
+				return true;
+			};
+
+
+			/**
+			 * Gets the number of values waiting
+			 * @return uint8_t
+			 */
+			uint8_t available(void) const{
+				return (head - tail) & (N - 1);
+			};
+
+
+			/**
+			 * Gets the number of values dropped because the queue was full, it wraps around
+			 * @return uint16_t
+			 */
+			uint16_t getOverflows(void) const{
+				return overflows;
+			};
+
+
+			/**
+			 * Throws away everything waiting, only call this from the reader
+			 */
+			void clear(void){
+				tail = head;
+			};
+		protected:
+			T data[N];	///< The slots
+			volatile uint8_t head;	///< Where the writer puts the next value
+			volatile uint8_t tail;	///< Where the reader takes the next value from
+			volatile uint16_t overflows;	///< Values dropped when full
+	};
+
+
+
+
+	/**
+	 * A fixed size ring of the most recent values written to it, where the newest value overwrites the oldest.
+
+	 * It is safe with one writer in an interrupt and one reader in loop\(\) without turning interrupts off: the value is stored before the head index \(a single byte\) moves to it, so the reader always sees a complete value.
+	 * @tparam T -the type of value stored
+	 * @tparam N -how many values are kept, a power of two
+	 */
+	template<typename T, uint8_t N>
+	class HistoryBuffer{
+		static_assert(N > 0 && (N & (N - 1)) == 0, "HistoryBuffer size must be a power of two");
+		public:
+			/**
+			 * The constructor for HistoryBuffer, it starts out empty
+			 */
+			HistoryBuffer(void): head(0), count(0){};
+
+
+			/**
+			 * Writes a new value over the oldest one
+			 * @param value -the value
+			 */
+			void put(T value){
+				uint8_t next = (head + 1) & (N - 1);
+				data[next] = value;
+				head = next;
+				if(count < N){
+					count++;
+				}
+			};
+
+
+			/**
+			 * Gets the newest value
+			 * @return T -the newest value, or whatever the buffer started with if nothing was written yet
+			 */
+			T latest(void) const{
+				return data[head];
+			};
+
+
+			/**
+			 * Copies out the most recent values, newest first
+			 * @param out -room for n values
+			 * @param n -the most values to copy
+			 * @return uint8_t -how many were copied
+			 */
+			uint8_t recent(T* out, uint8_t n) const{
+				uint8_t index = head;
+				uint8_t available = count;
+				if(n > available){
+					n = available;
+				}
+				for(uint8_t i = 0; i < n; i++){
+					out[i] = data[(index - i) & (N - 1)];
+				}
+				return n;
+			};
+
+
+			/**
+			 * Gets the number of values written so far, up to N
+			 * @return uint8_t
+			 */
+			uint8_t size(void) const{
+				return count;
+			};
+
+
+			/**
+			 * Empties the buffer
+			 */
+			void clear(void){
+				count = 0;
+				head = 0;
+				data[0] = T();
+			};
+		protected:
+			volatile T data[N];	///< The values
+			volatile uint8_t head;	///< Index of the newest value
+			volatile uint8_t count;	///< How many of the values have been written
+	};
+
+
+
+
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168__) || defined(__AVR_ATmega168P__)
+	#define CSF_FASTPIN_REGISTERS 1	///< Set when FastPin knows this board's port layout and skips digitalRead\(\)/digitalWrite\(\)
+	#define CSF_FASTPIN_MAX 20	///< FastPin pins must be below this
+
+
+	/**
+	 * The port a pin is on for the ATmega328P/168 \(Uno, Nano, Pro Mini\): D for 0-7, B for 8-13, C for A0-A5
+	 * @param pin -the Arduino pin
+	 * @return char
+	 */
+	constexpr char fastPortOf(uint8_t pin){
+		return pin < 8 ? 'D' : (pin < 14 ? 'B' : 'C');
+	}//end fastPortOf()
+
+
+	/**
+	 * The bit a pin is on within its port for the ATmega328P/168
+	 * @param pin -the Arduino pin
+	 * @return uint8_t
+	 */
+	constexpr uint8_t fastMaskOf(uint8_t pin){
+		return (uint8_t)(1 << (pin < 8 ? pin : (pin < 14 ? pin - 8 : pin - 14)));
+	}//end fastMaskOf()
+
+
+	/**
+	 * The input, output and direction registers of one port, picked at compile time
+	 * @tparam Port -the port letter
+	 */
+	template<char Port> struct FastPort;
+
+	template<> struct FastPort<'B'>{
+		static volatile uint8_t& in(void){ return PINB; };
+		static volatile uint8_t& out(void){ return PORTB; };
+		static volatile uint8_t& mode(void){ return DDRB; };
+	};
+
+	template<> struct FastPort<'C'>{
+		static volatile uint8_t& in(void){ return PINC; };
+		static volatile uint8_t& out(void){ return PORTC; };
+		static volatile uint8_t& mode(void){ return DDRC; };
+	};
+
+	template<> struct FastPort<'D'>{
+		static volatile uint8_t& in(void){ return PIND; };
+		static volatile uint8_t& out(void){ return PORTD; };
+		static volatile uint8_t& mode(void){ return DDRD; };
+	};
+#elif defined(SIM_PORTS)
+	#define CSF_FASTPIN_REGISTERS 1
+	#define CSF_FASTPIN_MAX NUM_DIGITAL_PINS
+
+
+	/**
+	 * The port a pin is on for the simulated board in host/sim, 8 pins to a port starting at port 1
+	 * @param pin -the Arduino pin
+	 * @return char
+	 */
+	constexpr char fastPortOf(uint8_t pin){
+		return (char)(pin / 8 + 1);
+	}//end fastPortOf()
+
+
+	/**
+	 * The bit a pin is on within its port for the simulated board
+	 * @param pin -the Arduino pin
+	 * @return uint8_t
+	 */
+	constexpr uint8_t fastMaskOf(uint8_t pin){
+		return (uint8_t)(1 << (pin % 8));
+	}//end fastMaskOf()
+
+
+	/**
+	 * The simulated board's port registers, so FastPin takes the same register path it would on an Uno
+	 * @tparam Port -the port number
+	 */
+	template<char Port> struct FastPort{
+		static volatile uint8_t& in(void){ return Sim::portInput[(uint8_t)Port]; };
+		static volatile uint8_t& out(void){ return Sim::portOutput[(uint8_t)Port]; };
+		static volatile uint8_t& mode(void){ return Sim::portMode[(uint8_t)Port]; };
+	};
+#endif
+
+
+
+
+	/**
+	 * FastPin is digitalRead\(\)/digitalWrite\(\) with the pin fixed at compile time, e.g. FastPin<2>::read\(\).\n
+	 * digitalRead\(\) looks the pin's port and bit up in tables on every call, a few microseconds on an AVR. Here the port, bit and direction register are worked out by the compiler so a read or write comes down to a single instruction on the register.\n
+	 * That needs the board's port layout, which is only filled in for the ATmega328P/168 \(Uno, Nano, Pro Mini\) and the simulated board in host/sim so far, see CSF_FASTPIN_REGISTERS. On every other board it falls back to digitalRead\(\)/digitalWrite\(\), so sketches still work, just without the speed up.
+	 * @tparam N -the Arduino pin
+	 */
+	template<uint8_t N>
+	class FastPin{
+		public:
+			/**
+			 * Sets the pin as an input, as pinMode\(N, INPUT\)
+			 */
+			static void input(void){
+				#if defined(CSF_FASTPIN_REGISTERS)
+					static_assert(N < CSF_FASTPIN_MAX, "FastPin doesn't know this pin on this board");
+					FastPort<fastPortOf(N)>::mode() &= ~fastMaskOf(N);
+					FastPort<fastPortOf(N)>::out() &= ~fastMaskOf(N);
+				#else
+					pinMode(N, INPUT);
+				#endif
+			};
+
+
+			/**
+			 * Sets the pin as an output, as pinMode\(N, OUTPUT\)
+			 */
+			static void output(void){
+				#if defined(CSF_FASTPIN_REGISTERS)
+					FastPort<fastPortOf(N)>::mode() |= fastMaskOf(N);
+				#else
+					pinMode(N, OUTPUT);
+				#endif
+			};
+
+
+			/**
+			 * Reads the pin, as digitalRead\(N\)
+			 * @return bool -true when HIGH
+			 */
+			static bool read(void){
+				#if defined(CSF_FASTPIN_REGISTERS)
+					return (FastPort<fastPortOf(N)>::in() & fastMaskOf(N)) != 0;
+				#else
+					return digitalRead(N) == HIGH;
+				#endif
+			};
+
+
+			/**
+			 * Drives the pin HIGH, as digitalWrite\(N, HIGH\)
+			 */
+			static void high(void){
+				#if defined(CSF_FASTPIN_REGISTERS)
+					FastPort<fastPortOf(N)>::out() |= fastMaskOf(N);
+				#else
+					digitalWrite(N, HIGH);
+				#endif
+			};
+
+
+			/**
+			 * Drives the pin LOW, as digitalWrite\(N, LOW\)
+			 */
+			static void low(void){
+				#if defined(CSF_FASTPIN_REGISTERS)
+					FastPort<fastPortOf(N)>::out() &= ~fastMaskOf(N);
+				#else
+					digitalWrite(N, LOW);
+				#endif
+			};
+
+
+			/**
+			 * Drives the pin, as digitalWrite\(N, level\)
+			 * @param level -true for HIGH
+			 */
+			static void write(bool level){
+				if(level){
+					high();
+				}
+				else{
+					low();
+				}
+			};
+	};
+
+
+
+
+	/**
+	 * ChangeTracker decides when a value is worth sending, for report-by-exception: only when it has moved by the deadband or more, when its on/off flag flips, or when the heartbeat interval has passed without anything being sent.\n
+	 * Each send gets the next sequence number \(wrapping at 255\), so the receiver can tell from a gap that a line went missing and the heartbeat gives it a fresh value to resync from.
+	 */
+	class ChangeTracker{
+		public:
+			/**
+			 * The constructor for ChangeTracker, any change at all counts and there's a heartbeat every second
+			 */
+			ChangeTracker(void);
+
+
+			/**
+			 * Sets what counts as a change
+			 * @param deadband -how far the value has to move, 1 for any change
+			 * @param heartbeat -milliseconds after which the value is sent even if it hasn't changed, 0 for never
+			 */
+			void configure(int deadband, unsigned int heartbeat);
+
+
+			/**
+			 * Decides whether to send a value, and if so takes it as the new value to measure changes from
+			 * @param value -the current value
+			 * @param flag -the current on/off state, any flip counts as a change
+			 * @param now -the current millis\(\)
+			 * @return bool -true if the value should be sent
+			 */
+			bool check(int value, bool flag, unsigned long now);
+
+
+			/**
+			 * Forgets the last value, so the next check\(\) always sends
+			 */
+			void reset(void);
+
+
+			/**
+			 * Getter for the sequence number of the last send
+			 * @return uint8_t
+			 */
+			uint8_t getSequence(void);
+		protected:
+			int lastValue;	///< The value last sent
+			int deadband;	///< How far the value has to move to be sent
+			unsigned int heartbeat;	///< Milliseconds between sends when nothing changes, 0 for never
+			unsigned long lastTime;	///< When the value was last sent
+			uint8_t sequence;	///< Sequence number of the last send
+			bool lastFlag;	///< The on/off state last sent
+			bool primed;	///< Set once something has been sent
+	};
+
+
+
+
+	/**
+	 * RateController picks how often a control is sampled from how much it's moving: quickly while it's being used, slowly while it's left alone.\n
+	 * Each sample goes through update\(\), and a reading that has moved by the threshold from the last one that did, or an on/off flip, counts as activity and drops the interval straight to the fast one. Once nothing has happened for the quiet time the interval doubles each sample until it's back at the idle one, so a knob being turned is followed closely and one left alone costs a read now and then.\n
+	 * The first movement is only seen at the next idle sample, so the idle interval is the longest it can take a control to wake up, wake\(\) brings it forward for activity seen some other way, e.g. an edge from Switches::EventCapture. Scheduling::ControlManager uses it to schedule controls added with one, and it keeps the time of the control's last report for the ControlManager to share out the serial port.\n
+	 * Times are in milliseconds.
+	 */
+	class RateController{
+		public:
+			/**
+			 * The constructor for RateController, 10 milliseconds while moving, 100 when idle, idle after a second of quiet, and a move of 3 counts is activity
+			 */
+			RateController(void);
+
+
+			/**
+			 * Sets the rates
+			 * @param fast -milliseconds between samples while the control is active
+			 * @param idle -milliseconds between samples once it has gone quiet
+			 * @param quiet -milliseconds without activity before it starts slowing down
+			 * @param threshold -how far a reading has to move to count as activity, 1 for any change, it should be over the reading's noise
+			 */
+			void configure(unsigned int fast, unsigned int idle, unsigned int quiet, int threshold);
+
+
+			/**
+			 * Takes a sample and works out when the next one is due
+			 * @param value -the reading
+			 * @param flag -the control's on/off state, or a button's state, any flip counts as activity
+			 * @param now -the current millis\(\)
+			 * @return unsigned int -milliseconds until the next sample
+			 */
+			unsigned int update(int value, bool flag, unsigned long now);
+
+
+			/**
+			 * Counts as activity without a sample, the next interval is the fast one
+			 * @param now -the current millis\(\)
+			 */
+			void wake(unsigned long now);
+
+
+			/**
+			 * Getter for whether there's been activity within the quiet time
+			 * @return bool
+			 */
+			bool isActive(void);
+
+
+			/**
+			 * Getter for the interval update\(\) last gave
+			 * @return unsigned int -in milliseconds
+			 */
+			unsigned int getInterval(void);
+
+
+			/**
+			 * Gets how long until the control may report again, given how far apart its reports have to be
+			 * @param now -the current millis\(\)
+			 * @param spacing -milliseconds between reports
+			 * @return unsigned int -milliseconds to wait, 0 if it may report now
+			 */
+			unsigned int getReportWait(unsigned long now, unsigned int spacing);
+
+
+			/**
+			 * Notes that the control has just reported, for getReportWait\(\)
+			 * @param now -the current millis\(\)
+			 */
+			void markReport(unsigned long now);
+		protected:
+			int reference;	///< The reading the last activity was measured at
+			int threshold;	///< How far a reading has to move to count
+			unsigned int fast;	///< Milliseconds between samples while active
+			unsigned int idle;	///< Milliseconds between samples when idle
+			unsigned int quiet;	///< Milliseconds without activity before slowing down
+			unsigned int interval;	///< The interval last given
+			unsigned long lastActivity;	///< When there was last activity
+			unsigned long lastReport;	///< When the control last reported
+			bool lastFlag;	///< The on/off state of the last sample
+			bool primed;	///< Set once a sample has been taken
+			bool active;	///< Set while within the quiet time of some activity
+			bool reported;	///< Set once the control has reported
+	};
+
+
+
+
+	/**
+	 * The Debouncer turns the raw level of a switch into a clean state, and into the events a sketch usually wants from a button.\n
+	 * It locks on the first edge: the moment the level changes the new state is taken and reported, so debouncing adds nothing to how quickly a press is seen. Every change for the hold-off time after that is treated as contact bounce and ignored, and if the level has settled the other way once the hold-off is over that's taken as the next change.\n
+	 * On a noisy line setConfirm\(\) turns on a glitch filter: a change is then only taken if the new level still holds at the confirm time after it was first seen, at the first update\(\) from then on, so a spike of noise shorter than that is rejected as a bounce rather than registering as a press. The price is that every press and release is seen the confirm time late, or later if update\(\) is called less often than that. CSF_DEBOUNCE_CONFIRM sets it for every Debouncer, it's 0, off, unless the sketch defines it.\n
+	 * The lockout is kept apart from the hold-off: it's the least time from one press to the next, so a button can be kept from being pressed again too soon without holding back its release. A press inside the lockout is taken when it's over if the button is still held, and dropped if it isn't.\n
+	 * update\(\) returns the events as bits and several can come at once, e.g. RELEASED | CLICKED:\n
+	 * - PRESSED, RELEASED: the state changed\n
+	 * - CLICKED: released before the click time was up, and not after a LONG_PRESSED\n
+	 * - DOUBLE_CLICKED: a click pressed within the double-click gap of the last click's release, it comes along with that click's CLICKED\n
+	 * - LONG_PRESSED: held for the long-press time, once per press while it's still held\n
+	 * - BOUNCED: a change was ignored, inside the hold-off or the lockout, or gone again by the confirm time\n
+	 * It doesn't read anything itself, so it works the same on a pin, a virtual pin, or a key from a bank or matrix. Times are in milliseconds.
+	 */
+	class Debouncer{
+		public:
+			static const uint8_t PRESSED = 0x01;
+			static const uint8_t RELEASED = 0x02;
+			static const uint8_t CLICKED = 0x04;
+			static const uint8_t DOUBLE_CLICKED = 0x08;
+			static const uint8_t LONG_PRESSED = 0x10;
+			static const uint8_t BOUNCED = 0x20;
+
+
+			/**
+			 * The constructor for Debouncer: released, CSF_DEBOUNCE_HOLDOFF hold-off and CSF_DEBOUNCE_CONFIRM confirm time, no lockout, clicks up to 400 milliseconds with 300 between a double click, and a long press at 800
+			 */
+			Debouncer(void);
+
+
+			/**
+			 * Takes the next reading of the switch
+			 * @param level -what was read, anything but 0 for pressed
+			 * @param now -the current millis\(\)
+			 * @return uint8_t -the events, see the class description, 0 for none
+			 */
+			uint8_t update(int level, unsigned long now);
+
+
+			/**
+			 * Getter for the debounced state
+			 * @return int -1 while pressed, 0 otherwise
+			 */
+			int getState(void);
+
+
+			/**
+			 * Sets how long after a change the switch is left to settle
+			 * @param ms -the hold-off, around 5 to 20 for most switches
+			 */
+			void setHoldOff(unsigned int ms);
+
+
+			/**
+			 * Sets how long a new level has to hold before it's taken
+			 * @param ms -the confirm time, a few milliseconds more than the longest spike of noise, up to 255, 0 to take a change the moment it's seen
+			 */
+			void setConfirm(unsigned int ms);
+
+
+			/**
+			 * Sets the least time from one press to the next, a press sooner than that waits until the lockout is over
+			 * @param ms -the lockout, 0 for none
+			 */
+			void setLockout(unsigned int ms);
+
+
+			/**
+			 * Sets what counts as a click
+			 * @param maxPress -the longest a press can last and still be a click
+			 * @param gap -the longest from one click's release to the next press for a double click, 0 for no double clicks
+			 */
+			void setClick(unsigned int maxPress, unsigned int gap);
+
+
+			/**
+			 * Sets how long a press has to be held to be a long press
+			 * @param ms -the time, 0 for no long presses
+			 */
+			void setLongPress(unsigned int ms);
+		protected:
+			static const uint8_t FLAG_STATE = 0x01;	///< The debounced state
+			static const uint8_t FLAG_RAW = 0x02;	///< The level last read
+			static const uint8_t FLAG_LONG = 0x04;	///< LONG_PRESSED has gone out for this press
+			static const uint8_t FLAG_ARMED = 0x08;	///< The last release was a click, so the next press may make a double
+			static const uint8_t FLAG_DOUBLE = 0x10;	///< This press came quickly enough to be the second of a double
+			static const uint8_t FLAG_PENDING = 0x20;	///< A change was seen and is waiting on the confirm time
+
+			unsigned long lastChange;	///< When the state last changed
+			unsigned long lastPress;	///< When the last press was taken
+			uint16_t holdOff;	///< Milliseconds to ignore changes after one is taken
+			uint16_t lockout;	///< The least milliseconds from one press to the next, 0 for none
+			uint16_t seenAt;	///< The low 16 bits of millis\(\) when the pending change was seen
+			uint8_t confirmTime;	///< Milliseconds a change has to hold before it's taken
+			uint16_t clickTime;	///< The longest press that's a click
+			uint16_t doubleGap;	///< The longest gap that makes a double click
+			uint16_t longTime;	///< How long a long press is, 0 for never
+			uint8_t flags;	///< FLAG_ bits
+	};
+
+
+
+
+	#if CSF_CONTROLS_STATS
+	/**
+	 * The counters each control keeps when CSF_CONTROLS_STATS is on, read them with getStats\(\) or the stats command.\n
+	 * The counts are 16 bits and wrap around, take the difference between two readings rather than the totals.
+	 */
+	struct ControlStats{
+		/**
+		 * The constructor for ControlStats, everything starts at 0
+		 */
+		ControlStats(void);
+
+
+		/**
+		 * Counts a read of a button, and a toggle if it changed since the last one
+		 * @param state -what was read, nonzero for pressed
+		 */
+		void sample(int state);
+
+
+		/**
+		 * Counts a toggle, starting the press-to-report clock if it isn't already running
+		 */
+		void toggle(void);
+
+
+		/**
+		 * Counts a value sent to the computer, and if a toggle is waiting to be reported hands its latency to Stats
+		 */
+		void emit(void);
+
+		uint16_t reads;	///< Times the sensor or button was read
+		uint16_t suppressed;	///< Changes ignored as contact bounce or noise by the debouncer
+		uint16_t toggles;	///< Times it was switched on or off, or the button changed
+		uint16_t emitted;	///< Values sent to the computer
+		unsigned long pressedAt;	///< micros\(\) when the toggle not yet reported happened
+		bool waiting;	///< Set while a toggle hasn't been reported
+		uint8_t level;	///< The button state last read, for telling toggles apart from reads
+	};
+
+
+
+
+	/**
+	 * Stats is the library-wide half of the instrumentation CSF_CONTROLS_STATS turns on, the part that isn't about any one control:\n
+	 * - a histogram of the time between loop\(\) passes, bucket n counting passes of 2^n to 2^\(n+1\) microseconds, so bucket 10 is about a millisecond and the last one takes everything slower\n
+	 * - the longest pass\n
+	 * - the furthest behind schedule a poll has run, in milliseconds\n
+	 * - the longest time from a toggle being read to its control's value being sent, in microseconds\n
+	 * Scheduling::ControlManager::tick\(\) calls markLoop\(\) itself, a sketch that doesn't use one calls it at the top of loop\(\). Everything is static since there's only the one loop\(\).
+	 */
+	class Stats{
+		public:
+			static const uint8_t LOOP_BUCKETS = 16;	///< Buckets in the loop histogram
+
+
+			/**
+			 * Marks the start of a pass of loop\(\), adding the time since the last mark to the histogram
+			 */
+			static void markLoop(void);
+
+
+			/**
+			 * Records how far behind schedule a poll ran
+			 * @param ms -milliseconds after it was due
+			 */
+			static void noteLate(unsigned long ms);
+
+
+			/**
+			 * Records the time from a toggle to its value being sent
+			 * @param us -microseconds
+			 */
+			static void noteLatency(unsigned long us);
+
+
+			/**
+			 * Getter for one bucket of the loop histogram, they stop counting at 65535
+			 * @param bucket -0 to LOOP_BUCKETS - 1
+			 * @return uint16_t
+			 */
+			static uint16_t getLoopBucket(uint8_t bucket);
+
+
+			/**
+			 * Getter for the longest pass of loop\(\)
+			 * @return unsigned long -microseconds
+			 */
+			static unsigned long getMaxLoop(void);
+
+
+			/**
+			 * Getter for the furthest behind schedule a poll has run
+			 * @return unsigned long -milliseconds
+			 */
+			static unsigned long getMaxLate(void);
+
+
+			/**
+			 * Getter for the longest press-to-report latency
+			 * @return unsigned long -microseconds
+			 */
+			static unsigned long getMaxLatency(void);
+
+
+			/**
+			 * Clears the histogram and the maximums, the next markLoop\(\) only starts the clock
+			 */
+			static void reset(void);
+		protected:
+			static uint16_t loopBuckets[LOOP_BUCKETS];	///< The loop histogram
+			static unsigned long lastLoop;	///< micros\(\) at the last markLoop\(\)
+			static bool looping;	///< Set once markLoop\(\) has been called since the last reset\(\)
+			static unsigned long maxLoop;	///< The longest pass, microseconds
+			static unsigned long maxLate;	///< The furthest behind a poll has run, milliseconds
+			static unsigned long maxLatency;	///< The longest press-to-report latency, microseconds
+	};
+	#endif
+
+
+
+
+}
+
+
+
+
+
+
+
+
+
+
+
+
+/**
+ * The Expansion namespace is for chips that give the board more inputs than it has pins, read through pin numbers that don't exist on the board
+ */
+namespace Expansion{
+
+
+	/**
+	 * An Expander is a chip, or a chain of them, that reads a number of inputs into the board over a few pins.\n
+	 * Once attached to VirtualPins each input gets a pin number of its own from CSF_VIRTUAL_PIN_BASE up, which can be given to a Pot, Button, Momentary, Touch or ControlBank in place of a real pin. The inputs are read a whole chip at a time by scan\(\), VirtualPins::scanAll\(\) in loop\(\) keeps every chip up to date, and the controls see the values from the last scan.
+	 */
+	class Expander{
+		public:
+			/**
+			 * Sets up the pins the chip is wired to, VirtualPins::attach\(\) calls this
+			 */
+			virtual void begin(void) = 0;
+
+
+			/**
+			 * Reads every input on the chip
+			 */
+			virtual void scan(void) = 0;
+
+
+			/**
+			 * Gets an input as of the last scan\(\) as a digital value
+			 * @param index -the input on the chip, from 0
+			 * @return int -HIGH or LOW
+			 */
+			virtual int read(uint8_t index) = 0;
+
+
+			/**
+			 * Gets an input as of the last scan\(\) as an analog value
+			 * @param index -the input on the chip, from 0
+			 * @return int -0 to 1023
+			 */
+			virtual int readAnalog(uint8_t index) = 0;
+
+
+			/**
+			 * Getter for the number of inputs on the chip
+			 * @return uint8_t
+			 */
+			virtual uint8_t getPinCount(void) = 0;
+
+
+			/**
+			 * Gets the pin number to give a control for one of the inputs
+			 * @param index -the input on the chip, from 0
+			 * @return int -the pin number, or -1 if the chip isn't attached or doesn't have that input
+			 */
+			int pin(uint8_t index);
+		protected:
+			int basePin = -1;	///< The pin number of input 0, set by VirtualPins::attach\(\)
+
+			friend class VirtualPins;
+	};
+
+
+
+
+	/**
+	 * AnalogMux reads the channels of a CD4051 \(8 channels, 3 select lines\) or 74HC4067 \(16 channels, 4 select lines\) analog multiplexer through one analog pin.\n
+	 * scan\(\) is pipelined so the mux settling overlaps the ADC rather than adding to it. On AVR boards the next channel is selected as soon as the ADC has taken its sample of the current one, so it settles during the rest of the conversion and the next conversion starts straight away, a full 16 channels is 16 conversions \(about 1.7 ms at the default ADC clock\). Elsewhere the next channel is selected the moment a read comes back and only whatever is left of the settling time is waited out. Channels are visited in Gray code order so only one select line changes per step.\n
+	 * While the Sampler is running from the ADC interrupt scan\(\) does nothing and the channels keep their last readings, since the two would fight over the ADC. Sampler::end\(\) first, or serve the Sampler from loop\(\) where the two take turns.
+	 */
+	class AnalogMux: public Expander{
+		public:
+			/**
+			 * The constructor for a CD4051, 8 channels
+			 * @param common -the analog pin the mux's common output is connected to
+			 * @param s0 -the pin connected to select line S0 \(A on a 4051\)
+			 * @param s1 -the pin connected to select line S1
+			 * @param s2 -the pin connected to select line S2
+			 */
+			AnalogMux(uint8_t common, uint8_t s0, uint8_t s1, uint8_t s2);
+
+
+			/**
+			 * The constructor for a 74HC4067, 16 channels
+			 * @param common -the analog pin the mux's common output is connected to
+			 * @param s0 -the pin connected to select line S0
+			 * @param s1 -the pin connected to select line S1
+			 * @param s2 -the pin connected to select line S2
+			 * @param s3 -the pin connected to select line S3
+			 */
+			AnalogMux(uint8_t common, uint8_t s0, uint8_t s1, uint8_t s2, uint8_t s3);
+
+
+			/**
+			 * Sets the select lines as outputs and the common pin as an input
+			 */
+			void begin(void);
+
+
+			/**
+			 * Reads every channel, see the class description for the pipelining. It does nothing while Sampler::isInterruptDriven\(\)
+			 */
+			void scan(void);
+
+
+			/**
+			 * Gets a channel as of the last scan\(\) as a digital value, HIGH when it's over half way
+			 * @param index -the channel
+			 * @return int -HIGH or LOW
+			 */
+			int read(uint8_t index);
+
+
+			/**
+			 * Gets a channel as of the last scan\(\)
+			 * @param index -the channel
+			 * @return int -0 to 1023
+			 */
+			int readAnalog(uint8_t index);
+
+
+			/**
+			 * Getter for the number of channels, 8 or 16
+			 * @return uint8_t
+			 */
+			uint8_t getPinCount(void);
+
+
+			/**
+			 * Sets how long the mux output needs after the select lines change before it can be read, 5 microseconds unless set
+			 * @param us -microseconds
+			 */
+			void setSettle(uint8_t us);
+		protected:
+			/**
+			 * Drives the select lines for a channel, only writing the ones that change
+			 * @param channel -the channel
+			 */
+			void select(uint8_t channel);
+
+			uint8_t commonPin;	///< The analog pin the mux output is on
+			uint8_t selectPins[4];	///< S0 to S3
+			uint8_t selectCount;	///< 3 or 4 select lines
+			uint8_t selected;	///< The channel the select lines are set to
+			uint8_t settle;	///< Microseconds from selecting a channel to reading it
+			uint16_t values[16];	///< Each channel's reading from the last scan
+	};
+
+
+
+
+	/**
+	 * ShiftIn reads a chain of 1 to 4 74HC165 parallel-in serial-out shift registers, 8 inputs each, over three pins.\n
+	 * scan\(\) latches every input at once and clocks the whole chain in as one burst. On AVR boards the three pins are driven through their port registers, found once in begin\(\), so 32 inputs take around 20 microseconds. Input 0 is D0 \(pin A\) of the chip wired to the board, input 8 is D0 of the next chip along and so on.
+	 */
+	class ShiftIn: public Expander{
+		public:
+			/**
+			 * The constructor for ShiftIn
+			 * @param load -the pin connected to SH/LD on every chip
+			 * @param clock -the pin connected to CLK on every chip
+			 * @param data -the pin connected to QH of the chip nearest the board
+			 * @param chips -how many chips are chained, 1 to 4
+			 */
+			ShiftIn(uint8_t load, uint8_t clock, uint8_t data, uint8_t chips = 1);
+
+
+			/**
+			 * Sets up the pins, leaving the chips shifting rather than loading
+			 */
+			void begin(void);
+
+
+			/**
+			 * Latches every input and shifts them all in
+			 */
+			void scan(void);
+
+
+			/**
+			 * Gets an input as of the last scan\(\)
+			 * @param index -the input
+			 * @return int -HIGH or LOW
+			 */
+			int read(uint8_t index);
+
+
+			/**
+			 * Gets an input as of the last scan\(\) as an analog value, for a Pot wired to a digital input
+			 * @param index -the input
+			 * @return int -1023 or 0
+			 */
+			int readAnalog(uint8_t index);
+
+
+			/**
+			 * Getter for the number of inputs, 8 per chip
+			 * @return uint8_t
+			 */
+			uint8_t getPinCount(void);
+
+
+			/**
+			 * Gets every input as of the last scan\(\), input 0 in bit 0
+			 * @return uint32_t
+			 */
+			uint32_t getBits(void);
+
+
+			/**
+			 * Flips every input, for buttons that pull their input to ground when pressed so they still read HIGH when pressed
+			 * @param activeLow -true to flip
+			 */
+			void setActiveLow(bool activeLow);
+		protected:
+			uint8_t loadPin;	///< SH/LD
+			uint8_t clockPin;	///< CLK
+			uint8_t dataPin;	///< QH of the nearest chip
+			uint8_t chipCount;	///< How many chips are chained
+			bool inverted;	///< Set by setActiveLow\(\)
+			uint32_t bits;	///< The inputs from the last scan, input 0 in bit 0
+			#if defined(__AVR__)
+				volatile uint8_t* loadRegister;	///< The port register loadPin is on
+				volatile uint8_t* clockRegister;	///< The port register clockPin is on
+				volatile uint8_t* dataRegister;	///< The pin register dataPin is on
+				uint8_t loadMask;	///< loadPin's bit in its port
+				uint8_t clockMask;	///< clockPin's bit in its port
+				uint8_t dataMask;	///< dataPin's bit in its port
+			#endif
+	};
+
+
+
+
+	/**
+	 * CapSense measures bare touch electrodes on the board's own pins, so a strip of copper tape or a screw head on a wire can be a Touch without a TTP223 module.\n
+	 * Each measurement drives the electrodes low, then lets them charge and counts passes of a tight loop until each pin reads HIGH. They charge either through the pins' own pull-ups, which needs nothing else but only takes a few passes so the readings are coarse, or from a send pin through a resistor of about 1 megohm to each electrode, which takes tens of passes and gives many times the resolution. A finger adds capacitance, so the pin takes longer to charge. Every electrode on a port is measured at once: the pull-ups come on together and each pass reads the whole port with one read, noting which pins have gone HIGH. So 8 electrodes on one port cost the same as one. Each port is charged setSamples\(\) times per scan and the passes added up, since one charge is only a few passes long.\n
+	 * Each electrode keeps a baseline, its count when nobody is touching it, that follows slow drift from temperature and humidity. It moves 1/2^drift of the way to each untouched reading, 4 times faster downwards so it doesn't stay high after a finger rested on it during begin\(\). While the electrode is touched it moves 16 times slower, so a touch held for a few seconds doesn't become the baseline but a touch that drift made up wears off. An electrode is touched once it reads a percentage over its baseline, and released once it drops under a lower one, so the same settings suit large and small electrodes and either way of charging them.\n
+	 * The charge loop runs with interrupts off and stops after setTimeout\(\) passes even if a pin never charges, so a scan is bounded by ports x samples x timeout passes. getScanMicros\(\) and getWorstScanMicros\(\) report what scans actually take.\n
+	 * Add the electrodes before attaching it to VirtualPins, then give the pins to Touch, e.g. Touch pad\(caps.pin\(0\)\); and pad.getState\(\) works as it would with a module. read\(\) is touched or not, readAnalog\(\) is how far over the baseline it reads. Keep the electrodes' wires short and away from each other. Each electrode costs 10 bytes of RAM.
+	 */
+	class CapSense: public Expander{
+		public:
+			/**
+			 * The constructor for CapSense, charging the electrodes through the pins' pull-ups
+			 */
+			CapSense(void);
+
+
+			/**
+			 * The constructor for CapSense, charging the electrodes from a send pin through a resistor to each one
+			 * @param send -the pin the resistors are connected to
+			 */
+			CapSense(uint8_t send);
+
+
+			/**
+			 * Adds an electrode, before VirtualPins::attach\(\)
+			 * @param p -the Arduino pin it's on, a real pin
+			 * @return int8_t -its input on the chip, or -1 if all CSF_CAPSENSE_CHANNELS are taken or the pin can't be used
+			 */
+			int8_t add(uint8_t p);
+
+
+			/**
+			 * Leaves every electrode driven low and takes the first baselines from 8 scans, VirtualPins::attach\(\) calls this
+			 */
+			void begin(void);
+
+
+			/**
+			 * Measures every electrode and updates its baseline and touched state
+			 */
+			void scan(void);
+
+
+			/**
+			 * Gets whether an electrode was touched as of the last scan\(\)
+			 * @param index -the electrode, in the order they were added
+			 * @return int -HIGH while touched
+			 */
+			int read(uint8_t index);
+
+
+			/**
+			 * Gets how far over its baseline an electrode read in the last scan\(\), which grows as a hand comes near
+			 * @param index -the electrode
+			 * @return int -0 to 1023
+			 */
+			int readAnalog(uint8_t index);
+
+
+			/**
+			 * Getter for the number of electrodes
+			 * @return uint8_t
+			 */
+			uint8_t getPinCount(void);
+
+
+			/**
+			 * Sets how many charges of each port are added up per scan, more is steadier but slower
+			 * @param count -1 to 64, 16 unless set
+			 */
+			void setSamples(uint8_t count);
+
+
+			/**
+			 * Sets the most loop passes one charge waits, which bounds how long a scan can take
+			 * @param passes -1 to 65535, 300 unless set
+			 */
+			void setTimeout(uint16_t passes);
+
+
+			/**
+			 * Sets the thresholds, as percentages of each electrode's baseline
+			 * @param touch -a reading this far over the baseline is a touch, 1 to 99. Unless set it's 40 charging through the pull-ups and 6 through resistors. Watch readAnalog\(\) against getBaseline\(\) while touching the electrodes to pick it
+			 * @param release -a touch ends once the reading is under this much over, less than touch, 25 or 4 unless set
+			 */
+			void setThresholds(uint8_t touch, uint8_t release);
+
+
+			/**
+			 * Sets how quickly the baselines follow drift
+			 * @param shift -each untouched scan moves the baseline 1/2^shift of the way, 0 to 12, 6 unless set
+			 */
+			void setDrift(uint8_t shift);
+
+
+			/**
+			 * Takes the current readings as the baselines and lets go of every touch, e.g. after the enclosure was closed
+			 */
+			void recalibrate(void);
+
+
+			/**
+			 * Getter for an electrode's reading in the last scan\(\)
+			 * @param index -the electrode
+			 * @return uint16_t -loop passes, added up over the samples
+			 */
+			uint16_t getRaw(uint8_t index);
+
+
+			/**
+			 * Getter for an electrode's baseline
+			 * @param index -the electrode
+			 * @return uint16_t -in the same counts as getRaw\(\)
+			 */
+			uint16_t getBaseline(uint8_t index);
+
+
+			/**
+			 * Getter for how long the last scan\(\) took
+			 * @return unsigned long -microseconds
+			 */
+			unsigned long getScanMicros(void);
+
+
+			/**
+			 * Getter for the longest scan\(\) since begin\(\)
+			 * @return unsigned long -microseconds
+			 */
+			unsigned long getWorstScanMicros(void);
+
+
+			/**
+			 * Getter for how many charges ran into the timeout since begin\(\), an electrode that never charges is shorted or far too big
+			 * @return unsigned long
+			 */
+			unsigned long getTimeouts(void);
+		protected:
+			/**
+			 * Takes every electrode's reading and times it, without touching the baselines
+			 */
+			void measure(void);
+
+
+			/**
+			 * Charges every electrode on one port once and adds each one's loop passes to its reading
+			 * @param lane -the port
+			 */
+			void charge(uint8_t lane);
+
+			static const uint8_t BASELINE_BITS = 8;	///< Fraction bits the baselines are kept with
+
+			int16_t sendPin;	///< The pin the resistors are on, or -1 to charge through the pull-ups
+			volatile uint8_t* sendRegister;	///< The port register sendPin is on
+			uint8_t sendMask;	///< sendPin's bit in its port
+			uint8_t channelCount;	///< How many electrodes are added
+			uint8_t laneCount;	///< How many ports they're on
+			uint8_t portNumbers[CSF_CAPSENSE_CHANNELS];	///< The port number of each lane
+			uint8_t laneMasks[CSF_CAPSENSE_CHANNELS];	///< The electrodes' bits on each lane
+			uint8_t lanes[CSF_CAPSENSE_CHANNELS];	///< The lane each electrode is on
+			uint8_t masks[CSF_CAPSENSE_CHANNELS];	///< The bit each electrode is on
+			uint16_t raws[CSF_CAPSENSE_CHANNELS];	///< Each electrode's reading from the last scan
+			uint32_t baselines[CSF_CAPSENSE_CHANNELS];	///< Each electrode's baseline, with BASELINE_BITS fraction bits
+			uint16_t touched;	///< A bit per electrode that's touched
+			uint8_t samples;	///< Charges per port per scan
+			uint16_t timeout;	///< The most loop passes per charge
+			uint8_t touchShare;	///< How far over the baseline a touch is, in 256ths of it
+			uint8_t releaseShare;	///< How far over the baseline a touch stays, in 256ths of it
+			uint8_t drift;	///< Baselines move 1/2^drift of the way per scan
+			unsigned long scanMicros;	///< How long the last scan took
+			unsigned long worstMicros;	///< The longest scan
+			unsigned long timeouts;	///< Charges that ran out of passes
+	};
+
+
+
+
+	/**
+	 * VirtualPins hands out pin numbers for the inputs of Expanders and reads them for the controls.\n
+	 * The controls read every pin through readDigital\(\) and readAnalog\(\), which pass real pins straight on to digitalRead\(\) and analogRead\(\), so a sketch without expanders only pays for a comparison. Everything is static since the pin numbers are shared by the whole sketch.
+	 */
+	class VirtualPins{
+		public:
+			/**
+			 * Adds an Expander, calling its begin\(\) and giving its inputs pin numbers
+			 * @param expander -the chip, it has to stay around as long as the pins are used
+			 * @return int -the pin number of its input 0, or -1 if all CSF_EXPANDERS are taken or there aren't enough numbers left
+			 */
+			static int attach(Expander& expander);
+
+
+			/**
+			 * Forgets every Expander, their pin numbers read as LOW and 0 afterwards
+			 */
+			static void detachAll(void);
+
+
+			/**
+			 * Place in loop\(\), scans every attached Expander
+			 */
+			static void scanAll(void);
+
+
+			/**
+			 * Checks whether a pin number belongs to an Expander rather than the board
+			 * @param p -the pin number
+			 * @return bool
+			 */
+			static bool isVirtual(int p){
+				return p >= CSF_VIRTUAL_PIN_BASE;
+			};
+
+
+			/**
+			 * digitalRead\(\) for real and virtual pins
+			 * @param p -the pin number
+			 * @return int -HIGH or LOW
+			 */
+			static int readDigital(int p){
+				if(!isVirtual(p)){
+					return digitalRead(p);
+				}
+				return readVirtual(p, false);
+			};
+
+
+			/**
+			 * analogRead\(\) for real and virtual pins
+			 * @param p -the pin number
+			 * @return int -0 to 1023
+			 */
+			static int readAnalog(int p){
+				if(!isVirtual(p)){
+					return analogRead(p);
+				}
+				return readVirtual(p, true);
+			};
+
+
+			/**
+			 * pinMode\(\) for real and virtual pins, virtual pins are set up by their Expander so this does nothing for them
+			 * @param p -the pin number
+			 * @param mode -INPUT, OUTPUT or INPUT_PULLUP
+			 */
+			static void setMode(int p, uint8_t mode){
+				if(!isVirtual(p)){
+					pinMode(p, mode);
+				}
+			};
+		protected:
+			/**
+			 * Finds the Expander behind a virtual pin and reads it
+			 * @param p -the pin number
+			 * @param analog -true for readAnalog\(\), false for read\(\)
+			 * @return int
+			 */
+			static int readVirtual(int p, bool analog);
+
+			static uint8_t expanderCount;	///< How many Expanders are attached
+			static int nextPin;	///< The pin number the next Expander's input 0 gets
+			static Expander* expanders[CSF_EXPANDERS];	///< The attached Expanders, in pin number order
+	};
+
+
+}
+
+
+
+
+
+
+
+
+
+
+
+namespace Static{
+	namespace Sensors{
+		template<class Derived> class BasicPot;
+	}
+}
+
+
+
+
+/**
+ * The Sensors namespace is for circuits normally used as primary inputs to a project
+ */
+namespace Sensors{
+
+	class Sampler;
+
+
+
+
+	/**
+	 * Works out how many fraction bits a fixed point mapping can afford, the most that still leaves the output range and the multiply clear of overflow.
+	 * @param maxAbs -the largest output magnitude, or span between the ends if that's larger
+	 * @param shift -the most fraction bits to try
+	 * @param bits -how many bits the values can use, 30 leaves a 32 bit long room for the sign and rounding, 61 does the same for 64 bits
+	 * @return uint8_t
+	 */
+	constexpr uint8_t fixedShift(long long maxAbs, uint8_t shift, uint8_t bits = 29){
+		return (shift == 0 || (shift <= bits ? maxAbs < (1LL << (bits - shift)) : maxAbs == 0)) ? shift : fixedShift(maxAbs, shift - 1, bits);
+	}//end fixedShift()
+
+
+	/**
+	 * Works out how many fraction bits a whole number mapping needs to round every reading the way exact arithmetic would, the slope's error over inMax readings has to stay under the 1/\(2 inMax\) a reading can be from the nearest half, so 2^bits > inMax^2
+	 * @param inMax -the top reading
+	 * @param bits -the fewest fraction bits to try
+	 * @return uint8_t
+	 */
+	constexpr uint8_t fixedNeeded(long long inMax, uint8_t bits = 0){
+		return (1LL << bits) > inMax * inMax ? bits : fixedNeeded(inMax, bits + 1);
+	}//end fixedNeeded()
+
+
+	/**
+	 * The larger of two magnitudes, for fixed point constants worked out at compile time
+	 * @param a -one
+	 * @param b -the other
+	 * @return long long
+	 */
+	constexpr long long fixedLarger(long long a, long long b){
+		return (a < 0 ? -a : a) > (b < 0 ? -b : b) ? (a < 0 ? -a : a) : (b < 0 ? -b : b);
+	}//end fixedLarger()
+
+
+	/**
+	 * Divides rounding to the nearest whole number, for fixed point constants worked out at compile time
+	 * @param num -the numerator
+	 * @param den -the denominator, positive
+	 * @return long long
+	 */
+	constexpr long long fixedRoundDiv(long long num, long long den){
+		return num >= 0 ? (num + den / 2) / den : (num - den / 2) / den;
+	}//end fixedRoundDiv()
+
+
+
+
+	/**
+	 * FixedMap is mapData\(\) worked out entirely at compile time, for when the range is known when writing the sketch.\n
+	 * The slope and offset are fixed point constants so each call is a single multiply and shift, rounding every reading the way exact arithmetic would. Ranges up to about a thousand, e.g. FixedMap<-200, 200>::map\(pot.getSensorValue\(\)\), get a 32 bit multiply, wider ones a 64 bit one, the same as LinearMap::setWhole\(\).
+	 * @tparam OutMin -the value the bottom of the pot maps to
+	 * @tparam OutMax -the value the top of the pot maps to
+	 * @tparam InMax -the top reading of the pot, 1023 for a plain analogRead\(\)
+	 */
+	template<long OutMin, long OutMax, long InMax = 1023>
+	class FixedMap{
+		static_assert(InMax > 0, "FixedMap input range must be positive");
+		static_assert(OutMin != OutMax, "FixedMap output range is empty");
+		public:
+			static constexpr long long LARGEST = fixedLarger(fixedLarger(OutMin, OutMax), (long long)OutMax - OutMin);	///< The largest value the line reaches, the multiply included
+			static constexpr uint8_t NEEDED = fixedNeeded(InMax);	///< Fraction bits for every reading to round exactly
+			static constexpr bool WIDE = fixedShift(LARGEST, 30, 30) < NEEDED;	///< Set when 32 bits don't leave enough fraction bits
+			static constexpr uint8_t SHIFT = WIDE ? fixedShift(LARGEST, 48, 61) : fixedShift(LARGEST, 30, 30);	///< Fraction bits
+			static constexpr long long SLOPE = fixedRoundDiv(((long long)OutMax - OutMin) * (1LL << SHIFT), InMax);	///< Output per input step, with SHIFT fraction bits
+			static constexpr long long OFFSET = (long long)OutMin * (1LL << SHIFT) + (1LL << SHIFT) / 2;	///< The output at 0, with SHIFT fraction bits and the rounding half added in
+			static_assert(SHIFT >= NEEDED, "FixedMap input range is too long to map exactly");
+
+
+			/**
+			 * Maps a reading
+			 * @param reading -0 to InMax
+			 * @return long -rounded to the nearest whole number, halves round up
+			 */
+			static long map(long reading){
+				if(WIDE){
+					return (long)((reading * SLOPE + OFFSET) >> SHIFT);
+				}
+				return (reading * (long)SLOPE + (long)OFFSET) >> SHIFT;
+			};
+	};
+
+
+
+
+	/**
+	 * LinearMap is mapData\(\)'s arithmetic, the straight line from the pot's range to the one asked for, kept as fixed point so mapping a reading doesn't touch floats or the generic map\(\).\n
+	 * The slope and offset are worked out once by set\(\) or setWhole\(\), after that each reading is one multiply and a shift. That's a 32 bit multiply when 32 bits leave enough fraction bits for the result to be exact, e.g. 0 to 100 or -3.14 to 3.14 from 0 to 1023, and a 64 bit one for wider or finer ranges, e.g. -32768 to 32767 or 0.001 to 0.002.\n
+	 * setWhole\(\) rounds every reading to the same whole number as exact arithmetic would, for any range of longs. set\(\) is good to a few millionths of the range for ranges up to +-2^60, past that the ends are pulled in to fit.
+	 */
+	class LinearMap{
+		public:
+			/**
+			 * The constructor for LinearMap, it starts out mapping 0 to 1023 onto itself
+			 */
+			LinearMap(void);
+
+
+			/**
+			 * Sets the range to map onto, this is the only place floating point math happens
+			 * @param outMin -what a reading of 0 maps to
+			 * @param outMax -what a reading of inMax maps to
+			 * @param inMax -the top reading of the pot, 1023 for a plain analogRead\(\)
+			 * @return bool -false if the range was past +-2^60 and had to be pulled in
+			 */
+			bool set(float outMin, float outMax, long inMax = 1023);
+
+
+			/**
+			 * Sets a whole number range to map onto, worked out in integers so toInt\(\) is exact
+			 * @param outMin -what a reading of 0 maps to
+			 * @param outMax -what a reading of inMax maps to
+			 * @param inMax -the top reading of the pot, 1023 for a plain analogRead\(\), more with oversampling
+			 */
+			void setWhole(long outMin, long outMax, long inMax = 1023);
+
+
+			/**
+			 * Maps a reading to fixed point
+			 * @param reading -0 to the inMax given to set\(\)
+			 * @return int64_t -the mapped value with getShift\(\) fraction bits
+			 */
+			int64_t apply(long reading) const{
+				if(wide){
+					return reading * slope + offset;
+				}
+				return reading * (long)slope + (long)offset;
+			};
+
+
+			/**
+			 * Maps a reading to the nearest whole number, halves round up
+			 * @param reading -0 to the inMax given to set\(\)
+			 * @return long
+			 */
+			long toInt(long reading) const{
+				if(wide){
+					return (long)((reading * slope + offset + half) >> shift);
+				}
+				return (reading * (long)slope + (long)offset + (long)half) >> shift;
+			};
+
+
+			/**
+			 * Maps a reading to a float, the only float math is the final scaling
+			 * @param reading -0 to the inMax given to set\(\)
+			 * @return float
+			 */
+			float toFloat(long reading) const{
+				return apply(reading) * scale;
+			};
+
+
+			/**
+			 * Getter for the number of fraction bits apply\(\) returns
+			 * @return uint8_t
+			 */
+			uint8_t getShift(void) const;
+
+
+			/**
+			 * Getter for whether the mapping needs the 64 bit multiply
+			 * @return bool
+			 */
+			bool isWide(void) const;
+		protected:
+			/**
+			 * Picks the fraction bits for a range, as many as 32 bit math allows if that's enough, otherwise as many as 64 bit math allows
+			 * @param largest -the largest of the ends and the span, as a whole number of output units rounded up
+			 * @param needed -the fewest fraction bits that give the precision asked for
+			 */
+			void pickShift(int64_t largest, uint8_t needed);
+
+
+			/**
+			 * Sets the rounding half and float scale for the shift picked
+			 */
+			void finish(void);
+
+			static const uint8_t NARROW_BITS = 30;	///< How far the line can reach with 32 bit math, leaving the sign and a bit for rounding
+			static const uint8_t WIDE_BITS = 61;	///< How far the line can reach with 64 bit math
+			static const uint8_t MAX_SHIFT = 48;	///< The most fraction bits, past a float's precision already
+
+			int64_t slope;	///< Output per input step, with shift fraction bits
+			int64_t offset;	///< The output at 0, with shift fraction bits
+			int64_t half;	///< One half in fixed point, added before shifting to round to nearest
+			float scale;	///< 2 to the power of -shift, to turn fixed point into a float
+			uint8_t shift;	///< The number of fraction bits
+			bool wide;	///< Set when the values need 64 bit math
+	};
+
+
+	const float TAPER_LINEAR = 0.5;	///< CurveTable taper, a linear pot reads half way at half travel
+	const float TAPER_AUDIO = 0.1;	///< CurveTable taper, an audio or log \("A"\) pot reads about 10% at half travel
+	const float TAPER_REVERSE_AUDIO = 0.9;	///< CurveTable taper, a reverse log \("C"\) pot reads about 90% at half travel
+
+
+	/**
+	 * Calibration is where a pot's readings really fall along its travel, captured on the board and kept in EEPROM, for CurveTable::generate\(\) to straighten out.\n
+	 * A worn slide that never gets below 20 or above 1000 only needs its endpoints: call startSweep\(\), pass sweep\(\) a reading every pass of loop\(\) while the slide is run end to end a few times, then endSweep\(\). For a pot that isn't the taper it says it is, capture points instead: start\(n\), set the pot at each of n evenly spaced marks along its travel in turn and pass capture\(\) readings while it sits there, each point is the average of the readings it was given.\n
+	 * Readings are plain analogRead\(\) values, 0 to 1023, e.g. from Pot::getRawValue\(\). Points can run downhill as well as up, for a pot wired backwards.\n
+	 * save\(\) and load\(\) keep it at an EEPROM address with a CRC, so a blank or corrupt EEPROM leaves the straight 0 to 1023 line in place rather than garbage. It needs STORAGE_SIZE bytes at that address, on an ESP call EEPROM.begin\(\) first.
+	 */
+	class Calibration{
+		public:
+			static const int STORAGE_SIZE = 2 + 2 * CSF_CALIBRATION_POINTS + 2;	///< EEPROM bytes save\(\) uses
+
+
+			/**
+			 * The constructor for Calibration, it starts out as a straight line from 0 to 1023
+			 */
+			Calibration(void);
+
+
+			/**
+			 * Goes back to the straight line from 0 to 1023
+			 */
+			void reset(void);
+
+
+			/**
+			 * Starts capturing the endpoints, the lowest and highest readings sweep\(\) is given
+			 */
+			void startSweep(void);
+
+
+			/**
+			 * Takes a reading while the pot is swept from end to end
+			 * @param reading -0 to 1023
+			 */
+			void sweep(int reading);
+
+
+			/**
+			 * Finishes capturing the endpoints, pulling each one in a little so a noisy reading at the end stop still reaches the end of the range
+			 * @param margin -how far to pull each endpoint in
+			 * @return bool -false if the sweep didn't cover enough of the range to use, the straight line is put back
+			 */
+			bool endSweep(uint8_t margin = 2);
+
+
+			/**
+			 * Starts capturing points along the travel
+			 * @param marks -how many evenly spaced marks, including both ends, 2 to CSF_CALIBRATION_POINTS
+			 * @return bool -false if that's more points than there is room for
+			 */
+			bool start(uint8_t marks);
+
+
+			/**
+			 * Takes a reading with the pot at one of the marks, each call for the same point adds to its average
+			 * @param point -the mark, 0 at the start of the travel
+			 * @param reading -0 to 1023
+			 * @return bool -false if there is no such point
+			 */
+			bool capture(uint8_t point, int reading);
+
+
+			/**
+			 * Sets a point outright, e.g. from a pot's datasheet
+			 * @param point -the mark, 0 at the start of the travel
+			 * @param reading -what the pot reads there, 0 to 1023
+			 * @return bool -false if there is no such point
+			 */
+			bool setPoint(uint8_t point, int reading);
+
+
+			/**
+			 * Getter for a point
+			 * @param point -the mark
+			 * @return int -the reading there
+			 */
+			int getPoint(uint8_t point) const;
+
+
+			/**
+			 * Getter for the number of points, 2 when only the endpoints were captured
+			 * @return uint8_t
+			 */
+			uint8_t getPointCount(void) const;
+
+
+			/**
+			 * Checks the points run steadily up or steadily down, which toPosition\(\) needs
+			 * @return bool
+			 */
+			bool isValid(void) const;
+
+
+			/**
+			 * Works out where along its travel the pot is from a reading, along straight lines between the points and carrying on past the end ones
+			 * @param reading -in analogRead\(\) units, may have a fraction
+			 * @return float -0 at the first point and 1 at the last
+			 */
+			float toPosition(float reading) const;
+
+
+			/**
+			 * Writes the points to EEPROM, only the bytes that changed
+			 * @param address -the first byte
+			 * @return bool -false if there is no EEPROM or it doesn't reach
+			 */
+			bool save(int address) const;
+
+
+			/**
+			 * Reads points written by save\(\)
+			 * @param address -the first byte
+			 * @return bool -false if there's nothing valid there, the points are left as they were
+			 */
+			bool load(int address);
+		protected:
+			uint16_t points[CSF_CALIBRATION_POINTS];	///< The reading at each mark
+			uint8_t count;	///< How many points are in use
+			uint8_t current;	///< The point capture\(\) is averaging
+			uint8_t samples;	///< How many readings the current point's average has
+			long sum;	///< The readings for the current point added up
+	};
+
+
+	/**
+	 * CurveTable maps a reading through a curve kept as a table in flash, usually to undo an audio taper and map the range in one go, so each reading is one lookup and an interpolation in integer math rather than the float math it took to work the curve out.\n
+	 * The table has 2^bits + 1 entries spread evenly along the readings, and the answer is the straight line between the two either side. generate\(\) fills one in from a taper, a range and optionally a Calibration, either at run time into an array in RAM, or on a PC with the csf_curve tool in host/tools, which prints it as a PROGMEM array to paste into the sketch along with how far it strays from the exact curve. 32 segments are usually plenty, 66 bytes of flash.\n
+	 * The entries are 16 bit whole numbers, for a decimal range like -3.14 to 3.14 they're kept in hundredths \(decimals = 2\) and toFloat\(\) divides back down. e.g.\n
+	 * const int16_t volumeCurve[33] PROGMEM = { ... };\n
+	 * Sensors::CurveTable volume\(volumeCurve, 5\);\n
+	 * int level = pot.mapData\(volume\);
+	 */
+	class CurveTable{
+		public:
+			/**
+			 * The constructor for CurveTable
+			 * @param table -2^bits + 1 entries, it has to outlive the CurveTable
+			 * @param bits -the table has 2^bits segments, 1 to 8
+			 * @param decimals -how many decimal places the entries are kept to, toFloat\(\) divides by 10^decimals
+			 * @param flash -true when the table is PROGMEM, false for an array in RAM
+			 */
+			CurveTable(const int16_t* table, uint8_t bits, uint8_t decimals = 0, bool flash = true);
+
+
+			/**
+			 * Fills in a table from a curve, this is the only place floating point math happens
+			 * @param table -room for 2^bits + 1 entries
+			 * @param bits -the table has 2^bits segments, 1 to 8
+			 * @param outMin -what the start of the pot's travel maps to
+			 * @param outMax -what the end of the pot's travel maps to
+			 * @param decimals -how many decimal places to keep the entries to
+			 * @param taper -how far up its range the pot reads at half travel, e.g. TAPER_AUDIO. Leave it TAPER_LINEAR with a Calibration that has points along the travel, they already include the taper
+			 * @param calibration -where the pot's readings really fall, or NULL for 0 to 1023
+			 * @return bool -false if the range didn't fit in 16 bits and some entries were cut off
+			 */
+			static bool generate(int16_t* table, uint8_t bits, float outMin, float outMax, uint8_t decimals = 0, float taper = TAPER_LINEAR, const Calibration* calibration = NULL);
+
+
+			/**
+			 * The exact curve generate\(\) samples, for checking a table against
+			 * @param reading -in analogRead\(\) units, may have a fraction
+			 * @param outMin -what the start of the pot's travel maps to
+			 * @param outMax -what the end of the pot's travel maps to
+			 * @param taper -how far up its range the pot reads at half travel
+			 * @param calibration -where the pot's readings really fall, or NULL for 0 to 1023
+			 * @return float
+			 */
+			static float evaluate(float reading, float outMin, float outMax, float taper = TAPER_LINEAR, const Calibration* calibration = NULL);
+
+
+			/**
+			 * Maps a reading through the table
+			 * @param reading -0 to 1023, or more with oversampling
+			 * @param extraBits -the bits of oversampling the reading has, see Pot::setOversampling\(\)
+			 * @return long -in the table's units, 10^decimals to a whole number
+			 */
+			long lookup(long reading, uint8_t extraBits = 0) const;
+
+
+			/**
+			 * Maps a reading through the table and scales it by the decimals
+			 * @param reading -0 to 1023, or more with oversampling
+			 * @param extraBits -the bits of oversampling the reading has
+			 * @return float
+			 */
+			float toFloat(long reading, uint8_t extraBits = 0) const;
+
+
+			/**
+			 * Getter for the number of decimal places the entries are kept to
+			 * @return uint8_t
+			 */
+			uint8_t getDecimals(void) const;
+
+
+			/**
+			 * Getter for the size of the table
+			 * @return uint8_t -the table has 2^bits segments
+			 */
+			uint8_t getBits(void) const;
+		protected:
+			/**
+			 * Reads an entry from flash or RAM
+			 * @param i -0 to 2^bits
+			 * @return int16_t
+			 */
+			int16_t entry(uint16_t i) const{
+				return flash ? (int16_t)pgm_read_word(&table[i]) : table[i];
+			};
+
+			const int16_t* table;	///< The entries
+			float scale;	///< 10 to the power of -decimals
+			uint8_t bits;	///< The table has 2^bits segments
+			uint8_t decimals;	///< Decimal places the entries are kept to
+			bool flash;	///< Whether table is PROGMEM
+	};
+
+
+	const uint8_t FILTER_EMA = 1;	///< FilterChain stage type, exponential moving average
+	const uint8_t FILTER_MEDIAN = 2;	///< FilterChain stage type, running median
+	const uint8_t FILTER_DEADBAND = 3;	///< FilterChain stage type, hysteresis deadband
+	const uint8_t FILTER_MEDIAN_MAX = 5;	///< The widest median window
+
+
+	/**
+	 * FilterChain cleans up a noisy sensor reading on the board, so whatever is reading the values \(the serial port, the computer\) gets them already steady.\n
+	 * It's a pipeline of up to CSF_FILTER_STAGES stages run in the order they were added, each in integer math with its state kept in the chain itself, nothing is allocated. Give a Pot one with Pot::setFilter\(\) and every reading the Pot takes goes through it. The stages, with rough costs on a 16 MHz ATmega328P worked out from the generated code rather than measured:\n
+	 * - addEMA\(k\): exponential moving average, each reading moves the output 1/2^k of the way to it. About 40 cycles plus 8 per bit of k.\n
+	 * - addMedian\(3 or 5\): the median of the last 3 or 5 readings, knocks out single spikes without the lag of an average. About 60 cycles for 3, 250 for 5.\n
+	 * - addDeadband\(w\): the output only moves when the reading gets w or more away from it, so a pot resting between two values stops flickering. About 25 cycles.\n
+	 * Oversampling, reading the pot several times and adding the readings up for extra bits, happens before the chain, see Pot::setOversampling\(\).
+	 */
+	class FilterChain{
+		public:
+			/**
+			 * The constructor for FilterChain, it starts with no stages and passes readings straight through
+			 */
+			FilterChain(void);
+
+
+			/**
+			 * Adds an exponential moving average stage
+			 * @param k -each reading moves the output 1/2^k of the way, 1 to 8, higher is smoother but slower
+			 * @return bool -false if all CSF_FILTER_STAGES are taken
+			 */
+			bool addEMA(uint8_t k);
+
+
+			/**
+			 * Adds a running median stage
+			 * @param width -3 or 5 readings
+			 * @return bool -false if all CSF_FILTER_STAGES are taken or the width isn't 3 or 5
+			 */
+			bool addMedian(uint8_t width);
+
+
+			/**
+			 * Adds a hysteresis deadband stage
+			 * @param width -how far the reading has to move before the output follows
+			 * @return bool -false if all CSF_FILTER_STAGES are taken
+			 */
+			bool addDeadband(uint8_t width);
+
+
+			/**
+			 * Forgets the history in every stage, the next reading starts each one fresh
+			 */
+			void reset(void);
+
+
+			/**
+			 * Runs a reading through every stage
+			 * @param reading -the reading
+			 * @return int -the filtered reading
+			 */
+			int process(int reading);
+
+
+			/**
+			 * Getter for the number of stages
+			 * @return uint8_t
+			 */
+			uint8_t getStageCount(void);
+		protected:
+			/**
+			 * The type, setting and history of one stage
+			 */
+			struct Stage{
+				uint8_t type;	///< FILTER_EMA, FILTER_MEDIAN or FILTER_DEADBAND
+				uint8_t param;	///< k, the width, or the deadband
+				uint8_t index;	///< Where the next median reading goes
+				uint8_t filled;	///< How many readings the stage has seen, up to what it needs
+				union{
+					long accumulator;	///< The EMA output with k fraction bits
+					int window[FILTER_MEDIAN_MAX];	///< The median's last readings
+					int output;	///< The deadband's current output
+				};
+			};
+
+			/**
+			 * Fills in a new stage
+			 * @return bool -false if all CSF_FILTER_STAGES are taken
+			 */
+			bool addStage(uint8_t type, uint8_t param);
+
+			Stage stages[CSF_FILTER_STAGES];	///< The stages in the order they run
+			uint8_t stageCount;	///< How many stages are in use
+	};
+
+
+
+
+	/**
+	 * @section description Description
+	 * ControlUnit is the parent class for sensor controls.\n
+	 * Each "Control" typically consists of a tactile-momentary-switch or capacitive touch-sensor for a power button, a power indicator LED, and a sensor to input the control data\n
+	 */
+	class ControlUnit{
+		public:
+			/**
+			 * The constructor for the sensor.\n
+			 * With only three arguments it sets the reuired time interval that must pass between registering button clicks to 250 milliseconds\n
+			 * @param but -the power button connected to the sensor
+			 * @param lin -the power line coming from the Arduino
+			 * @param sig -the Arduino pin the sensor signal will be sent to
+			 */
+			ControlUnit(int but, int lin, int sig);
+			
+			
+			
+			/**
+			 * The constructor for the sensor.\n
+			 * @param but -the power button connected to the sensor
+			 * @param lin -the power line coming from the Arduino
+			 * @param sig -the Arduino pin the sensor signal will be sent to
+			 * @param val -the required time interval that must pass between registering button clicks -in milliseconds
+			 */
+			ControlUnit(int but, int lin, int sig, int val);
+			
+			
+			
+			/**
+			 * The destructor, virtual so a sensor made with new can be deleted through a ControlUnit pointer
+			 */
+			virtual ~ControlUnit(void){};
+			
+			
+			
+			/**
+			 * Initializes all variables and assigns INPUT/OUTPUT to the connections on the scale controls, i.e. the pinMode\(i, m\) method for Arduino\n
+			 * Call this method in the setup\(\) method in the .ino file
+			 */
+			virtual void begin(void) = 0;
+			
+			
+			/**
+			 * Gets the current value of this control's sensor
+			 * 
+			 * @return int
+			 */
+			virtual int getSensorValue(void) = 0;
+			
+			
+			/**
+			 * Toggles the On/Off state of this control
+			 */
+			void toggleIsSensorOn(void);
+			
+			
+			/**
+			 * Getter for the On/Off state data of this control
+			 * @return bool
+			 */
+			bool getIsSensorOn(void);
+			
+			
+			/**
+			 * Activates the power to this control
+			 */
+			void activateControl(void);
+			
+			
+			/**
+			 * Deactivates the power to this control
+			 */
+			void deactivateControl(void);
+			
+			
+			/**
+			 * Called when ready to check if the Activation Button for this control is currently being pressed \(I chose not to put interupts in this library\)\n
+			 * Place in loop\(\) somewhere to determine if the power button for this control is currently being pressed.\n
+			 * The button is read on every call and the On/Off state toggles once per press, the moment the press is seen, or the confirm time after if the debouncer has one, so holding the button down doesn't keep toggling it. Scheduling::ControlManager reads it every ControlManager::POLL_INTERVAL whatever the interval. The interval is the debouncer's lockout, the least time from one press to the next, and doesn't hold back the release, see Utility::Debouncer.
+			 */
+			void isButtonPressed(void);
+			
+			
+			/**
+			 * Reads the Activation Button right now and toggles the On/Off state if it has just been pressed.\n
+			 * isButtonPressed\(\) calls this, and Scheduling::ControlManager calls it on its own schedule.
+			 */
+			void pollButton(void);
+			
+			
+			/**
+			 * Getter for the lockout between presses of the Activation Button
+			 * @return long -in milliseconds
+			 */
+			long getInterval(void);
+			
+			
+			/**
+			 * I often find my ideas for Arduino projects are input devices (essentially a customized keyboard or mouse override) for software running on my PC. This is typically handled with bits of code written in python making use of the libraries pyserial and pyautogui.\n
+			 * This method is encapsulates sending the sensor data to the serial port for that purpose.\n
+			 */
+			virtual void toSerial(void) = 0;
+			
+			
+			/**
+			 * Report-by-exception version of toSerial\(\): it only sends when the reading has moved by the deadband, the sensor was switched on or off, or the heartbeat is due, so an idle control doesn't keep filling the serial port with the same value.\n
+			 * Each line sent starts with a sequence number and a space, e.g. "17 -1.25", the sequence going up by one per line \(wrapping at 255\) so the computer can spot a missing line. See setReportByException\(\).
+			 * @return bool -true if a line was sent
+			 */
+			bool toSerialOnChange(void);
+
+
+			/**
+			 * toSerialOnChange\(\) with a reading that has just been taken, for a caller that already has one, e.g. Scheduling::ControlManager with a Utility::RateController
+			 * @param reading -from getSensorValue\(\), or 0 when the sensor is off
+			 * @return bool -true if a line was sent
+			 */
+			bool toSerialOnChange(int reading);
+			
+			
+			/**
+			 * Sets what counts as a change for toSerialOnChange\(\)
+			 * @param deadband -how far the reading \(before mapping\) has to move, 1 for any change
+			 * @param heartbeat -milliseconds after which the value is sent even if it hasn't changed, 0 for never
+			 */
+			void setReportByException(int deadband, unsigned int heartbeat);
+
+
+			#if CSF_CONTROLS_STATS
+			/**
+			 * Getter for this control's counters
+			 * @return Utility::ControlStats& -the stats command resets them through this
+			 */
+			Utility::ControlStats& getStats(void);
+			#endif
+		protected:
+			/**
+			 * Prints a reading the way toSerial\(\) would, Pot overrides this to print the mapped value
+			 * @param reading -the reading from getSensorValue\(\), or 0 when the sensor is off
+			 */
+			virtual void printValue(int reading);
+
+
+			/**
+			 * Runs a reading of the Activation Button through the debouncer and toggles the On/Off state on a press
+			 * @param level -what was read from the button
+			 */
+			void debounceButton(int level);
+
+			Utility::ChangeTracker tracker;	///< Decides when toSerialOnChange\(\) sends
+			#if CSF_CONTROLS_STATS
+			Utility::ControlStats stats;	///< Counters for the stats command
+			#endif
+			bool isSensorOn;			///<On/Off State of this control
+			int powerButton;		///<Power button for this control
+			int powerLine; 		///<Power Line for this control's sensor and power indicator LED
+			int sensorLine;		///<Input line feeding back from the sesnsor in this control
+			long interval;	///< The amount of time to wait between checking presses of buttons
+			Utility::Debouncer powerDebouncer;	///< Turns the Activation Button into presses, with the interval as its lockout
+	};
+
+
+
+
+	/**
+	 * PotReader is the part of a Pot that reads and maps the sensor: oversampling, the Sampler, the filter, the range from mapData\(\) and printing a reading that way.\n
+	 * Pot and Static::Sensors::Pot both build on it, so the two share one implementation of all that, and the Activation Button, power line and which getSensorValue\(\) gets called are left to them. It has no virtual functions, and the pin is passed in rather than kept here since the ControlUnit already has it.
+	 */
+	class PotReader{
+		public:
+			/**
+			 * The constructor for the reader, unmapped and unfiltered with no oversampling
+			 */
+			PotReader(void){mappingMode = 0; minValueInt = 0; maxValueInt = 0; minValueFloat = 0.0; maxValueFloat = 0.0; curve = NULL; samplerChannel = -1; filter = NULL; oversampling = 0; lastValue = 0;};
+
+
+			/**
+			 * Runs every reading this Pot takes through a FilterChain, e.g. to smooth out a noisy slider. The filtering happens in getSensorValue\(\), so the mapped values and toSerial\(\) are filtered too.\n
+			 * Each reading advances the filter one step, so read the Pot at a steady rate for a steady response.
+			 * @param chain -the chain, it has to outlive the Pot
+			 */
+			void setFilter(FilterChain& chain);
+
+
+			/**
+			 * Stops filtering the readings
+			 */
+			void clearFilter(void);
+
+
+			/**
+			 * Reads the pot 4^bits times and adds the readings up to gain bits of resolution from the noise, e.g. 2 extra bits takes 16 readings and gives 0 to 4092.\n
+			 * getSensorValue\(\) returns the larger range and mapData\(\) allows for it. With the Sampler attached it adds up the readings the Sampler already has instead of waiting on new ones, so the bits are capped at Sampler::OVERSAMPLING, what CSF_SAMPLER_DEPTH readings hold: 1 with the default 4, raise CSF_SAMPLER_DEPTH to 16 or 64 for 2 or 3. Attaching lowers bits already set past that.
+			 * @param bits -extra bits, 0 to 3
+			 */
+			void setOversampling(uint8_t bits);
+
+
+			/**
+			 * Gets the reading getSensorValue\(\) last returned, without taking a new one or stepping the filter
+			 * @return int
+			 */
+			int getLastValue(void);
+
+
+			/**
+			 * Getter for the Sampler channel this Pot reads from
+			 * @return int8_t -the channel, or -1 if it isn't attached to the Sampler
+			 */
+			int8_t getSamplerChannel(void);
+		protected:
+			/**
+			 * Forgets the range from mapData\(\), as the Pots' begin\(\) does
+			 */
+			void clearMapping(void);
+
+
+			/**
+			 * Takes a reading, from the Sampler if attached, oversampled and filtered if set up to be, for getSensorValue\(\)
+			 * @param pin -the sensor pin
+			 * @return int
+			 */
+			int readSensor(int pin);
+
+
+			/**
+			 * Takes a single reading, the Sampler's newest if attached, for getRawValue\(\)
+			 * @param pin -the sensor pin
+			 * @return int -0 to 1023
+			 */
+			int readRaw(int pin);
+
+
+			/**
+			 * Maps a reading to a range, working the mapping out again only when the range changes, for mapData\(\)
+			 * @param min -the value at one end of the pot
+			 * @param max -the value at the other end
+			 * @param reading -from getSensorValue\(\)
+			 * @return float
+			 */
+			float mapReading(float min, float max, int reading);
+
+
+			/**
+			 * Maps a reading to a range, rounded to the nearest whole number, for mapData\(\)
+			 * @param min -the value at one end of the pot
+			 * @param max -the value at the other end
+			 * @param reading -from getSensorValue\(\)
+			 * @return int
+			 */
+			int mapReading(int min, int max, int reading);
+
+
+			/**
+			 * Maps a reading through a CurveTable, for mapData\(\)
+			 * @param table -the curve, it has to outlive the Pot
+			 * @param reading -from getSensorValue\(\)
+			 * @return int
+			 */
+			int mapReading(const CurveTable& table, int reading);
+
+
+			/**
+			 * Prints a reading mapped the same way as the last mapData\(\) call, or 0 when the sensor is off
+			 * @param reading -the reading from getSensorValue\(\)
+			 * @param on -whether the sensor is on
+			 */
+			void printReading(int reading, bool on);
+
+			int mappingMode; ///< If the mapData\(\) function has been called this will be track whether it should be an int or a float for toSerial\(\) with the same range.\n 0 is unmapped, 1 is int, 2 is float, 3 is a CurveTable.
+			int minValueInt;	///< hold the mapped data from the sensor
+			int maxValueInt;	///< hold the mapped data from the sensor
+			float minValueFloat;	///< hold the mapped data from the sensor
+			float maxValueFloat;	///< hold the mapped data from the sensor
+			LinearMap mapping;	///< The fixed point form of the range last given to mapData\(\)
+			const CurveTable* curve;	///< The table last given to mapData\(\), or NULL
+			int8_t samplerChannel;	///< The Sampler channel this Pot reads from, or -1 to call analogRead\(\) directly
+			FilterChain* filter;	///< The filter readings go through, or NULL
+			uint8_t oversampling;	///< Extra bits of resolution from oversampling
+			int lastValue;	///< The last value getSensorValue\(\) returned
+
+			friend class Sampler;
+	};
+
+
+
+
+	/**
+	 * The Pot class is for potentiometer input to an Arduino, I use it for both rotary and sliding potentiometers.\n
+	 * I also usually include a Power-Indicator-LED with each particular sensor, so the power-line variable actually activates a NPN transistor to supply the VCC voltage to both the LED and Potentiometer from the +5V or +3.3V rail.\n
+	 * The extra pin on there is a supplemental power In/Out to bypass the button and LED. For example a recent project I put together contained two pots wired up in this fashion, originally one sent values ranging from -5.12 to +5.12 to the computer and the other sent the range -3.14 to +3.14. By connecting their supplemental pins I was able to use the other as a strength control \(without the LED confusing which sensor was active\) so that the values sent to the computer could be refined from \(+-\)0.0512 to \(+-\)512.0 and \(+-\)0.0314 to \(+-\)314. 0, allowing for much finer or broader control with ease.
+	 * Here are the prototypes of the Rotary-Pot-Module and Slider-Pot-Module to go with classes in this library. The thought of smaller and smaller electronics is nice, but I like the size of these controls with my chubby-stubby-northern-european-ancestory fingers when mocking up ideas so the Pot-Module-R and Pot-Module-S Gerber files don't include components, just holes for them to go in and I plan to solder the full size components in myself, but might as well share those here too, if you want to update a copy of the gerber file most any factory wouldn't have any trouble stamping these common parts on there for you \(that may not be the case with the dual output slide pots I use, but everything else... definitely\).\n
+	 * <IMG src="../images/pot_circuit.PNG">
+	 * <IMG src="../images/tactile_button_circuit.PNG">\n
+	 * <IMG src="../images/Pot_Module-R.jpg" width="500">
+	 * <A href="../pcb/Gerber_Rotary Pot Module.zip"> Download Gerber Files for Pot-Module-R</A>\n\n
+	 * <IMG src="../images/Pot_Module-S.jpg" width="500">
+	 * <A href="../pcb/Gerber_Slider Pot Module.zip"> Download Gerber Files for Pot-Module-S</A>\n
+	 * @htmlonly
+	 * <iframe src="../pcb/pcb_rotary.html" width="900" height="700">
+	 * </iframe>
+	 <iframe src="../pcb/pcb_slider.html" width="900" height="700">
+	 * </iframe>
+	 * @endhtmlonly
+	 */
+	class Pot: public ControlUnit, public PotReader{
+		public:
+			/**
+			 * The constructor for the sensor.\n
+			 * @param but -the power button connected to the sensor
+			 * @param lin -the power line coming from the Arduino
+			 * @param sig -the Arduino pin the sensor signal will be sent to
+			 */
+			Pot(int but, int lin, int sig): ControlUnit(but, lin, sig){};
+			
+			
+			
+			/**
+			 * The constructor for the sensor.\n
+			 * @param but -the power button connected to the sensor
+			 * @param lin -the power line coming from the Arduino
+			 * @param sig -the Arduino pin the sensor signal will be sent to
+			 * @param val -the reuired time interval that must pass between registering button clicks -in milliseconds
+			 */
+			Pot(int but, int lin, int sig, int val): ControlUnit(but, lin, sig, val){};
+			
+			
+			void begin(void);
+			
+			
+			
+			int getSensorValue(void);
+			
+			
+			/**
+			 * Remaps the potentiometer data to the desired values. \n
+			 * 0 to 1023 is presumed here, as circuits grow more complicated and draw more current these values may change, expanding the range between min and max can adjust for such a drop in input.\n
+			 * The mapping is worked out when the range changes and kept in fixed point \(see LinearMap\), so calling this every pass of loop\(\) with the same range only costs a multiply and a shift.
+			 * @param min -the minimum value the potentiometer input should be mapped to
+			 * @param max -the maximum value the potentiometer input should be mapped to
+			 * @return float
+			 */
+			float mapData(float min, float max);
+			
+			
+			
+			/**
+			 * Remaps the potentiometer data to the desired values. \n
+			 * 0 to 1023 is presumed here, as circuits grow more complicated and draw more current these values may change, expanding the range between min and max can adjust for such a drop in input.\n
+			 * The mapping is worked out when the range changes and kept in fixed point \(see LinearMap\), and rounds to the nearest whole number.
+			 * @param min -the minimum value the potentiometer input should be mapped to
+			 * @param max -the maximum value the potentiometer input should be mapped to
+			 * @return int 
+			 */
+			int mapData(int min, int max);
+			
+			
+			
+			/**
+			 * Maps the potentiometer data through a CurveTable, e.g. to straighten out an audio taper or a worn slide, the table takes the place of the range for toSerial\(\) too.\n
+			 * Each call is one table lookup and an interpolation, whatever the curve.
+			 * @param table -the curve, it has to outlive the Pot
+			 * @return int -in the table's units, for a table with decimals toSerial\(\) prints it with the decimal point put back
+			 */
+			int mapData(const CurveTable& table);
+			
+			
+			
+			void toSerial(void);
+			
+			
+			/**
+			 * Gets a single reading straight from the pot, no oversampling or filtering
+			 * @return int -0 to 1023
+			 */
+			int getRawValue(void);
+		protected:
+			/**
+			 * Prints a reading mapped the same way as the last mapData\(\) call, or 0 when the sensor is off
+			 * @param reading -the reading from getSensorValue\(\)
+			 */
+			void printValue(int reading);
+
+			friend class Sampler;
+	};
+
+
+
+
+	/**
+	 * FastPot is a Pot with its pins fixed at compile time, so checking the Activation Button and switching the power line use FastPin instead of digitalRead\(\)/digitalWrite\(\).\n
+	 * It is still a Pot, so it can go anywhere a Pot can, but the faster isButtonPressed\(\), pollButton\(\), activateControl\(\) and deactivateControl\(\) only apply when they're called on the FastPot itself rather than through a ControlUnit pointer. e.g. FastPot<2, 3, A0> rotary;
+	 * @tparam But -the power button connected to the sensor
+	 * @tparam Lin -the power line coming from the Arduino
+	 * @tparam Sig -the Arduino pin the sensor signal will be sent to
+	 */
+	template<uint8_t But, uint8_t Lin, uint8_t Sig>
+	class FastPot: public Pot{
+		public:
+			/**
+			 * The constructor for the sensor, 250 milliseconds between presses of the button
+			 */
+			FastPot(void): Pot(But, Lin, Sig){};
+
+
+			/**
+			 * The constructor for the sensor.\n
+			 * @param val -the reuired time interval that must pass between registering button clicks -in milliseconds
+			 */
+			FastPot(int val): Pot(But, Lin, Sig, val){};
+
+
+			/**
+			 * Activates the power to this control
+			 */
+			void activateControl(void){
+				Utility::FastPin<Lin>::high();
+			};
+
+
+			/**
+			 * Deactivates the power to this control
+			 */
+			void deactivateControl(void){
+				Utility::FastPin<Lin>::low();
+			};
+
+
+			/**
+			 * Reads the Activation Button right now and toggles the On/Off state if it has just been pressed
+			 */
+			void pollButton(void){
+				debounceButton(Utility::FastPin<But>::read());
+			};
+
+
+			/**
+			 * Checks the Activation Button, as ControlUnit::isButtonPressed\(\)
+			 */
+			void isButtonPressed(void){
+				pollButton();
+			};
+	};
+
+
+
+
+	/**
+	 * The Sampler takes the analogRead\(\) waiting out of loop\(\). Once Pots are attached it keeps the ADC converting in the background, one Pot after another, and files each reading into a small ring buffer for that Pot.\n
+	 * Pot::getSensorValue\(\) on an attached Pot then just hands back the newest reading, it never waits on a conversion.\n
+	 * On AVR boards \(Uno, Nano, Mega, Leonardo\) a sketch with CSF_SAMPLER_ISR\(\) at the top level has each conversion finishing fire the ADC interrupt, which stores the reading and starts the conversion for the next Pot, so there's nothing to call from loop\(\). While the Sampler is running that way don't call analogRead\(\) yourself, it would fight the interrupt for the ADC.\n
+	 * Without CSF_SAMPLER_ISR\(\), on other boards, or on the simulated board in host/sim, call Sampler::service\(\) from loop\(\) or a timer instead, each call reads one Pot.\n
+	 * Everything is static since there's only the one ADC.
+	 */
+	class Sampler{
+		public:
+			static const uint8_t OVERSAMPLING = (CSF_SAMPLER_DEPTH >= 64) ? 3 : (CSF_SAMPLER_DEPTH >= 16) ? 2 : (CSF_SAMPLER_DEPTH >= 4) ? 1 : 0;	///< The most bits of oversampling an attached Pot gets, from the 4^bits readings the history keeps
+
+
+			/**
+			 * Adds a Pot to the channels the Sampler cycles through, call this in setup\(\) after the Pot's begin\(\) and before Sampler::begin\(\)
+			 * @param pot -the Pot, it has to stay around as long as the Sampler runs
+			 * @return int8_t -the channel number, or -1 if all CSF_SAMPLER_CHANNELS are taken or the Pot is on an Expansion::AnalogMux
+			 */
+			static int8_t attach(Pot& pot);
+
+
+			/**
+			 * Adds a Static::Sensors::Pot, or a Static::Sensors::FastPot, as attach\(Pot&\)
+			 * @param pot -the Pot, it has to stay around as long as the Sampler runs
+			 * @return int8_t -the channel number, or -1 if all CSF_SAMPLER_CHANNELS are taken or the Pot is on an Expansion::AnalogMux
+			 */
+			template<class Derived>
+			static int8_t attach(Static::Sensors::BasicPot<Derived>& pot){
+				return attachReader(pot, pot.sensorLine);
+			};
+
+
+			/**
+			 * Starts converting in the background
+			 */
+			static void begin(void);
+
+
+			/**
+			 * Stops converting, attached Pots keep returning their last reading until detached
+			 */
+			static void end(void);
+
+
+			/**
+			 * Detaches every Pot so they go back to calling analogRead\(\), stopping the Sampler first
+			 */
+			static void detachAll(void);
+
+
+			/**
+			 * Getter for the newest reading on a channel
+			 * @param channel -the channel number from attach\(\)
+			 * @return int -0 to 1023
+			 */
+			static int latest(uint8_t channel);
+
+
+			/**
+			 * Copies out the recent readings on a channel, newest first
+			 * @param channel -the channel number from attach\(\)
+			 * @param out -room for n readings
+			 * @param n -the most readings to copy, up to CSF_SAMPLER_DEPTH
+			 * @return uint8_t -how many were copied
+			 */
+			static uint8_t recent(uint8_t channel, uint16_t* out, uint8_t n);
+
+
+			/**
+			 * Files a finished conversion for the current channel and starts on the next one.\n
+			 * The ADC interrupt from CSF_SAMPLER_ISR\(\) calls this, service\(\) calls it otherwise, and a test can call it directly to stand in for the ADC.
+			 * @param reading -the conversion result, 0 to 1023
+			 */
+			static void onConversion(uint16_t reading);
+
+
+			/**
+			 * Marks the conversions as coming from the ADC interrupt, CSF_SAMPLER_ISR\(\) calls this as the sketch starts. From then on begin\(\) turns the interrupt on and service\(\) does nothing
+			 * @param hooked -false to go back to service\(\), as a test might
+			 * @return bool -hooked
+			 */
+			static bool hookInterrupt(bool hooked = true);
+
+
+			/**
+			 * Unless the ADC interrupt is hooked, reads the current channel with analogRead\(\) and moves on to the next
+			 */
+			static void service(void);
+
+
+			/**
+			 * Getter for whether the Sampler is converting
+			 * @return bool
+			 */
+			static bool isRunning(void);
+
+
+			/**
+			 * Getter for whether the Sampler is converting from the ADC interrupt, when nothing else may use the ADC
+			 * @return bool
+			 */
+			static bool isInterruptDriven(void);
+
+
+			/**
+			 * Getter for the number of conversions since begin\(\), it wraps around
+			 * @return unsigned long
+			 */
+			static unsigned long getConversions(void);
+		protected:
+			/**
+			 * Adds the reading half of a Pot to the channels, for both attach\(\) calls
+			 * @param pot -the Pot
+			 * @param sensorLine -the Pot's sensor pin
+			 * @return int8_t -the channel number, or -1
+			 */
+			static int8_t attachReader(PotReader& pot, int sensorLine);
+
+
+			/**
+			 * Points the ADC at the current channel and starts a conversion
+			 */
+			static void startConversion(void);
+
+			static uint8_t channelCount;	///< How many channels are attached
+			static volatile uint8_t current;	///< The channel being converted
+			static volatile bool running;	///< Set between begin\(\) and end\(\)
+			static bool hooked;	///< Set by hookInterrupt\(\)
+			static volatile unsigned long conversions;	///< Conversions since begin\(\)
+			static uint8_t pins[CSF_SAMPLER_CHANNELS];	///< The Arduino pin for each channel
+			static uint8_t adcChannels[CSF_SAMPLER_CHANNELS];	///< The ADC multiplexer channel for each channel
+			static PotReader* pots[CSF_SAMPLER_CHANNELS];	///< The Pot attached to each channel
+			static Utility::HistoryBuffer<uint16_t, CSF_SAMPLER_DEPTH> history[CSF_SAMPLER_CHANNELS];	///< The recent readings for each channel
+	};
+
+
+
+
+	/**
+	 * The int form of a ControlBank mapping: the output is min plus the reading times slope, with slope in 16.16 fixed point
+	 */
+	struct BankIntRange{
+		int32_t slope;	///< Output per reading step, with 16 fraction bits
+		int16_t min;	///< The output for a reading of 0
+	};
+
+
+	/**
+	 * The float form of a ControlBank mapping
+	 */
+	struct BankFloatRange{
+		float slope;	///< Output per reading step
+		float min;	///< The output for a reading of 0
+	};
+
+
+	/**
+	 * One ControlBank mapping, which of the two is in use is kept in the bank's mapping tags
+	 */
+	union BankRange{
+		BankIntRange whole;	///< Used when the tag is BANK_MAP_INT
+		BankFloatRange real;	///< Used when the tag is BANK_MAP_FLOAT
+	};
+
+
+	const uint8_t BANK_MAP_NONE = 0;	///< ControlBank mapping tag, the raw reading
+	const uint8_t BANK_MAP_INT = 1;	///< ControlBank mapping tag, a whole number range
+	const uint8_t BANK_MAP_FLOAT = 2;	///< ControlBank mapping tag, a decimal range
+
+
+
+
+	/**
+	 * The ControlBank holds a lot of Pot style controls in as little RAM as possible, for boards like a Mega running 64 or more sensors.\n
+	 * A Pot keeps int pins, long timestamps, both an int and a float range and a vtable pointer, 50 or so bytes on an AVR. The bank keeps each field in its own array instead: a byte per pin, one bit for on/off, two 16 bit timestamps relative to millis\(\) and an 8 byte union for whichever range mapData\(\) last set, about 15.5 bytes a control. Going through every control in a row reads each array front to back, which is also what a PC's cache does best with.\n
+	 * Controls are numbered in the order add\(\) was called and use the same functions as a Pot, with the number first, e.g. bank.mapData\(3, -100, 100\). togglePressed\(\), syncPowerLines\(\) and emitActive\(\) do a job for every control at once.\n
+	 * Whole number ranges keep their low end in 16 bits and the slope in 32, which covers every range of a 16 bit int on an AVR. Where int is 32 bits the low end is clamped to -32768 to 32767, and a span over about 33 million to what the slope holds.\n
+	 * The interval is the least time from one press of a button to the next, as for a Pot, and each button is left CSF_DEBOUNCE_HOLDOFF to settle after a change. The interval is shared by the whole bank and, being 16 bits, has to be under 65 seconds.
+	 * @tparam N -the most controls the bank holds, up to 256
+	 */
+	template<uint16_t N>
+	class ControlBank{
+		static_assert(N > 0 && N <= 256, "ControlBank holds 1 to 256 controls");
+		public:
+			/**
+			 * The constructor for ControlBank, 250 milliseconds between presses of the buttons
+			 */
+			ControlBank(void): count(0), interval(250){};
+
+
+			/**
+			 * The constructor for ControlBank
+			 * @param val -the least time from one press of a control's button to the next -in milliseconds
+			 */
+			ControlBank(uint16_t val): count(0), interval(val){};
+
+
+			/**
+			 * Adds a control, call begin\(\) once they're all added
+			 * @param but -the power button connected to the sensor
+			 * @param lin -the power line coming from the Arduino
+			 * @param sig -the Arduino pin the sensor signal will be sent to
+			 * @return int -the control's number, or -1 if the bank is full
+			 */
+			int add(uint8_t but, uint8_t lin, uint8_t sig){
+				if(count >= N){
+					return -1;
+				}
+				uint8_t i = count++;
+				powerButtons[i] = but;
+				powerLines[i] = lin;
+				sensorLines[i] = sig;
+				previousTimes[i] = (uint16_t)millis() - CSF_DEBOUNCE_HOLDOFF;	//so the first press isn't held off
+				pressTimes[i] = (uint16_t)millis() - interval;
+				setFlag(onFlags, i, false);
+				setFlag(pressedFlags, i, false);
+				setTag(i, BANK_MAP_NONE);
+				return i;
+			};
+
+
+			/**
+			 * Sets the pin modes for every control, as Pot::begin\(\)
+			 */
+			void begin(void){
+				for(uint16_t i = 0; i < count; i++){
+					Expansion::VirtualPins::setMode(powerButtons[i], INPUT);
+					Expansion::VirtualPins::setMode(powerLines[i], OUTPUT);
+					Expansion::VirtualPins::setMode(sensorLines[i], INPUT);
+				}
+			};
+
+
+			/**
+			 * Getter for the number of controls added
+			 * @return uint16_t
+			 */
+			uint16_t getCount(void) const{
+				return count;
+			};
+
+
+			/**
+			 * Getter for the On/Off state of a control
+			 * @param i -the control's number
+			 * @return bool
+			 */
+			bool getIsSensorOn(uint8_t i) const{
+				return onFlags[i >> 3] & (1 << (i & 0x07));
+			};
+
+
+			/**
+			 * Toggles the On/Off state of a control
+			 * @param i -the control's number
+			 */
+			void toggleIsSensorOn(uint8_t i){
+				onFlags[i >> 3] ^= (1 << (i & 0x07));
+			};
+
+
+			/**
+			 * Activates the power to a control
+			 * @param i -the control's number
+			 */
+			void activateControl(uint8_t i){
+				digitalWrite(powerLines[i], HIGH);
+			};
+
+
+			/**
+			 * Deactivates the power to a control
+			 * @param i -the control's number
+			 */
+			void deactivateControl(uint8_t i){
+				digitalWrite(powerLines[i], LOW);
+			};
+
+
+			/**
+			 * Checks a control's button and toggles the On/Off state once per press, as Pot::isButtonPressed\(\)
+			 * @param i -the control's number
+			 */
+			void isButtonPressed(uint8_t i){
+				pollButton(i);
+			};
+
+
+			/**
+			 * Reads a control's button right now and toggles the On/Off state if it has just been pressed
+			 * @param i -the control's number
+			 */
+			void pollButton(uint8_t i){
+				debounceButton(i, (uint16_t)millis());
+			};
+
+
+			/**
+			 * Reads a control's sensor
+			 * @param i -the control's number
+			 * @return int -0 to 1023
+			 */
+			int getSensorValue(uint8_t i){
+				return Expansion::VirtualPins::readAnalog(sensorLines[i]);
+			};
+
+
+			/**
+			 * Maps a control to a whole number range and takes a reading in it, as Pot::mapData\(\). The range stays set for toSerial\(\) and emitActive\(\).
+			 * @param i -the control's number
+			 * @param min -the value at one end of the pot
+			 * @param max -the value at the other end
+			 * @return int
+			 */
+			int mapData(uint8_t i, int min, int max){
+				if(getTag(i) != BANK_MAP_INT || ranges[i].whole.min != min || toInt(i, 1023) != max){	//the slope is rounded to the nearest 1/65536, close enough that 1023 always maps back to max
+					setTag(i, BANK_MAP_INT);
+					ranges[i].whole.min = intMin(min);
+					ranges[i].whole.slope = intSlope(ranges[i].whole.min, max);
+				}
+				return toInt(i, getSensorValue(i));
+			};
+
+
+			/**
+			 * Maps a control to a decimal range and takes a reading in it, as Pot::mapData\(\). The range stays set for toSerial\(\) and emitActive\(\).
+			 * @param i -the control's number
+			 * @param min -the value at one end of the pot
+			 * @param max -the value at the other end
+			 * @return float
+			 */
+			float mapData(uint8_t i, float min, float max){
+				if(getTag(i) != BANK_MAP_FLOAT || ranges[i].real.min != min || toFloat(i, 1023) != max){	//checked by multiplying so the division only happens when the range changes
+					setTag(i, BANK_MAP_FLOAT);
+					ranges[i].real.min = min;
+					ranges[i].real.slope = (max - min) / 1023.0;
+				}
+				return toFloat(i, getSensorValue(i));
+			};
+
+
+			/**
+			 * Takes a control back to sending the raw reading
+			 * @param i -the control's number
+			 */
+			void clearMapping(uint8_t i){
+				setTag(i, BANK_MAP_NONE);
+			};
+
+
+			/**
+			 * Maps a reading with a control's int range, or hands it back as it is if the control isn't mapped to whole numbers
+			 * @param i -the control's number
+			 * @param reading -0 to 1023
+			 * @return int
+			 */
+			int toInt(uint8_t i, int reading) const{
+				if(getTag(i) != BANK_MAP_INT){
+					return reading;
+				}
+				int32_t slope = ranges[i].whole.slope;
+				int32_t whole = (int32_t)reading * (slope >> 16);	//split so neither product passes 32 bits, the sum is the 64 bit reading * slope exactly
+				uint32_t fraction = (uint32_t)reading * (uint16_t)(slope & 0xFFFF);
+				return (int)(ranges[i].whole.min + whole + (int32_t)((fraction + 0x8000) >> 16));
+			};
+
+
+			/**
+			 * Maps a reading with a control's float range, or hands it back as it is if the control isn't mapped to decimals
+			 * @param i -the control's number
+			 * @param reading -0 to 1023
+			 * @return float
+			 */
+			float toFloat(uint8_t i, int reading) const{
+				if(getTag(i) != BANK_MAP_FLOAT){
+					return reading;
+				}
+				return ranges[i].real.min + reading * ranges[i].real.slope;
+			};
+
+
+			/**
+			 * Prints a control's reading, mapped the way its last mapData\(\) call asked, or 0 when it's off, as Pot::toSerial\(\)
+			 * @param i -the control's number
+			 */
+			void toSerial(uint8_t i){
+				printValue(i, getIsSensorOn(i) ? getSensorValue(i) : 0);
+			};
+
+
+			/**
+			 * Checks every control's button and toggles the ones that have just been pressed, isButtonPressed\(\) for the whole bank with a single millis\(\) call
+			 * @return uint16_t -how many controls were toggled
+			 */
+			uint16_t togglePressed(void){
+				uint16_t now = (uint16_t)millis();
+				uint16_t toggled = 0;
+				for(uint16_t i = 0; i < count; i++){
+					if(debounceButton(i, now)){
+						toggled++;
+					}
+				}
+				return toggled;
+			};
+
+
+			/**
+			 * Drives every control's power line to match its On/Off state
+			 */
+			void syncPowerLines(void){
+				for(uint16_t i = 0; i < count; i++){
+					digitalWrite(powerLines[i], getIsSensorOn(i) ? HIGH : LOW);
+				}
+			};
+
+
+			/**
+			 * Reads and prints every control that's switched on, a line each of its number and its mapped reading, e.g. "3 -42"
+			 * @return uint16_t -how many controls were printed
+			 */
+			uint16_t emitActive(void){
+				uint16_t sent = 0;
+				for(uint8_t byteIndex = 0; byteIndex * 8 < count; byteIndex++){
+					uint8_t on = onFlags[byteIndex];
+					for(uint8_t bit = 0; on != 0; bit++, on >>= 1){
+						if(on & 0x01){
+							uint8_t i = byteIndex * 8 + bit;
+							Serial.print(i);
+							Serial.print(' ');
+							printValue(i, getSensorValue(i));
+							sent++;
+						}
+					}
+				}
+				return sent;
+			};
+
+
+			/**
+			 * Getter for how many controls are switched on
+			 * @return uint16_t
+			 */
+			uint16_t getActiveCount(void) const{
+				uint16_t active = 0;
+				for(uint8_t byteIndex = 0; byteIndex * 8 < count; byteIndex++){
+					for(uint8_t on = onFlags[byteIndex]; on != 0; on &= on - 1){
+						active++;
+					}
+				}
+				return active;
+			};
+		protected:
+			/**
+			 * Prints a reading mapped the way the control's last mapData\(\) call asked
+			 * @param i -the control's number
+			 * @param reading -the reading, or 0 when the control is off
+			 */
+			void printValue(uint8_t i, int reading){
+				uint8_t tag = getTag(i);
+				if(tag == BANK_MAP_INT){
+					Serial.println(getIsSensorOn(i) ? toInt(i, reading) : 0);
+				}
+				else if(tag == BANK_MAP_FLOAT){
+					Serial.println(getIsSensorOn(i) ? toFloat(i, reading) : 0.0);
+				}
+				else{
+					Serial.println(getIsSensorOn(i) ? reading : 0);
+				}
+			};
+
+
+			/**
+			 * Works out the 16.16 fixed point slope for an int range, rounded to nearest, in 64 bits since the span times 65536 passes 32 bits from a span of 32768
+			 * @param min -the value for a reading of 0
+			 * @param max -the value for a reading of 1023, a span too steep for the 32 bit slope, over 33 million, is clamped
+			 * @return int32_t
+			 */
+			static int32_t intSlope(int min, int max){
+				int64_t span = ((int64_t)max - min) * 65536;
+				int64_t slope = (span + (span >= 0 ? 511 : -511)) / 1023;
+				const int64_t LARGEST = 0x7FFFFFFFL;
+				return slope > LARGEST ? (int32_t)LARGEST : (slope < -LARGEST ? (int32_t)-LARGEST : (int32_t)slope);
+			};
+
+
+			/**
+			 * Clamps the value for a reading of 0 to what BankIntRange::min holds, it always fits on an AVR
+			 * @param min -the value for a reading of 0
+			 * @return int16_t
+			 */
+			static int16_t intMin(int min){
+				return (int16_t)constrain((long)min, -32768L, 32767L);
+			};
+
+
+			/**
+			 * Gets a control's mapping tag
+			 * @param i -the control's number
+			 * @return uint8_t -BANK_MAP_NONE, BANK_MAP_INT or BANK_MAP_FLOAT
+			 */
+			uint8_t getTag(uint8_t i) const{
+				return (tags[i >> 2] >> ((i & 0x03) * 2)) & 0x03;
+			};
+
+
+			/**
+			 * Sets a control's mapping tag
+			 * @param i -the control's number
+			 * @param tag -BANK_MAP_NONE, BANK_MAP_INT or BANK_MAP_FLOAT
+			 */
+			void setTag(uint8_t i, uint8_t tag){
+				uint8_t shift = (i & 0x03) * 2;
+				tags[i >> 2] = (tags[i >> 2] & ~(0x03 << shift)) | (tag << shift);
+			};
+
+
+			/**
+			 * Debounces a control's button, locking on the first edge and holding off for CSF_DEBOUNCE_HOLDOFF after each change with presses at least the interval apart, and toggles the On/Off state on a press
+			 * @param i -the control's number
+			 * @param now -the low 16 bits of millis\(\)
+			 * @return bool -true if it was toggled
+			 */
+			bool debounceButton(uint8_t i, uint16_t now){
+				bool level = Expansion::VirtualPins::readDigital(powerButtons[i]) == HIGH;
+				bool pressed = (pressedFlags[i >> 3] & (1 << (i & 0x07))) != 0;
+				if(level == pressed || (uint16_t)(now - previousTimes[i]) < CSF_DEBOUNCE_HOLDOFF){
+					return false;
+				}
+				if(level && (uint16_t)(now - pressTimes[i]) < interval){
+					return false;	//too soon after the last press, taken once the interval is up if it's still held
+				}
+				setFlag(pressedFlags, i, level);
+				previousTimes[i] = now;
+				if(level){
+					pressTimes[i] = now;
+					toggleIsSensorOn(i);
+				}
+				return level;
+			};
+
+
+			/**
+			 * Sets or clears one bit in a packed array of flags
+			 * @param flags -the array
+			 * @param i -the control's number
+			 * @param value -the new bit
+			 */
+			static void setFlag(uint8_t* flags, uint8_t i, bool value){
+				if(value){
+					flags[i >> 3] |= (1 << (i & 0x07));
+				}
+				else{
+					flags[i >> 3] &= ~(1 << (i & 0x07));
+				}
+			};
+
+			uint16_t count;	///< How many controls have been added
+			uint16_t interval;	///< The least milliseconds from one press of a control's button to the next
+			uint8_t powerButtons[N];	///< Power button pin for each control
+			uint8_t powerLines[N];	///< Power line pin for each control
+			uint8_t sensorLines[N];	///< Sensor pin for each control
+			uint16_t previousTimes[N];	///< The low 16 bits of millis\(\) when each control's button last changed
+			uint16_t pressTimes[N];	///< The low 16 bits of millis\(\) when each control's button was last pressed
+			uint8_t onFlags[(N + 7) / 8];	///< On/Off state, one bit per control
+			uint8_t pressedFlags[(N + 7) / 8];	///< The debounced state of each control's button, one bit per control
+			uint8_t tags[(N + 3) / 4];	///< Which member of ranges is in use, two bits per control
+			BankRange ranges[N];	///< The range each control maps to
+	};
+
+
+}
+
+
+
+
+
+
+
+
+
+
+
+/**
+ * The Switches namesapce is for activation/deactivation controls which typically require more than merely reading the level coming to an Arduino pin
+ */
+namespace Switches{
+	
+	
+	/**
+	 * This is the parent object for tactile switches and touch sensors which will essentially be used as On/Off switches.\n
+	 * Essentially this just returns the On/Off state of the switch/sensor as an int \(1 when pressed, 0 otherwise\).\n
+	 * getState\(\) on a Button is the pin as it is right now. poll\(\), and getState\(\) on the subclasses, go through a Utility::Debouncer instead, which also picks out presses, releases, clicks, double clicks and long presses for getEvents\(\).\n
+	 * getState\(\) and poll\(\) are virtual, so toSerialOnChange\(\), and the streamers, queues and managers that hold a Button, get the debounced state from a Momentary or Touch and the bank's from a BankButton or MatrixKey.
+	 */
+	class Button{
+		public:
+			/**
+			 * The constructor for ControlButton class
+			 * @param p -The Arduino pin the momentary-switch/touch-sensor is connected to
+			 */
+			Button(int p);
+
+
+			/**
+			 * The destructor for Button, virtual so a button made with new can be deleted through a Button*
+			 */
+			virtual ~Button(void){};
+			
+			
+			/**
+			 * Initializes all variables and assigns INPUT/OUTPUT to the connections on the scale controls, i.e. the pinMode\(i, m\) method for Arduino\n
+			 * Call this method in the setup\(\) method in the .ino file
+			 */
+			void begin(void);
+			
+			
+			
+			/**
+			 * gets the current state of the button 
+			 * @return int -a 1 if currently being pressed/touched, and 0 otherwise
+			 */
+			virtual int getState();
+			
+			
+			
+			/**
+			 * gets the current state of the button 
+			 * @param condition -a boolean approving the activation of this button \(for example, I often combine features to a common potentiometer, and want to be certain that the other use of the sensor is not running before I turn this one on\). In most cases just pass in the word true though.
+			 * @return int -a 1 if currently being pressed/touched, and 0 otherwise
+			 */
+			int getState(bool condition);
+			
+			
+			/**
+			 * I often find my ideas for Arduino projects are input devices (essentially a customized keyboard or mouse override) for software running on my PC. This is typically handled with bits of code written in python making use of the libraries pyserial and pyautogui.\n
+			 * This method is encapsulates sending the data to the serial port for that purpose, in this case it sends a true/false value to represent whether the button is currently activated \(pressed or touched, etc.\) or not.\n
+			 * see getState\(\) about the overloading
+			 */
+			void toSerial(void);
+			
+			
+			/**
+			 * I often find my ideas for Arduino projects are input devices (essentially a customized keyboard or mouse override) for software running on my PC. This is typically handled with bits of code written in python making use of the libraries pyserial and pyautogui.\n
+			 * This method is encapsulates sending the data to the serial port for that purpose, in this case it sends a true/false value to represent whether the button is currently activated \(pressed or touched, etc.\) or not.\n
+			 * see getState\(\) about the overloading
+			 */
+			void toSerial(bool condition);
+			
+			
+			/**
+			 * Reads the button through the debouncer and keeps the state for getLastState\(\), Scheduling::ControlManager calls this on its own schedule
+			 */
+			virtual void poll(void);
+			
+			
+			/**
+			 * gets the state of the button as of the last read through the debouncer, by poll\(\) or a subclass's getState\(\), without reading the pin again
+			 * @return int -a 1 if it was being pressed/touched, and 0 otherwise
+			 */
+			int getLastState(void);
+			
+			
+			/**
+			 * Getter for the Arduino pin the button is connected to
+			 * @return int
+			 */
+			int getPin(void);
+			
+			
+			/**
+			 * Report-by-exception version of toSerial\(\): it only sends when the button is pressed or released, or the heartbeat is due.\n
+			 * Each line sent starts with a sequence number and a space, e.g. "18 1", the sequence going up by one per line \(wrapping at 255\) so the computer can spot a missing line. See setReportByException\(\).
+			 * @return bool -true if a line was sent
+			 */
+			bool toSerialOnChange(void);
+
+
+			/**
+			 * toSerialOnChange\(\) with a state that has just been read, e.g. getLastState\(\) after poll\(\)
+			 * @param state -1 while pressed, 0 otherwise
+			 * @return bool -true if a line was sent
+			 */
+			bool toSerialOnChange(int state);
+			
+			
+			/**
+			 * Sets how often toSerialOnChange\(\) resends an unchanged state
+			 * @param heartbeat -milliseconds after which the state is sent even if it hasn't changed, 0 for never
+			 */
+			void setReportByException(unsigned int heartbeat);
+
+
+			/**
+			 * Gets the debouncer's events since the last call and clears them, e.g. if\(button.getEvents\(\) & Utility::Debouncer::DOUBLE_CLICKED\)
+			 * @return uint8_t -Utility::Debouncer event bits
+			 */
+			uint8_t getEvents(void);
+
+
+			/**
+			 * Getter for the debouncer, to set its hold-off and click timing
+			 * @return Utility::Debouncer&
+			 */
+			Utility::Debouncer& getDebouncer(void);
+
+
+			#if CSF_CONTROLS_STATS
+			/**
+			 * Getter for this control's counters
+			 * @return Utility::ControlStats& -the stats command resets them through this
+			 */
+			Utility::ControlStats& getStats(void);
+			#endif
+		protected:
+			/**
+			 * Runs a reading through the debouncer, keeping its events for getEvents\(\)
+			 * @param level -what was read from the pin
+			 * @return int -the debounced state, 1 while pressed
+			 */
+			int debounce(int level);
+
+			Utility::ChangeTracker tracker;	///< Decides when toSerialOnChange\(\) sends
+			#if CSF_CONTROLS_STATS
+			Utility::ControlStats stats;	///< Counters for the stats command
+			#endif
+			Utility::Debouncer debouncer;	///< Cleans up the reads for poll\(\) and the subclasses' getState\(\)
+			uint8_t events;	///< Debouncer events not yet taken by getEvents\(\)
+			int pin;	///<The arduino pin the button/touch-sensor is connected to
+			int lastState;	///<The state read by the last poll\(\)
+	};
+
+
+
+
+
+
+
+
+
+
+	/**
+	 * The subclass of Button specialized for Taactile-Momentary-Switches. If such a setup is used as a regular "Button" make sure to include a timer to avoid spamming the On/Off states at every pulse of the processor's clock.\n
+	 * <IMG src="../images/tactile_button_circuit.png">
+	 */
+	class Momentary: public Button{
+		public:
+			/**
+			 * The constructor for Momentary objects.
+			 * @param p -the Arduino pin the signal from the tactile-momentary-switch will be received on
+			 */
+			Momentary(int p): Button(p){};
+			
+			
+			/**
+			 * The constructor for Momentary objects.
+			 * @param p -the Arduino pin the signal from the tactile-momentary-switch will be received on
+			 * @param val -the required time interval that must pass between registering button presses -in milliseconds, the release is seen as soon as it settles
+			 */
+			Momentary(int p, int val): Button(p){debouncer.setLockout(val);};
+			
+			
+			
+			/**
+			 * Overrides getState\(\) from Button class, reading the button through the debouncer: it's 1 from the moment a press is seen until the release, and never flickers with contact bounce
+			 * @return int -a 1 if currently being pressed/touched, and 0 otherwise
+			 */
+			int getState(void);
+
+
+			/**
+			 * Overrides getState\(\) from Button class, reading the button through the debouncer
+			 * @param condition -a boolean approving the activation of this button \(for example, I often combine features to a common sensor when they won't overlap, and want to be certain that the other use of the sensor is not running before I turn this one on\). In most cases just pass in the word true though.
+			 * @return int -a 1 if currently being pressed/touched and the condition is met, and 0 otherwise
+			 */
+			int getState(bool condition);
+	};
+
+
+	/**
+	 * The subclass of Button specialized for Capacitive-Touch-Sensor-Modules. If such a setup is used as a regular "Button" make sure to include a timer to avoid spamming the On/Off states at every pulse of the processor's clock.\n
+	 * This is what I use this with the prebuilt capacitive touch sensor modules, and not a custom capacitive touch sensor. For bare electrodes without a module, give it a pin from an Expansion::CapSense, e.g. Touch pad\(caps.pin\(0\)\); and getState\(\) reads the electrode the CapSense measured.
+	 */
+	class Touch: public Button{
+		public:
+			/**
+			 * The constructor for Touch objects.
+			 * @param p -the Arduino pin the signal from the capacitive-touch-sensor-module will be received on
+			 */
+			Touch(int p): Button(p){};
+			
+			
+			
+			/**
+			 * The constructor for Touch objects.
+			 * @param p -the Arduino pin the signal from the tactile-momentary-switch will be received on
+			 * @param val -the required time interval that must pass between registering button presses -in milliseconds, the release is seen as soon as it settles
+			 */
+			Touch(int p, int val): Button(p){debouncer.setLockout(val);};
+			
+			
+			/**
+			 * Overrides getState\(\) from Button class, reading the touch sensor through the debouncer: it's 1 from the moment a press is seen until the release, and never flickers with contact bounce
+			 * @return int -a 1 if currently being pressed/touched, and 0 otherwise
+			 */
+			int getState(void);
+
+
+			/**
+			 * Overrides getState\(\) from Button class, reading the touch sensor through the debouncer
+			 * @param condition -a boolean approving the activation of this button \(for example, I often combine features to a common sensor when they won't overlap, and want to be certain that the other use of the sensor is not running before I turn this one on\). In most cases just pass in the word true though.
+			 * @return int -a 1 if currently being pressed/touched and the condition is met, and 0 otherwise
+			 */
+			int getState(bool condition);
+	};
+
+
+
+
+
+	/**
+	 * FastButton is a Button with its pin fixed at compile time, reading it with FastPin instead of digitalRead\(\). e.g. FastButton<7> clicker;\n
+	 * The faster methods only apply when called on the FastButton itself rather than through a Button pointer.
+	 * @tparam P -the Arduino pin the momentary-switch/touch-sensor is connected to
+	 */
+	template<uint8_t P>
+	class FastButton: public Button{
+		public:
+			/**
+			 * The constructor for FastButton
+			 */
+			FastButton(void): Button(P){};
+
+
+			/**
+			 * Sets the pin as an input, call this in setup\(\)
+			 */
+			void begin(void){
+				Utility::FastPin<P>::input();
+			};
+
+
+			/**
+			 * gets the current state of the button
+			 * @return int -a 1 if currently being pressed/touched, and 0 otherwise
+			 */
+			int getState(void){
+				int state = Utility::FastPin<P>::read();
+				CSF_STAT(stats.sample(state));
+				return state;
+			};
+
+
+			/**
+			 * gets the current state of the button
+			 * @param condition -a boolean approving the activation of this button, see Button::getState\(bool\)
+			 * @return int -a 1 if currently being pressed/touched, and 0 otherwise or if condition is false
+			 */
+			int getState(bool condition){
+				return condition ? getState() : 0;
+			};
+
+
+			/**
+			 * Sends the button state to the serial port, as Button::toSerial\(\)
+			 */
+			void toSerial(void){
+				Serial.println(getState());
+				CSF_STAT(stats.emit());
+			};
+
+
+			/**
+			 * Reads the button through the debouncer and keeps the state for getLastState\(\)
+			 */
+			void poll(void){
+				lastState = debounce(Utility::FastPin<P>::read());
+			};
+	};
+
+
+
+
+	/**
+	 * FastMomentary is a Momentary with its pin fixed at compile time, reading it with FastPin instead of digitalRead\(\). e.g. FastMomentary<2> clicker;\n
+	 * The faster methods only apply when called on the FastMomentary itself rather than through a Button pointer.
+	 * @tparam P -the Arduino pin the signal from the tactile-momentary-switch will be received on
+	 */
+	template<uint8_t P>
+	class FastMomentary: public Momentary{
+		public:
+			/**
+			 * The constructor for FastMomentary
+			 */
+			FastMomentary(void): Momentary(P){};
+
+
+			/**
+			 * The constructor for FastMomentary
+			 * @param val -the least time from one press to the next -in milliseconds, see Momentary
+			 */
+			FastMomentary(int val): Momentary(P, val){};
+
+
+			/**
+			 * Sets the pin as an input, call this in setup\(\)
+			 */
+			void begin(void){
+				Utility::FastPin<P>::input();
+			};
+
+
+			/**
+			 * Reads the button through the debouncer, as Momentary::getState\(\)
+			 * @return int -a 1 if currently being pressed, and 0 otherwise
+			 */
+			int getState(void){
+				return debounce(Utility::FastPin<P>::read());
+			};
+
+
+			/**
+			 * Reads the button through the debouncer, as Momentary::getState\(bool\)
+			 * @param condition -a boolean approving the activation of this button
+			 * @return int -a 1 if currently being pressed, and 0 otherwise
+			 */
+			int getState(bool condition){
+				int state = getState();
+				return condition ? state : 0;
+			};
+
+
+			/**
+			 * Reads the button through the debouncer and keeps the state for getLastState\(\)
+			 */
+			void poll(void){
+				lastState = getState();
+			};
+	};
+
+
+
+
+	/**
+	 * FastTouch is a Touch with its pin fixed at compile time, reading it with FastPin instead of digitalRead\(\). e.g. FastTouch<5> zone;\n
+	 * The faster methods only apply when called on the FastTouch itself rather than through a Button pointer.
+	 * @tparam P -the Arduino pin the signal from the capacitive-touch-sensor-module will be received on
+	 */
+	template<uint8_t P>
+	class FastTouch: public Touch{
+		public:
+			/**
+			 * The constructor for FastTouch
+			 */
+			FastTouch(void): Touch(P){};
+
+
+			/**
+			 * The constructor for FastTouch
+			 * @param val -the least time from one press to the next -in milliseconds, see Momentary
+			 */
+			FastTouch(int val): Touch(P, val){};
+
+
+			/**
+			 * Sets the pin as an input, call this in setup\(\)
+			 */
+			void begin(void){
+				Utility::FastPin<P>::input();
+			};
+
+
+			/**
+			 * Reads the sensor through the debouncer, as Touch::getState\(\)
+			 * @return int -a 1 if currently being touched, and 0 otherwise
+			 */
+			int getState(void){
+				return debounce(Utility::FastPin<P>::read());
+			};
+
+
+			/**
+			 * Reads the sensor through the debouncer, as Touch::getState\(bool\)
+			 * @param condition -a boolean approving the activation of this button
+			 * @return int -a 1 if currently being touched, and 0 otherwise
+			 */
+			int getState(bool condition){
+				int state = getState();
+				return condition ? state : 0;
+			};
+
+
+			/**
+			 * Reads the sensor through the debouncer and keeps the state for getLastState\(\)
+			 */
+			void poll(void){
+				lastState = getState();
+			};
+	};
+
+
+
+
+	/**
+	 * The ButtonBank debounces a whole panel of buttons at once. Instead of each Button calling digitalRead\(\) on its own pin with its own timer, tick\(\) reads each GPIO port the buttons sit on in one go and debounces all 8 bits of the port side by side.\n
+	 * The debouncing is a vertical counter: each bit has a two bit counter spread across two bytes, and a handful of bitwise operations per port count every bit that differs from its debounced state. A bit has to read the same for 4 ticks in a row before its state flips, so tick\(\) every 5 milliseconds or so gives 20 milliseconds of debounce.\n
+	 * Buttons are numbered by bank bit, 8 per port in the order the ports were first attached, e.g. on an Uno pins 2 and 3 attached first are bits 2 and 3 of the bank. The state and edges come back as bitmasks on those numbers, and a BankButton gives the usual Button interface for one of them.
+	 */
+	class ButtonBank{
+		public:
+			/**
+			 * The constructor for ButtonBank, it starts out with no buttons
+			 */
+			ButtonBank(void);
+
+
+			/**
+			 * Adds a button to the bank, call this in setup\(\) before begin\(\)
+			 * @param p -the Arduino pin the button is connected to
+			 * @return int8_t -the bank bit for the button, or -1 if its port would be past CSF_BANK_PORTS
+			 */
+			int8_t attach(uint8_t p);
+
+
+			/**
+			 * Adds a button to the bank
+			 * @param p -the Arduino pin the button is connected to
+			 * @param activeLow -true for a button wired to ground with INPUT_PULLUP, so LOW reads as pressed
+			 * @return int8_t -the bank bit for the button, or -1 if its port would be past CSF_BANK_PORTS or it's a virtual pin
+			 */
+			int8_t attach(uint8_t p, bool activeLow);
+
+
+			/**
+			 * Adds a Button's pin to the bank
+			 * @param button -the button
+			 * @return int8_t -the bank bit for the button, or -1 if its port would be past CSF_BANK_PORTS
+			 */
+			int8_t attach(Button& button);
+
+
+			/**
+			 * Sets the attached pins as inputs and takes their current levels as the starting debounced state, call this in setup\(\)
+			 */
+			void begin(void);
+
+
+			/**
+			 * Place in loop\(\) or call from a timer, reads each port once and steps the debounce counters
+			 */
+			void tick(void);
+
+
+			/**
+			 * Getter for the bank bit of a pin
+			 * @param p -the Arduino pin
+			 * @return int8_t -the bank bit, or -1 if the pin isn't attached
+			 */
+			int8_t bitOf(uint8_t p);
+
+
+			/**
+			 * Gets the debounced state of every button
+			 * @return uint32_t -bit n set when bank bit n is pressed
+			 */
+			uint32_t getState(void);
+
+
+			/**
+			 * Gets the debounced state of one button
+			 * @param bit -the bank bit
+			 * @return bool
+			 */
+			bool isPressed(uint8_t bit);
+
+
+			/**
+			 * Gets the buttons pressed since the last call, and clears them
+			 * @return uint32_t -bit n set when bank bit n has been pressed
+			 */
+			uint32_t takePressed(void);
+
+
+			/**
+			 * Gets the buttons released since the last call, and clears them
+			 * @return uint32_t -bit n set when bank bit n has been released
+			 */
+			uint32_t takeReleased(void);
+		protected:
+			/**
+			 * Finds the lane for a port, adding it if there is room
+			 * @param port -the port number from digitalPinToPort\(\)
+			 * @return int8_t -the lane, or -1 when full
+			 */
+			int8_t laneFor(uint8_t port);
+
+			uint8_t laneCount;	///< How many ports are attached
+			uint8_t portNumbers[CSF_BANK_PORTS];	///< The port number of each lane
+			volatile uint8_t* inputs[CSF_BANK_PORTS];	///< The input register of each lane
+			uint8_t masks[CSF_BANK_PORTS];	///< The attached bits of each lane
+			uint8_t inverts[CSF_BANK_PORTS];	///< The active low bits of each lane
+			uint8_t states[CSF_BANK_PORTS];	///< The debounced state of each lane
+			uint8_t counts0[CSF_BANK_PORTS];	///< Low bits of the vertical counters
+			uint8_t counts1[CSF_BANK_PORTS];	///< High bits of the vertical counters
+			uint8_t pressed[CSF_BANK_PORTS];	///< Presses not yet taken
+			uint8_t released[CSF_BANK_PORTS];	///< Releases not yet taken
+	};
+
+
+
+
+	/**
+	 * BankButton is a Button that reads its debounced state from a ButtonBank instead of the pin, so code written for a Button works unchanged on a button in a bank.\n
+	 * The bank does the reading and debouncing in its tick\(\), getState\(\) just picks out this button's bit. As with the Fast variants, call it on the BankButton itself rather than through a Button pointer.
+	 */
+	class BankButton: public Button{
+		public:
+			/**
+			 * The constructor for BankButton
+			 * @param bank -the bank the button is attached to, it has to outlive the button
+			 * @param p -the Arduino pin the button is connected to
+			 */
+			BankButton(ButtonBank& bank, int p): Button(p), bank(bank), bankBit(-1){};
+
+
+			/**
+			 * Attaches the pin to the bank, call this in setup\(\) before the bank's begin\(\)
+			 */
+			void begin(void);
+
+
+			/**
+			 * gets the debounced state of the button
+			 * @return int -a 1 if currently being pressed, and 0 otherwise
+			 */
+			int getState(void);
+
+
+			/**
+			 * gets the debounced state of the button
+			 * @param condition -a boolean approving the activation of this button, see Button::getState\(bool\)
+			 * @return int -a 1 if currently being pressed, and 0 otherwise or if condition is false
+			 */
+			int getState(bool condition);
+
+
+			/**
+			 * Sends the debounced state to the serial port, as Button::toSerial\(\)
+			 */
+			void toSerial(void);
+
+
+			/**
+			 * Keeps the debounced state for getLastState\(\), and picks the clicks and long presses out of it for getEvents\(\)
+			 */
+			void poll(void);
+		protected:
+			ButtonBank& bank;	///< The bank doing the reading
+			int8_t bankBit;	///< This button's bit in the bank, -1 until begin\(\)
+	};
+
+
+
+
+	/**
+	 * One edge on a button pin, as captured by EventCapture
+	 */
+	struct EdgeEvent{
+		uint8_t pin;	///< The Arduino pin
+		uint8_t level;	///< HIGH if the pin went up, LOW if it went down
+		unsigned long time;	///< micros\(\) when the edge was captured
+	};
+
+
+
+
+	/**
+	 * EventCapture catches every edge on button pins with interrupts, so no press is lost however short it is or however long loop\(\) takes to come around.\n
+	 * The interrupt stamps each edge with micros\(\) and pushes it onto a queue, and loop\(\) takes them off in batches with drain\(\) whenever it gets to it. If loop\(\) falls so far behind that the queue fills up, CSF_EVENT_QUEUE - 1 edges, later edges are counted in getOverflows\(\) instead of overwriting earlier ones.\n
+	 * attach\(\) uses attachInterrupt\(\), so it takes pins with an external interrupt: 2 and 3 on an Uno, 2, 3, 18, 19, 20, 21 on a Mega, any pin on most 32 bit boards. Pin change interrupts aren't hooked here since libraries such as SoftwareSerial own those vectors, but a sketch's own pin change ISR \(or a test standing in for the hardware\) can feed edges in through capture\(\).\n
+	 * Everything is static since the interrupts need somewhere fixed to put the edges.
+	 */
+	class EventCapture{
+		public:
+			/**
+			 * Starts capturing edges on a button's pin
+			 * @param button -the button
+			 * @return bool -false if the pin has no external interrupt or all CSF_EVENT_PINS are taken
+			 */
+			static bool attach(Button& button);
+
+
+			/**
+			 * Starts capturing edges on a pin
+			 * @param p -the Arduino pin
+			 * @return bool -false if the pin has no external interrupt, is a virtual pin, or all CSF_EVENT_PINS are taken
+			 */
+			static bool attach(uint8_t p);
+
+
+			/**
+			 * Stops capturing on every pin and empties the queue
+			 */
+			static void detachAll(void);
+
+
+			/**
+			 * Queues an edge stamped with the current micros\(\). The attached interrupts call this, and so can a pin change ISR in the sketch or a test injecting edges
+			 * @param p -the Arduino pin
+			 * @param level -HIGH or LOW, the level the pin changed to
+			 */
+			static void capture(uint8_t p, uint8_t level);
+
+
+			/**
+			 * Takes waiting edges off the queue, oldest first
+			 * @param events -room for max edges
+			 * @param max -the most edges to take
+			 * @return uint8_t -how many were taken
+			 */
+			static uint8_t drain(EdgeEvent* events, uint8_t max);
+
+
+			/**
+			 * Gets the number of edges waiting
+			 * @return uint8_t
+			 */
+			static uint8_t available(void);
+
+
+			/**
+			 * Gets the number of edges lost because the queue was full, it wraps around
+			 * @return uint16_t
+			 */
+			static uint16_t getOverflows(void);
+
+
+			/**
+			 * Called by the interrupt for an attached slot, a slot nothing is attached in is ignored
+			 * @param slot -the slot the pin was attached in
+			 */
+			static void onInterrupt(uint8_t slot);
+		protected:
+			static uint8_t pinCount;	///< How many pins are attached
+			static uint8_t pins[CSF_EVENT_PINS];	///< The pin attached in each slot
+			static Utility::RingBuffer<EdgeEvent, CSF_EVENT_QUEUE> queue;	///< Edges waiting for drain\(\)
+	};
+
+
+
+
+	/**
+	 * One key going down or up in a KeyMatrix
+	 */
+	struct KeyEvent{
+		uint8_t key;	///< The key number, see KeyMatrix::keyOf\(\)
+		uint8_t pressed;	///< 1 when the key went down, 0 when it came up
+		unsigned long time;	///< micros\(\) at the start of the scan that saw it
+	};
+
+
+
+
+	/**
+	 * The KeyMatrix reads a grid of keys wired in rows and columns, so a panel of 100 keys needs 20 pins rather than 100.\n
+	 * A scan pulls each row low in turn, the other rows left floating, and reads the columns, which have their pull-ups on, so a pressed key reads LOW in its column. The column pins are grouped by GPIO port and each port is read once per row however many columns it has, so put the columns on as few ports as the board allows.\n
+	 * Each row's keys are debounced side by side with vertical counters, as in ButtonBank: two bits of counter per key, kept in two words per row, so a key has to read the same for 4 scans in a row before it changes. Scanning every 5 milliseconds \(the default for update\(\)\) gives 20 milliseconds of debounce. Every change goes into a queue stamped with the time of the scan, for loop\(\) to take off with drain\(\).\n
+	 * Without a diode on every key, three keys held at the corners of a rectangle make the fourth corner read as pressed too. A scan where two rows read two or more columns in common can't tell which keys are real, so those keys are blocked: they keep their state until the scan is unambiguous again, and isGhosted\(\) says so. With diodes fitted, setDiodes\(\) turns the check off.\n
+	 * A MatrixKey gives the usual Button interface for one key.
+	 */
+	class KeyMatrix{
+		public:
+			/**
+			 * The constructor for KeyMatrix, it starts out with no rows or columns
+			 */
+			KeyMatrix(void);
+
+
+			/**
+			 * Adds a row, call this in setup\(\) before begin\(\)
+			 * @param p -the Arduino pin the row is connected to
+			 * @return int8_t -the row number, or -1 if all CSF_MATRIX_ROWS are taken
+			 */
+			int8_t addRow(uint8_t p);
+
+
+			/**
+			 * Adds a column, call this in setup\(\) before begin\(\)
+			 * @param p -the Arduino pin the column is connected to
+			 * @return int8_t -the column number, or -1 if all CSF_MATRIX_COLUMNS are taken or it's a virtual pin
+			 */
+			int8_t addColumn(uint8_t p);
+
+
+			/**
+			 * Lets go of the rows, turns the pull-ups on for the columns and clears every key, call this in setup\(\)
+			 */
+			void begin(void);
+
+
+			/**
+			 * Place in loop\(\), scans when the interval has passed
+			 * @return bool -true if it scanned
+			 */
+			bool update(void);
+
+
+			/**
+			 * Scans every row now and steps the debounce counters, for calling from a timer or a ControlManager task
+			 */
+			void scan(void);
+
+
+			/**
+			 * Sets how often update\(\) scans
+			 * @param ms -milliseconds between scans, 5 unless set
+			 */
+			void setInterval(unsigned int ms);
+
+
+			/**
+			 * Sets how long a row is held low before the columns are read, for long wires where the pull-ups need a moment to bring a column back up
+			 * @param us -microseconds, 0 unless set
+			 */
+			void setSettle(uint8_t us);
+
+
+			/**
+			 * Says whether every key has a diode, which makes ghosting impossible so the check is skipped
+			 * @param fitted -true if there are diodes
+			 */
+			void setDiodes(bool fitted);
+
+
+			/**
+			 * Gets the number of a key, add every row and column before using key numbers
+			 * @param row -the row number from addRow\(\)
+			 * @param column -the column number from addColumn\(\)
+			 * @return uint8_t -row times the number of columns, plus column
+			 */
+			uint8_t keyOf(uint8_t row, uint8_t column);
+
+
+			/**
+			 * Gets the debounced state of one key
+			 * @param key -the key number
+			 * @return bool
+			 */
+			bool isPressed(uint8_t key);
+
+
+			/**
+			 * Gets the debounced state of one row
+			 * @param row -the row number
+			 * @return uint16_t -bit n set when the key in column n is pressed
+			 */
+			uint16_t getRow(uint8_t row);
+
+
+			/**
+			 * Takes waiting key events off the queue, oldest first
+			 * @param events -room for max events
+			 * @param max -the most events to take
+			 * @return uint8_t -how many were taken
+			 */
+			uint8_t drain(KeyEvent* events, uint8_t max);
+
+
+			/**
+			 * Gets the number of key events waiting
+			 * @return uint8_t
+			 */
+			uint8_t available(void);
+
+
+			/**
+			 * Gets the number of key events lost because the queue was full, it wraps around
+			 * @return uint16_t
+			 */
+			uint16_t getOverflows(void);
+
+
+			/**
+			 * Gets whether the last scan had keys blocked for ghosting
+			 * @return bool
+			 */
+			bool isGhosted(void);
+
+
+			/**
+			 * Gets the number of scans that had keys blocked for ghosting, it wraps around
+			 * @return uint16_t
+			 */
+			uint16_t getGhostedScans(void);
+
+
+			/**
+			 * Gets how long the last scan took
+			 * @return unsigned long -microseconds
+			 */
+			unsigned long getScanMicros(void);
+
+
+			/**
+			 * Gets the longest any scan has taken since begin\(\) or the last resetScanMicros\(\)
+			 * @return unsigned long -microseconds
+			 */
+			unsigned long getMaxScanMicros(void);
+
+
+			/**
+			 * Starts measuring the longest scan over again
+			 */
+			void resetScanMicros(void);
+		protected:
+			/**
+			 * Reads every column port once and gathers the columns into a word
+			 * @return uint16_t -bit n set when column n reads LOW
+			 */
+			uint16_t readColumns(void);
+
+			uint8_t rowCount;	///< How many rows are added
+			uint8_t columnCount;	///< How many columns are added
+			uint8_t laneCount;	///< How many ports the columns are on
+			uint8_t rowPins[CSF_MATRIX_ROWS];	///< The pin of each row
+			uint8_t columnLanes[CSF_MATRIX_COLUMNS];	///< The lane of each column's port
+			uint8_t columnMasks[CSF_MATRIX_COLUMNS];	///< Each column's bit in its port
+			uint8_t lanePorts[CSF_MATRIX_COLUMNS];	///< The port number of each lane
+			volatile uint8_t* laneInputs[CSF_MATRIX_COLUMNS];	///< The input register of each lane
+			uint16_t states[CSF_MATRIX_ROWS];	///< The debounced state of each row
+			uint16_t counts0[CSF_MATRIX_ROWS];	///< Low bits of each row's vertical counters
+			uint16_t counts1[CSF_MATRIX_ROWS];	///< High bits of each row's vertical counters
+			Utility::RingBuffer<KeyEvent, CSF_MATRIX_QUEUE> queue;	///< Key events waiting for drain\(\)
+			unsigned int interval;	///< Milliseconds between scans in update\(\)
+			unsigned long lastScan;	///< millis\(\) at the last scan from update\(\)
+			uint8_t settle;	///< Microseconds a row is held before reading
+			bool diodes;	///< Set when ghosting can't happen
+			bool ghosted;	///< Set when the last scan blocked keys
+			uint16_t ghostedScans;	///< Scans that blocked keys
+			unsigned long scanMicros;	///< How long the last scan took
+			unsigned long maxScanMicros;	///< The longest scan
+	};
+
+
+
+
+	/**
+	 * MatrixKey is a Button that reads its debounced state from a KeyMatrix, so code written for a Button works unchanged on a key in a matrix.\n
+	 * The matrix does the scanning and debouncing, getState\(\) just picks out this key. As with BankButton, call it on the MatrixKey itself rather than through a Button pointer, and getPin\(\) gives the key number since the key has no pin of its own.
+	 */
+	class MatrixKey: public Button{
+		public:
+			/**
+			 * The constructor for MatrixKey
+			 * @param matrix -the matrix the key is in, it has to outlive the key
+			 * @param row -the row number from KeyMatrix::addRow\(\)
+			 * @param column -the column number from KeyMatrix::addColumn\(\)
+			 */
+			MatrixKey(KeyMatrix& matrix, uint8_t row, uint8_t column): Button(-1), matrix(matrix), row(row), column(column){};
+
+
+			/**
+			 * Looks up the key number, call this in setup\(\) once the matrix has all its rows and columns
+			 */
+			void begin(void);
+
+
+			/**
+			 * gets the debounced state of the key
+			 * @return int -a 1 if currently being pressed, and 0 otherwise
+			 */
+			int getState(void);
+
+
+			/**
+			 * gets the debounced state of the key
+			 * @param condition -a boolean approving the activation of this key, see Button::getState\(bool\)
+			 * @return int -a 1 if currently being pressed, and 0 otherwise or if condition is false
+			 */
+			int getState(bool condition);
+
+
+			/**
+			 * Sends the debounced state to the serial port, as Button::toSerial\(\)
+			 */
+			void toSerial(void);
+
+
+			/**
+			 * Keeps the debounced state for getLastState\(\), and picks the clicks and long presses out of it for getEvents\(\)
+			 */
+			void poll(void);
+		protected:
+			KeyMatrix& matrix;	///< The matrix doing the scanning
+			uint8_t row;	///< The key's row
+			uint8_t column;	///< The key's column
+	};
+
+
+
+
+
+
+}
+
+
+
+
+
+
+
+
+
+
+/**
+ * The Scheduling namespace is for running the controls from loop\(\) without polling each one by hand
+ */
+namespace Scheduling{
+
+
+	/**
+	 * The ControlManager runs every control registered with it from a single tick\(\) in loop\(\).\n
+	 * Each tick reads the clock once and only runs the controls that are due, so a loop with 20 idle controls costs a look at the top of a heap rather than 20 trips through millis\(\). The controls are kept in a min-heap ordered by when each is next due.\n
+	 * For a ControlUnit it checks the Activation Button every POLL_INTERVAL and switches the power line with activateControl\(\)/deactivateControl\(\) whenever the On/Off state changes, so the sketch doesn't have to. For a Button it calls poll\(\) so getLastState\(\) is current. Plain functions can be added too, e.g. a streamer's update.\n
+	 * A control added with a Utility::RateController is sampled and reported by the manager as well, on a schedule that follows the control: each sample takes a reading, or the button's state, hands it to the RateController and sends it with toSerialOnChange\(\), and the next comes after whatever interval the RateController gives, so a control being moved is sampled every few milliseconds and one left alone hardly at all. The button is still read every POLL_INTERVAL in between, so a tap shorter than the idle interval is debounced like any other and a press or a toggle is sampled straight away, waking the control into its fast rate.\n
+	 * Their reports share the serial port set with setSerialBudget\(\): it's split evenly between the controls active at the moment, so however many are being moved at once none of them can crowd out the rest or back up the port, and a single control being moved gets all of it. A control that's been held back isn't run again until it may report, the reading it sends then being the newest.
+	 */
+	class ControlManager{
+		public:
+			static const uint8_t REPORT_BYTES = 10;	///< What one report is counted as against the serial budget, e.g. "17 -1.25" and the line ending
+			static const uint8_t POLL_INTERVAL = 20;	///< Milliseconds between reads of a Button or a ControlUnit's Activation Button, apart from the control's own timing
+
+
+			/**
+			 * A function the ControlManager calls on a schedule
+			 */
+			typedef void (*Task)(void);
+
+
+			/**
+			 * The constructor for ControlManager
+			 */
+			ControlManager(void);
+
+
+			/**
+			 * Adds a sensor control, its Activation Button read every POLL_INTERVAL
+			 * @param control -the Pot or other sensor, it has to outlive the manager
+			 * @return bool -false if all CSF_MANAGER_CONTROLS are already taken
+			 */
+			bool add(Sensors::ControlUnit& control);
+
+
+			/**
+			 * Adds a button, polled every POLL_INTERVAL
+			 * @param button -the Momentary, Touch or other button, it has to outlive the manager
+			 * @return bool -false if all CSF_MANAGER_CONTROLS are already taken
+			 */
+			bool add(Switches::Button& button);
+
+
+			/**
+			 * Adds a button
+			 * @param button -the Momentary, Touch or other button, it has to outlive the manager
+			 * @param val -the time interval in milliseconds between polls
+			 * @return bool -false if all CSF_MANAGER_CONTROLS are already taken
+			 */
+			bool add(Switches::Button& button, unsigned int val);
+
+
+			/**
+			 * Adds a sensor control sampled and reported as fast as it's moving, see the class description
+			 * @param control -the Pot or other sensor, it has to outlive the manager
+			 * @param rate -its own RateController, it has to outlive the manager
+			 * @return bool -false if all CSF_MANAGER_CONTROLS are already taken
+			 */
+			bool add(Sensors::ControlUnit& control, Utility::RateController& rate);
+
+
+			/**
+			 * Adds a button polled and reported quickly around its presses and slowly otherwise, see the class description
+			 * @param button -the Momentary, Touch or other button, it has to outlive the manager
+			 * @param rate -its own RateController, it has to outlive the manager
+			 * @return bool -false if all CSF_MANAGER_CONTROLS are already taken
+			 */
+			bool add(Switches::Button& button, Utility::RateController& rate);
+
+
+			/**
+			 * Adds a function to call on a schedule
+			 * @param task -the function
+			 * @param val -the time interval in milliseconds between calls
+			 * @return bool -false if all CSF_MANAGER_CONTROLS are already taken
+			 */
+			bool add(Task task, unsigned int val);
+
+
+			/**
+			 * Sets every control's power line to match its On/Off state and starts the schedule, call this in setup\(\) after the controls' begin\(\)
+			 */
+			void begin(void);
+
+
+			/**
+			 * Place in loop\(\), runs whatever is due
+			 * @return uint8_t -how many controls and tasks ran
+			 */
+			uint8_t tick(void);
+
+
+			/**
+			 * Sets how much of the serial port the reports from controls added with a RateController can use between them
+			 * @param bytesPerSecond -e.g. 1152 for a tenth of 115200 baud, each report counted as REPORT_BYTES, 0 for no limit
+			 */
+			void setSerialBudget(unsigned int bytesPerSecond);
+
+
+			/**
+			 * Runs a control added with a RateController on the next tick\(\) and at its fast rate from then on, for activity seen some other way, e.g. an edge from Switches::EventCapture. Call it from loop\(\), not an interrupt
+			 * @param rate -the RateController it was added with
+			 * @return bool -false if no control was added with it
+			 */
+			bool wake(Utility::RateController& rate);
+
+
+			/**
+			 * Getter for the number of controls added with a RateController that are active, the number the serial budget is split between
+			 * @return uint8_t
+			 */
+			uint8_t getActiveCount(void);
+
+
+			/**
+			 * Getter for the clock reading the last tick\(\) ran with, for code in loop\(\) that wants the time without reading the clock again
+			 * @return unsigned long -in milliseconds
+			 */
+			unsigned long getTime(void);
+
+
+			/**
+			 * Getter for the number of controls and tasks added
+			 * @return uint8_t
+			 */
+			uint8_t getCount(void);
+		protected:
+			/**
+			 * Runs one control or task
+			 * @param slot -the control's slot
+			 */
+			void dispatch(uint8_t slot);
+
+
+			/**
+			 * Fills in a new slot and puts it on the heap
+			 * @param kind -what the slot holds
+			 * @param target -the control or task
+			 * @param val -the time interval in milliseconds
+			 * @return bool -false if all CSF_MANAGER_CONTROLS are already taken
+			 */
+			bool addSlot(uint8_t kind, void* target, unsigned int val);
+
+
+			/**
+			 * Hands a sample from a control added with a RateController to it and sets when the slot is next sampled and run
+			 * @param slot -the control's slot
+			 * @param value -the reading, or the button's state
+			 * @param flag -the sensor's On/Off state, or whether the button is pressed
+			 * @return bool -true if the control may report now
+			 */
+			bool adapt(uint8_t slot, int value, bool flag);
+
+
+			/**
+			 * Whether a slot with a RateController is due to be sampled on this run
+			 * @param slot -the control's slot
+			 * @return bool
+			 */
+			bool isSampleDue(uint8_t slot);
+
+
+			/**
+			 * Moves the heap entry at index up until its parent is due before it
+			 * @param index -the heap index
+			 */
+			void siftUp(uint8_t index);
+
+
+			/**
+			 * Moves the heap entry at index down until both its children are due after it
+			 * @param index -the heap index
+			 */
+			void siftDown(uint8_t index);
+
+
+			/**
+			 * Whether heap entry a is due before heap entry b, allowing for the clock wrapping around
+			 * @return bool
+			 */
+			bool isBefore(uint8_t a, uint8_t b);
+
+			uint8_t count;	///< How many slots are in use, also the heap size
+			uint8_t kinds[CSF_MANAGER_CONTROLS];	///< What each slot holds
+			void* targets[CSF_MANAGER_CONTROLS];	///< The control or task in each slot
+			unsigned int intervals[CSF_MANAGER_CONTROLS];	///< The time in milliseconds between runs of each slot
+			unsigned long deadlines[CSF_MANAGER_CONTROLS];	///< When each heap entry is next due
+			uint8_t heap[CSF_MANAGER_CONTROLS];	///< The slots ordered as a min-heap on deadlines, deadlines[i] belongs to heap[i]
+			unsigned long currentTime;	///< The clock reading of the last tick\(\)
+			Utility::RateController* rates[CSF_MANAGER_CONTROLS];	///< The RateController of each slot, NULL for a fixed interval
+			unsigned int budget;	///< Bytes per second for reports, 0 for no limit
+			uint8_t activeCount;	///< How many of the RateControllers are active
+			unsigned long sampleTimes[CSF_MANAGER_CONTROLS];	///< When each slot with a RateController is next sampled
+	};
+
+
+}
+
+
+
+
+
+
+
+
+
+
+namespace Comms{
+
+	class TxQueue;
+
+
+	/**
+	 * The FrameStreamer pushes the state of every control it carries to the computer on its own schedule, rather than waiting to be asked for one value at a time.\n
+	 * Each frame holds every registered channel along with a sequence number, a timestamp and a CRC, and is COBS encoded and ended with a 0x00 byte \(see CSF_Protocol.h for the layout\). The matching decoder for the PC side is Host::FrameDecoder in host/CSF_Host.h.\n
+	 * Sensors are sent as their raw reading when switched on and 0 with the on flag clear otherwise, buttons as 1 or 0.
+	 */
+	class FrameStreamer{
+		public:
+			/**
+			 * The constructor for FrameStreamer, sends a frame every 50 milliseconds
+			 */
+			FrameStreamer(void);
+
+
+			/**
+			 * The constructor for FrameStreamer
+			 * @param val -the time interval in milliseconds between frames
+			 */
+			FrameStreamer(int val);
+
+
+			/**
+			 * Initializes the sequence number and the timer, call this in the setup\(\) method after Serial.begin\(\)
+			 */
+			void begin(void);
+
+
+			/**
+			 * Adds a sensor control as the next channel in the frame
+			 * @param control -the Pot or other sensor, it has to outlive the streamer
+			 * @return bool -false if all CSF_STREAM_CHANNELS are already taken
+			 */
+			bool add(Sensors::ControlUnit& control);
+
+
+			/**
+			 * Adds a button as the next channel in the frame
+			 * @param button -the Momentary, Touch or other button, it has to outlive the streamer
+			 * @return bool -false if all CSF_STREAM_CHANNELS are already taken
+			 */
+			bool add(Switches::Button& button);
+
+
+			/**
+			 * Place in loop\(\), sends a frame whenever the interval has passed
+			 */
+			void update(void);
+
+
+			/**
+			 * Builds and sends a frame right now regardless of the interval
+			 */
+			void sendFrame(void);
+
+
+			/**
+			 * Changes the time between frames
+			 * @param val -the time interval in milliseconds between frames
+			 */
+			void setInterval(int val);
+
+
+			/**
+			 * Getter for the number of channels carried in each frame
+			 * @return uint8_t
+			 */
+			uint8_t getChannelCount(void);
+
+
+			/**
+			 * Getter for the sequence number the next frame will carry
+			 * @return uint16_t
+			 */
+			uint16_t getSequence(void);
+
+
+			/**
+			 * Sends frames through a TxQueue instead of straight to Serial, so a full transmit buffer drops a frame \(the sequence number shows the gap\) rather than holding up loop\(\)
+			 * @param queue -the TxQueue, it has to outlive the streamer, its update\(\) or drain\(\) has to be called from loop\(\) too
+			 */
+			void setOutput(TxQueue& queue);
+		protected:
+			/**
+			 * Packs the payload and CRC for the current state of every channel
+			 * @param payload -room for framePayloadSize\(CSF_STREAM_CHANNELS\) bytes
+			 * @return size_t -the payload size
+			 */
+			size_t buildPayload(uint8_t* payload);
+
+			uint8_t channelCount;	///< How many of the channel slots are in use
+			uint8_t kinds[CSF_STREAM_CHANNELS];	///< FRAME_KIND_SENSOR or FRAME_KIND_BUTTON for each channel
+			void* channels[CSF_STREAM_CHANNELS];	///< The ControlUnit or Button behind each channel, see kinds for which
+			uint16_t sequence;	///< The sequence number for the next frame
+			long interval;	///< The amount of time to wait between frames
+			long previousTime;	///< The timestamp of the last frame sent
+			TxQueue* output;	///< Where frames go, or NULL for straight to Serial
+	};
+
+
+
+
+	/**
+	 * The TxQueue stands between the controls and the serial port so sending never holds up loop\(\).\n
+	 * Serial.println\(\) waits whenever the board's transmit buffer is full, and each control printing its own line pays the line overhead every time. Instead the TxQueue keeps a ring of CSF_TX_BUFFER bytes and drain\(\) only hands Serial as many as availableForWrite\(\) says it can take without waiting, the core's transmit interrupt then sends them in the background.\n
+	 * Control values go in through slots, one per channel, that only ever hold the newest value: set\(\) overwrites whatever hasn't gone out yet, and every interval the slots that changed are sent together as one line, e.g. "0:512 1:0 3:1". Only one of those lines is ever waiting in the ring: until it has gone out the values stay in their slots and the next try sends the ones current then, so an old value never stands in front of a new one. When there's only room for some of the channels those go out and the rest wait for the next line, counted by getSplit\(\), so a line longer than the ring can't hold the channels back forever.\n
+	 * Anything else, like the frames from a FrameStreamer given setOutput\(\), goes in whole or not at all, and what didn't fit is counted by getDropped\(\).
+	 */
+	class TxQueue{
+		public:
+			/**
+			 * The constructor for TxQueue, sends the channels every 50 milliseconds
+			 */
+			TxQueue(void);
+
+
+			/**
+			 * The constructor for TxQueue
+			 * @param val -the time interval in milliseconds between sending the channels
+			 */
+			TxQueue(int val);
+
+
+			/**
+			 * Adds a sensor as the next channel, its reading \(or 0 when switched off\) is taken every interval
+			 * @param control -the Pot or other sensor, it has to outlive the queue
+			 * @return int -the channel, or -1 if all CSF_TX_CHANNELS are taken
+			 */
+			int add(Sensors::ControlUnit& control);
+
+
+			/**
+			 * Adds a button as the next channel, its state is taken every interval
+			 * @param button -the Momentary, Touch or other button, it has to outlive the queue
+			 * @return int -the channel, or -1 if all CSF_TX_CHANNELS are taken
+			 */
+			int add(Switches::Button& button);
+
+
+			/**
+			 * Adds a channel with nothing behind it, for values given with set\(\)
+			 * @return int -the channel, or -1 if all CSF_TX_CHANNELS are taken
+			 */
+			int addChannel(void);
+
+
+			/**
+			 * Puts a new value in a channel's slot, replacing one that hasn't been sent yet
+			 * @param channel -the channel from add\(\) or addChannel\(\)
+			 * @param value -the value
+			 */
+			void set(uint8_t channel, int value);
+
+
+			/**
+			 * Queues a block of bytes, all of it or none of it
+			 * @param data -the bytes
+			 * @param len -how many
+			 * @return bool -false if there wasn't room, the block is dropped and counted
+			 */
+			bool write(const uint8_t* data, size_t len);
+
+
+			/**
+			 * Queues a line of text with the line ending println\(\) would add, all of it or none of it
+			 * @param text -the line
+			 * @return bool -false if there wasn't room
+			 */
+			bool println(const char* text);
+
+
+			/**
+			 * Place in loop\(\), takes the controls' values and queues the changed channels when the interval has passed, then drains what the serial port will take
+			 */
+			void update(void);
+
+
+			/**
+			 * Queues the channels that changed as one line right now. If the whole line won't fit in the room left, the channels that fit go out now and the rest wait for the next line
+			 * @return bool -false if there wasn't room for all of them or the last line is still waiting, the values not sent stay in their slots for the next try
+			 */
+			bool flush(void);
+
+
+			/**
+			 * Hands Serial as many queued bytes as it can take without waiting
+			 * @return uint8_t -how many bytes were handed over
+			 */
+			uint8_t drain(void);
+
+
+			/**
+			 * Changes the time between sending the channels
+			 * @param val -the time interval in milliseconds
+			 */
+			void setInterval(int val);
+
+
+			/**
+			 * Getter for the number of bytes waiting to be sent
+			 * @return uint8_t
+			 */
+			uint8_t getPending(void);
+
+
+			/**
+			 * Getter for the most bytes that have been waiting at once, how close the queue has come to full
+			 * @return uint8_t
+			 */
+			uint8_t getHighWater(void);
+
+
+			/**
+			 * Getter for the number of blocks dropped by write\(\) and println\(\) because there wasn't room
+			 * @return uint16_t
+			 */
+			uint16_t getDropped(void);
+
+
+			/**
+			 * Getter for the number of times a channel's value was replaced before it went out
+			 * @return uint16_t
+			 */
+			uint16_t getOverwritten(void);
+
+
+			/**
+			 * Getter for the number of times the changed channels didn't all fit in the room left and were sent over more than one line
+			 * @return uint16_t
+			 */
+			uint16_t getSplit(void);
+		protected:
+			/**
+			 * Takes the current value of every channel with a control behind it
+			 */
+			void sample(void);
+
+
+			/**
+			 * Writes a number as text
+			 * @param out -room for 11 characters
+			 * @param value -the number
+			 * @return uint8_t -how many characters were written
+			 */
+			static uint8_t formatNumber(char* out, long value);
+
+			static const uint8_t TX_KIND_NONE = 0;
+			static const uint8_t TX_KIND_SENSOR = 1;
+			static const uint8_t TX_KIND_BUTTON = 2;
+			static const uint8_t TX_ENTRY_MAX = 16;	///< The longest a channel's part of a line can be, " 255:-2147483648"
+			static const uint8_t TX_LINE_MAX = (CSF_TX_CHANNELS * TX_ENTRY_MAX + 2 < CSF_TX_BUFFER - 1) ? CSF_TX_CHANNELS * TX_ENTRY_MAX + 2 : CSF_TX_BUFFER - 1;	///< The longest line of channels with its line ending, no more than the ring can hold
+
+			Utility::RingBuffer<uint8_t, CSF_TX_BUFFER> bytes;	///< The bytes waiting for the serial port
+			uint8_t highWater;	///< The most bytes that have been waiting at once
+			uint16_t dropped;	///< Blocks turned away for lack of room
+			uint16_t overwritten;	///< Values replaced before they were sent
+			uint16_t split;	///< Lines of channels that had to leave some for the next line
+			uint16_t written;	///< Bytes ever queued, it wraps around
+			uint16_t drained;	///< Bytes ever handed to Serial, it wraps around
+			uint16_t lineEnd;	///< What written was just after the last line of channels, it has gone out once drained passes it
+			uint8_t channelCount;	///< How many channels are in use
+			uint8_t kinds[CSF_TX_CHANNELS];	///< What's behind each channel
+			void* controls[CSF_TX_CHANNELS];	///< The ControlUnit or Button behind each channel, see kinds for which
+			int values[CSF_TX_CHANNELS];	///< The newest value for each channel
+			int sentValues[CSF_TX_CHANNELS];	///< The value last queued for each channel
+			uint8_t pending[(CSF_TX_CHANNELS + 7) / 8];	///< A bit per channel set when its value hasn't been queued yet
+			long interval;	///< The amount of time to wait between sending the channels
+			long previousTime;	///< The timestamp of the last time the channels were sent
+	};
+
+
+
+
+	/**
+	 * Called for a command added with CommandParser::on\(\)
+	 * @param argc -how many words follow the command
+	 * @param argv -the words, null terminated, only good until the handler returns
+	 */
+	typedef void (*CommandHandler)(uint8_t argc, char** argv);
+
+
+	/**
+	 * The CommandParser answers text commands from the computer without loop\(\) ever waiting on the serial port.\n
+	 * update\(\) takes whatever bytes have already arrived into a fixed buffer and runs the command once its newline comes in, so half a line costs nothing and no String is ever built. The command word is looked up by its commandHash\(\), for the built in commands that's a switch on values worked out at compile time. Every command gets exactly one line back so the computer never has to wait out a timeout:\n
+	 * - a bound name, e.g. Slide: the control's toSerial\(\)\n
+	 * - get <name or number>: the same\n
+	 * - map <name or number> <min> <max>: Pot::mapData\(\) with ints, or floats if either has a decimal point, then the reading in the new range\n
+	 * - rate <hz>: how often the attached FrameStreamer sends, answers ok\n
+	 * - list: the bound names separated by spaces\n
+	 * - stats: only when CSF_CONTROLS_STATS is on, each bound control as name=reads/suppressed/toggles/emitted, then loop= and the Utility::Stats histogram from bucket 0 up separated by commas, loopmax= in microseconds, late= in milliseconds and press= in microseconds, e.g. "Slide=812/2400/2/812 loop=0,0,0,0,0,0,3,950,41,0,0,0,0,0,0,0 loopmax=310 late=1 press=1480"\n
+	 * - stats reset: clears all of it, answers ok\n
+	 * - anything added with on\(\): whatever its handler prints\n
+	 * Anything else, and a line longer than CSF_COMMAND_LENGTH, gets ? and the word back, and an empty line or one of only spaces gets a ? on its own, so even a stray newline is answered.
+	 */
+	class CommandParser{
+		public:
+			/**
+			 * The constructor for CommandParser
+			 */
+			CommandParser(void);
+
+
+			/**
+			 * Gives a Pot a name the computer can use, e.g. parser.bind\("Slide", slider\); it's numbered in the order bound as well
+			 * @param name -the name, it has to outlive the parser, a string literal is fine
+			 * @param pot -the Pot, it has to outlive the parser
+			 * @return bool -false if all CSF_COMMAND_BINDINGS are taken
+			 */
+			bool bind(const char* name, Sensors::Pot& pot);
+
+
+			/**
+			 * Gives any other sensor a name the computer can use, it can be read but not mapped
+			 * @param name -the name, it has to outlive the parser
+			 * @param control -the sensor, it has to outlive the parser
+			 * @return bool -false if all CSF_COMMAND_BINDINGS are taken
+			 */
+			bool bind(const char* name, Sensors::ControlUnit& control);
+
+
+			/**
+			 * Gives a button a name the computer can use
+			 * @param name -the name, it has to outlive the parser
+			 * @param button -the button, it has to outlive the parser
+			 * @return bool -false if all CSF_COMMAND_BINDINGS are taken
+			 */
+			bool bind(const char* name, Switches::Button& button);
+
+
+			/**
+			 * Adds a command of your own, checked after the built in ones and the bound names
+			 * @param name -the command word, it has to outlive the parser
+			 * @param handler -called with the words after the command, it should print one line back
+			 * @return bool -false if all CSF_COMMAND_BINDINGS are taken
+			 */
+			bool on(const char* name, CommandHandler handler);
+
+
+			/**
+			 * Lets rate change how often a FrameStreamer sends
+			 * @param s -the FrameStreamer, it has to outlive the parser
+			 */
+			void attach(FrameStreamer& s);
+
+
+			/**
+			 * Place in loop\(\), reads whatever has arrived on Serial and runs each command it completes, it never waits for more
+			 * @return uint8_t -how many commands ran
+			 */
+			uint8_t update(void);
+
+
+			/**
+			 * Takes one byte of a command line, for bytes that come from somewhere other than Serial
+			 * @param c -the byte
+			 * @return bool -true if it completed a command and the command ran, false for an empty line even though it's answered
+			 */
+			bool push(char c);
+
+
+			/**
+			 * Runs one whole command line
+			 * @param line -the command, without the newline, it gets split up in place
+			 */
+			void execute(char* line);
+
+
+			/**
+			 * Getter for how many lines were answered with ?
+			 * @return unsigned int
+			 */
+			unsigned int getErrors(void);
+		protected:
+			/**
+			 * Finds a bound control by name or number
+			 * @param word -the name or number
+			 * @return int -the binding, or -1
+			 */
+			int find(const char* word);
+
+
+			/**
+			 * Adds a name to the table
+			 * @param name -the name
+			 * @param kind -COMMAND_POT, COMMAND_SENSOR, COMMAND_BUTTON or COMMAND_HANDLER
+			 * @param target -the control or the handler
+			 * @return bool -false if the table is full
+			 */
+			bool addBinding(const char* name, uint8_t kind, void* target);
+
+
+			/**
+			 * Prints a bound control
+			 * @param index -the binding
+			 * @return bool -false if it isn't a control
+			 */
+			bool print(uint8_t index);
+
+
+			/**
+			 * Answers a line that couldn't be run
+			 * @param word -the command word
+			 */
+			void reject(const char* word);
+
+
+			#if CSF_CONTROLS_STATS
+			/**
+			 * Gets the stats of a bound control
+			 * @param index -the binding
+			 * @return Utility::ControlStats* -NULL if it isn't a control
+			 */
+			Utility::ControlStats* statsOf(uint8_t index);
+
+
+			/**
+			 * Answers the stats command, see the class description
+			 */
+			void printStats(void);
+			#endif
+
+			static const uint8_t COMMAND_POT = 0;
+			static const uint8_t COMMAND_SENSOR = 1;
+			static const uint8_t COMMAND_BUTTON = 2;
+			static const uint8_t COMMAND_HANDLER = 3;
+			static const uint8_t COMMAND_MAX_WORDS = 6;	///< The command and up to 5 arguments
+
+			char buffer[CSF_COMMAND_LENGTH + 1];	///< The line being collected
+			uint8_t length;	///< How much of the buffer is used
+			bool overflow;	///< Set when the line being collected is too long, it's skipped up to the newline
+			uint8_t bindingCount;	///< How many names are bound
+			uint16_t hashes[CSF_COMMAND_BINDINGS];	///< commandHash\(\) of each name, checked before comparing the names themselves
+			uint8_t kinds[CSF_COMMAND_BINDINGS];	///< What each name is bound to
+			const char* names[CSF_COMMAND_BINDINGS];	///< The names
+			void* targets[CSF_COMMAND_BINDINGS];	///< The control or handler behind each name, see kinds for which
+			FrameStreamer* streamer;	///< What rate changes, or NULL
+			unsigned int errors;	///< Lines answered with ?
+	};
+
+
+
+
+	/**
+	 * One row of a capture, every channel's value at one sample
+	 */
+	struct TraceRow{
+		uint16_t index;	///< The low 16 bits of the sample number
+		int16_t values[CSF_CAPTURE_CHANNELS];	///< Each channel's value
+	};
+
+
+
+
+	/**
+	 * TraceCapture samples its controls at an exact rate set by a hardware timer, whatever loop\(\) is busy with, so the readings can be used for rates and derivatives and replayed later.\n
+	 * Each sample reads every channel into a ring of CSF_CAPTURE_DEPTH rows: a Pot's raw reading before any filter \(Pot::getRawValue\(\)\) and a Button's debounced state, see add\(Switches::Button&\). dump\(\) from loop\(\) sends the rows waiting as delta encoded blocks \(see CSF_Protocol.h\), a few bytes a row, and Host::TraceDecoder and csf_replay in host/ read them back. If loop\(\) doesn't dump often enough the ring fills, later rows are counted in getOverflows\(\) and the gap shows in the sample numbers.\n
+	 * On AVR boards a sketch with CSF_TRACE_ISR\(\) at the top level has Timer1 fire every period and take the sample in its interrupt. Timer1 is also used by the Servo library and PWM on pins 9 and 10 of an Uno, so they can't run alongside it. Every Pot has to be attached to the Sampler then, and begin\(\) refuses otherwise, so the interrupt takes the Sampler's latest reading rather than waiting out an analogRead\(\).\n
+	 * Without CSF_TRACE_ISR\(\), and on other boards, call service\(\) from loop\(\), which takes every sample that has come due by micros\(\). The sample numbers still advance at the exact rate, but the readings are only as on time as loop\(\).\n
+	 * Everything is static since the interrupt needs somewhere fixed to put the rows.
+	 */
+	class TraceCapture{
+		public:
+			/**
+			 * Adds a Pot as the next channel, call this in setup\(\) before begin\(\)
+			 * @param pot -the Pot, it has to stay around as long as the capture runs
+			 * @return bool -false if all CSF_CAPTURE_CHANNELS are taken or the capture is running
+			 */
+			static bool add(Sensors::Pot& pot);
+
+
+			/**
+			 * Adds a Button as the next channel, call this in setup\(\) before begin\(\)
+			 * @param button -the Button, read with getState\(\) from service\(\), or its getLastState\(\) from the interrupt, so a Momentary or Touch has to be read in loop\(\) as well
+			 * @return bool -false if all CSF_CAPTURE_CHANNELS are taken or the capture is running
+			 */
+			static bool add(Switches::Button& button);
+
+
+			/**
+			 * Starts sampling, from sample number 0
+			 * @param periodMicros -microseconds between samples, rounded to what the timer can do, see getPeriod\(\)
+			 * @return bool -false if there are no channels, the timer can't count that long, or the interrupt is hooked and a Pot isn't attached to the Sampler
+			 */
+			static bool begin(unsigned long periodMicros);
+
+
+			/**
+			 * Stops sampling, rows already taken can still be dumped
+			 */
+			static void end(void);
+
+
+			/**
+			 * Stops sampling and forgets every channel and row
+			 */
+			static void detachAll(void);
+
+
+			/**
+			 * Marks the samples as coming from the Timer1 interrupt, CSF_TRACE_ISR\(\) calls this as the sketch starts. From then on begin\(\) starts the timer and service\(\) does nothing
+			 * @param hooked -false to go back to service\(\), as a test might
+			 * @return bool -hooked
+			 */
+			static bool hookInterrupt(bool hooked = true);
+
+
+			/**
+			 * Place in loop\(\) unless the Timer1 interrupt is hooked, takes the samples that have come due
+			 */
+			static void service(void);
+
+
+			/**
+			 * Sends a block of up to CSF_CAPTURE_BLOCK of the rows waiting
+			 * @return uint8_t -how many rows were sent, 0 if none were waiting
+			 */
+			static uint8_t dump(void);
+
+
+			/**
+			 * Gets the number of rows waiting to be dumped
+			 * @return uint8_t
+			 */
+			static uint8_t available(void);
+
+
+			/**
+			 * Gets the number of rows lost because the ring was full, it wraps around
+			 * @return uint16_t
+			 */
+			static uint16_t getOverflows(void);
+
+
+			/**
+			 * Gets the number of samples taken since begin\(\), including any lost
+			 * @return unsigned long
+			 */
+			static unsigned long getSamples(void);
+
+
+			/**
+			 * Gets the period the timer actually runs at
+			 * @return unsigned long -microseconds
+			 */
+			static unsigned long getPeriod(void);
+
+
+			/**
+			 * Getter for whether sampling is running
+			 * @return bool
+			 */
+			static bool isRunning(void);
+
+
+			/**
+			 * Getter for whether sampling is running from the Timer1 interrupt
+			 * @return bool
+			 */
+			static bool isInterruptDriven(void);
+
+
+			/**
+			 * Sends blocks through a TxQueue instead of straight to Serial, a block that doesn't fit is dropped whole and shows up as a gap in the sample numbers
+			 * @param queue -the TxQueue, it has to outlive the capture, its update\(\) or drain\(\) has to be called from loop\(\) too
+			 */
+			static void setOutput(TxQueue& queue);
+
+
+			/**
+			 * Takes one sample, the timer interrupt and service\(\) call this
+			 */
+			static void onTick(void);
+		protected:
+			/**
+			 * Packs the payload and CRC of a block from the rows waiting
+			 * @param payload -room for traceMaxPayloadSize\(CSF_CAPTURE_CHANNELS, CSF_CAPTURE_BLOCK\) bytes
+			 * @param rows -filled in with how many rows went in
+			 * @return size_t -the payload size
+			 */
+			static size_t buildBlock(uint8_t* payload, uint8_t& rows);
+
+			static uint8_t channelCount;	///< How many channels are added
+			static uint8_t kinds[CSF_CAPTURE_CHANNELS];	///< FRAME_KIND_SENSOR or FRAME_KIND_BUTTON for each channel
+			static void* channels[CSF_CAPTURE_CHANNELS];	///< The Pot or Button behind each channel, see kinds for which
+			static Utility::RingBuffer<TraceRow, CSF_CAPTURE_DEPTH> rows;	///< Rows waiting for dump\(\)
+			static volatile unsigned long samples;	///< Samples taken since begin\(\)
+			static volatile bool running;	///< Set between begin\(\) and end\(\)
+			static bool hooked;	///< Set by hookInterrupt\(\)
+			static unsigned long period;	///< Microseconds between samples
+			static unsigned long nextDue;	///< micros\(\) of the next sample for service\(\)
+			static unsigned long nextIndex;	///< The sample number the next row dumped should have
+			static uint16_t sequence;	///< The sequence number of the next block
+			static TxQueue* output;	///< Where blocks go, or NULL for straight to Serial
+	};
+
+
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,287 @@
+/**
+ * @file
+ * @section description Description
+ * The binary framing shared by the Arduino side of CSF_Controls and the PC side decoder in host/.\n
+ * Nothing in here depends on Arduino.h so the exact same code packs a frame on the board and unpacks it on the computer.\n
+ * A frame on the wire is the COBS encoded payload followed by a single 0x00 delimiter, the payload being:\n
+ * <pre>
+ * version     1 byte   FRAME_VERSION
+ * sequence    2 bytes  increments by one every frame, so the receiver can count drops
+ * timestamp   4 bytes  millis() on the board when the frame was built
+ * count       1 byte   number of channels that follow
+ * channels    3 bytes each: flags (kind in the low bits, FRAME_FLAG_ON in the high bit), then the value as a signed 16 bit int
+ * crc         2 bytes  CRC-16/CCITT of everything above
+ * </pre>
+ * Multi-byte fields are little endian.\n
+ * Traces from Comms::TraceCapture are framed the same way, COBS and a 0x00 delimiter, with a payload that starts with TRACE_VERSION so neither decoder mistakes one for the other:\n
+ * <pre>
+ * version     1 byte   TRACE_VERSION
+ * sequence    2 bytes  increments by one every block
+ * period      4 bytes  microseconds between rows
+ * index       4 bytes  the sample number of the first row, counted from when the capture started
+ * count       1 byte   number of channels in each row
+ * rows        1 byte   number of rows that follow
+ * kinds       1 byte per channel, FRAME_KIND_SENSOR or FRAME_KIND_BUTTON
+ * rows        each channel in turn, its value minus its value in the row before \(0 before the first row of the block\), zigzag then varint encoded
+ * crc         2 bytes  CRC-16/CCITT of everything above
+ * </pre>
+ * The rows in a block are consecutive samples, a gap in index from the end of one block to the start of the next is samples the board lost.\n
+ * The commands going the other way are plain text lines read by CommandParser, the words in them are looked up with commandHash\(\).
+ */
+
+
+#ifndef CSF_Protocol_h
+#define CSF_Protocol_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+
+/**
+ * The Comms namespace is for getting control data off the board and onto the computer
+ */
+namespace Comms{
+
+	const uint8_t FRAME_VERSION = 1;	///< Bumped whenever the payload layout changes
+	const uint8_t FRAME_DELIMITER = 0x00;	///< Ends every frame on the wire, COBS guarantees it appears nowhere else
+	const uint8_t FRAME_HEADER_SIZE = 8;	///< version, sequence, timestamp and count
+	const uint8_t FRAME_CHANNEL_SIZE = 3;	///< flags and value
+	const uint8_t FRAME_CRC_SIZE = 2;
+	const uint8_t FRAME_MAX_CHANNELS = 32;	///< The most channels a decoder has to be ready for
+
+	const uint8_t FRAME_KIND_SENSOR = 0;	///< The channel is a Sensors::ControlUnit
+	const uint8_t FRAME_KIND_BUTTON = 1;	///< The channel is a Switches::Button
+	const uint8_t FRAME_KIND_MASK = 0x0F;
+	const uint8_t FRAME_FLAG_ON = 0x80;	///< Set when a sensor is switched on or a button is pressed
+
+	const uint8_t TRACE_VERSION = 0x81;	///< Starts a trace block, never a valid FRAME_VERSION
+	const uint8_t TRACE_HEADER_SIZE = 13;	///< version, sequence, period, index, count and rows, the kinds follow
+	const uint8_t TRACE_MAX_CHANNELS = 16;	///< The most channels a trace decoder has to be ready for
+	const uint8_t TRACE_VALUE_MAX_SIZE = 3;	///< The most bytes one 16 bit value takes zigzag and varint encoded
+
+
+	/**
+	 * The payload size for a number of channels, including the CRC
+	 * @param channels -how many channels are in the frame
+	 * @return size_t
+	 */
+	inline size_t framePayloadSize(uint8_t channels){
+		return FRAME_HEADER_SIZE + (size_t)channels * FRAME_CHANNEL_SIZE + FRAME_CRC_SIZE;
+	}//end framePayloadSize()
+
+
+	/**
+	 * The worst case size of a COBS encoded block, not counting the delimiter
+	 * @param len -the size before encoding
+	 * @return size_t
+	 */
+	inline size_t cobsMaxSize(size_t len){
+		return len + len / 254 + 1;
+	}//end cobsMaxSize()
+
+
+	/**
+	 * CRC-16/CCITT-FALSE \(polynomial 0x1021, starting at 0xFFFF\), done bit by bit rather than with a table to keep it out of the Arduino's memory
+	 * @param data -the bytes to check
+	 * @param len -how many
+	 * @param crc -the running value when checking a block in pieces
+	 * @return uint16_t
+	 */
+	inline uint16_t crc16(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF){
+		for(size_t i = 0; i < len; i++){
+			crc ^= (uint16_t)data[i] << 8;
+			for(uint8_t bit = 0; bit < 8; bit++){
+				crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+			}
+		}
+		return crc;
+	}//end crc16()
+
+
+	/**
+	 * Consistent Overhead Byte Stuffing, rewrites a block so it contains no 0x00 bytes and the delimiter can mark the end of the frame
+	 * @param in -the bytes to encode
+	 * @param len -how many
+	 * @param out -room for at least cobsMaxSize\(len\) bytes
+	 * @return size_t -the encoded size
+	 */
+	inline size_t cobsEncode(const uint8_t* in, size_t len, uint8_t* out){
+		size_t write = 1;
+		size_t codeIndex = 0;
+		uint8_t code = 1;
+		for(size_t read = 0; read < len; read++){
+			if(in[read] == 0){
+				out[codeIndex] = code;
+				codeIndex = write++;
+				code = 1;
+			}
+			else{
+				out[write++] = in[read];
+				code++;
+				if(code == 0xFF){
+					out[codeIndex] = code;
+					codeIndex = write++;
+					code = 1;
+				}
+			}
+		}
+		out[codeIndex] = code;
+		return write;
+	}//end cobsEncode()
+
+
+	/**
+	 * Reverses cobsEncode\(\), the delimiter should already be stripped off
+	 * @param in -the encoded bytes
+	 * @param len -how many
+	 * @param out -room for at least len bytes
+	 * @return size_t -the decoded size, or 0 if the block is not valid COBS
+	 */
+	inline size_t cobsDecode(const uint8_t* in, size_t len, uint8_t* out){
+		size_t read = 0;
+		size_t write = 0;
+		while(read < len){
+			uint8_t code = in[read];
+			if(code == 0 || read + code > len){
+				return 0;
+			}
+			read++;
+			for(uint8_t i = 1; i < code; i++){
+				if(in[read] == 0){
+					return 0;
+				}
+				out[write++] = in[read++];
+			}
+			if(code != 0xFF && read < len){
+				out[write++] = 0;
+			}
+		}
+		return write;
+	}//end cobsDecode()
+
+
+	/**
+	 * Stores a 16 bit value little endian
+	 * @param out -where to put it
+	 * @param value -the value
+	 */
+	inline void putU16(uint8_t* out, uint16_t value){
+		out[0] = (uint8_t)value;
+		out[1] = (uint8_t)(value >> 8);
+	}//end putU16()
+
+
+	/**
+	 * Stores a 32 bit value little endian
+	 * @param out -where to put it
+	 * @param value -the value
+	 */
+	inline void putU32(uint8_t* out, uint32_t value){
+		out[0] = (uint8_t)value;
+		out[1] = (uint8_t)(value >> 8);
+		out[2] = (uint8_t)(value >> 16);
+		out[3] = (uint8_t)(value >> 24);
+	}//end putU32()
+
+
+	/**
+	 * Reads a 16 bit little endian value
+	 * @param in -where it is
+	 * @return uint16_t
+	 */
+	inline uint16_t getU16(const uint8_t* in){
+		return (uint16_t)(in[0] | ((uint16_t)in[1] << 8));
+	}//end getU16()
+
+
+	/**
+	 * Reads a 32 bit little endian value
+	 * @param in -where it is
+	 * @return uint32_t
+	 */
+	inline uint32_t getU32(const uint8_t* in){
+		return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+	}//end getU32()
+
+
+	/**
+	 * Folds a signed value into an unsigned one so that small values either side of 0 both come out small, 0, -1, 1, -2 ... become 0, 1, 2, 3 ...
+	 * @param value -the value
+	 * @return uint32_t
+	 */
+	inline uint32_t zigzagEncode(int32_t value){
+		return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+	}//end zigzagEncode()
+
+
+	/**
+	 * Reverses zigzagEncode\(\)
+	 * @param value -the folded value
+	 * @return int32_t
+	 */
+	inline int32_t zigzagDecode(uint32_t value){
+		return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+	}//end zigzagDecode()
+
+
+	/**
+	 * Stores a value 7 bits to a byte, low bits first, the top bit of each byte set when another follows, so values under 128 take a single byte
+	 * @param out -room for 5 bytes
+	 * @param value -the value
+	 * @return size_t -how many bytes were stored
+	 */
+	inline size_t putVarint(uint8_t* out, uint32_t value){
+		size_t size = 0;
+		while(value >= 0x80){
+			out[size++] = (uint8_t)(value | 0x80);
+			value >>= 7;
+		}
+		out[size++] = (uint8_t)value;
+		return size;
+	}//end putVarint()
+
+
+	/**
+	 * Reads a value stored by putVarint\(\)
+	 * @param in -where it is
+	 * @param len -how many bytes there are to read from
+	 * @param value -filled in with the value
+	 * @return size_t -how many bytes it took, or 0 if it runs past len or is longer than 5 bytes
+	 */
+	inline size_t getVarint(const uint8_t* in, size_t len, uint32_t& value){
+		value = 0;
+		for(size_t i = 0; i < len && i < 5; i++){
+			value |= (uint32_t)(in[i] & 0x7F) << (7 * i);
+			if(!(in[i] & 0x80)){
+				return i + 1;
+			}
+		}
+		return 0;
+	}//end getVarint()
+
+
+	/**
+	 * The worst case payload size of a trace block, including the CRC
+	 * @param channels -how many channels are in each row
+	 * @param rows -how many rows
+	 * @return size_t
+	 */
+	inline size_t traceMaxPayloadSize(uint8_t channels, uint8_t rows){
+		return TRACE_HEADER_SIZE + channels + (size_t)channels * rows * TRACE_VALUE_MAX_SIZE + FRAME_CRC_SIZE;
+	}//end traceMaxPayloadSize()
+
+
+	/**
+	 * The 16 bit djb2 hash of a command word. It's constexpr so the hash of a literal can be a case label, e.g. case commandHash\("get"\):
+	 * @param text -the word, null terminated
+	 * @param hash -the hash so far, leave this out
+	 * @return uint16_t
+	 */
+	constexpr uint16_t commandHash(const char* text, uint16_t hash = 5381){
+		return *text == 0 ? hash : commandHash(text + 1, (uint16_t)(((uint32_t)hash << 5) + hash + (uint8_t)*text));
+	}//end commandHash()
+
+}
+
+#endif
@@ -0,0 +1,773 @@
+/**
+ * @file
+ * @section description Description
+ * Versions of the controls with no virtual functions, for boards where every byte of SRAM counts.\n
+ * Sensors::ControlUnit has pure virtual begin\(\), getSensorValue\(\) and toSerial\(\), so every Pot carries a pointer to a vtable, every call to them goes through it, and on an AVR the vtables themselves are copied into SRAM at startup. The classes in here work out which function to call at compile time instead \(the base class is a template on the class deriving from it\), so there is no vtable, every call is a direct one and the compiler can inline straight through isButtonPressed\(\). The reading and mapping code is Sensors::PotReader, shared with Sensors::Pot rather than copied.\n
+ * The class and function names are the same as in CSF_Controls.h, so an existing sketch can switch over by including this file and changing its using directives, e.g. using namespace Static::Sensors; in place of using namespace Sensors;\n
+ * What's given up is treating different controls the same way at run time: these aren't Sensors::ControlUnit or Switches::Button, so they can't be handed to the ControlManager, FrameStreamer, ButtonBank or EventCapture, and a Static::Sensors::Pot can't be stored next to a FastPot through a common pointer. Use the classes in CSF_Controls.h for those, both kinds can be used in the same sketch.\n
+ * host/bench compares the two on a PC, csf_bench static
+ */
+
+
+#ifndef CSF_Static_h
+#define CSF_Static_h
+
+#include "CSF_Controls.h"
+
+
+
+/**
+ * The Static namespace holds the versions of the controls that are resolved at compile time, with the same layout of namespaces as CSF_Controls.h
+ */
+namespace Static{
+
+
+	/**
+	 * Picks the class at the bottom of a hierarchy, the class named if there is one or Self when it's void
+	 * @tparam Derived -the class deriving from Self, or void
+	 * @tparam Self -the class asking
+	 */
+	template<class Derived, class Self> struct MostDerived{
+		typedef Derived type;
+	};
+
+
+	/**
+	 * see MostDerived
+	 */
+	template<class Self> struct MostDerived<void, Self>{
+		typedef Self type;
+	};
+
+
+
+
+	/**
+	 * Static::Sensors is Sensors without the virtual functions
+	 */
+	namespace Sensors{
+
+
+		/**
+		 * The ControlUnit is the on/off switch, power line and timing shared by the sensors, as Sensors::ControlUnit.\n
+		 * Where Sensors::ControlUnit declares virtual functions this calls them on Derived directly, so Derived must supply begin\(\), getSensorValue\(\) and toSerial\(\), and can replace pollButton\(\), activateControl\(\), deactivateControl\(\) or printValue\(\) and have its own version used everywhere in here.
+		 * @tparam Derived -the sensor class deriving from this one
+		 */
+		template<class Derived>
+		class ControlUnit{
+			public:
+				/**
+				 * The constructor for the sensor, 250 milliseconds between presses of the button
+				 * @param but -the power button connected to the sensor
+				 * @param lin -the power line coming from the Arduino
+				 * @param sig -the Arduino pin the sensor signal will be sent to
+				 */
+				ControlUnit(int but, int lin, int sig){
+					isSensorOn = false;
+					powerButton = but;
+					powerLine = lin;
+					sensorLine = sig;
+					interval = 250;
+					powerDebouncer.setLockout(interval);
+				};
+
+
+				/**
+				 * The constructor for the sensor
+				 * @param but -the power button connected to the sensor
+				 * @param lin -the power line coming from the Arduino
+				 * @param sig -the Arduino pin the sensor signal will be sent to
+				 * @param val -the reuired time interval that must pass between registering button clicks -in milliseconds
+				 */
+				ControlUnit(int but, int lin, int sig, int val){
+					isSensorOn = false;
+					powerButton = but;
+					powerLine = lin;
+					sensorLine = sig;
+					interval = val;
+					powerDebouncer.setLockout(interval);
+				};
+
+
+				/**
+				 * Toggles the On/Off state of the sensor
+				 */
+				void toggleIsSensorOn(void){
+					isSensorOn = !isSensorOn;
+				};
+
+
+				/**
+				 * Getter for the On/Off state of the sensor
+				 * @return bool
+				 */
+				bool getIsSensorOn(void){
+					return isSensorOn;
+				};
+
+
+				/**
+				 * Activates the power to this control
+				 */
+				void activateControl(void){
+					digitalWrite(powerLine, HIGH);
+				};
+
+
+				/**
+				 * Deactivates the power to this control
+				 */
+				void deactivateControl(void){
+					digitalWrite(powerLine, LOW);
+				};
+
+
+				/**
+				 * Checks the Activation Button, toggling the On/Off state once per press, see Sensors::ControlUnit::isButtonPressed\(\)
+				 */
+				void isButtonPressed(void){
+					self().pollButton();
+				};
+
+
+				/**
+				 * Reads the Activation Button right now and toggles the On/Off state if it has just been pressed
+				 */
+				void pollButton(void){
+					debounceButton(Expansion::VirtualPins::readDigital(powerButton));
+				};
+
+
+				/**
+				 * Getter for the lockout between presses of the Activation Button
+				 * @return long -milliseconds
+				 */
+				long getInterval(void){
+					return interval;
+				};
+
+
+				/**
+				 * Sends the reading over the serial port only when it has moved past the deadband, the sensor was switched on or off, or the heartbeat is due, see Sensors::ControlUnit::toSerialOnChange\(\)
+				 * @return bool -true if a line was sent
+				 */
+				bool toSerialOnChange(void){
+					int reading = isSensorOn ? self().getSensorValue() : 0;
+					if(!tracker.check(reading, isSensorOn, millis())){
+						return false;
+					}
+					Serial.print(tracker.getSequence());
+					Serial.print(' ');
+					self().printValue(reading);
+					return true;
+				};
+
+
+				/**
+				 * Sets when toSerialOnChange\(\) sends
+				 * @param deadband -how far the reading has to move from the last one sent
+				 * @param heartbeat -milliseconds after which the reading is sent anyway, 0 for never
+				 */
+				void setReportByException(int deadband, unsigned int heartbeat){
+					tracker.configure(deadband, heartbeat);
+				};
+			protected:
+				/**
+				 * Prints a reading the way toSerial\(\) would
+				 * @param reading -the reading from getSensorValue\(\), or 0 when the sensor is off
+				 */
+				void printValue(int reading){
+					Serial.println(reading);
+				};
+
+
+				/**
+				 * Runs a reading of the Activation Button through the debouncer and toggles the On/Off state on a press
+				 * @param level -what was read from the button
+				 */
+				void debounceButton(int level){
+					if(powerDebouncer.update(level, millis()) & Utility::Debouncer::PRESSED){
+						toggleIsSensorOn();
+					}
+				};
+
+
+				/**
+				 * The sensor this is part of
+				 * @return Derived&
+				 */
+				Derived& self(void){
+					return static_cast<Derived&>(*this);
+				};
+
+				Utility::ChangeTracker tracker;	///< Decides when toSerialOnChange\(\) sends
+				bool isSensorOn;			///<On/Off State of this control
+				int powerButton;		///<Power button for this control
+				int powerLine; 		///<Power Line for this control's sensor and power indicator LED
+				int sensorLine;		///<Input line feeding back from the sesnsor in this control
+				long interval;	///< The amount of time to wait between checking presses of buttons
+				Utility::Debouncer powerDebouncer;	///< Turns the Activation Button into presses, with the interval as its lockout
+		};
+
+
+
+
+		/**
+		 * BasicPot is everything in Pot, for classes that want to build on it, e.g. FastPot. Use Pot itself in a sketch.\n
+		 * The reading, oversampling, filtering and mapping are Sensors::PotReader, the same code Sensors::Pot runs, so it can be attached to the Sampler too.
+		 * @tparam Derived -the class deriving from this one, or void when this is the Pot
+		 */
+		template<class Derived = void>
+		class BasicPot: public ControlUnit<typename MostDerived<Derived, BasicPot<Derived> >::type>, public ::Sensors::PotReader{
+			typedef typename MostDerived<Derived, BasicPot<Derived> >::type Self;
+			typedef Static::Sensors::ControlUnit<Self> Unit;
+			friend class Static::Sensors::ControlUnit<Self>;
+			friend class ::Sensors::Sampler;
+			public:
+				/**
+				 * The constructor for the sensor, 250 milliseconds between presses of the button
+				 * @param but -the power button connected to the sensor
+				 * @param lin -the power line coming from the Arduino
+				 * @param sig -the Arduino pin the sensor signal will be sent to
+				 */
+				BasicPot(int but, int lin, int sig): Unit(but, lin, sig){};
+
+
+				/**
+				 * The constructor for the sensor
+				 * @param but -the power button connected to the sensor
+				 * @param lin -the power line coming from the Arduino
+				 * @param sig -the Arduino pin the sensor signal will be sent to
+				 * @param val -the reuired time interval that must pass between registering button clicks -in milliseconds
+				 */
+				BasicPot(int but, int lin, int sig, int val): Unit(but, lin, sig, val){};
+
+
+				/**
+				 * Sets the pin modes, as Sensors::Pot::begin\(\)
+				 */
+				void begin(void){
+					this->clearMapping();
+					Expansion::VirtualPins::setMode(this->powerButton, INPUT);
+					Expansion::VirtualPins::setMode(this->powerLine, OUTPUT);
+					Expansion::VirtualPins::setMode(this->sensorLine, INPUT);
+				};
+
+
+				/**
+				 * Takes a reading, oversampled and filtered if set up to be, as Sensors::Pot::getSensorValue\(\)
+				 * @return int
+				 */
+				int getSensorValue(void){
+					return this->readSensor(this->sensorLine);
+				};
+
+
+				/**
+				 * Takes a single reading, skipping the oversampling and the filter
+				 * @return int
+				 */
+				int getRawValue(void){
+					return this->readRaw(this->sensorLine);
+				};
+
+
+				/**
+				 * Takes a reading and maps it to the range given, as Sensors::Pot::mapData\(\)
+				 * @param min -the value at one end of the pot
+				 * @param max -the value at the other end
+				 * @return float
+				 */
+				float mapData(float min, float max){
+					return this->mapReading(min, max, this->self().getSensorValue());
+				};
+
+
+				/**
+				 * Takes a reading and maps it to the range given, as Sensors::Pot::mapData\(\)
+				 * @param min -the value at one end of the pot
+				 * @param max -the value at the other end
+				 * @return int
+				 */
+				int mapData(int min, int max){
+					return this->mapReading(min, max, this->self().getSensorValue());
+				};
+
+
+				/**
+				 * Takes a reading and maps it through a CurveTable, as Sensors::Pot::mapData\(\)
+				 * @param table -the curve, it has to outlive the Pot
+				 * @return int
+				 */
+				int mapData(const ::Sensors::CurveTable& table){
+					return this->mapReading(table, this->self().getSensorValue());
+				};
+
+
+				/**
+				 * Prints the reading, mapped the same way as the last mapData\(\) call
+				 */
+				void toSerial(void){
+					this->self().printValue(this->isSensorOn ? this->self().getSensorValue() : 0);
+				};
+			protected:
+				/**
+				 * Prints a reading mapped the same way as the last mapData\(\) call, or 0 when the sensor is off
+				 * @param reading -the reading from getSensorValue\(\)
+				 */
+				void printValue(int reading){
+					this->printReading(reading, this->isSensorOn);
+				};
+		};
+
+
+		typedef BasicPot<> Pot;	///< A potentiometer, as Sensors::Pot. e.g. Static::Sensors::Pot rotary = Static::Sensors::Pot\(2, 3, A0\);
+
+
+
+
+		/**
+		 * FastPot is a Pot with its pins fixed at compile time so the button and power line use FastPin, as Sensors::FastPot.\n
+		 * Unlike Sensors::FastPot the faster pin access is used everywhere, including the isButtonPressed\(\) it inherits.
+		 * @tparam But -the power button connected to the sensor
+		 * @tparam Lin -the power line coming from the Arduino
+		 * @tparam Sig -the Arduino pin the sensor signal will be sent to
+		 */
+		template<uint8_t But, uint8_t Lin, uint8_t Sig>
+		class FastPot: public BasicPot<FastPot<But, Lin, Sig> >{
+			public:
+				/**
+				 * The constructor for the sensor, 250 milliseconds between presses of the button
+				 */
+				FastPot(void): BasicPot<FastPot<But, Lin, Sig> >(But, Lin, Sig){};
+
+
+				/**
+				 * The constructor for the sensor
+				 * @param val -the reuired time interval that must pass between registering button clicks -in milliseconds
+				 */
+				FastPot(int val): BasicPot<FastPot<But, Lin, Sig> >(But, Lin, Sig, val){};
+
+
+				/**
+				 * Activates the power to this control
+				 */
+				void activateControl(void){
+					Utility::FastPin<Lin>::high();
+				};
+
+
+				/**
+				 * Deactivates the power to this control
+				 */
+				void deactivateControl(void){
+					Utility::FastPin<Lin>::low();
+				};
+
+
+				/**
+				 * Reads the Activation Button right now and toggles the On/Off state if it has just been pressed
+				 */
+				void pollButton(void){
+					this->debounceButton(Utility::FastPin<But>::read());
+				};
+		};
+
+
+	}
+
+
+
+
+	/**
+	 * Static::Switches is Switches without calls that depend on which class they're made through
+	 */
+	namespace Switches{
+
+
+		/**
+		 * BasicButton is the Button, for classes that want to build on it. Use Button, Momentary or Touch in a sketch.\n
+		 * Everything that reads the pin goes through Derived's readPin\(\) and getState\(\), so toSerial\(\) on a Momentary uses the Momentary's timing, which Switches::Button::toSerial\(\) doesn't.
+		 * @tparam Derived -the class deriving from this one, or void when this is the Button
+		 */
+		template<class Derived = void>
+		class BasicButton{
+			typedef typename MostDerived<Derived, BasicButton<Derived> >::type Self;
+			public:
+				/**
+				 * The constructor for a button
+				 * @param p -the arduino pin the button is connected to
+				 */
+				BasicButton(int p){
+					pin = p;
+					lastState = 0;
+					events = 0;
+				};
+
+
+				/**
+				 * Sets the pin as an input
+				 */
+				void begin(void){
+					Expansion::VirtualPins::setMode(pin, INPUT);
+				};
+
+
+				/**
+				 * Reads the button
+				 * @return int -HIGH or LOW
+				 */
+				int getState(void){
+					return self().readPin();
+				};
+
+
+				/**
+				 * Reads the button if the condition is met
+				 * @param condition -a boolean condition that must be met
+				 * @return int -HIGH or LOW, LOW when the condition isn't met
+				 */
+				int getState(bool condition){
+					return condition ? self().getState() : LOW;
+				};
+
+
+				/**
+				 * Prints the state of the button
+				 */
+				void toSerial(void){
+					Serial.println(self().getState());
+				};
+
+
+				/**
+				 * Prints the state of the button if the condition is met
+				 * @param condition -a boolean condition that must be met
+				 */
+				void toSerial(bool condition){
+					Serial.println(self().getState(condition));
+				};
+
+
+				/**
+				 * Reads the button through the debouncer and keeps the state for getLastState\(\)
+				 */
+				void poll(void){
+					lastState = debounce(self().readPin());
+				};
+
+
+				/**
+				 * Getter for the state read by the last poll\(\)
+				 * @return int
+				 */
+				int getLastState(void){
+					return lastState;
+				};
+
+
+				/**
+				 * Getter for the pin
+				 * @return int
+				 */
+				int getPin(void){
+					return pin;
+				};
+
+
+				/**
+				 * Sends the state over the serial port only when it has changed or the heartbeat is due, see Switches::Button::toSerialOnChange\(\)
+				 * @return bool -true if a line was sent
+				 */
+				bool toSerialOnChange(void){
+					int state = self().getState();
+					if(!tracker.check(state, state != 0, millis())){
+						return false;
+					}
+					Serial.print(tracker.getSequence());
+					Serial.print(' ');
+					Serial.println(state);
+					return true;
+				};
+
+
+				/**
+				 * Sets when toSerialOnChange\(\) sends
+				 * @param heartbeat -milliseconds after which the state is sent anyway, 0 for never
+				 */
+				void setReportByException(unsigned int heartbeat){
+					tracker.configure(1, heartbeat);
+				};
+
+
+				/**
+				 * Gets the debouncer's events since the last call and clears them, see Switches::Button::getEvents\(\)
+				 * @return uint8_t -Utility::Debouncer event bits
+				 */
+				uint8_t getEvents(void){
+					uint8_t taken = events;
+					events = 0;
+					return taken;
+				};
+
+
+				/**
+				 * Getter for the debouncer, to set its hold-off and click timing
+				 * @return Utility::Debouncer&
+				 */
+				Utility::Debouncer& getDebouncer(void){
+					return debouncer;
+				};
+			protected:
+				/**
+				 * Reads the pin, the Fast variants replace this
+				 * @return int -HIGH or LOW
+				 */
+				int readPin(void){
+					return Expansion::VirtualPins::readDigital(pin);
+				};
+
+
+				/**
+				 * Runs a reading through the debouncer, keeping its events for getEvents\(\)
+				 * @param level -what was read from the pin
+				 * @return int -the debounced state, 1 while pressed
+				 */
+				int debounce(int level){
+					events |= debouncer.update(level, millis());
+					return debouncer.getState();
+				};
+
+
+				/**
+				 * The button this is part of
+				 * @return Self&
+				 */
+				Self& self(void){
+					return static_cast<Self&>(*this);
+				};
+
+				Utility::ChangeTracker tracker;	///< Decides when toSerialOnChange\(\) sends
+				Utility::Debouncer debouncer;	///< Cleans up the reads for poll\(\) and Momentary and Touch
+				uint8_t events;	///< Debouncer events not yet taken by getEvents\(\)
+				int pin;	///<The arduino pin the button/touch-sensor is connected to
+				int lastState;	///<The state read by the last poll\(\)
+		};
+
+
+		typedef BasicButton<> Button;	///< A plain button, as Switches::Button
+
+
+
+
+		/**
+		 * BasicTimedButton is a button read through its debouncer, the shared part of Momentary and Touch.
+		 * @tparam Derived -the class deriving from this one
+		 */
+		template<class Derived>
+		class BasicTimedButton: public BasicButton<Derived>{
+			friend class BasicButton<Derived>;
+			public:
+				/**
+				 * The constructor for the button, with the debouncer's default timing and no lockout
+				 * @param p -the arduino pin the button is connected to
+				 */
+				BasicTimedButton(int p): BasicButton<Derived>(p){};
+
+
+				/**
+				 * The constructor for the button
+				 * @param p -the arduino pin the button is connected to
+				 * @param val -the debouncer's lockout, the least time from one press to the next -in milliseconds
+				 */
+				BasicTimedButton(int p, int val): BasicButton<Derived>(p){this->debouncer.setLockout(val);};
+
+
+				/**
+				 * Reads the button through the debouncer, see Switches::Momentary::getState\(\)
+				 * @return int -HIGH or LOW
+				 */
+				int getState(void){
+					return this->debounce(this->self().readPin());
+				};
+
+
+				/**
+				 * Reads the button if the condition is met, see getState\(\)
+				 * @param condition -a boolean condition that must be met
+				 * @return int -HIGH or LOW, LOW when the condition isn't met
+				 */
+				int getState(bool condition){
+					int state = getState();
+					return condition ? state : LOW;
+				};
+		};
+
+
+
+
+		/**
+		 * A momentary push button, as Switches::Momentary
+		 */
+		class Momentary: public BasicTimedButton<Momentary>{
+			public:
+				/**
+				 * The constructor for the button, with the debouncer's default timing and no lockout
+				 * @param p -the arduino pin the button is connected to
+				 */
+				Momentary(int p): BasicTimedButton<Momentary>(p){};
+
+
+				/**
+				 * The constructor for the button
+				 * @param p -the arduino pin the button is connected to
+				 * @param val -the debouncer's lockout, the least time from one press to the next -in milliseconds
+				 */
+				Momentary(int p, int val): BasicTimedButton<Momentary>(p, val){};
+		};
+
+
+
+
+		/**
+		 * A touch sensor, as Switches::Touch
+		 */
+		class Touch: public BasicTimedButton<Touch>{
+			public:
+				/**
+				 * The constructor for the sensor, with the debouncer's default timing and no lockout
+				 * @param p -the arduino pin the sensor is connected to
+				 */
+				Touch(int p): BasicTimedButton<Touch>(p){};
+
+
+				/**
+				 * The constructor for the sensor
+				 * @param p -the arduino pin the sensor is connected to
+				 * @param val -the debouncer's lockout, the least time from one press to the next -in milliseconds
+				 */
+				Touch(int p, int val): BasicTimedButton<Touch>(p, val){};
+		};
+
+
+
+
+		/**
+		 * A Button on a pin fixed at compile time, read with FastPin, as Switches::FastButton
+		 * @tparam P -the arduino pin the button is connected to
+		 */
+		template<uint8_t P>
+		class FastButton: public BasicButton<FastButton<P> >{
+			friend class BasicButton<FastButton<P> >;
+			public:
+				/**
+				 * The constructor for the button
+				 */
+				FastButton(void): BasicButton<FastButton<P> >(P){};
+
+
+				/**
+				 * Sets the pin as an input
+				 */
+				void begin(void){
+					Utility::FastPin<P>::input();
+				};
+			protected:
+				/**
+				 * Reads the pin with FastPin
+				 * @return int -HIGH or LOW
+				 */
+				int readPin(void){
+					return Utility::FastPin<P>::read();
+				};
+		};
+
+
+
+
+		/**
+		 * A Momentary on a pin fixed at compile time, read with FastPin, as Switches::FastMomentary
+		 * @tparam P -the arduino pin the button is connected to
+		 */
+		template<uint8_t P>
+		class FastMomentary: public BasicTimedButton<FastMomentary<P> >{
+			friend class BasicButton<FastMomentary<P> >;
+			friend class BasicTimedButton<FastMomentary<P> >;
+			public:
+				/**
+				 * The constructor for the button, with the debouncer's default timing and no lockout
+				 */
+				FastMomentary(void): BasicTimedButton<FastMomentary<P> >(P){};
+
+
+				/**
+				 * The constructor for the button
+				 * @param val -the debouncer's lockout, the least time from one press to the next -in milliseconds
+				 */
+				FastMomentary(int val): BasicTimedButton<FastMomentary<P> >(P, val){};
+
+
+				/**
+				 * Sets the pin as an input
+				 */
+				void begin(void){
+					Utility::FastPin<P>::input();
+				};
+			protected:
+				/**
+				 * Reads the pin with FastPin
+				 * @return int -HIGH or LOW
+				 */
+				int readPin(void){
+					return Utility::FastPin<P>::read();
+				};
+		};
+
+
+
+
+		/**
+		 * A Touch on a pin fixed at compile time, read with FastPin, as Switches::FastTouch
+		 * @tparam P -the arduino pin the sensor is connected to
+		 */
+		template<uint8_t P>
+		class FastTouch: public BasicTimedButton<FastTouch<P> >{
+			friend class BasicButton<FastTouch<P> >;
+			friend class BasicTimedButton<FastTouch<P> >;
+			public:
+				/**
+				 * The constructor for the sensor, with the debouncer's default timing and no lockout
+				 */
+				FastTouch(void): BasicTimedButton<FastTouch<P> >(P){};
+
+
+				/**
+				 * The constructor for the sensor
+				 * @param val -the debouncer's lockout, the least time from one press to the next -in milliseconds
+				 */
+				FastTouch(int val): BasicTimedButton<FastTouch<P> >(P, val){};
+
+
+				/**
+				 * Sets the pin as an input
+				 */
+				void begin(void){
+					Utility::FastPin<P>::input();
+				};
+			protected:
+				/**
+				 * Reads the pin with FastPin
+				 * @return int -HIGH or LOW
+				 */
+				int readPin(void){
+					return Utility::FastPin<P>::read();
+				};
+		};
+
+
+	}
+
+
+}
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ * @file
+ * @section desription Description
+ * An example using the CSF_Controls library.\n
+ * The same two pots as pot_example, but a ControlManager checks their power buttons and switches their power lines, so loop\(\) only has to tick it and print.\n
+ * The circuit used for this is pictured below: \(see documentation for library for wiring schematic on sections\)\n
+ * <IMG src="../images/example_circuit1.jpg" width="500" height="300">\n\n\n
+ * <IMG src="../images/example_circuit2.jpg" width="500" height="300">\n
+ */
+
+#include <CSF_Controls.h>
+
+using namespace Sensors;
+using namespace Scheduling;
+
+
+Pot rotary = Pot(2, 3, A0); ///<Object representing the rotary potentiometer and associated components
+Pot slider = Pot(5, 6, A2); ///<Object representing the slide potentiometer and associated components
+ControlManager manager = ControlManager(); ///<Runs the power buttons for both pots
+
+
+/**
+ * Prints both pots, the manager calls this every half second
+ */
+void printPots(){
+  if(rotary.getIsSensorOn()){
+    Serial.print("rotary pot: ");
+    rotary.toSerial();
+  }
+  if(slider.getIsSensorOn()){
+    Serial.print("slider pot: ");
+    slider.toSerial();
+  }
+}
+
+
+/**
+ * The standard setup\(\) method for arduino\n
+ * For this example it intializes the serial communication port and the Pot objects, then hands them to the manager
+ */
+void setup() {
+  Serial.begin(9600);
+  rotary.begin();
+  slider.begin();
+  rotary.mapData(-3.14f, 3.14f);
+  slider.mapData(24, 38);
+  manager.add(rotary);
+  manager.add(slider);
+  manager.add(printPots, 500);
+  manager.begin();
+}
+
+
+
+
+
+/**
+ * The standard loop\(\) method for Arduino\n
+ * The manager does the rest.
+ */
+void loop() {
+  manager.tick();
+}
@@ -0,0 +1,66 @@
+/**
+ * @file
+ * @section desription Description
+ * An example using the CSF_Controls library.\n
+ * Instead of waiting for the computer to ask for each value, the board pushes binary frames holding both pots and the button 50 times a second. Decode them on the computer with Host::FrameDecoder from host/CSF_Host.h.\n
+ * The circuit used for this is pictured below: \(see documentation for library for wiring schematic on sections\)\n
+ * <IMG src="../images/example_circuit1.jpg" width="500" height="300">\n\n\n
+ * <IMG src="../images/example_circuit2.jpg" width="500" height="300">\n
+ */
+
+#include <CSF_Controls.h>
+
+using namespace Sensors;
+using namespace Switches;
+using namespace Comms;
+
+
+Pot rotary = Pot(2, 3, A0); ///< Object representing the rotary potentiometer and associated components
+Pot slider = Pot(5, 6, A2); ///< Object representing the slide potentiometer and associated components
+Momentary clicker = Momentary(7); ///< Object representing the tactile-momentary-switch circuit
+FrameStreamer streamer = FrameStreamer(20); ///< Sends a frame every 20 milliseconds
+
+
+/**
+ * The standard setup\(\) method for arduino\n
+ * For this example it intializes the serial communication port, the controls, and adds the controls to the streamer in the order the computer will see them
+ */
+void setup() {
+  Serial.begin(115200);
+  rotary.begin();
+  slider.begin();
+  clicker.begin();
+  streamer.add(rotary);
+  streamer.add(slider);
+  streamer.add(clicker);
+  streamer.begin();
+}
+
+
+
+
+
+/**
+ * The standard loop\(\) method for Arduino\n
+ * Here it checks if the sensors need activated/deactivated and lets the streamer send a frame when it is due.
+ */
+void loop() {
+  rotary.isButtonPressed();
+  slider.isButtonPressed();
+
+  if(rotary.getIsSensorOn()){
+    rotary.activateControl();
+  }
+  else{
+    rotary.deactivateControl();
+  }
+
+  if(slider.getIsSensorOn()){
+    slider.activateControl();
+  }
+  else{
+    slider.deactivateControl();
+  }
+
+  streamer.update();
+}
@@ -0,0 +1,472 @@
+#include "CSF_Aggregator.h"
+#include "CSF_Client.h"
+#include <algorithm>
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+using namespace Host;
+
+namespace{
+	const uint64_t TAG_DEVICE = 0;	///< The high half of an epoll event's data says which kind of descriptor it is, the low half which one
+	const uint64_t TAG_LISTENER = 1;
+	const uint64_t TAG_CLIENT = 2;
+	const int CLIENT_BUFFER = 4 << 20;	///< Asked for as each client's send buffer, so a client can fall a good way behind before it loses records
+
+
+	/**
+	 * The time now on steady_clock
+	 * @return int64_t -nanoseconds
+	 */
+	int64_t now(){
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}//end now()
+
+
+	/**
+	 * Adds a descriptor to an epoll set for reading
+	 * @param epollFd -the set
+	 * @param fd -the descriptor
+	 * @param tag -TAG_DEVICE, TAG_LISTENER or TAG_CLIENT
+	 * @param index -the device number, or the descriptor itself for a client
+	 * @return bool -false if epoll wouldn't take it
+	 */
+	bool watch(int epollFd, int fd, uint64_t tag, uint32_t index){
+		struct epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN;
+		event.data.u64 = (tag << 32) | index;
+		return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+	}//end watch()
+
+
+	/**
+	 * Fills in the address of a Unix socket
+	 * @param path -where the socket is
+	 * @param address -filled in
+	 * @return bool -false if the path is too long
+	 */
+	bool addressOf(const char* path, struct sockaddr_un& address){
+		memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		if(strlen(path) >= sizeof(address.sun_path)){
+			return false;
+		}
+		strcpy(address.sun_path, path);
+		return true;
+	}//end addressOf()
+}
+
+
+
+
+// Aggregator
+
+Aggregator::Aggregator(unsigned long windowMicros, size_t queueDepth){
+	epollFd = epoll_create1(EPOLL_CLOEXEC);
+	window = (int64_t)windowMicros * 1000;
+	depth = queueDepth > 0 ? queueDepth : 1;
+	deviceCount = 0;
+	reading = 0;
+	readTime = 0;
+	listenFd = -1;
+	batched = 0;
+	for(size_t i = 0; i < FEED_BATCH; i++){
+		vectors[i].iov_base = &batch[i];
+		vectors[i].iov_len = 0;
+		memset(&messages[i], 0, sizeof(messages[i]));
+		messages[i].msg_hdr.msg_iov = &vectors[i];
+		messages[i].msg_hdr.msg_iovlen = 1;
+	}
+	handler = NULL;
+	handlerContext = NULL;
+	records = 0;
+	lastSent = INT64_MIN;
+	clientDrops = 0;
+}//end constructor
+
+
+Aggregator::~Aggregator(){
+	for(uint8_t i = 0; i < deviceCount; i++){
+		closeDevice(i);
+	}
+	for(int client : clients){
+		close(client);
+	}
+	if(listenFd >= 0){
+		close(listenFd);
+		unlink(socketPath.c_str());
+	}
+	if(epollFd >= 0){
+		close(epollFd);
+	}
+}//end destructor
+
+
+int Aggregator::add(const char* path, unsigned long baud){
+	int port = openPort(path, baud);
+	if(port < 0){
+		return -1;
+	}
+	int device = addDevice(port, true);
+	if(device < 0){
+		close(port);
+	}
+	return device;
+}//end add()
+
+
+int Aggregator::attach(int port){
+	return addDevice(port, false);
+}//end attach()
+
+
+int Aggregator::addDevice(int port, bool owns){
+	if(epollFd < 0 || deviceCount >= CSF_AGGREGATOR_DEVICES){
+		return -1;
+	}
+	uint8_t index = deviceCount;
+	fcntl(port, F_SETFL, fcntl(port, F_GETFL) | O_NONBLOCK);
+	if(!watch(epollFd, port, TAG_DEVICE, index)){
+		return -1;
+	}
+	Device& device = devices[index];
+	device.fd = port;
+	device.ownsFd = owns;
+	device.decoder.reset();
+	device.queue = queues.size();
+	device.head = 0;
+	device.held = 0;
+	device.synced = false;
+	device.lastTimestamp = 0;
+	device.lastTime = 0;
+	memset(&device.stats, 0, sizeof(device.stats));
+	device.stats.open = true;
+	queues.resize(queues.size() + depth);
+	deviceCount++;
+	return index;
+}//end addDevice()
+
+
+bool Aggregator::listen(const char* path){
+	struct sockaddr_un address;
+	if(epollFd < 0 || listenFd >= 0 || !addressOf(path, address)){
+		return false;
+	}
+	int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);	//seqpacket keeps each record whole, so the clients don't need to find where one ends
+	if(fd < 0){
+		return false;
+	}
+	unlink(path);
+	if(bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0 || ::listen(fd, 16) != 0 || !watch(epollFd, fd, TAG_LISTENER, 0)){
+		close(fd);
+		return false;
+	}
+	listenFd = fd;
+	socketPath = path;
+	return true;
+}//end listen()
+
+
+void Aggregator::onRecord(RecordHandler recordHandler, void* context){
+	handler = recordHandler;
+	handlerContext = context;
+}//end onRecord()
+
+
+size_t Aggregator::poll(int timeoutMs){
+	//come back when the first held frame is due, if that's sooner
+	int wait = timeoutMs;
+	int first = earliest();
+	if(first >= 0){
+		const FeedRecord& next = queues[devices[first].queue + devices[first].head];
+		int64_t due = next.time + window - now();
+		int dueMs = due <= 0 ? 0 : (int)((due + 999999) / 1000000);
+		wait = (wait < 0 || dueMs < wait) ? dueMs : wait;
+	}
+
+	int ready = epoll_wait(epollFd, events, EVENTS, wait);
+	int64_t time = now();
+	for(int i = 0; i < ready; i++){
+		uint64_t tag = events[i].data.u64 >> 32;
+		uint32_t index = (uint32_t)events[i].data.u64;
+		if(tag == TAG_DEVICE){
+			readDevice(index, time);
+		}
+		else if(tag == TAG_LISTENER){
+			acceptClients();
+		}
+		else{
+			char ignored[64];	//clients have nothing to say, this is only to see them hang up
+			ssize_t count = read(index, ignored, sizeof(ignored));
+			if(count == 0 || (count < 0 && errno != EAGAIN && errno != EINTR)){
+				dropClient(index);
+			}
+		}
+	}
+	size_t sent = release(time, false);
+	sendBatch();
+	return sent;
+}//end poll()
+
+
+size_t Aggregator::flush(){
+	size_t sent = release(now(), true);
+	sendBatch();
+	return sent;
+}//end flush()
+
+
+void Aggregator::readDevice(uint8_t index, int64_t time){
+	Device& device = devices[index];
+	if(device.fd < 0){
+		return;
+	}
+	ssize_t count = read(device.fd, block, sizeof(block));	//one read per pass, so a busy board can't starve the rest
+	if(count > 0){
+		device.stats.bytes += count;
+		reading = index;
+		readTime = time;
+		device.decoder.feed(block, count, decoded, this);
+	}
+	else if(count == 0 || (errno != EAGAIN && errno != EINTR)){
+		closeDevice(index);	//a pseudo-terminal with its master closed reads EIO
+	}
+}//end readDevice()
+
+
+void Aggregator::closeDevice(uint8_t index){
+	Device& device = devices[index];
+	if(device.fd < 0){
+		return;
+	}
+	epoll_ctl(epollFd, EPOLL_CTL_DEL, device.fd, NULL);
+	if(device.ownsFd){
+		close(device.fd);
+	}
+	device.fd = -1;
+	device.stats.open = false;
+}//end closeDevice()
+
+
+void Aggregator::decoded(const Frame& frame, void* context){
+	Aggregator* aggregator = (Aggregator*)context;
+	aggregator->hold(aggregator->reading, frame, aggregator->readTime);
+}//end decoded()
+
+
+void Aggregator::hold(uint8_t index, const Frame& frame, int64_t arrived){
+	Device& device = devices[index];
+	if(device.held == depth){
+		device.stats.overflows++;
+		release(arrived, true, index);
+	}
+
+	//onto the PC's clock: the last estimate moved on by the board's time between the frames, plus a little slack, but never after the frame arrived
+	uint32_t elapsed = frame.timestamp - device.lastTimestamp;
+	int64_t time = arrived;
+	if(device.synced && elapsed < 0x80000000UL){
+		int64_t step = (int64_t)elapsed * 1000000;
+		time = std::min(arrived, device.lastTime + step + (step >> CLOCK_SLACK_SHIFT));
+	}//else the first frame or the board restarted, all there is to go on is when it arrived
+	device.synced = true;
+	device.lastTimestamp = frame.timestamp;
+	device.lastTime = time;
+
+	FeedRecord& record = queues[device.queue + (device.head + device.held) % depth];
+	record.timestamp = frame.timestamp;
+	record.time = time;
+	record.received = arrived;
+	record.sequence = frame.sequence;
+	record.device = index;
+	record.count = frame.count;
+	memcpy(record.channels, frame.channels, frame.count * sizeof(Channel));
+	device.held++;
+}//end hold()
+
+
+size_t Aggregator::release(int64_t time, bool all, int until){
+	size_t sent = 0;
+	while(until < 0 || devices[until].held == depth){
+		int first = earliest();
+		if(first < 0){
+			break;
+		}
+		Device& device = devices[first];
+		FeedRecord& record = queues[device.queue + device.head];
+		if(!all && record.time + window > time){
+			break;
+		}
+		if(record.time < lastSent){
+			device.stats.late++;
+		}
+		else{
+			lastSent = record.time;
+		}
+		emit(record);
+		device.head = (device.head + 1) % depth;
+		device.held--;
+		sent++;
+	}
+	return sent;
+}//end release()
+
+
+int Aggregator::earliest() const{
+	int first = -1;
+	int64_t time = INT64_MAX;
+	for(uint8_t i = 0; i < deviceCount; i++){
+		const Device& device = devices[i];
+		if(device.held > 0 && queues[device.queue + device.head].time < time){
+			time = queues[device.queue + device.head].time;
+			first = i;
+		}
+	}
+	return first;
+}//end earliest()
+
+
+void Aggregator::emit(FeedRecord& record){
+	record.index = records++;
+	if(handler != NULL){
+		handler(record, handlerContext);
+	}
+	if(clients.empty()){
+		return;
+	}
+	size_t size = FEED_HEADER_SIZE + record.count * sizeof(Channel);
+	memcpy(&batch[batched], &record, size);
+	vectors[batched].iov_len = size;
+	batched++;
+	if(batched == FEED_BATCH){
+		sendBatch();
+	}
+}//end emit()
+
+
+void Aggregator::sendBatch(){
+	if(batched == 0){
+		return;
+	}
+	for(size_t i = 0; i < clients.size(); i++){
+		int fd = clients[i];
+		size_t done = 0;
+		while(done < batched){
+			int count = sendmmsg(fd, messages + done, batched - done, MSG_DONTWAIT | MSG_NOSIGNAL);
+			if(count > 0){
+				done += count;
+			}
+			else if(count < 0 && errno == EINTR){
+				continue;
+			}
+			else if(count < 0 && errno != EAGAIN){
+				dropClient(fd);	//hung up, it's gone from clients so look at this slot again
+				i--;
+				break;
+			}
+			else{
+				clientDrops += batched - done;	//its buffer is full, it misses the rest of the batch
+				break;
+			}
+		}
+	}
+	batched = 0;
+}//end sendBatch()
+
+
+void Aggregator::acceptClients(){
+	while(true){
+		int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if(fd < 0){
+			return;
+		}
+		setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &CLIENT_BUFFER, sizeof(CLIENT_BUFFER));	//capped at net.core.wmem_max, whatever it gets is fine
+		if(!watch(epollFd, fd, TAG_CLIENT, fd)){
+			close(fd);
+			continue;
+		}
+		clients.push_back(fd);
+	}
+}//end acceptClients()
+
+
+void Aggregator::dropClient(int fd){
+	std::vector<int>::iterator found = std::find(clients.begin(), clients.end(), fd);
+	if(found == clients.end()){
+		return;
+	}
+	clients.erase(found);
+	epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, NULL);
+	close(fd);
+}//end dropClient()
+
+
+size_t Aggregator::getDeviceCount() const{
+	return deviceCount;
+}//end getDeviceCount()
+
+
+DeviceStats Aggregator::getStats(uint8_t index) const{
+	DeviceStats stats;
+	memset(&stats, 0, sizeof(stats));
+	if(index >= deviceCount){
+		return stats;
+	}
+	const Device& device = devices[index];
+	stats = device.stats;
+	stats.frames = device.decoder.getFrames();
+	stats.errors = device.decoder.getErrors();
+	stats.dropped = device.decoder.getDropped();
+	return stats;
+}//end getStats()
+
+
+unsigned long Aggregator::getRecords() const{
+	return records;
+}//end getRecords()
+
+
+size_t Aggregator::getClientCount() const{
+	return clients.size();
+}//end getClientCount()
+
+
+unsigned long Aggregator::getClientDrops() const{
+	return clientDrops;
+}//end getClientDrops()
+
+
+
+
+
+
+// Feed
+
+int Host::connectFeed(const char* path){
+	struct sockaddr_un address;
+	if(!addressOf(path, address)){
+		return -1;
+	}
+	int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	if(fd < 0){
+		return -1;
+	}
+	if(connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0){
+		close(fd);
+		return -1;
+	}
+	return fd;
+}//end connectFeed()
+
+
+bool Host::readFeed(int fd, FeedRecord& record){
+	ssize_t count;
+	do{
+		count = recv(fd, &record, sizeof(record), 0);
+	}while(count < 0 && errno == EINTR);
+	return count >= (ssize_t)FEED_HEADER_SIZE && record.count <= Comms::FRAME_MAX_CHANNELS && (size_t)count == FEED_HEADER_SIZE + record.count * sizeof(Channel);
+}//end readFeed()
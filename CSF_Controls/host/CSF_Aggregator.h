@@ -0,0 +1,326 @@
+/**
+ * @file
+ * @section description Description
+ * An aggregator for a Linux PC with several boards plugged in, each running a Comms::FrameStreamer.\n
+ * Where the Client gives every board a thread of its own, the Aggregator reads all of them from one epoll loop, decodes each one's frames as the bytes come in and merges them into a single feed in the order they happened on the boards. The feed is handed to a callback in the same process and sent to any number of other programs over a Unix socket, see connectFeed\(\) and readFeed\(\) for the other end.\n
+ * tools/CSF_Aggregated.cpp runs it as a daemon, demo/CSF_AggregatorDemo.cpp measures it with pseudo-terminals standing in for the boards.
+ */
+
+
+#ifndef CSF_Aggregator_h
+#define CSF_Aggregator_h
+
+#include "CSF_Host.h"
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <string>
+#include <vector>
+
+
+#ifndef CSF_AGGREGATOR_DEVICES
+#define CSF_AGGREGATOR_DEVICES 64	///< The most boards one Aggregator reads, the device number in a FeedRecord is a byte
+#endif
+
+
+namespace Host{
+
+
+	/**
+	 * One frame in the merged feed, exactly as it goes over the Unix socket: the fields up to channels, then count of the channels, so a record is FEED_HEADER_SIZE + 4 * count bytes.\n
+	 * The socket only ever connects programs on the same PC, so the layout is the PC's own rather than packed little endian like a frame on the serial port.
+	 */
+	struct FeedRecord{
+		uint32_t index;	///< Counts every record the Aggregator has sent, a gap means the client was too slow to take some
+		uint32_t timestamp;	///< millis\(\) on the board when the frame was built
+		int64_t time;	///< The timestamp moved onto the PC's clock, what the feed is in order of, nanoseconds on std::chrono::steady_clock
+		int64_t received;	///< When the frame was decoded, nanoseconds on std::chrono::steady_clock
+		uint16_t sequence;	///< The board's sequence number
+		uint8_t device;	///< Which board, in the order they were added to the Aggregator
+		uint8_t count;	///< How many of the channels are filled in
+		Channel channels[Comms::FRAME_MAX_CHANNELS];	///< The channels in the order they were added on the board
+	};
+
+	const size_t FEED_HEADER_SIZE = offsetof(FeedRecord, channels);	///< The size of a record with no channels
+
+
+	/**
+	 * The counts kept for each board
+	 */
+	struct DeviceStats{
+		unsigned long bytes;	///< Bytes read off the port
+		unsigned long frames;	///< Good frames decoded
+		unsigned long errors;	///< Frames thrown away as corrupt
+		unsigned long dropped;	///< Frames the sequence numbers say never arrived
+		unsigned long late;	///< Frames that arrived after the feed had already moved past their time, sent on straight away
+		unsigned long overflows;	///< Frames sent before their window was up because the board's queue was full
+		bool open;	///< Cleared when the port hangs up or fails
+	};
+
+
+
+
+	/**
+	 * The Aggregator owns an epoll set with every board's port in it, the listening Unix socket and the clients connected to it. Nothing runs on its own, the program calls poll\(\) in a loop, so it all happens on the program's thread.\n
+	 * Each board has its own FrameDecoder and a fixed ring of FeedRecords the frames are decoded straight into, set up when the board is added, so nothing is allocated per frame. A client connecting is the only thing that allocates once the boards are added.\n
+	 * Every board counts millis\(\) from its own reset, so each frame's timestamp is moved onto the PC's clock before the streams are merged. The Aggregator keeps a running estimate for each board from the quickest trips, the estimate only ever lands on or before the frame's arrival and it's let creep forward a little each frame so a board's resonator running slow doesn't leave it behind. A frame is held for the window so a slower board's frames from the same moment can catch up, then whichever board's oldest frame is earliest goes next. The oldest frames are at the front of each ring, so that's a look at one record per board.\n
+	 * The records going out are collected and sent to each client with one sendmmsg\(\) per poll\(\) pass, or per FEED_BATCH records if there are more. The sends never block, a client too slow to keep up loses records rather than holding up the boards, see FeedRecord::index.
+	 */
+	class Aggregator{
+		public:
+			/**
+			 * Called with each record as it joins the feed
+			 */
+			typedef void (*RecordHandler)(const FeedRecord& record, void* context);
+
+
+			/**
+			 * The constructor for Aggregator
+			 * @param windowMicros -how long a frame is held for the other boards' frames from the same moment to arrive, in microseconds
+			 * @param queueDepth -how many frames each board can have held at once, more than the window holds at the fastest frame rate
+			 */
+			Aggregator(unsigned long windowMicros = 10000, size_t queueDepth = 64);
+
+
+			/**
+			 * The destructor, closes the ports it opened, the clients and the listening socket
+			 */
+			~Aggregator(void);
+
+
+			/**
+			 * Opens a board's serial port and adds it
+			 * @param path -e.g. /dev/ttyACM0, or the slave side of a pseudo-terminal
+			 * @param baud -the baud rate the board's Serial.begin\(\) used
+			 * @return int -the device number in the feed, or -1 if the port couldn't be opened or there's no room
+			 */
+			int add(const char* path, unsigned long baud = 115200);
+
+
+			/**
+			 * Adds a board on a file descriptor that's already open, it is switched to non-blocking
+			 * @param port -the descriptor, the Aggregator doesn't close it
+			 * @return int -the device number in the feed, or -1 if there's no room
+			 */
+			int attach(int port);
+
+
+			/**
+			 * Starts taking clients on a Unix socket, replacing anything already at that path
+			 * @param path -where the socket goes in the file system
+			 * @return bool -false if it couldn't be set up
+			 */
+			bool listen(const char* path);
+
+
+			/**
+			 * Sets the function called with each record, set it before the first poll\(\)
+			 * @param handler -the function, NULL for none
+			 * @param context -passed through to the handler
+			 */
+			void onRecord(RecordHandler handler, void* context = NULL);
+
+
+			/**
+			 * Waits for the ports and sockets, reads whatever is ready and sends on the frames whose window is up
+			 * @param timeoutMs -the longest to wait for something to happen, it comes back sooner when a held frame is due
+			 * @return size_t -the number of records sent
+			 */
+			size_t poll(int timeoutMs);
+
+
+			/**
+			 * Sends on every frame still held without waiting out its window, e.g. before shutting down
+			 * @return size_t -the number of records sent
+			 */
+			size_t flush(void);
+
+
+			/**
+			 * Getter for the number of boards added
+			 * @return size_t
+			 */
+			size_t getDeviceCount(void) const;
+
+
+			/**
+			 * Gets a board's counts
+			 * @param device -the device number from add\(\) or attach\(\)
+			 * @return DeviceStats -all zero if there's no such board
+			 */
+			DeviceStats getStats(uint8_t device) const;
+
+
+			/**
+			 * Getter for the number of records that have joined the feed
+			 * @return unsigned long
+			 */
+			unsigned long getRecords(void) const;
+
+
+			/**
+			 * Getter for the number of clients connected to the socket
+			 * @return size_t
+			 */
+			size_t getClientCount(void) const;
+
+
+			/**
+			 * Getter for the number of records a client's socket was too full to take, over all the clients
+			 * @return unsigned long
+			 */
+			unsigned long getClientDrops(void) const;
+		protected:
+			/**
+			 * One board
+			 */
+			struct Device{
+				int fd;	///< Its port, -1 once it's closed
+				bool ownsFd;	///< Set when add\(\) opened the port
+				FrameDecoder decoder;	///< Only its bytes go through here
+				size_t queue;	///< Where its ring starts in queues
+				size_t head;	///< The oldest record held in the ring
+				size_t held;	///< How many records are held
+				bool synced;	///< Set once a frame has set the clock estimate
+				uint32_t lastTimestamp;	///< The board timestamp of the frame before
+				int64_t lastTime;	///< The estimate for the frame before
+				DeviceStats stats;	///< Its counts, frames, errors and dropped are copied from the decoder
+			};
+
+
+			/**
+			 * Adds a descriptor to the Aggregator's boards
+			 * @param port -the descriptor
+			 * @param owns -whether the Aggregator closes it
+			 * @return int -the device number, or -1 if there's no room
+			 */
+			int addDevice(int port, bool owns);
+
+
+			/**
+			 * Reads what's waiting on a board's port and decodes it into the board's ring
+			 * @param device -the device number
+			 * @param now -when the read happened, nanoseconds on steady_clock
+			 */
+			void readDevice(uint8_t device, int64_t now);
+
+
+			/**
+			 * Takes a board out of the epoll set and closes its port if it owns it, leaving its held frames to be sent
+			 * @param device -the device number
+			 */
+			void closeDevice(uint8_t device);
+
+
+			/**
+			 * The FrameDecoder::FrameHandler for the board being read
+			 * @param frame -the good frame
+			 * @param context -the Aggregator
+			 */
+			static void decoded(const Frame& frame, void* context);
+
+
+			/**
+			 * Moves a frame onto the PC's clock and puts it on the end of its board's ring
+			 * @param device -the device number
+			 * @param frame -the good frame
+			 * @param arrived -when it was read, nanoseconds on steady_clock
+			 */
+			void hold(uint8_t device, const Frame& frame, int64_t arrived);
+
+
+			/**
+			 * Sends on held records in time order
+			 * @param now -nanoseconds on steady_clock
+			 * @param all -send everything held, not just the records whose window is up
+			 * @param until -stop once this board has room in its ring, -1 to go on until there's nothing more to send
+			 * @return size_t -the number of records sent
+			 */
+			size_t release(int64_t now, bool all, int until = -1);
+
+
+			/**
+			 * Finds the board whose oldest held record is earliest
+			 * @return int -the device number, or -1 if nothing is held
+			 */
+			int earliest(void) const;
+
+
+			/**
+			 * Adds a record to the batch going out and runs the callback
+			 * @param record -the record, its index is filled in
+			 */
+			void emit(FeedRecord& record);
+
+
+			/**
+			 * Sends the batch to every client
+			 */
+			void sendBatch(void);
+
+
+			/**
+			 * Takes everyone waiting to connect to the listening socket
+			 */
+			void acceptClients(void);
+
+
+			/**
+			 * Hangs up on a client
+			 * @param fd -its socket
+			 */
+			void dropClient(int fd);
+
+			static const size_t FEED_BATCH = 64;	///< The most records sent to a client with one sendmmsg\(\)
+			static const int EVENTS = 64;	///< The most epoll events taken in one pass
+			static const int CLOCK_SLACK_SHIFT = 7;	///< The clock estimate may creep forward 1/2^this of the time between frames, 0.8%, more than a ceramic resonator is off by
+
+			int epollFd;	///< The epoll set
+			int64_t window;	///< How long frames are held, nanoseconds
+			size_t depth;	///< The size of each board's ring
+			Device devices[CSF_AGGREGATOR_DEVICES];	///< The boards
+			uint8_t deviceCount;	///< How many boards have been added
+			std::vector<FeedRecord> queues;	///< Every board's ring, one after another, grown only by add\(\)
+			uint8_t reading;	///< The board whose bytes are going through its decoder
+			int64_t readTime;	///< When they were read
+			uint8_t block[4096];	///< Where the bytes are read to
+			struct epoll_event events[EVENTS];	///< Filled in by epoll_wait\(\)
+
+			int listenFd;	///< The Unix socket clients connect to, -1 before listen\(\)
+			std::string socketPath;	///< Removed by the destructor
+			std::vector<int> clients;	///< The connected clients' sockets
+			FeedRecord batch[FEED_BATCH];	///< The records going out
+			struct iovec vectors[FEED_BATCH];	///< One per record in the batch
+			struct mmsghdr messages[FEED_BATCH];	///< One per record in the batch
+			size_t batched;	///< How many records are in the batch
+
+			RecordHandler handler;	///< Called with each record
+			void* handlerContext;	///< Passed to the handler
+			uint32_t records;	///< The index the next record gets
+			int64_t lastSent;	///< The time of the newest record sent, a frame from before it is late
+			unsigned long clientDrops;	///< Records the clients' sockets were too full to take
+	};
+
+
+
+
+	/**
+	 * Connects to an Aggregator's Unix socket to read the feed
+	 * @param path -the path given to Aggregator::listen\(\)
+	 * @return int -the socket, or -1 if nothing is listening there
+	 */
+	int connectFeed(const char* path);
+
+
+	/**
+	 * Waits for the next record on a socket from connectFeed\(\)
+	 * @param fd -the socket
+	 * @param record -filled in
+	 * @return bool -false once the Aggregator hangs up, or if what arrived isn't a record
+	 */
+	bool readFeed(int fd, FeedRecord& record);
+
+
+}
+
+#endif
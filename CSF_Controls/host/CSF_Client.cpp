@@ -0,0 +1,376 @@
+#include "CSF_Client.h"
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+
+using namespace Host;
+
+namespace{
+	/**
+	 * The time now on steady_clock
+	 * @return int64_t -nanoseconds
+	 */
+	int64_t now(){
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}//end now()
+
+
+	/**
+	 * The termios speed for a baud rate
+	 * @param baud -the baud rate
+	 * @return speed_t -B0 if it isn't one termios knows
+	 */
+	speed_t speedOf(unsigned long baud){
+		switch(baud){
+			case 9600: return B9600;
+			case 19200: return B19200;
+			case 38400: return B38400;
+			case 57600: return B57600;
+			case 115200: return B115200;
+			case 230400: return B230400;
+			#ifdef B460800
+			case 460800: return B460800;
+			#endif
+			#ifdef B921600
+			case 921600: return B921600;
+			#endif
+			#ifdef B1000000
+			case 1000000: return B1000000;
+			#endif
+			#ifdef B2000000
+			case 2000000: return B2000000;
+			#endif
+			default: return B0;
+		}
+	}//end speedOf()
+}
+
+
+
+
+// openPort
+
+int Host::openPort(const char* path, unsigned long baud){
+	int port = ::open(path, O_RDWR | O_NOCTTY | O_CLOEXEC);
+	if(port < 0){
+		return -1;
+	}
+	struct termios settings;
+	if(tcgetattr(port, &settings) != 0){
+		close(port);
+		return -1;
+	}
+	cfmakeraw(&settings);
+	settings.c_cflag |= CLOCAL | CREAD;
+	settings.c_cc[VMIN] = 0;	//reads come back with whatever is there, poll() does the waiting
+	settings.c_cc[VTIME] = 0;
+	speed_t speed = speedOf(baud);
+	if(speed != B0){
+		cfsetispeed(&settings, speed);
+		cfsetospeed(&settings, speed);
+	}
+	if(tcsetattr(port, TCSANOW, &settings) != 0){
+		close(port);
+		return -1;
+	}
+	tcflush(port, TCIFLUSH);
+	return port;
+}//end openPort()
+
+
+
+
+
+
+// Client
+
+Client::Client(size_t historyDepth){
+	fd = -1;
+	ownsFd = false;
+	running = false;
+	version = 0;
+	header = 0;
+	timestamp = 0;
+	received = 0;
+	seen = 0;
+	for(size_t i = 0; i < Comms::FRAME_MAX_CHANNELS; i++){
+		channels[i] = 0;
+		historyHeads[i] = 0;
+	}
+	frames = 0;
+	errors = 0;
+	dropped = 0;
+	depth = historyDepth > 0 ? historyDepth : 1;
+	delayHead = 0;
+	hasEpoch = false;
+	epoch = 0;
+	fastest = INT64_MAX;
+}//end constructor
+
+
+Client::~Client(){
+	stop();
+}//end destructor
+
+
+bool Client::open(const char* path, unsigned long baud){
+	if(running){
+		return false;
+	}
+	int port = openPort(path, baud);
+	if(port < 0){
+		return false;
+	}
+	if(!attach(port)){
+		close(port);
+		return false;
+	}
+	ownsFd = true;
+	return true;
+}//end open()
+
+
+bool Client::attach(int port){
+	if(running){
+		return false;
+	}
+	stop();	//a reader that ended on its own, the port hung up, still has to be joined, and the port it opened closed
+	fd = port;
+	ownsFd = false;
+	decoder.reset();
+	running = true;
+	reader = std::thread(&Client::run, this);
+	return true;
+}//end attach()
+
+
+void Client::stop(){
+	running = false;
+	if(reader.joinable()){
+		reader.join();
+	}
+	if(ownsFd && fd >= 0){
+		close(fd);
+	}
+	fd = -1;
+	ownsFd = false;
+}//end stop()
+
+
+bool Client::isRunning() const{
+	return running;
+}//end isRunning()
+
+
+void Client::onChange(ChangeHandler handler){
+	changeHandler = handler;
+}//end onChange()
+
+
+void Client::onFrame(FrameCallback callback){
+	frameCallback = callback;
+}//end onFrame()
+
+
+void Client::run(){
+	uint8_t block[512];
+	Frame frame;
+	while(running){
+		struct pollfd waiting = {fd, POLLIN, 0};
+		int ready = poll(&waiting, 1, 50);	//wakes up now and then to see if stop() was called
+		if(ready < 0 && errno != EINTR){
+			break;
+		}
+		if(ready <= 0){
+			continue;
+		}
+		ssize_t count = read(fd, block, sizeof(block));
+		if(count < 0 && errno != EAGAIN && errno != EINTR){
+			break;
+		}
+		if(count == 0 && (waiting.revents & POLLHUP)){
+			break;
+		}
+		int64_t arrived = now();
+		for(ssize_t i = 0; i < count; i++){
+			if(decoder.push(block[i], frame)){
+				publish(frame, arrived);
+			}
+		}
+		frames = decoder.getFrames();
+		errors = decoder.getErrors();
+		dropped = decoder.getDropped();
+	}
+	running = false;
+}//end run()
+
+
+void Client::publish(const Frame& frame, int64_t arrived){
+	Channel before[Comms::FRAME_MAX_CHANNELS];
+	uint64_t wasSeen = seen.load(std::memory_order_relaxed);
+	for(uint8_t i = 0; i < frame.count; i++){
+		before[i] = unpack(channels[i].load(std::memory_order_relaxed));
+	}
+
+	//the sequence lock, odd while writing
+	uint32_t v = version.load(std::memory_order_relaxed);
+	version.store(v + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	header.store(frame.sequence | ((uint32_t)frame.count << 16), std::memory_order_relaxed);
+	timestamp.store(frame.timestamp, std::memory_order_relaxed);
+	received.store(arrived, std::memory_order_relaxed);
+	for(uint8_t i = 0; i < frame.count; i++){
+		channels[i].store(pack(frame.channels[i]), std::memory_order_relaxed);
+	}
+	seen.store(wasSeen | (frame.count >= 64 ? ~0ULL : ((1ULL << frame.count) - 1)), std::memory_order_relaxed);
+	version.store(v + 2, std::memory_order_release);
+
+	{
+		std::lock_guard<std::mutex> guard(historyLock);
+		for(uint8_t i = 0; i < frame.count; i++){
+			std::vector<Sample>& ring = histories[i];
+			Sample sample = {arrived, frame.timestamp, frame.channels[i].on, frame.channels[i].value};
+			if(ring.size() < depth){
+				ring.push_back(sample);
+			}
+			else{
+				ring[historyHeads[i]] = sample;
+			}
+			historyHeads[i] = (historyHeads[i] + 1) % depth;
+		}
+		int64_t delay = arrived - (int64_t)frame.timestamp * 1000000;
+		if(hasEpoch){
+			delay -= epoch;
+		}
+		else if(delay < fastest){
+			fastest = delay;
+		}
+		if(delays.size() < LATENCY_SAMPLES){
+			delays.push_back(delay);
+		}
+		else{
+			delays[delayHead] = delay;
+		}
+		delayHead = (delayHead + 1) % LATENCY_SAMPLES;
+	}
+
+	if(frameCallback){
+		frameCallback(frame);
+	}
+	if(changeHandler){
+		for(uint8_t i = 0; i < frame.count; i++){
+			const Channel& now = frame.channels[i];
+			if(!(wasSeen & (1ULL << i)) || now.value != before[i].value || now.on != before[i].on){
+				changeHandler(i, now, before[i]);
+			}
+		}
+	}
+}//end publish()
+
+
+bool Client::snapshot(Snapshot& out) const{
+	uint32_t before;
+	uint32_t after;
+	do{
+		before = version.load(std::memory_order_acquire);
+		uint32_t packed = header.load(std::memory_order_relaxed);
+		out.sequence = packed & 0xFFFF;
+		out.count = (uint8_t)(packed >> 16);
+		out.timestamp = timestamp.load(std::memory_order_relaxed);
+		out.received = received.load(std::memory_order_relaxed);
+		for(uint8_t i = 0; i < out.count && i < Comms::FRAME_MAX_CHANNELS; i++){
+			out.channels[i] = unpack(channels[i].load(std::memory_order_relaxed));
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		after = version.load(std::memory_order_relaxed);
+	}while((before & 1) != 0 || before != after);
+	return before != 0;
+}//end snapshot()
+
+
+bool Client::latest(uint8_t channel, Channel& out) const{
+	if(channel >= Comms::FRAME_MAX_CHANNELS || !(seen.load(std::memory_order_acquire) & (1ULL << channel))){
+		return false;
+	}
+	out = unpack(channels[channel].load(std::memory_order_acquire));	//one word, so it can't be torn
+	return true;
+}//end latest()
+
+
+size_t Client::history(uint8_t channel, std::vector<Sample>& out) const{
+	out.clear();
+	if(channel >= Comms::FRAME_MAX_CHANNELS){
+		return 0;
+	}
+	std::lock_guard<std::mutex> guard(historyLock);
+	const std::vector<Sample>& ring = histories[channel];
+	size_t start = ring.size() < depth ? 0 : historyHeads[channel];
+	for(size_t i = 0; i < ring.size(); i++){
+		out.push_back(ring[(start + i) % ring.size()]);
+	}
+	return out.size();
+}//end history()
+
+
+void Client::setBoardEpoch(std::chrono::steady_clock::time_point start){
+	std::lock_guard<std::mutex> guard(historyLock);
+	epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count();
+	hasEpoch = true;
+	delays.clear();
+	delayHead = 0;
+}//end setBoardEpoch()
+
+
+Latency Client::getLatency() const{
+	std::vector<int64_t> sorted;
+	int64_t floor = 0;
+	{
+		std::lock_guard<std::mutex> guard(historyLock);
+		sorted = delays;
+		floor = hasEpoch ? 0 : fastest;
+	}
+	Latency latency = {sorted.size(), 0, 0, 0, 0};
+	if(sorted.empty()){
+		return latency;
+	}
+	std::sort(sorted.begin(), sorted.end());
+	size_t last = sorted.size() - 1;
+	latency.p50 = (sorted[last * 50 / 100] - floor) / 1000.0;
+	latency.p90 = (sorted[last * 90 / 100] - floor) / 1000.0;
+	latency.p99 = (sorted[last * 99 / 100] - floor) / 1000.0;
+	latency.max = (sorted[last] - floor) / 1000.0;
+	return latency;
+}//end getLatency()
+
+
+unsigned long Client::getFrames() const{
+	return frames;
+}//end getFrames()
+
+
+unsigned long Client::getErrors() const{
+	return errors;
+}//end getErrors()
+
+
+unsigned long Client::getDropped() const{
+	return dropped;
+}//end getDropped()
+
+
+uint32_t Client::pack(const Channel& channel){
+	return (uint16_t)channel.value | ((uint32_t)channel.kind << 16) | (channel.on ? 0x01000000UL : 0);
+}//end pack()
+
+
+Channel Client::unpack(uint32_t word){
+	Channel channel;
+	channel.value = (int16_t)(word & 0xFFFF);
+	channel.kind = (word >> 16) & 0xFF;
+	channel.on = (word & 0x01000000UL) != 0;
+	return channel;
+}//end unpack()
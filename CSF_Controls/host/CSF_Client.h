@@ -0,0 +1,274 @@
+/**
+ * @file
+ * @section description Description
+ * A client for programs on a Linux PC that use the frames from a Comms::FrameStreamer.\n
+ * Where Controller_to_PC_example.py asks for one value at a time and waits for the answer, the Client lets the board stream and keeps up with it on a thread of its own. Anything in the program can then look at the newest values at any moment without waiting or locking, be called back when a value changes, or look back over the recent values of a channel.
+ */
+
+
+#ifndef CSF_Client_h
+#define CSF_Client_h
+
+#include "CSF_Host.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace Host{
+
+
+	/**
+	 * Everything the Client knows about the board at one moment, copied out by Client::snapshot\(\)
+	 */
+	struct Snapshot{
+		uint16_t sequence;	///< The sequence number of the newest frame
+		uint32_t timestamp;	///< millis\(\) on the board when the newest frame was built
+		int64_t received;	///< When the newest frame was decoded, nanoseconds on std::chrono::steady_clock
+		uint8_t count;	///< How many of the channels are filled in
+		Channel channels[Comms::FRAME_MAX_CHANNELS];	///< The newest value of each channel
+	};
+
+
+	/**
+	 * One value kept in a channel's history
+	 */
+	struct Sample{
+		int64_t received;	///< When it was decoded, nanoseconds on std::chrono::steady_clock
+		uint32_t timestamp;	///< millis\(\) on the board
+		bool on;	///< Whether the sensor was switched on or the button pressed
+		int16_t value;	///< The value
+	};
+
+
+	/**
+	 * Percentiles of the time from a frame being built on the board to it being decoded, in microseconds
+	 */
+	struct Latency{
+		size_t samples;	///< How many frames the figures are from
+		double p50;	///< The median
+		double p90;
+		double p99;
+		double max;
+	};
+
+
+
+
+	/**
+	 * Opens a serial port in raw mode at a baud rate, with reads that come back straight away with whatever has arrived so the waiting can be left to poll\(\) or epoll
+	 * @param path -e.g. /dev/ttyACM0, or the slave side of a pseudo-terminal
+	 * @param baud -the baud rate the board's Serial.begin\(\) used, left as it is if termios doesn't know it
+	 * @return int -the file descriptor, or -1 if the port couldn't be opened or set up
+	 */
+	int openPort(const char* path, unsigned long baud = 115200);
+
+
+
+
+	/**
+	 * The Client reads frames from the board on a thread of its own and keeps the newest value of every channel.\n
+	 * The newest values are published under a sequence lock: the reader thread bumps a counter to odd, writes, and bumps it back to even, and snapshot\(\) copies until it gets the same even count before and after. So taking a snapshot never blocks the reader thread, and the reader thread never waits on the program.\n
+	 * Callbacks run on the reader thread, they should be quick and can't call stop\(\). The history and latency figures are behind a mutex the reader thread only holds for a moment per frame.\n
+	 * Latency is measured against the board's timestamp, so it needs to know when the board's millis\(\) was 0, see setBoardEpoch\(\). Without that it reports each frame's delay over the quickest frame seen, which is the jitter rather than the whole trip. Either way it's only as fine as the board's millisecond clock.
+	 */
+	class Client{
+		public:
+			/**
+			 * Called from the reader thread when a channel's value or on flag changes
+			 */
+			typedef std::function<void(uint8_t channel, const Channel& now, const Channel& before)> ChangeHandler;
+
+
+			/**
+			 * Called from the reader thread with every good frame
+			 */
+			typedef std::function<void(const Frame& frame)> FrameCallback;
+
+
+			/**
+			 * The constructor for Client
+			 * @param historyDepth -how many values to keep in each channel's history
+			 */
+			Client(size_t historyDepth = 256);
+
+
+			/**
+			 * The destructor, stops the reader thread and closes the port if the Client opened it
+			 */
+			~Client(void);
+
+
+			/**
+			 * Opens a serial port in raw mode and starts the reader thread
+			 * @param path -e.g. /dev/ttyACM0, or the slave side of a pseudo-terminal
+			 * @param baud -the baud rate the board's Serial.begin\(\) used
+			 * @return bool -false if the port couldn't be opened or set up
+			 */
+			bool open(const char* path, unsigned long baud = 115200);
+
+
+			/**
+			 * Starts the reader thread on a file descriptor that's already open, e.g. a pipe in a test.\n
+			 * Once the port hangs up the reader thread ends on its own and isRunning\(\) goes false, the Client can then be attached or opened again, which joins the old thread and closes the port if open\(\) opened it.
+			 * @param port -the descriptor, the Client doesn't close it
+			 * @return bool -false if the reader thread is already running
+			 */
+			bool attach(int port);
+
+
+			/**
+			 * Stops the reader thread, and closes the port if open\(\) opened it
+			 */
+			void stop(void);
+
+
+			/**
+			 * Getter for whether the reader thread is running
+			 * @return bool
+			 */
+			bool isRunning(void) const;
+
+
+			/**
+			 * Sets the function called when a channel changes, set it before open\(\)
+			 * @param handler -the function
+			 */
+			void onChange(ChangeHandler handler);
+
+
+			/**
+			 * Sets the function called with every frame, set it before open\(\)
+			 * @param callback -the function
+			 */
+			void onFrame(FrameCallback callback);
+
+
+			/**
+			 * Copies out the newest values, never blocks
+			 * @param out -filled in
+			 * @return bool -false if no frame has arrived yet
+			 */
+			bool snapshot(Snapshot& out) const;
+
+
+			/**
+			 * Gets the newest value of one channel, never blocks
+			 * @param channel -the channel, in the order they were added on the board
+			 * @param out -filled in
+			 * @return bool -false if the channel hasn't arrived yet
+			 */
+			bool latest(uint8_t channel, Channel& out) const;
+
+
+			/**
+			 * Copies out a channel's recent values, oldest first
+			 * @param channel -the channel
+			 * @param out -replaced with up to the depth given to the constructor
+			 * @return size_t -how many were copied
+			 */
+			size_t history(uint8_t channel, std::vector<Sample>& out) const;
+
+
+			/**
+			 * Tells the Client when the board's millis\(\) was 0 so latency can be measured end to end
+			 * @param start -the steady_clock time the board started counting from
+			 */
+			void setBoardEpoch(std::chrono::steady_clock::time_point start);
+
+
+			/**
+			 * Gets the latency percentiles over the most recent frames
+			 * @return Latency
+			 */
+			Latency getLatency(void) const;
+
+
+			/**
+			 * Getter for the number of good frames
+			 * @return unsigned long
+			 */
+			unsigned long getFrames(void) const;
+
+
+			/**
+			 * Getter for the number of frames thrown away as corrupt
+			 * @return unsigned long
+			 */
+			unsigned long getErrors(void) const;
+
+
+			/**
+			 * Getter for the number of frames the sequence numbers say never arrived
+			 * @return unsigned long
+			 */
+			unsigned long getDropped(void) const;
+		protected:
+			/**
+			 * The reader thread, reads and decodes until stop\(\)
+			 */
+			void run(void);
+
+
+			/**
+			 * Publishes a decoded frame and runs the callbacks
+			 * @param frame -the frame
+			 * @param arrived -when it was decoded, nanoseconds on steady_clock
+			 */
+			void publish(const Frame& frame, int64_t arrived);
+
+
+			/**
+			 * Packs a channel into one word for the sequence locked table
+			 * @param channel -the channel
+			 * @return uint32_t
+			 */
+			static uint32_t pack(const Channel& channel);
+
+
+			/**
+			 * Unpacks a channel from the sequence locked table
+			 * @param word -the packed channel
+			 * @return Channel
+			 */
+			static Channel unpack(uint32_t word);
+
+			static const size_t LATENCY_SAMPLES = 4096;	///< How many frames the latency figures cover
+
+			int fd;	///< The port being read
+			bool ownsFd;	///< Set when open\(\) opened the port so stop\(\) closes it
+			std::thread reader;	///< Runs run\(\)
+			std::atomic<bool> running;	///< Cleared to stop the reader thread
+			ChangeHandler changeHandler;	///< Called when a channel changes
+			FrameCallback frameCallback;	///< Called with every frame
+			FrameDecoder decoder;	///< Only touched by the reader thread
+
+			std::atomic<uint32_t> version;	///< The sequence lock, odd while the reader thread is writing
+			std::atomic<uint32_t> header;	///< The sequence number in the low 16 bits and the count above
+			std::atomic<uint32_t> timestamp;	///< The board timestamp of the newest frame
+			std::atomic<int64_t> received;	///< When the newest frame was decoded
+			std::atomic<uint32_t> channels[Comms::FRAME_MAX_CHANNELS];	///< The newest value of each channel, packed
+			std::atomic<uint64_t> seen;	///< A bit per channel that has arrived at least once
+
+			std::atomic<unsigned long> frames;	///< Copied from the decoder after each read
+			std::atomic<unsigned long> errors;	///< Copied from the decoder after each read
+			std::atomic<unsigned long> dropped;	///< Copied from the decoder after each read
+
+			mutable std::mutex historyLock;	///< Guards everything below
+			size_t depth;	///< How many values each channel's history keeps
+			std::vector<Sample> histories[Comms::FRAME_MAX_CHANNELS];	///< A ring of recent values for each channel
+			size_t historyHeads[Comms::FRAME_MAX_CHANNELS];	///< Where the next value goes in each ring
+			std::vector<int64_t> delays;	///< A ring of the most recent frames' delays, nanoseconds
+			size_t delayHead;	///< Where the next delay goes
+			bool hasEpoch;	///< Set by setBoardEpoch\(\)
+			int64_t epoch;	///< When the board's millis\(\) was 0, nanoseconds on steady_clock
+			int64_t fastest;	///< The smallest raw delay seen, used when there's no epoch
+	};
+
+
+}
+
+#endif
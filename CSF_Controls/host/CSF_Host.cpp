@@ -0,0 +1,117 @@
+#include "CSF_Host.h"
+
+
+using namespace Host;
+using namespace Comms;
+
+// FrameDecoder
+
+FrameDecoder::FrameDecoder(){
+	reset();
+}//end constructor
+
+
+void FrameDecoder::reset(){
+	length = 0;
+	overflow = false;
+	synced = false;
+	nextSequence = 0;
+	frames = 0;
+	errors = 0;
+	dropped = 0;
+}//end reset()
+
+
+bool FrameDecoder::push(uint8_t byte, Frame& frame){
+	if(byte != FRAME_DELIMITER){
+		if(length < BUFFER_SIZE){
+			buffer[length++] = byte;
+		}
+		else{
+			overflow = true;
+		}
+		return false;
+	}
+	bool good = false;
+	if(overflow){
+		errors++;
+	}
+	else if(length > 0){
+		good = decode(frame);
+	}
+	length = 0;
+	overflow = false;
+	return good;
+}//end push()
+
+
+size_t FrameDecoder::feed(const uint8_t* data, size_t len, FrameHandler handler, void* context){
+	Frame frame;
+	size_t count = 0;
+	for(size_t i = 0; i < len; i++){
+		if(push(data[i], frame)){
+			count++;
+			if(handler != NULL){
+				handler(frame, context);
+			}
+		}
+	}
+	return count;
+}//end feed()
+
+
+bool FrameDecoder::decode(Frame& frame){
+	uint8_t payload[BUFFER_SIZE];
+	size_t size = cobsDecode(buffer, length, payload);
+	if(size < framePayloadSize(0) || payload[0] != FRAME_VERSION){
+		errors++;
+		return false;
+	}
+	uint8_t count = payload[7];
+	if(count > FRAME_MAX_CHANNELS || size != framePayloadSize(count)){
+		errors++;
+		return false;
+	}
+	size_t body = size - FRAME_CRC_SIZE;
+	if(crc16(payload, body) != getU16(payload + body)){
+		errors++;
+		return false;
+	}
+
+	frame.sequence = getU16(payload + 1);
+	frame.timestamp = getU32(payload + 3);
+	frame.count = count;
+	const uint8_t* channel = payload + FRAME_HEADER_SIZE;
+	for(uint8_t i = 0; i < count; i++){
+		frame.channels[i].kind = channel[0] & FRAME_KIND_MASK;
+		frame.channels[i].on = (channel[0] & FRAME_FLAG_ON) != 0;
+		frame.channels[i].value = (int16_t)getU16(channel + 1);
+		channel += FRAME_CHANNEL_SIZE;
+	}
+
+	if(synced){
+		uint16_t gap = frame.sequence - nextSequence;
+		if(gap < 0x8000){
+			dropped += gap;
+		}//else the board restarted or the frame is a late duplicate, just resync
+	}
+	synced = true;
+	nextSequence = frame.sequence + 1;
+	frames++;
+	return true;
+}//end decode()
+
+
+unsigned long FrameDecoder::getFrames() const{
+	return frames;
+}//end getFrames()
+
+
+unsigned long FrameDecoder::getErrors() const{
+	return errors;
+}//end getErrors()
+
+
+unsigned long FrameDecoder::getDropped() const{
+	return dropped;
+}//end getDropped()
@@ -0,0 +1,133 @@
+/**
+ * @file
+ * @section description Description
+ * The PC side of CSF_Controls, for programs on the computer that read what the Arduino sends.\n
+ * This is plain C++ with no Arduino code in it, it shares the frame layout with the board through CSF_Protocol.h.
+ */
+
+
+#ifndef CSF_Host_h
+#define CSF_Host_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../CSF_Controls/CSF_Protocol.h"
+
+
+
+/**
+ * The Host namespace is for code running on the computer at the other end of the serial port
+ */
+namespace Host{
+
+
+	/**
+	 * One channel of a decoded frame
+	 */
+	struct Channel{
+		uint8_t kind;	///< Comms::FRAME_KIND_SENSOR or Comms::FRAME_KIND_BUTTON
+		bool on;	///< Whether the sensor is switched on or the button pressed
+		int16_t value;	///< The sensor reading or button state
+	};
+
+
+	/**
+	 * One decoded frame, every channel the board carries at a single point in time
+	 */
+	struct Frame{
+		uint16_t sequence;	///< Increments by one every frame the board sends
+		uint32_t timestamp;	///< millis\(\) on the board when the frame was built
+		uint8_t count;	///< How many of the channels are filled in
+		Channel channels[Comms::FRAME_MAX_CHANNELS];	///< The channels in the order they were added on the board
+	};
+
+
+
+
+	/**
+	 * The FrameDecoder turns the byte stream from a Comms::FrameStreamer back into frames.\n
+	 * Bytes can be fed in blocks of any size as they come off the serial port, a frame is handed back each time a delimiter completes one. Frames that fail the CRC or are cut short are thrown away and counted, and gaps in the sequence numbers are counted as dropped frames.\n
+	 * Nothing is allocated after construction.
+	 */
+	class FrameDecoder{
+		public:
+			/**
+			 * Called with each good frame from feed\(\)
+			 */
+			typedef void (*FrameHandler)(const Frame& frame, void* context);
+
+
+			/**
+			 * The constructor for FrameDecoder
+			 */
+			FrameDecoder(void);
+
+
+			/**
+			 * Forgets any partial frame and zeroes the counters
+			 */
+			void reset(void);
+
+
+			/**
+			 * Takes the next byte off the serial port
+			 * @param byte -the byte
+			 * @param frame -filled in when this byte completes a good frame
+			 * @return bool -true if frame was filled in
+			 */
+			bool push(uint8_t byte, Frame& frame);
+
+
+			/**
+			 * Takes a block of bytes off the serial port and hands back every good frame in it
+			 * @param data -the bytes
+			 * @param len -how many
+			 * @param handler -called with each good frame
+			 * @param context -passed through to the handler
+			 * @return size_t -the number of good frames
+			 */
+			size_t feed(const uint8_t* data, size_t len, FrameHandler handler, void* context);
+
+
+			/**
+			 * Getter for the number of good frames decoded
+			 * @return unsigned long
+			 */
+			unsigned long getFrames(void) const;
+
+
+			/**
+			 * Getter for the number of frames thrown away for a bad CRC, bad COBS, a wrong version or a wrong length
+			 * @return unsigned long
+			 */
+			unsigned long getErrors(void) const;
+
+
+			/**
+			 * Getter for the number of frames the sequence numbers say never arrived
+			 * @return unsigned long
+			 */
+			unsigned long getDropped(void) const;
+		protected:
+			/**
+			 * Checks and unpacks the frame collected in the buffer
+			 * @param frame -filled in if the frame is good
+			 * @return bool -true if the frame is good
+			 */
+			bool decode(Frame& frame);
+
+			static const size_t BUFFER_SIZE = 128;	///< Bigger than the largest encoded frame
+			uint8_t buffer[BUFFER_SIZE];	///< The encoded bytes of the frame being collected
+			size_t length;	///< How many bytes are in the buffer
+			bool overflow;	///< Set when the frame being collected will not fit, it is skipped up to the next delimiter
+			bool synced;	///< Set once a sequence number has been seen to compare the next against
+			uint16_t nextSequence;	///< The sequence number expected in the next frame
+			unsigned long frames;	///< The number of good frames
+			unsigned long errors;	///< The number of bad frames
+			unsigned long dropped;	///< The number of frames missing from the sequence
+	};
+
+
+}
+
+#endif
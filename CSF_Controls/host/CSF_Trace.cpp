@@ -0,0 +1,235 @@
+#include "CSF_Trace.h"
+#include <stdio.h>
+#include <algorithm>
+
+
+using namespace Host;
+using namespace Comms;
+
+// TraceDecoder
+
+TraceDecoder::TraceDecoder(){
+	reset();
+}//end constructor
+
+
+void TraceDecoder::reset(){
+	buffer.clear();
+	blocks = 0;
+	errors = 0;
+}//end reset()
+
+
+bool TraceDecoder::push(uint8_t byte, TraceBlock& block){
+	if(byte != FRAME_DELIMITER){
+		if(buffer.size() < cobsMaxSize(traceMaxPayloadSize(TRACE_MAX_CHANNELS, 255))){
+			buffer.push_back(byte);
+		}
+		return false;
+	}
+	bool good = !buffer.empty() && decode(block);
+	buffer.clear();
+	return good;
+}//end push()
+
+
+bool TraceDecoder::decode(TraceBlock& block){
+	std::vector<uint8_t> payload(buffer.size());
+	size_t size = cobsDecode(buffer.data(), buffer.size(), payload.data());
+	if(size < (size_t)TRACE_HEADER_SIZE + FRAME_CRC_SIZE || payload[0] != TRACE_VERSION){
+		errors++;
+		return false;
+	}
+	size_t body = size - FRAME_CRC_SIZE;
+	if(crc16(payload.data(), body) != getU16(payload.data() + body)){
+		errors++;
+		return false;
+	}
+	uint8_t count = payload[11];
+	uint8_t rows = payload[12];
+	if(count == 0 || count > TRACE_MAX_CHANNELS || (size_t)TRACE_HEADER_SIZE + count > body){
+		errors++;
+		return false;
+	}
+
+	block.sequence = getU16(payload.data() + 1);
+	block.period = getU32(payload.data() + 3);
+	block.index = getU32(payload.data() + 7);
+	block.count = count;
+	block.rows = rows;
+	for(uint8_t i = 0; i < count; i++){
+		block.kinds[i] = payload[TRACE_HEADER_SIZE + i];
+	}
+	block.values.resize((size_t)rows * count);
+	int32_t previous[TRACE_MAX_CHANNELS] = {0};
+	size_t read = TRACE_HEADER_SIZE + count;
+	for(size_t v = 0; v < block.values.size(); v++){
+		uint32_t folded;
+		size_t used = getVarint(payload.data() + read, body - read, folded);
+		if(used == 0){
+			errors++;
+			return false;
+		}
+		read += used;
+		uint8_t channel = v % count;
+		previous[channel] += zigzagDecode(folded);
+		block.values[v] = (int16_t)previous[channel];
+	}
+	if(read != body){
+		errors++;
+		return false;
+	}
+	blocks++;
+	return true;
+}//end decode()
+
+
+unsigned long TraceDecoder::getBlocks() const{
+	return blocks;
+}//end getBlocks()
+
+
+unsigned long TraceDecoder::getErrors() const{
+	return errors;
+}//end getErrors()
+
+
+
+
+
+
+// Trace
+
+Trace::Trace(){
+	period = 0;
+	count = 0;
+}//end constructor
+
+
+bool Trace::load(const char* path){
+	FILE* file = fopen(path, "rb");
+	if(file == NULL){
+		return false;
+	}
+	TraceDecoder decoder;
+	TraceBlock block;
+	uint8_t chunk[4096];
+	size_t got;
+	bool good = true;
+	while((got = fread(chunk, 1, sizeof(chunk), file)) > 0){
+		for(size_t i = 0; i < got; i++){
+			if(decoder.push(chunk[i], block)){
+				good = add(block) && good;
+			}
+		}
+	}
+	fclose(file);
+	return good && !indexes.empty();
+}//end load()
+
+
+bool Trace::add(const TraceBlock& block){
+	if(indexes.empty()){
+		period = block.period;
+		count = block.count;
+		std::copy(block.kinds, block.kinds + block.count, kinds);
+	}
+	else if(block.period != period || block.count != count || !std::equal(block.kinds, block.kinds + count, kinds) || block.index <= indexes.back()){
+		return false;
+	}
+	for(uint8_t row = 0; row < block.rows; row++){
+		indexes.push_back(block.index + row);
+	}
+	values.insert(values.end(), block.values.begin(), block.values.end());
+	return true;
+}//end add()
+
+
+bool Trace::save(const char* path) const{
+	FILE* file = fopen(path, "wb");
+	if(file == NULL){
+		return false;
+	}
+	std::vector<uint8_t> payload(traceMaxPayloadSize(TRACE_MAX_CHANNELS, 255));
+	std::vector<uint8_t> encoded(cobsMaxSize(payload.size()) + 1);
+	uint16_t sequence = 0;
+	size_t row = 0;
+	while(row < indexes.size()){
+		//a block is up to 255 consecutive rows
+		size_t rows = 1;
+		while(row + rows < indexes.size() && rows < 255 && indexes[row + rows] == indexes[row] + rows){
+			rows++;
+		}
+		payload[0] = TRACE_VERSION;
+		putU16(&payload[1], sequence++);
+		putU32(&payload[3], period);
+		putU32(&payload[7], indexes[row]);
+		payload[11] = count;
+		payload[12] = (uint8_t)rows;
+		std::copy(kinds, kinds + count, &payload[TRACE_HEADER_SIZE]);
+		size_t write = TRACE_HEADER_SIZE + count;
+		int32_t previous[TRACE_MAX_CHANNELS] = {0};
+		for(size_t r = row; r < row + rows; r++){
+			for(uint8_t channel = 0; channel < count; channel++){
+				int16_t value = getValue(r, channel);
+				write += putVarint(&payload[write], zigzagEncode(value - previous[channel]));
+				previous[channel] = value;
+			}
+		}
+		putU16(&payload[write], crc16(payload.data(), write));
+		size_t size = cobsEncode(payload.data(), write + FRAME_CRC_SIZE, encoded.data());
+		encoded[size++] = FRAME_DELIMITER;
+		fwrite(encoded.data(), 1, size, file);
+		row += rows;
+	}
+	return fclose(file) == 0;
+}//end save()
+
+
+uint32_t Trace::getPeriod() const{
+	return period;
+}//end getPeriod()
+
+
+uint8_t Trace::getChannelCount() const{
+	return count;
+}//end getChannelCount()
+
+
+uint8_t Trace::getKind(uint8_t channel) const{
+	return channel < count ? kinds[channel] : FRAME_KIND_SENSOR;
+}//end getKind()
+
+
+size_t Trace::getRowCount() const{
+	return indexes.size();
+}//end getRowCount()
+
+
+uint32_t Trace::getIndex(size_t row) const{
+	return indexes[row];
+}//end getIndex()
+
+
+int16_t Trace::getValue(size_t row, uint8_t channel) const{
+	return values[row * count + channel];
+}//end getValue()
+
+
+int16_t Trace::valueAt(uint8_t channel, uint64_t micros) const{
+	if(indexes.empty() || channel >= count || period == 0){
+		return 0;
+	}
+	uint64_t sample = micros / period;
+	std::vector<uint32_t>::const_iterator after = std::upper_bound(indexes.begin(), indexes.end(), sample);
+	size_t row = after == indexes.begin() ? 0 : (after - indexes.begin()) - 1;
+	return getValue(row, channel);
+}//end valueAt()
+
+
+unsigned long Trace::getLost() const{
+	if(indexes.empty()){
+		return 0;
+	}
+	return (indexes.back() - indexes.front() + 1) - indexes.size();
+}//end getLost()
@@ -0,0 +1,199 @@
+/**
+ * @file
+ * @section description Description
+ * The PC side of Comms::TraceCapture: decoding the delta encoded blocks the board dumps and collecting them into a Trace that can be looked up by time.\n
+ * Like CSF_Host.h it is plain C++ with no Arduino code in it. host/sim/SimDevices.h has a Sim::TracePlayer that plays a Trace back into the simulated board, and csf_replay runs the library's filters and mapping over one.
+ */
+
+
+#ifndef CSF_Trace_h
+#define CSF_Trace_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "../CSF_Controls/CSF_Protocol.h"
+
+
+namespace Host{
+
+
+	/**
+	 * One decoded trace block, consecutive rows of every channel
+	 */
+	struct TraceBlock{
+		uint16_t sequence;	///< Increments by one every block the board sends
+		uint32_t period;	///< Microseconds between rows
+		uint32_t index;	///< The sample number of the first row
+		uint8_t count;	///< How many channels are in each row
+		uint8_t rows;	///< How many rows there are
+		uint8_t kinds[Comms::TRACE_MAX_CHANNELS];	///< Comms::FRAME_KIND_SENSOR or Comms::FRAME_KIND_BUTTON for each channel
+		std::vector<int16_t> values;	///< Row by row, count values to a row
+	};
+
+
+
+
+	/**
+	 * The TraceDecoder turns the byte stream from a Comms::TraceCapture back into blocks.\n
+	 * It works the same way as FrameDecoder, bytes in blocks of any size and a block handed back each time a delimiter completes one. Anything that isn't a good trace block, including frames from a FrameStreamer on the same port, is thrown away and counted.
+	 */
+	class TraceDecoder{
+		public:
+			/**
+			 * The constructor for TraceDecoder
+			 */
+			TraceDecoder(void);
+
+
+			/**
+			 * Forgets any partial block and zeroes the counters
+			 */
+			void reset(void);
+
+
+			/**
+			 * Takes the next byte off the serial port
+			 * @param byte -the byte
+			 * @param block -filled in when this byte completes a good block
+			 * @return bool -true if block was filled in
+			 */
+			bool push(uint8_t byte, TraceBlock& block);
+
+
+			/**
+			 * Getter for the number of good blocks decoded
+			 * @return unsigned long
+			 */
+			unsigned long getBlocks(void) const;
+
+
+			/**
+			 * Getter for the number of blocks thrown away for a bad CRC, bad COBS, a wrong version or bad contents
+			 * @return unsigned long
+			 */
+			unsigned long getErrors(void) const;
+		protected:
+			/**
+			 * Checks and unpacks the block collected in the buffer
+			 * @param block -filled in if the block is good
+			 * @return bool -true if the block is good
+			 */
+			bool decode(TraceBlock& block);
+
+			std::vector<uint8_t> buffer;	///< The encoded bytes of the block being collected
+			unsigned long blocks;	///< The number of good blocks
+			unsigned long errors;	///< The number of bad blocks
+	};
+
+
+
+
+	/**
+	 * A Trace is every row of a capture in sample order, for replaying it.\n
+	 * Time in a trace is counted from sample 0, row n having been taken n periods after it. Samples the board lost leave a gap, and looking up a time in a gap gives the last row before it, as a sample-and-hold would.
+	 */
+	class Trace{
+		public:
+			/**
+			 * The constructor for Trace, it starts out empty
+			 */
+			Trace(void);
+
+
+			/**
+			 * Reads a file of bytes saved from the serial port, keeping every good block in it
+			 * @param path -the file
+			 * @return bool -false if it couldn't be read or held no blocks
+			 */
+			bool load(const char* path);
+
+
+			/**
+			 * Adds a decoded block, blocks have to come in sample order and all have the same channels and period
+			 * @param block -the block
+			 * @return bool -false if it doesn't match the blocks before it or goes back in time
+			 */
+			bool add(const TraceBlock& block);
+
+
+			/**
+			 * Writes the rows back out as trace blocks, the same bytes a board would send
+			 * @param path -the file
+			 * @return bool -false if it couldn't be written
+			 */
+			bool save(const char* path) const;
+
+
+			/**
+			 * Getter for the microseconds between samples
+			 * @return uint32_t
+			 */
+			uint32_t getPeriod(void) const;
+
+
+			/**
+			 * Getter for the number of channels in each row
+			 * @return uint8_t
+			 */
+			uint8_t getChannelCount(void) const;
+
+
+			/**
+			 * Getter for what a channel is
+			 * @param channel -the channel
+			 * @return uint8_t -Comms::FRAME_KIND_SENSOR or Comms::FRAME_KIND_BUTTON
+			 */
+			uint8_t getKind(uint8_t channel) const;
+
+
+			/**
+			 * Getter for the number of rows
+			 * @return size_t
+			 */
+			size_t getRowCount(void) const;
+
+
+			/**
+			 * Getter for the sample number of a row
+			 * @param row -the row
+			 * @return uint32_t
+			 */
+			uint32_t getIndex(size_t row) const;
+
+
+			/**
+			 * Getter for a value
+			 * @param row -the row
+			 * @param channel -the channel
+			 * @return int16_t
+			 */
+			int16_t getValue(size_t row, uint8_t channel) const;
+
+
+			/**
+			 * Gets a channel's value at a time, as a sample-and-hold of the trace would give it
+			 * @param channel -the channel
+			 * @param micros -microseconds since sample 0
+			 * @return int16_t -the value of the last row at or before that time, the first row's before it
+			 */
+			int16_t valueAt(uint8_t channel, uint64_t micros) const;
+
+
+			/**
+			 * Gets how many samples are missing between the rows
+			 * @return unsigned long
+			 */
+			unsigned long getLost(void) const;
+		protected:
+			uint32_t period;	///< Microseconds between samples
+			uint8_t count;	///< Channels in each row
+			uint8_t kinds[Comms::TRACE_MAX_CHANNELS];	///< What each channel is
+			std::vector<uint32_t> indexes;	///< The sample number of each row
+			std::vector<int16_t> values;	///< Row by row, count values to a row
+	};
+
+
+}
+
+#endif
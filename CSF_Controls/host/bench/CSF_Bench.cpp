@@ -0,0 +1,667 @@
+/**
+ * @file
+ * @section description Description
+ * Micro-benchmarks for CSF_Controls, built against the simulated board in host/sim.\n
+ * Each one times a library call over banks of 1 to 256 controls and prints the cost per call and per loop\(\) pass \(one tick, every control called once\).\n
+ * The numbers are PC nanoseconds, not AVR cycles, they are for comparing one version of the library against the next and seeing how a cost grows with the number of controls. The simulated clock steps 1us per read so the interval timers run the way they would on a board.\n
+ * Run with no arguments for the whole table, with the name of one benchmark, e.g. csf_bench mapData\(int\), with static to compare the virtual classes against the ones in CSF_Static.h, with expansion for the multiplexer and shift register scans, with bounce for what the debouncer makes of a switch with contact bounce, with touch for the capacitive electrodes, or with adaptive for Pots reported at a fixed interval against ones following a Utility::RateController
+ */
+
+
+#include <Arduino.h>
+#include <CSF_Controls.h>
+#include <CSF_Static.h>
+#include <SimDevices.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+using namespace Sensors;
+using namespace Switches;
+using namespace Scheduling;
+
+
+
+
+namespace{
+	const int COUNTS[] = {1, 4, 16, 64, 256};	///< The bank sizes each benchmark is run over
+	const double MIN_SECONDS = 0.02;	///< Each measurement repeats until it has run this long
+	volatile long sink = 0;	///< Results are added in here so the compiler can't drop the calls being timed
+
+
+	/**
+	 * A bank of Pots and Momentary buttons spread over the simulated pins with the sensors switched on, and a ControlManager running as many of the Pots as it has room for
+	 */
+	struct Bank{
+		std::vector<Pot> pots;
+		std::vector<Momentary> buttons;
+		ControlManager manager;
+
+
+		Bank(int count){
+			pots.reserve(count);
+			buttons.reserve(count);
+			for(int i = 0; i < count; i++){
+				int but = 2 + (i * 3) % 48;
+				pots.emplace_back(but, but + 1, A0 + (i % 8));
+				buttons.emplace_back(but + 2);
+			}
+			for(int i = 0; i < count; i++){
+				pots[i].begin();
+				buttons[i].begin();
+				pots[i].activateControl();
+				Sim::setAnalog(A0 + (i % 8), 100 + i);
+				if(i < CSF_MANAGER_CONTROLS){
+					manager.add(pots[i]);
+				}
+			}
+			manager.begin();
+		}
+	};
+
+
+	/**
+	 * The same bank made from the classes in CSF_Static.h
+	 */
+	struct StaticBank{
+		std::vector<Static::Sensors::Pot> pots;
+		std::vector<Static::Switches::Momentary> buttons;
+
+
+		StaticBank(int count){
+			pots.reserve(count);
+			buttons.reserve(count);
+			for(int i = 0; i < count; i++){
+				int but = 2 + (i * 3) % 48;
+				pots.emplace_back(but, but + 1, A0 + (i % 8));
+				buttons.emplace_back(but + 2);
+			}
+			for(int i = 0; i < count; i++){
+				pots[i].begin();
+				buttons[i].begin();
+				pots[i].activateControl();
+				Sim::setAnalog(A0 + (i % 8), 100 + i);
+			}
+		}
+	};
+
+
+	/**
+	 * The same controls again packed into a ControlBank
+	 */
+	struct PackedBank{
+		ControlBank<256> bank;
+
+
+		PackedBank(int count){
+			for(int i = 0; i < count; i++){
+				int but = 2 + (i * 3) % 48;
+				bank.add(but, but + 1, A0 + (i % 8));
+				Sim::setAnalog(A0 + (i % 8), 100 + i);
+			}
+			bank.begin();
+			for(int i = 0; i < count; i++){
+				bank.toggleIsSensorOn(i);
+			}
+		}
+	};
+
+
+	/**
+	 * 64 inputs on expansion chips: two 74HC4067 muxes for 32 pots and four chained 74HC165s for their 32 power buttons, with the Pots reading them through virtual pins
+	 */
+	struct ExpandedBank{
+		Sim::Mux simMuxes[2] = {Sim::Mux(A0, {2, 3, 4, 5}), Sim::Mux(A1, {6, 7, 8, 9})};
+		Sim::ShiftRegister simChain = Sim::ShiftRegister(10, 11, 12, 4);
+		Expansion::AnalogMux muxes[2] = {Expansion::AnalogMux(A0, 2, 3, 4, 5), Expansion::AnalogMux(A1, 6, 7, 8, 9)};
+		Expansion::ShiftIn chain = Expansion::ShiftIn(10, 11, 12, 4);
+		std::vector<Pot> pots;
+
+
+		ExpandedBank(int count){
+			Expansion::VirtualPins::detachAll();
+			for(int m = 0; m < 2; m++){
+				simMuxes[m].connect();
+				for(int k = 0; k < 16; k++){
+					simMuxes[m].setChannel(k, 100 + m * 16 + k);
+				}
+				Expansion::VirtualPins::attach(muxes[m]);
+			}
+			simChain.connect();
+			simChain.setInputs(0xFFFFFFFF);
+			Expansion::VirtualPins::attach(chain);
+			pots.reserve(count);
+			for(int i = 0; i < count; i++){
+				pots.emplace_back(chain.pin(i % 32), 20 + (i % 40), muxes[(i / 16) % 2].pin(i % 16));
+			}
+			Expansion::VirtualPins::scanAll();
+			for(int i = 0; i < count; i++){
+				pots[i].begin();
+				pots[i].activateControl();
+			}
+		}
+
+
+		~ExpandedBank(){
+			Expansion::VirtualPins::detachAll();
+		}
+	};
+
+
+	/**
+	 * An 8 by 16 KeyMatrix, rows on pins 2 to 9 and columns on two ports, with as many keys held down as the count, up to all 128
+	 */
+	struct MatrixBank{
+		Sim::Keypad pad;
+		KeyMatrix matrix;
+
+
+		MatrixBank(int count): pad(pins(2, 8), pins(16, 16), true){
+			for(uint8_t p : pins(2, 8)){
+				matrix.addRow(p);
+			}
+			for(uint8_t p : pins(16, 16)){
+				matrix.addColumn(p);
+			}
+			matrix.setDiodes(true);
+			matrix.begin();
+			pad.connect();
+			for(int i = 0; i < count && i < 128; i++){
+				int key = (i * 37) % 128;	//spread over the rows
+				pad.press(key / 16, key % 16, true);
+			}
+		}
+
+
+		static std::vector<uint8_t> pins(uint8_t first, uint8_t count){
+			std::vector<uint8_t> list;
+			for(uint8_t i = 0; i < count; i++){
+				list.push_back(first + i);
+			}
+			return list;
+		}
+	};
+
+
+	/**
+	 * Measures electrodes on one port with a CapSense and prints a row: how long a scan takes on the simulated board with every electrode charged at once, against a CapSense per electrode scanned one after the other, then what it made of 100 touches.\n
+	 * Each electrode is 15 to 25 pF with noise on every charge and drifts up 10 pF over the run, as an enclosure warming up. Every 40 scans a random electrode is touched for 15 scans, with 3 pF through a panel for the resistors or 15 pF on the bare copper for the pull-ups, which only count a few passes and can't see a light touch. A touch is caught if the electrode reads touched during it, any other scan that reads touched is false.
+	 * @param count -how many electrodes, 1 to 8
+	 * @param resistor -true to charge from a send pin through 1 megohm, false to use the pull-ups
+	 */
+	void touchRun(uint8_t count, bool resistor){
+		Sim::reset();
+		Expansion::VirtualPins::detachAll();
+		std::vector<Sim::Electrode> electrodes;
+		for(uint8_t i = 0; i < count; i++){
+			electrodes.push_back(Sim::Electrode(8 + i, 15 + 10 * i / 7.0, 35, 11 + i));
+		}
+		for(Sim::Electrode& electrode : electrodes){
+			if(resistor){
+				electrode.setResistor(4, 1000);
+			}
+			electrode.setNoise(resistor ? 200 : 40);
+			electrode.connect();
+		}
+
+		//one electrode per CapSense, charged one after the other
+		std::vector<Expansion::CapSense> single(count, resistor ? Expansion::CapSense(4) : Expansion::CapSense());
+		unsigned long oneByOne = 0;
+		for(uint8_t i = 0; i < count; i++){
+			single[i].add(8 + i);
+			single[i].begin();
+			single[i].scan();
+			oneByOne += single[i].getScanMicros();
+		}
+
+		Expansion::CapSense caps = resistor ? Expansion::CapSense(4) : Expansion::CapSense();
+		for(uint8_t i = 0; i < count; i++){
+			caps.add(8 + i);
+		}
+		caps.begin();
+		unsigned long together = caps.getScanMicros();
+		std::mt19937 random(5);
+		std::uniform_int_distribution<int> pick(0, count - 1);
+		float start[8];
+		for(uint8_t i = 0; i < count; i++){
+			start[i] = electrodes[i].getCapacitance();
+		}
+		int caught = 0;
+		int falses = 0;
+		const int SCANS = 4000;
+		int touching = -1;
+		bool seen = false;
+		for(int scan = 0; scan < SCANS; scan++){
+			for(uint8_t i = 0; i < count; i++){
+				electrodes[i].setCapacitance(start[i] + 10.0 * scan / SCANS);
+			}
+			if(scan % 40 == 20){
+				touching = pick(random);
+				electrodes[touching].touch(resistor ? 3 : 15);
+				seen = false;
+			}
+			else if(scan % 40 == 35){
+				electrodes[touching].release();
+				caught += seen ? 1 : 0;
+				touching = -1;
+			}
+			caps.scan();
+			for(uint8_t i = 0; i < count; i++){
+				if(caps.read(i) == HIGH){
+					if(i == touching){
+						seen = true;
+					}
+					else if(scan % 40 < 20 || scan % 40 > 37){	//a couple of scans for the release to show
+						falses++;
+					}
+				}
+			}
+			Sim::advanceMillis(10);
+		}
+		printf("%-9s %10u %10lu %12lu %10lu %7d/%-4d %6d %8lu\n", resistor ? "1M" : "pull-up", count, together, oneByOne, caps.getWorstScanMicros(), caught, SCANS / 40, falses, caps.getTimeouts());
+	}//end touchRun()
+
+
+	/**
+	 * Runs Pots through a ControlManager for 16 simulated seconds and prints a row of what it cost and how quickly the computer heard about movement.\n
+	 * Nothing moves for the first 5 seconds. Then each Pot in turn is swept 300 counts over 0.4 seconds, a little over half a second apart so they don't line up with the schedules, and from 12 to 14 seconds they're all swung back and forth together. The Pots report with toSerialOnChange\(\), a deadband of 2 and no heartbeat, each mapped to its own range so the lines can be told apart.\n
+	 * Fixed runs the reports from a task every interval, the way a sketch would with the interval every ControlUnit defaults to, or a short one to keep up with a knob. Adaptive adds each Pot with a Utility::RateController and a serial budget of 1152 bytes per second, a tenth of 115200 baud.\n
+	 * Idle is from 1 to 5 seconds, past the first report of each Pot. Wake is from a Pot starting to move to the first line about it, the mean and the worst. All moving is the fewest and most reports a Pot got per second, and the bytes per second all of them sent, from 12 to 14 seconds.
+	 * @param count -how many Pots, 1 to 8
+	 * @param interval -milliseconds between reports for the fixed runs, 0 for adaptive
+	 */
+	void adaptRun(uint8_t count, unsigned int interval){
+		Sim::reset();
+		std::vector<Pot> pots;
+		pots.reserve(count);
+		std::vector<Utility::RateController> rates(count);
+		for(uint8_t i = 0; i < count; i++){
+			pots.emplace_back(2 + 3 * i, 3 + 3 * i, A0 + i);
+			Sim::scriptAnalog(A0 + i, [i](unsigned long us){
+				double t = us / 1e6;
+				double start = 5 + 0.5371 * i;
+				double base = 100 + 50 * i + (t < start ? 0 : (t < start + 0.4 ? 300 * (t - start) / 0.4 : 300));
+				return (int)(base + (t >= 12 && t < 14 ? 200 * sin((t - 12) * 2 * M_PI) : 0));
+			});
+		}
+
+		static std::vector<Pot>* running;	//for the fixed runs' task, a plain function
+		running = &pots;
+		ControlManager manager;
+		for(uint8_t i = 0; i < count; i++){
+			pots[i].begin();
+			pots[i].toggleIsSensorOn();
+			pots[i].mapData(2000 * i, 2000 * i + 1023);
+			pots[i].setReportByException(2, 0);
+			if(interval == 0){
+				manager.add(pots[i], rates[i]);
+			}
+			else{
+				manager.add(pots[i]);
+			}
+		}
+		if(interval == 0){
+			manager.setSerialBudget(1152);
+		}
+		else{
+			manager.add([](){
+				for(Pot& pot : *running){
+					pot.toSerialOnChange();
+				}
+			}, interval);
+		}
+
+		//every line the board sends, when it was sent and which Pot
+		std::vector<std::pair<unsigned long, int> > lines;
+		unsigned long idleBytes = 0;
+		unsigned long movingBytes = 0;
+		std::string line;
+		Sim::setSerialSink([&](const uint8_t* data, size_t len){
+			unsigned long now = Sim::now();
+			idleBytes += (now >= 1000000 && now < 5000000) ? len : 0;
+			movingBytes += (now >= 12000000 && now < 14000000) ? len : 0;
+			for(size_t i = 0; i < len; i++){
+				if(data[i] == '\n'){
+					int sequence = 0;
+					int value = 0;
+					if(sscanf(line.c_str(), "%d %d", &sequence, &value) == 2){
+						lines.push_back(std::make_pair(now, value / 2000));
+					}
+					line.clear();
+				}
+				else{
+					line += (char)data[i];
+				}
+			}
+		});
+
+		manager.begin();
+		unsigned long idleReads = 0;
+		while(Sim::now() < 16000000){
+			Sim::advanceMicros(100);
+			manager.tick();
+			if(Sim::now() == 1000000 || Sim::now() == 5000000){
+				idleReads = Sim::getAnalogReads() - idleReads;
+			}
+		}
+		Sim::setSerialSink(nullptr);
+
+		double wakeTotal = 0;
+		double wakeWorst = 0;
+		std::vector<int> moving(count, 0);
+		for(uint8_t i = 0; i < count; i++){
+			unsigned long start = 5000000 + 537100UL * i;
+			for(const std::pair<unsigned long, int>& sent : lines){
+				if(sent.second == i && sent.first >= start){
+					double wake = (sent.first - start) / 1000.0;
+					wakeTotal += wake;
+					wakeWorst = std::max(wakeWorst, wake);
+					break;
+				}
+			}
+		}
+		for(const std::pair<unsigned long, int>& sent : lines){
+			if(sent.first >= 12000000 && sent.first < 14000000 && sent.second >= 0 && sent.second < count){
+				moving[sent.second]++;
+			}
+		}
+		char mode[16];
+		snprintf(mode, sizeof(mode), interval == 0 ? "adaptive" : "fixed %u", interval);
+		printf("%-10s %5u %10.1f %10.1f %9.1f %9.1f %9.1f %9.1f %10.0f\n", mode, count, idleReads / 4.0 / count, idleBytes / 4.0, wakeTotal / count, wakeWorst, *std::min_element(moving.begin(), moving.end()) / 2.0, *std::max_element(moving.begin(), moving.end()) / 2.0, movingBytes / 2.0);
+	}//end adaptRun()
+
+
+	/**
+	 * Plays 200 gestures on a switch with 3 milliseconds of contact bounce into a Momentary read every 100 microseconds, and prints a row of what its debouncer made of them next to what was played.\n
+	 * The gestures go round single clicks, double clicks, long presses, and a single click after a 150 microsecond spike of noise, with 600 milliseconds of rest after each. Latency is from the first contact to the PRESSED event, and a PRESSED that isn't within 50 milliseconds of a press counts as extra.
+	 * @param holdOff -the debounce hold-off, milliseconds
+	 * @param confirm -the debouncer's confirm time, milliseconds
+	 */
+	void bounceRun(unsigned int holdOff, unsigned int confirm){
+		Sim::reset();
+		Sim::BouncySwitch contact(2, 3000, 7);
+		Momentary button(2);
+		button.getDebouncer().setHoldOff(holdOff);
+		button.getDebouncer().setConfirm(confirm);
+		button.begin();
+		contact.connect();
+		std::mt19937 random(3);
+		std::uniform_int_distribution<unsigned long> held(60000, 200000);
+		std::vector<unsigned long> presses;
+		int clicks = 0;
+		int doubles = 0;
+		int longs = 0;
+		unsigned long t = 100000;
+		for(int i = 0; i < 200; i++){
+			int gesture = i % 4;
+			if(gesture == 3){
+				contact.glitch(t, 150);
+				t += 300000;
+			}
+			presses.push_back(t);
+			if(gesture == 1){
+				contact.press(t);
+				contact.release(t + 80000);
+				presses.push_back(t + 200000);
+				contact.press(t + 200000);
+				contact.release(t + 280000);
+				clicks += 2;
+				doubles++;
+				t += 280000;
+			}
+			else if(gesture == 2){
+				contact.press(t);
+				contact.release(t + 1200000);
+				longs++;
+				t += 1200000;
+			}
+			else{
+				unsigned long duration = held(random);
+				contact.press(t);
+				contact.release(t + duration);
+				clicks++;
+				t += duration;
+			}
+			t += 600000;
+		}
+
+		int seen[8] = {0};
+		int matched = 0;
+		unsigned long worst = 0;
+		double total = 0;
+		size_t next = 0;
+		while(Sim::now() < t){
+			sink += button.getState();
+			uint8_t events = button.getEvents();
+			for(int bit = 0; bit < 8; bit++){
+				if(events & (1 << bit)){
+					seen[bit]++;
+				}
+			}
+			if(events & Utility::Debouncer::PRESSED){
+				while(next < presses.size() && presses[next] + 50000 < Sim::now()){
+					next++;	//too long ago for this to be its press
+				}
+				if(next < presses.size() && presses[next] <= Sim::now()){
+					unsigned long latency = Sim::now() - presses[next];
+					worst = latency > worst ? latency : worst;
+					total += latency;
+					matched++;
+					next++;
+				}
+			}
+			Sim::advanceMicros(100);
+		}
+		printf("%-8u %8u %7d/%-5d %6d %7d/%-5d %7d/%-5d %7d/%-5d %9d %10.0f %10lu\n", holdOff, confirm, matched, (int)presses.size(), seen[0] - matched, seen[2], clicks, seen[3], doubles, seen[4], longs, seen[5], matched > 0 ? total / matched : 0.0, worst);
+	}//end bounceRun()
+
+
+	/**
+	 * Times one tick over the bank, repeating until MIN_SECONDS has passed
+	 * @param bank -the controls
+	 * @param tick -calls the code being timed once on every control
+	 * @return double -nanoseconds per tick
+	 */
+	template<typename B, typename Tick> double timeTicks(B& bank, Tick tick){
+		typedef std::chrono::steady_clock Clock;
+		unsigned long ticks = 0;
+		unsigned long batch = 1;
+		Clock::time_point start = Clock::now();
+		double elapsed = 0;
+		while(elapsed < MIN_SECONDS){
+			for(unsigned long i = 0; i < batch; i++){
+				tick(bank);
+			}
+			ticks += batch;
+			batch *= 2;
+			elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+		}
+		return elapsed * 1e9 / ticks;
+	}//end timeTicks()
+
+
+	/**
+	 * Runs one benchmark over every bank size and prints a row for each
+	 * @param name -what's being timed
+	 * @param filter -the benchmark asked for on the command line, or NULL for all of them
+	 * @param tick -calls the code being timed once on every control
+	 */
+	template<typename B = Bank, typename Tick> void run(const char* name, const char* filter, Tick tick){
+		if(filter != NULL && strcmp(filter, name) != 0 && strncmp(name, filter, strlen(filter)) != 0){
+			return;
+		}
+		for(size_t c = 0; c < sizeof(COUNTS) / sizeof(COUNTS[0]); c++){
+			Sim::reset();
+			Sim::setClockStep(1);
+			Sim::setSerialSink([](const uint8_t* data, size_t len){ sink += data[0] + (long)len; });
+			B bank(COUNTS[c]);
+			double perTick = timeTicks(bank, tick);
+			printf("%-30s %5d %12.1f %12.3f\n", name, COUNTS[c], perTick / COUNTS[c], perTick / 1000.0);
+		}
+	}//end run()
+}
+
+
+
+
+int main(int argc, char** argv){
+	const char* filter = argc > 1 ? argv[1] : NULL;
+	printf("%-30s %5s %12s %12s\n", "benchmark", "count", "ns/call", "us/tick");
+
+	run("isButtonPressed", filter, [](Bank& bank){
+		for(Pot& pot : bank.pots){
+			pot.isButtonPressed();
+		}
+	});
+	run("getSensorValue", filter, [](Bank& bank){
+		for(Pot& pot : bank.pots){
+			sink += pot.getSensorValue();
+		}
+	});
+	run("mapData(int)", filter, [](Bank& bank){
+		for(Pot& pot : bank.pots){
+			sink += pot.mapData(-100, 100);
+		}
+	});
+	run("mapData(float)", filter, [](Bank& bank){
+		for(Pot& pot : bank.pots){
+			sink += (long)pot.mapData(-3.14f, 3.14f);
+		}
+	});
+	run("Pot::toSerial", filter, [](Bank& bank){
+		for(Pot& pot : bank.pots){
+			pot.toSerial();
+		}
+	});
+	run("Momentary::getState", filter, [](Bank& bank){
+		for(Momentary& button : bank.buttons){
+			sink += button.getState();
+		}
+	});
+	run("Momentary::toSerial", filter, [](Bank& bank){
+		for(Momentary& button : bank.buttons){
+			button.toSerial();
+		}
+	});
+	run("ControlManager::tick", filter, [](Bank& bank){
+		sink += bank.manager.tick();
+	});
+	run<PackedBank>("ControlBank::togglePressed", filter, [](PackedBank& packed){
+		sink += packed.bank.togglePressed();
+	});
+	run<PackedBank>("ControlBank::mapData(int)", filter, [](PackedBank& packed){
+		for(uint16_t i = 0; i < packed.bank.getCount(); i++){
+			sink += packed.bank.mapData(i, -100, 100);
+		}
+	});
+	run<PackedBank>("ControlBank::emitActive", filter, [](PackedBank& packed){
+		sink += packed.bank.emitActive();
+	});
+	run<MatrixBank>("KeyMatrix::scan", filter, [](MatrixBank& bank){
+		bank.matrix.scan();
+		sink += bank.matrix.available();
+	});
+
+	//scanning the expansion chips, once per tick whatever the count, then the Pots reading the scanned values
+	if(filter == NULL || strcmp(filter, "expansion") == 0){
+		Sim::reset();
+		ExpandedBank expanded(64);
+		unsigned long before = Sim::now();
+		Expansion::VirtualPins::scanAll();
+		printf("\n%-30s %5u us simulated\n\n", "scan of 64 inputs", (unsigned)(Sim::now() - before));
+	}
+	run<ExpandedBank>("expansion scanAll", filter, [](ExpandedBank&){
+		Expansion::VirtualPins::scanAll();
+	});
+	run<ExpandedBank>("expansion getSensorValue", filter, [](ExpandedBank& bank){
+		for(Pot& pot : bank.pots){
+			sink += pot.getSensorValue();
+		}
+	});
+
+	//the debouncer against contact bounce, the hold-off has to outlast the 3 milliseconds of chatter, and a confirm time rejects the noise spikes for a few milliseconds of latency, without it, as by default, each one the loop happens to read is taken as a press
+	if(filter == NULL || strcmp(filter, "bounce") == 0){
+		printf("\n%-8s %8s %13s %6s %13s %13s %13s %9s %10s %10s\n", "holdoff", "confirm", "presses", "extra", "clicks", "doubles", "longs", "bounced", "mean us", "worst us");
+		const unsigned int HOLD_OFFS[] = {1, 2, 5, 10, 20};
+		for(unsigned int holdOff : HOLD_OFFS){
+			bounceRun(holdOff, 2);
+		}
+		bounceRun(20, 0);
+		printf("\n");
+	}
+
+	//bare touch electrodes, one scan charges every electrode on the port at once, so it costs about the same for 8 as for 1
+	if(filter == NULL || strcmp(filter, "touch") == 0){
+		printf("\n%-9s %10s %10s %12s %10s %12s %6s %8s\n", "charging", "electrodes", "scan us", "one-by-one", "worst us", "touches", "false", "timeouts");
+		const uint8_t COUNTS_TOUCH[] = {1, 2, 4, 8};
+		for(bool resistor : {false, true}){
+			for(uint8_t count : COUNTS_TOUCH){
+				touchRun(count, resistor);
+			}
+		}
+		printf("\n");
+	}
+
+	//reporting Pots at a fixed interval against following them with a RateController, what it costs while they sit still and how quickly a movement gets to the computer
+	if(filter == NULL || strcmp(filter, "adaptive") == 0){
+		printf("\n%-10s %5s %10s %10s %9s %9s %9s %9s %10s\n", "reporting", "pots", "idle rd/s", "idle B/s", "wake ms", "worst ms", "min rep/s", "max rep/s", "all B/s");
+		const uint8_t COUNTS_ADAPT[] = {1, 4, 8};
+		for(unsigned int interval : {250u, 10u, 0u}){
+			for(uint8_t count : COUNTS_ADAPT){
+				adaptRun(count, interval);
+			}
+		}
+		printf("\n");
+	}
+
+	//the same calls on the classes from CSF_Static.h, the virtual ones through a ControlUnit reference as a sketch holding a mix of sensors would
+	if(filter == NULL || strcmp(filter, "static") == 0){
+		printf("\n%-30s %5u bytes\n", "sizeof(Pot)", (unsigned)sizeof(Sensors::Pot));
+		printf("%-30s %5u bytes\n", "sizeof(Static Pot)", (unsigned)sizeof(Static::Sensors::Pot));
+		printf("%-30s %5u bytes\n", "sizeof(Momentary)", (unsigned)sizeof(Switches::Momentary));
+		printf("%-30s %5u bytes\n\n", "sizeof(Static Momen.)", (unsigned)sizeof(Static::Switches::Momentary));
+		filter = "static";
+	}
+	run("static virtual getSensorValue", filter, [](Bank& bank){
+		for(Pot& pot : bank.pots){
+			ControlUnit& unit = pot;
+			sink += unit.getSensorValue();
+		}
+	});
+	run<StaticBank>("static getSensorValue", filter, [](StaticBank& bank){
+		for(Static::Sensors::Pot& pot : bank.pots){
+			sink += pot.getSensorValue();
+		}
+	});
+	run<StaticBank>("static isButtonPressed", filter, [](StaticBank& bank){
+		for(Static::Sensors::Pot& pot : bank.pots){
+			pot.isButtonPressed();
+		}
+	});
+	run<StaticBank>("static mapData(int)", filter, [](StaticBank& bank){
+		for(Static::Sensors::Pot& pot : bank.pots){
+			sink += pot.mapData(-100, 100);
+		}
+	});
+	run("static virtual toSerial", filter, [](Bank& bank){
+		for(Pot& pot : bank.pots){
+			ControlUnit& unit = pot;
+			unit.toSerial();
+		}
+	});
+	run<StaticBank>("static toSerial", filter, [](StaticBank& bank){
+		for(Static::Sensors::Pot& pot : bank.pots){
+			pot.toSerial();
+		}
+	});
+	run<StaticBank>("static Momentary", filter, [](StaticBank& bank){
+		for(Static::Switches::Momentary& button : bank.buttons){
+			sink += button.getState();
+		}
+	});
+
+	return 0;
+}//end main()
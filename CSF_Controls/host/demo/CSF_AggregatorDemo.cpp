@@ -0,0 +1,310 @@
+/**
+ * @file
+ * @section description Description
+ * Measures a Host::Aggregator reading 1 to 32 boards, with pseudo-terminals standing in for them.\n
+ * For each number of boards a writer thread plays every board, building frames the way a Comms::FrameStreamer does and writing them into the master side of its pseudo-terminal, while the Aggregator opens the slave sides by name, the same as it would /dev/ttyACM0, and serves the feed on a Unix socket to a client thread.\n
+ * With a frame rate of 0 the boards send as fast as the pseudo-terminals take it, so the frames per second is as many as the Aggregator can keep up with, on a PC shared with the writer and the client. With a rate, each board sends that many frames a second, spread out, and the CPU the Aggregator needed is the figure to look at.\n
+ * The client checks the feed as it goes: every record there, in time order, each board's sequence numbers unbroken. The latency is from a frame being decoded to the client having it, which includes the window the Aggregator holds frames for.\n
+ * csf_aggregator_demo [seconds per run] [frames per second per board, 0 for as fast as possible] [channels] [window ms]
+ */
+
+
+#include "../CSF_Aggregator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <memory>
+#include <poll.h>
+#include <pty.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace Comms;
+
+
+
+
+namespace{
+	const int COUNTS[] = {1, 2, 4, 8, 16, 32};	///< The numbers of boards each run has
+	const int BURST = 16;	///< Frames written at once per board when sending as fast as possible
+
+
+	/**
+	 * The time now on steady_clock
+	 * @return int64_t -nanoseconds
+	 */
+	int64_t now(){
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}//end now()
+
+
+	/**
+	 * One board, played by the writer thread
+	 */
+	struct Board{
+		int master;	///< The writer's side of the pseudo-terminal
+		int slave;	///< Held open so the pseudo-terminal doesn't hang up before the Aggregator opens it
+		char name[128];	///< The slave side's path
+		uint16_t sequence;	///< The next frame's sequence number
+		uint8_t pending[BURST * 128];	///< Frames waiting to be written
+		size_t length;	///< How many bytes are waiting
+		size_t written;	///< How many of them are gone
+		unsigned long frames;	///< Frames built
+	};
+
+
+	/**
+	 * Builds a frame the way Comms::FrameStreamer does and adds it to what's waiting to be written
+	 * @param board -the board
+	 * @param timestamp -millis\(\) on the board
+	 * @param channels -how many channels it carries
+	 */
+	void build(Board& board, uint32_t timestamp, uint8_t channels){
+		uint8_t payload[FRAME_HEADER_SIZE + FRAME_MAX_CHANNELS * FRAME_CHANNEL_SIZE + FRAME_CRC_SIZE];
+		payload[0] = FRAME_VERSION;
+		putU16(payload + 1, board.sequence);
+		putU32(payload + 3, timestamp);
+		payload[7] = channels;
+		uint8_t* channel = payload + FRAME_HEADER_SIZE;
+		for(uint8_t i = 0; i < channels; i++){
+			channel[0] = (i % 4 == 3) ? FRAME_KIND_BUTTON : (FRAME_KIND_SENSOR | FRAME_FLAG_ON);
+			putU16(channel + 1, (uint16_t)((board.sequence + i * 64) % 1024));
+			channel += FRAME_CHANNEL_SIZE;
+		}
+		size_t size = channel - payload;
+		putU16(channel, crc16(payload, size));
+		board.length += cobsEncode(payload, size + FRAME_CRC_SIZE, board.pending + board.length);
+		board.pending[board.length++] = FRAME_DELIMITER;
+		board.sequence++;
+		board.frames++;
+	}//end build()
+
+
+	/**
+	 * Writes as much of what's waiting as the pseudo-terminal takes
+	 * @param board -the board
+	 * @return bool -true once it has all gone
+	 */
+	bool drain(Board& board){
+		while(board.written < board.length){
+			ssize_t count = write(board.master, board.pending + board.written, board.length - board.written);
+			if(count <= 0){
+				return false;
+			}
+			board.written += count;
+		}
+		board.length = 0;
+		board.written = 0;
+		return true;
+	}//end drain()
+
+
+	/**
+	 * What the client thread found in the feed
+	 */
+	struct Feed{
+		unsigned long records = 0;
+		unsigned long missing = 0;	///< Gaps in the record index
+		unsigned long disorder = 0;	///< Records with an earlier time than the one before
+		unsigned long breaks = 0;	///< Gaps in a board's sequence numbers
+		std::vector<int64_t> latencies;	///< Nanoseconds from decoded to the client having it
+	};
+
+
+	/**
+	 * The client thread, reads the feed until the Aggregator hangs up
+	 * @param fd -the socket from connectFeed\(\)
+	 * @param feed -filled in
+	 */
+	void client(int fd, Feed& feed){
+		Host::FeedRecord record;
+		uint32_t nextIndex = 0;
+		int64_t lastTime = INT64_MIN;
+		uint16_t nextSequence[CSF_AGGREGATOR_DEVICES];
+		bool seen[CSF_AGGREGATOR_DEVICES] = {false};
+		while(Host::readFeed(fd, record)){
+			int64_t arrived = now();
+			feed.missing += record.index - nextIndex;
+			nextIndex = record.index + 1;
+			feed.disorder += record.time < lastTime ? 1 : 0;
+			lastTime = std::max(lastTime, record.time);
+			feed.breaks += (seen[record.device] && record.sequence != nextSequence[record.device]) ? 1 : 0;
+			seen[record.device] = true;
+			nextSequence[record.device] = record.sequence + 1;
+			if(feed.latencies.size() < feed.latencies.capacity()){
+				feed.latencies.push_back(arrived - record.received);
+			}
+			feed.records++;
+		}
+	}//end client()
+
+
+	/**
+	 * One run, printed as a row of the table
+	 * @param count -how many boards
+	 * @param seconds -how long they send for
+	 * @param rate -frames per second per board, 0 for as fast as possible
+	 * @param channels -channels per frame
+	 * @param windowMs -the Aggregator's window
+	 * @return bool -false if the run couldn't be set up or the feed wasn't right
+	 */
+	bool run(int count, double seconds, double rate, uint8_t channels, unsigned long windowMs){
+		std::vector<Board> boards(count);
+		std::unique_ptr<Host::Aggregator> aggregator(new Host::Aggregator(windowMs * 1000, 256));
+		struct termios raw;
+		cfmakeraw(&raw);
+		for(Board& board : boards){
+			board = Board();
+			if(openpty(&board.master, &board.slave, board.name, &raw, NULL) != 0 || aggregator->add(board.name) < 0){
+				perror("openpty");
+				return false;
+			}
+			fcntl(board.master, F_SETFL, fcntl(board.master, F_GETFL) | O_NONBLOCK);
+		}
+		char path[64];
+		snprintf(path, sizeof(path), "/tmp/csf_aggregator_demo.%d.sock", (int)getpid());
+		if(!aggregator->listen(path)){
+			perror("listen");
+			return false;
+		}
+		int fd = Host::connectFeed(path);
+		Feed feed;
+		feed.latencies.reserve(1 << 22);
+		std::thread reader(client, fd, std::ref(feed));
+		while(aggregator->getClientCount() == 0){
+			aggregator->poll(10);
+		}
+
+		//the boards
+		int64_t start = now();
+		int64_t end = start + (int64_t)(seconds * 1e9);
+		std::atomic<bool> writing(true);
+		std::thread writer([&](){
+			std::vector<struct pollfd> waiting(count);
+			int64_t period = rate > 0 ? (int64_t)(1e9 / rate) : 0;
+			std::vector<int64_t> due(count);
+			for(int i = 0; i < count; i++){
+				due[i] = start + period * i / count;	//spread out across the period, like boards switched on at different times
+			}
+			while(now() < end){
+				if(period > 0){
+					int next = std::min_element(due.begin(), due.end()) - due.begin();
+					int64_t wait = due[next] - now();
+					if(wait > 0){
+						struct timespec pause = {(time_t)(wait / 1000000000), (long)(wait % 1000000000)};
+						nanosleep(&pause, NULL);
+					}
+					Board& board = boards[next];
+					if(board.length + 128 <= sizeof(board.pending)){	//else it's backed up, the frame is never built so the sequence numbers don't break
+						build(board, (uint32_t)((due[next] - start) / 1000000), channels);
+					}
+					drain(board);
+					due[next] += period;
+					continue;
+				}
+				bool blocked = true;
+				for(Board& board : boards){
+					if(board.length == 0){
+						uint32_t timestamp = (uint32_t)((now() - start) / 1000000);
+						for(int i = 0; i < BURST; i++){
+							build(board, timestamp, channels);
+						}
+					}
+					blocked = !drain(board) && blocked;
+				}
+				if(blocked){
+					for(int i = 0; i < count; i++){
+						waiting[i] = {boards[i].master, POLLOUT, 0};
+					}
+					::poll(waiting.data(), count, 10);
+				}
+			}
+			for(Board& board : boards){	//the last of what's waiting
+				while(!drain(board)){
+					struct pollfd one = {board.master, POLLOUT, 0};
+					::poll(&one, 1, 10);
+				}
+			}
+			writing = false;
+		});
+
+		//the Aggregator, on this thread
+		struct timespec cpuStart;
+		struct timespec cpuEnd;
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuStart);
+		while(writing){
+			aggregator->poll(10);
+		}
+		writer.join();
+		int64_t quiet = now() + 200000000 + (int64_t)windowMs * 1000000;
+		while(now() < quiet){
+			aggregator->poll(10);
+		}
+		aggregator->flush();
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuEnd);
+		double cpu = (cpuEnd.tv_sec - cpuStart.tv_sec) + (cpuEnd.tv_nsec - cpuStart.tv_nsec) / 1e9;
+
+		unsigned long sent = 0;
+		unsigned long bytes = 0;
+		unsigned long frames = 0;
+		unsigned long errors = 0;
+		unsigned long dropped = 0;
+		unsigned long late = 0;
+		for(int i = 0; i < count; i++){
+			Host::DeviceStats stats = aggregator->getStats(i);
+			sent += boards[i].frames;
+			bytes += stats.bytes;
+			frames += stats.frames;
+			errors += stats.errors;
+			dropped += stats.dropped;
+			late += stats.late;
+		}
+		unsigned long clientDrops = aggregator->getClientDrops();
+		aggregator.reset();	//hangs up on the client
+		reader.join();
+		close(fd);
+		for(Board& board : boards){
+			close(board.slave);
+			close(board.master);
+		}
+
+		std::sort(feed.latencies.begin(), feed.latencies.end());
+		size_t last = feed.latencies.empty() ? 0 : feed.latencies.size() - 1;
+		double p50 = feed.latencies.empty() ? 0 : feed.latencies[last * 50 / 100] / 1000.0;
+		double p99 = feed.latencies.empty() ? 0 : feed.latencies[last * 99 / 100] / 1000.0;
+		printf("%6d %10lu %10lu %11.0f %8.1f %6.1f %9.2f %8.0f %8.0f %7lu %7lu %6lu %6lu %7lu\n", count, sent, feed.records, frames / seconds, bytes / seconds / 1e6, 100 * cpu / seconds, frames > 0 ? cpu * 1e6 / frames : 0, p50, p99, errors + dropped, feed.missing + clientDrops, late, feed.disorder, feed.breaks);
+		return sent == frames && frames == feed.records && errors + dropped + feed.missing + feed.breaks == 0 && feed.disorder == late;
+	}//end run()
+}
+
+
+
+
+int main(int argc, char** argv){
+	double seconds = argc > 1 ? atof(argv[1]) : 2.0;
+	double rate = argc > 2 ? atof(argv[2]) : 0;
+	int channels = argc > 3 ? atoi(argv[3]) : 8;
+	unsigned long windowMs = argc > 4 ? strtoul(argv[4], NULL, 10) : 10;
+	if(seconds <= 0 || rate < 0 || channels < 1 || channels > FRAME_MAX_CHANNELS){
+		fprintf(stderr, "usage: csf_aggregator_demo [seconds per run] [frames per second per board] [channels 1-%u] [window ms]\n", FRAME_MAX_CHANNELS);
+		return 2;
+	}
+	if(rate > 0){
+		printf("%.1f s per run, %.0f frames/s per board, %d channels, %lu ms window\n", seconds, rate, channels, windowMs);
+	}
+	else{
+		printf("%.1f s per run, boards sending as fast as they can, %d channels, %lu ms window\n", seconds, channels, windowMs);
+	}
+	printf("%6s %10s %10s %11s %8s %6s %9s %8s %8s %7s %7s %6s %6s %7s\n", "boards", "sent", "delivered", "frames/s", "MB/s", "cpu%", "cpu us/f", "p50 us", "p99 us", "corrupt", "missed", "late", "order", "breaks");
+	bool good = true;
+	for(int count : COUNTS){
+		good = run(count, seconds, rate, channels, windowMs) && good;
+	}
+	return good ? 0 : 1;
+}//end main()
@@ -0,0 +1,112 @@
+/**
+ * @file
+ * @section description Description
+ * Runs the simulated board and a Host::Client against each other through a pseudo-terminal, the way the Client would talk to a real board over USB.\n
+ * The board side is a FrameStreamer carrying two Pots, swept back and forth by scripted analog inputs, and a Momentary pressed now and then, with the simulated clock kept in step with the real one. The PC side opens the slave end of the pseudo-terminal by name, the same as it would /dev/ttyACM0.\n
+ * At the end it prints the frame counts, a channel's recent history and the latency percentiles from the frame being built to the Client decoding it.\n
+ * csf_pty_demo [seconds] [frame interval ms]
+ */
+
+
+#include <Arduino.h>
+#include <CSF_Controls.h>
+#include "../CSF_Client.h"
+#include <math.h>
+#include <pty.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+using namespace Sensors;
+using namespace Switches;
+using namespace Comms;
+
+
+
+
+int main(int argc, char** argv){
+	double seconds = argc > 1 ? atof(argv[1]) : 3.0;
+	int interval = argc > 2 ? atoi(argv[2]) : 5;
+
+	int master;
+	int slave;
+	char name[128];
+	struct termios raw;
+	cfmakeraw(&raw);
+	if(openpty(&master, &slave, name, &raw, NULL) != 0){
+		perror("openpty");
+		return 1;
+	}
+
+	//the board
+	Sim::reset();
+	Sim::setSerialSink([master](const uint8_t* data, size_t len){
+		while(len > 0){
+			ssize_t written = write(master, data, len);
+			if(written <= 0){
+				return;
+			}
+			data += written;
+			len -= written;
+		}
+	});
+	Sim::scriptAnalog(A0, [](unsigned long us){ return (int)(511.5 + 511.5 * sin(us / 400000.0)); });
+	Sim::scriptAnalog(A2, [](unsigned long us){ return (int)((us / 1000) % 1024); });
+	Sim::scriptDigital(8, [](unsigned long us){ return (us / 250000) % 4 == 0 ? HIGH : LOW; });
+	Pot rotary = Pot(2, 3, A0);
+	Pot slider = Pot(5, 6, A2);
+	Momentary button = Momentary(8, 0);
+	FrameStreamer streamer = FrameStreamer(interval);
+	rotary.begin();
+	slider.begin();
+	button.begin();
+	rotary.toggleIsSensorOn();
+	slider.toggleIsSensorOn();
+	streamer.add(rotary);
+	streamer.add(slider);
+	streamer.add(button);
+
+	//the PC
+	Host::Client client;
+	unsigned long changes = 0;
+	client.onChange([&changes](uint8_t, const Host::Channel&, const Host::Channel&){ changes++; });
+	if(!client.open(name)){
+		fprintf(stderr, "couldn't open %s\n", name);
+		return 1;
+	}
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	client.setBoardEpoch(start);
+
+	//run the board in real time, the simulated clock catching up to the real one each pass
+	streamer.begin();
+	std::chrono::steady_clock::time_point end = start + std::chrono::microseconds((long)(seconds * 1e6));
+	unsigned long boardMicros = 0;
+	while(std::chrono::steady_clock::now() < end){
+		unsigned long elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+		Sim::advanceMicros(elapsed - boardMicros);
+		boardMicros = elapsed;
+		streamer.update();
+		usleep(200);
+	}
+	usleep(50000);	//let the last frames through
+	client.stop();
+
+	Host::Snapshot snapshot;
+	client.snapshot(snapshot);
+	printf("pty %s, %.1f s, a frame every %d ms\n", name, seconds, interval);
+	printf("frames sent %u, decoded %lu, errors %lu, dropped %lu, changes %lu\n", streamer.getSequence(), client.getFrames(), client.getErrors(), client.getDropped(), changes);
+	printf("newest frame %u: rotary %d, slider %d, button %d\n", snapshot.sequence, snapshot.channels[0].value, snapshot.channels[1].value, snapshot.channels[2].value);
+	std::vector<Host::Sample> recent;
+	client.history(0, recent);
+	printf("rotary history, %zu values, the last five:", recent.size());
+	for(size_t i = recent.size() > 5 ? recent.size() - 5 : 0; i < recent.size(); i++){
+		printf(" %d", recent[i].value);
+	}
+	printf("\n");
+	Host::Latency latency = client.getLatency();
+	printf("latency over %zu frames: p50 %.0f us, p90 %.0f us, p99 %.0f us, max %.0f us (board clock is 1 ms resolution)\n", latency.samples, latency.p50, latency.p90, latency.p99, latency.max);
+	close(slave);
+	close(master);
+	return 0;
+}//end main()
@@ -0,0 +1,602 @@
+/**
+ * @file
+ * @section description Description
+ * The simulated board behind host/sim/Arduino.h: the clock, the pins and Serial all live in plain variables here.
+ */
+
+
+#include "Arduino.h"
+#include "EEPROM.h"
+#include <deque>
+#include <stdio.h>
+
+
+HardwareSerial Serial;
+EEPROMClass EEPROM;
+
+namespace Sim{
+	volatile uint8_t portInput[SIM_PORTS];
+	volatile uint8_t portOutput[SIM_PORTS];
+	volatile uint8_t portMode[SIM_PORTS];
+}
+
+
+namespace{
+	unsigned long clockMicros = 0;	///< the virtual clock
+	unsigned long clockStep = 0;	///< microseconds the clock moves on its own per read
+	unsigned long analogReads = 0;
+	int analogValues[NUM_DIGITAL_PINS];
+	uint8_t modes[NUM_DIGITAL_PINS];
+	std::function<int(unsigned long)> digitalScripts[NUM_DIGITAL_PINS];
+	std::function<int(unsigned long)> analogScripts[NUM_DIGITAL_PINS];
+	std::function<void(int)> outputWatchers[NUM_DIGITAL_PINS];
+	std::function<void(void)> portReadWatchers[NUM_DIGITAL_PINS];
+	unsigned long portReadNanos = 500;
+	unsigned long clockNanos = 0;	///< the part of a microsecond readPort() has added to the clock
+	void (*interruptHandlers[NUM_DIGITAL_PINS])(void);
+	int interruptModes[NUM_DIGITAL_PINS];
+	bool interruptsEnabled = true;
+	std::deque<uint8_t> serialIn;
+	std::string serialOut;
+	std::function<void(const uint8_t*, size_t)> serialSink;
+	int serialTxSpace = 63;
+	uint8_t eeprom[SIM_EEPROM_SIZE];
+	bool eepromBlank = true;	///< a new chip reads 0xFF, filled in on first use since nothing clears it
+	unsigned long eepromWrites = 0;
+
+
+	int levelOf(uint8_t pin){
+		uint8_t port = digitalPinToPort(pin);
+		return (Sim::portInput[port] & digitalPinToBitMask(pin)) ? HIGH : LOW;
+	}//end levelOf()
+
+
+	void setLevel(uint8_t pin, int level){
+		if(pin >= NUM_DIGITAL_PINS){
+			return;
+		}
+		int previous = levelOf(pin);
+		uint8_t port = digitalPinToPort(pin);
+		if(level == HIGH){
+			Sim::portInput[port] |= digitalPinToBitMask(pin);
+		}
+		else{
+			Sim::portInput[port] &= ~digitalPinToBitMask(pin);
+		}
+		if(previous != level && interruptHandlers[pin] != NULL && interruptsEnabled){
+			int mode = interruptModes[pin];
+			if(mode == CHANGE || (mode == RISING && level == HIGH) || (mode == FALLING && level == LOW)){
+				interruptHandlers[pin]();
+			}
+		}
+	}//end setLevel()
+
+
+	void runScripts(void){
+		for(int pin = 0; pin < NUM_DIGITAL_PINS; pin++){
+			if(digitalScripts[pin]){
+				setLevel(pin, digitalScripts[pin](clockMicros) ? HIGH : LOW);
+			}
+		}
+	}//end runScripts()
+
+
+	void emit(const uint8_t* data, size_t len){
+		if(serialSink){
+			serialSink(data, len);
+		}
+		else{
+			serialOut.append((const char*)data, len);
+		}
+	}//end emit()
+
+
+	size_t emitText(const char* text){
+		size_t len = strlen(text);
+		emit((const uint8_t*)text, len);
+		return len;
+	}//end emitText()
+
+
+	uint8_t* eepromByte(int address){
+		if(eepromBlank){
+			memset(eeprom, 0xFF, sizeof(eeprom));
+			eepromBlank = false;
+		}
+		if(address < 0 || address >= SIM_EEPROM_SIZE){
+			return NULL;
+		}
+		return &eeprom[address];
+	}//end eepromByte()
+}
+
+
+
+
+// Arduino API
+
+unsigned long millis(){
+	clockMicros += clockStep;
+	return clockMicros / 1000;
+}//end millis()
+
+
+unsigned long micros(){
+	clockMicros += clockStep;
+	return clockMicros;
+}//end micros()
+
+
+void delay(unsigned long ms){
+	Sim::advanceMillis(ms);
+}//end delay()
+
+
+void delayMicroseconds(unsigned int us){
+	Sim::advanceMicros(us);
+}//end delayMicroseconds()
+
+
+void pinMode(uint8_t pin, uint8_t mode){
+	if(pin >= NUM_DIGITAL_PINS){
+		return;
+	}
+	bool wasOutput = modes[pin] == OUTPUT;
+	modes[pin] = mode;
+	uint8_t port = digitalPinToPort(pin);
+	if(mode == OUTPUT){
+		Sim::portMode[port] |= digitalPinToBitMask(pin);
+	}
+	else{
+		Sim::portMode[port] &= ~digitalPinToBitMask(pin);
+		if(mode == INPUT_PULLUP && !digitalScripts[pin]){
+			setLevel(pin, HIGH);
+		}
+	}
+	if(wasOutput != (mode == OUTPUT) && outputWatchers[pin]){
+		outputWatchers[pin](mode == OUTPUT ? Sim::getDigitalOutput(pin) : -1);
+	}
+}//end pinMode()
+
+
+int digitalRead(uint8_t pin){
+	if(pin >= NUM_DIGITAL_PINS){
+		return LOW;
+	}
+	return levelOf(pin);
+}//end digitalRead()
+
+
+void digitalWrite(uint8_t pin, uint8_t val){
+	if(pin >= NUM_DIGITAL_PINS){
+		return;
+	}
+	uint8_t port = digitalPinToPort(pin);
+	if(val == HIGH){
+		Sim::portOutput[port] |= digitalPinToBitMask(pin);
+	}
+	else{
+		Sim::portOutput[port] &= ~digitalPinToBitMask(pin);
+	}
+	if(modes[pin] == OUTPUT){
+		setLevel(pin, val == HIGH ? HIGH : LOW);
+		if(outputWatchers[pin]){
+			outputWatchers[pin](val == HIGH ? HIGH : LOW);
+		}
+	}
+}//end digitalWrite()
+
+
+int analogRead(uint8_t pin){
+	analogReads++;
+	if(pin < NUM_ANALOG_INPUTS && pin < A0){
+		pin = pin + A0;
+	}
+	if(pin >= NUM_DIGITAL_PINS){
+		return 0;
+	}
+	if(analogScripts[pin]){
+		return constrain(analogScripts[pin](clockMicros), 0, 1023);
+	}
+	return analogValues[pin];
+}//end analogRead()
+
+
+long map(long x, long in_min, long in_max, long out_min, long out_max){
+	return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}//end map()
+
+
+void noInterrupts(){
+	interruptsEnabled = false;
+}//end noInterrupts()
+
+
+void interrupts(){
+	interruptsEnabled = true;
+}//end interrupts()
+
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode){
+	if(interruptNum < NUM_DIGITAL_PINS){
+		interruptHandlers[interruptNum] = userFunc;
+		interruptModes[interruptNum] = mode;
+	}
+}//end attachInterrupt()
+
+
+void detachInterrupt(uint8_t interruptNum){
+	if(interruptNum < NUM_DIGITAL_PINS){
+		interruptHandlers[interruptNum] = NULL;
+	}
+}//end detachInterrupt()
+
+
+
+
+// Serial
+
+void HardwareSerial::begin(unsigned long baud){
+	(void)baud;
+}//end begin()
+
+
+void HardwareSerial::end(){
+}//end end()
+
+
+int HardwareSerial::available(){
+	return (int)serialIn.size();
+}//end available()
+
+
+int HardwareSerial::availableForWrite(){
+	return serialTxSpace;
+}//end availableForWrite()
+
+
+int HardwareSerial::read(){
+	if(serialIn.empty()){
+		return -1;
+	}
+	int c = serialIn.front();
+	serialIn.pop_front();
+	return c;
+}//end read()
+
+
+int HardwareSerial::peek(){
+	if(serialIn.empty()){
+		return -1;
+	}
+	return serialIn.front();
+}//end peek()
+
+
+void HardwareSerial::flush(){
+}//end flush()
+
+
+size_t HardwareSerial::write(uint8_t b){
+	emit(&b, 1);
+	return 1;
+}//end write(uint8_t)
+
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size){
+	emit(buffer, size);
+	return size;
+}//end write(buffer)
+
+
+size_t HardwareSerial::write(const char* str){
+	return emitText(str);
+}//end write(str)
+
+
+size_t HardwareSerial::print(const char* str){
+	return emitText(str);
+}//end print(str)
+
+
+size_t HardwareSerial::print(char c){
+	return write((uint8_t)c);
+}//end print(char)
+
+
+size_t HardwareSerial::print(int n){
+	return print((long)n);
+}//end print(int)
+
+
+size_t HardwareSerial::print(unsigned int n){
+	return print((unsigned long)n);
+}//end print(unsigned int)
+
+
+size_t HardwareSerial::print(long n){
+	char text[24];
+	snprintf(text, sizeof(text), "%ld", n);
+	return emitText(text);
+}//end print(long)
+
+
+size_t HardwareSerial::print(unsigned long n){
+	char text[24];
+	snprintf(text, sizeof(text), "%lu", n);
+	return emitText(text);
+}//end print(unsigned long)
+
+
+size_t HardwareSerial::print(double n, int digits){
+	char text[48];
+	snprintf(text, sizeof(text), "%.*f", digits, n);
+	return emitText(text);
+}//end print(double)
+
+
+size_t HardwareSerial::println(){
+	return emitText("\r\n");
+}//end println()
+
+
+size_t HardwareSerial::println(const char* str){
+	return print(str) + println();
+}//end println(str)
+
+
+size_t HardwareSerial::println(char c){
+	return print(c) + println();
+}//end println(char)
+
+
+size_t HardwareSerial::println(int n){
+	return print(n) + println();
+}//end println(int)
+
+
+size_t HardwareSerial::println(unsigned int n){
+	return print(n) + println();
+}//end println(unsigned int)
+
+
+size_t HardwareSerial::println(long n){
+	return print(n) + println();
+}//end println(long)
+
+
+size_t HardwareSerial::println(unsigned long n){
+	return print(n) + println();
+}//end println(unsigned long)
+
+
+size_t HardwareSerial::println(double n, int digits){
+	return print(n, digits) + println();
+}//end println(double)
+
+
+
+
+// Sim
+
+void Sim::reset(){
+	clockMicros = 0;
+	clockStep = 0;
+	clockNanos = 0;
+	portReadNanos = 500;
+	analogReads = 0;
+	for(int port = 0; port < SIM_PORTS; port++){
+		portInput[port] = 0;
+		portOutput[port] = 0;
+		portMode[port] = 0;
+	}
+	for(int pin = 0; pin < NUM_DIGITAL_PINS; pin++){
+		analogValues[pin] = 0;
+		modes[pin] = INPUT;
+		digitalScripts[pin] = nullptr;
+		analogScripts[pin] = nullptr;
+		outputWatchers[pin] = nullptr;
+		portReadWatchers[pin] = nullptr;
+		interruptHandlers[pin] = NULL;
+	}
+	interruptsEnabled = true;
+	serialIn.clear();
+	serialOut.clear();
+	serialSink = nullptr;
+	serialTxSpace = 63;
+}//end reset()
+
+
+void Sim::advanceMicros(unsigned long us){
+	clockMicros += us;
+	runScripts();
+}//end advanceMicros()
+
+
+void Sim::advanceMillis(unsigned long ms){
+	advanceMicros(ms * 1000);
+}//end advanceMillis()
+
+
+unsigned long Sim::now(){
+	return clockMicros;
+}//end now()
+
+
+void Sim::setClockStep(unsigned long us){
+	clockStep = us;
+}//end setClockStep()
+
+
+void Sim::setDigital(uint8_t pin, int level){
+	setLevel(pin, level);
+}//end setDigital()
+
+
+void Sim::setAnalog(uint8_t pin, int value){
+	if(pin < NUM_ANALOG_INPUTS && pin < A0){
+		pin = pin + A0;
+	}
+	if(pin < NUM_DIGITAL_PINS){
+		analogValues[pin] = constrain(value, 0, 1023);
+	}
+}//end setAnalog()
+
+
+void Sim::scriptDigital(uint8_t pin, std::function<int(unsigned long)> script){
+	if(pin < NUM_DIGITAL_PINS){
+		digitalScripts[pin] = script;
+		if(script){
+			setLevel(pin, script(clockMicros) ? HIGH : LOW);
+		}
+	}
+}//end scriptDigital()
+
+
+void Sim::scriptAnalog(uint8_t pin, std::function<int(unsigned long)> script){
+	if(pin < NUM_ANALOG_INPUTS && pin < A0){
+		pin = pin + A0;
+	}
+	if(pin < NUM_DIGITAL_PINS){
+		analogScripts[pin] = script;
+	}
+}//end scriptAnalog()
+
+
+void Sim::watchOutput(uint8_t pin, std::function<void(int)> watcher){
+	if(pin < NUM_DIGITAL_PINS){
+		outputWatchers[pin] = watcher;
+	}
+}//end watchOutput()
+
+
+int Sim::getDigitalOutput(uint8_t pin){
+	if(pin >= NUM_DIGITAL_PINS){
+		return LOW;
+	}
+	return (portOutput[digitalPinToPort(pin)] & digitalPinToBitMask(pin)) ? HIGH : LOW;
+}//end getDigitalOutput()
+
+
+int Sim::getPinMode(uint8_t pin){
+	if(pin >= NUM_DIGITAL_PINS){
+		return INPUT;
+	}
+	return modes[pin];
+}//end getPinMode()
+
+
+unsigned long Sim::getAnalogReads(){
+	return analogReads;
+}//end getAnalogReads()
+
+
+void Sim::serialInput(const uint8_t* data, size_t len){
+	serialIn.insert(serialIn.end(), data, data + len);
+}//end serialInput(bytes)
+
+
+void Sim::serialInput(const char* text){
+	serialInput((const uint8_t*)text, strlen(text));
+}//end serialInput(text)
+
+
+const std::string& Sim::serialOutput(){
+	return serialOut;
+}//end serialOutput()
+
+
+void Sim::clearSerialOutput(){
+	serialOut.clear();
+}//end clearSerialOutput()
+
+
+void Sim::setSerialSink(std::function<void(const uint8_t*, size_t)> sink){
+	serialSink = sink;
+}//end setSerialSink()
+
+
+void Sim::setSerialTxSpace(int bytes){
+	serialTxSpace = bytes;
+}//end setSerialTxSpace()
+
+
+
+uint8_t Sim::readPort(const volatile uint8_t* reg){
+	clockNanos += portReadNanos;
+	if(clockNanos >= 1000){
+		clockMicros += clockNanos / 1000;
+		clockNanos %= 1000;
+		runScripts();
+	}
+	if(reg >= portInput && reg < portInput + SIM_PORTS){
+		uint8_t port = reg - portInput;
+		for(int pin = (port - 1) * 8; pin >= 0 && pin < port * 8 && pin < NUM_DIGITAL_PINS; pin++){
+			if(portReadWatchers[pin]){
+				portReadWatchers[pin]();
+			}
+		}
+	}
+	return *reg;
+}//end readPort()
+
+
+void Sim::setPortReadNanos(unsigned long ns){
+	portReadNanos = ns;
+}//end setPortReadNanos()
+
+
+unsigned long long Sim::nowNanos(){
+	return (unsigned long long)clockMicros * 1000 + clockNanos;
+}//end nowNanos()
+
+
+void Sim::watchPortReads(uint8_t pin, std::function<void(void)> watcher){
+	if(pin < NUM_DIGITAL_PINS){
+		portReadWatchers[pin] = watcher;
+	}
+}//end watchPortReads()
+
+
+void Sim::clearEEPROM(){
+	eepromBlank = true;
+	eepromWrites = 0;
+}//end clearEEPROM()
+
+
+unsigned long Sim::getEEPROMWrites(){
+	return eepromWrites;
+}//end getEEPROMWrites()
+
+
+
+
+
+
+// EEPROM
+
+uint8_t EEPROMClass::read(int address){
+	uint8_t* cell = eepromByte(address);
+	return cell != NULL ? *cell : 0xFF;
+}//end read()
+
+
+void EEPROMClass::write(int address, uint8_t value){
+	uint8_t* cell = eepromByte(address);
+	if(cell != NULL){
+		*cell = value;
+		eepromWrites++;
+	}
+}//end write()
+
+
+void EEPROMClass::update(int address, uint8_t value){
+	if(read(address) != value){
+		write(address, value);
+	}
+}//end update()
+
+
+uint16_t EEPROMClass::length(){
+	return SIM_EEPROM_SIZE;
+}//end length()
@@ -0,0 +1,304 @@
+/**
+ * @file
+ * @section description Description
+ * A stand-in for the Arduino core so CSF_Controls.cpp can be built and measured on a Linux PC.\n
+ * It provides the parts of the Arduino API the library uses: a virtual clock behind millis\(\) and micros\(\), scriptable digital and analog pins, pin interrupts, the port register lookups, and a Serial object that captures everything written to it.\n
+ * The controls for the simulation itself are in the Sim namespace at the bottom, e.g. Sim::advanceMillis\(\) to move the clock forward or Sim::setDigital\(\) to press a button.
+ */
+
+
+#ifndef CSF_Sim_Arduino_h
+#define CSF_Sim_Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <functional>
+
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define NOT_A_PORT 0
+#define NOT_A_PIN 0
+#define NOT_AN_INTERRUPT -1
+
+#define SIM_PORTS 9	///< Number of simulated 8 bit ports, port 0 is NOT_A_PORT so pins start on port 1, also tells CSF_Controls it can use the port registers
+#define NUM_DIGITAL_PINS ((SIM_PORTS - 1) * 8)
+#define NUM_ANALOG_INPUTS 16
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+#define A6 20
+#define A7 21
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+
+#define digitalPinToPort(p) ((p) < NUM_DIGITAL_PINS ? ((p) / 8) + 1 : NOT_A_PORT)
+#define digitalPinToBitMask(p) ((uint8_t)(1 << ((p) % 8)))
+#define portInputRegister(P) (&Sim::portInput[(P)])
+#define portOutputRegister(P) (&Sim::portOutput[(P)])
+#define portModeRegister(P) (&Sim::portMode[(P)])
+#define CSF_PORT_READ(reg) Sim::readPort(reg)	///< So Expansion::CapSense's timed loop takes simulated time and the electrodes can charge, see Sim::readPort\(\)
+#define digitalPinToInterrupt(p) ((p) < NUM_DIGITAL_PINS ? (p) : NOT_AN_INTERRUPT)
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t val);
+int analogRead(uint8_t pin);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+void noInterrupts(void);
+void interrupts(void);
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode);
+void detachInterrupt(uint8_t interruptNum);
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+
+
+
+/**
+ * Captures the serial output of the library and feeds it scripted input, standing in for HardwareSerial
+ */
+class HardwareSerial{
+	public:
+		void begin(unsigned long baud);
+		void end(void);
+		int available(void);
+		int availableForWrite(void);
+		int read(void);
+		int peek(void);
+		void flush(void);
+		size_t write(uint8_t b);
+		size_t write(const uint8_t* buffer, size_t size);
+		size_t write(const char* str);
+		size_t print(const char* str);
+		size_t print(char c);
+		size_t print(int n);
+		size_t print(unsigned int n);
+		size_t print(long n);
+		size_t print(unsigned long n);
+		size_t print(double n, int digits = 2);
+		size_t println(void);
+		size_t println(const char* str);
+		size_t println(char c);
+		size_t println(int n);
+		size_t println(unsigned int n);
+		size_t println(long n);
+		size_t println(unsigned long n);
+		size_t println(double n, int digits = 2);
+		operator bool(void){ return true; }
+};
+
+extern HardwareSerial Serial;
+
+
+
+
+/**
+ * The controls for the simulated board, nothing in here exists on a real Arduino
+ */
+namespace Sim{
+	extern volatile uint8_t portInput[SIM_PORTS];	///< The PINx registers, what digitalRead\(\) sees
+	extern volatile uint8_t portOutput[SIM_PORTS];	///< The PORTx registers, what digitalWrite\(\) drives
+	extern volatile uint8_t portMode[SIM_PORTS];	///< The DDRx registers, 1 is OUTPUT
+
+
+	/**
+	 * Puts the clock back to zero, clears every pin, interrupt, script and the serial buffers
+	 */
+	void reset(void);
+
+
+	/**
+	 * Moves the virtual clock forward, running any scripted inputs and firing pin interrupts for the edges they cause
+	 * @param us -the number of microseconds to move forward
+	 */
+	void advanceMicros(unsigned long us);
+
+
+	/**
+	 * Moves the virtual clock forward
+	 * @param ms -the number of milliseconds to move forward
+	 */
+	void advanceMillis(unsigned long ms);
+
+
+	/**
+	 * Reads the virtual clock without moving it, unlike micros\(\) with a clock step set
+	 * @return unsigned long -microseconds
+	 */
+	unsigned long now(void);
+
+
+	/**
+	 * Sets how far the clock moves on its own every time millis\(\) or micros\(\) is read, 0 by default so time only moves with advanceMicros\(\)
+	 * @param us -microseconds added per clock read
+	 */
+	void setClockStep(unsigned long us);
+
+
+	/**
+	 * Drives an input pin from outside the board, e.g. a button being pressed, firing any interrupt attached to it
+	 * @param pin -the Arduino pin
+	 * @param level -HIGH or LOW
+	 */
+	void setDigital(uint8_t pin, int level);
+
+
+	/**
+	 * Sets the value the next analogRead\(\) of the pin will return
+	 * @param pin -the Arduino pin
+	 * @param value -0 to 1023
+	 */
+	void setAnalog(uint8_t pin, int value);
+
+
+	/**
+	 * Scripts a digital input as a function of time, evaluated every time the clock moves
+	 * @param pin -the Arduino pin
+	 * @param script -returns HIGH or LOW for the given micros\(\) timestamp, an empty function removes the script
+	 */
+	void scriptDigital(uint8_t pin, std::function<int(unsigned long)> script);
+
+
+	/**
+	 * Scripts an analog input as a function of time, evaluated on each analogRead\(\)
+	 * @param pin -the Arduino pin
+	 * @param script -returns 0 to 1023 for the given micros\(\) timestamp, an empty function removes the script
+	 */
+	void scriptAnalog(uint8_t pin, std::function<int(unsigned long)> script);
+
+
+	/**
+	 * Calls a function every time the board writes to an output pin, so a model of the chip on the other end can follow it
+	 * @param pin -the Arduino pin
+	 * @param watcher -called with HIGH or LOW after each digitalWrite\(\) and when pinMode\(\) makes the pin an output, and with -1 when pinMode\(\) lets go of it, an empty function removes it
+	 */
+	void watchOutput(uint8_t pin, std::function<void(int)> watcher);
+
+
+	/**
+	 * Gets the level the board is currently driving an output pin to
+	 * @param pin -the Arduino pin
+	 * @return int -HIGH or LOW
+	 */
+	int getDigitalOutput(uint8_t pin);
+
+
+	/**
+	 * Gets the mode last set with pinMode\(\)
+	 * @param pin -the Arduino pin
+	 * @return int -INPUT, OUTPUT or INPUT_PULLUP
+	 */
+	int getPinMode(uint8_t pin);
+
+
+	/**
+	 * Gets the number of analogRead\(\) calls since the last reset\(\)
+	 * @return unsigned long
+	 */
+	unsigned long getAnalogReads(void);
+
+
+	/**
+	 * Queues bytes for the board to read from Serial, as if the PC had sent them
+	 * @param data -the bytes
+	 * @param len -how many
+	 */
+	void serialInput(const uint8_t* data, size_t len);
+
+
+	/**
+	 * Queues a string for the board to read from Serial, as if the PC had sent it
+	 * @param text -the characters, the terminating null is not sent
+	 */
+	void serialInput(const char* text);
+
+
+	/**
+	 * Gets everything the board has written to Serial since the last clearSerialOutput\(\)
+	 * @return const std::string&
+	 */
+	const std::string& serialOutput(void);
+
+
+	/**
+	 * Empties the captured serial output
+	 */
+	void clearSerialOutput(void);
+
+
+	/**
+	 * Sends the serial output somewhere as it is written instead of capturing it, e.g. to a pseudo-terminal
+	 * @param sink -called with each block written, an empty function goes back to capturing
+	 */
+	void setSerialSink(std::function<void(const uint8_t*, size_t)> sink);
+
+
+	/**
+	 * Limits how many bytes availableForWrite\(\) reports, to model a full transmit buffer
+	 * @param bytes -the free space in the transmit buffer, 63 by default as on an Uno
+	 */
+	void setSerialTxSpace(int bytes);
+
+
+	/**
+	 * Reads a port register the way CSF_PORT_READ does on the simulated board. Each read takes setPortReadNanos\(\) of simulated time, then anything watching a pin on that port with watchPortReads\(\) updates it before the register is read
+	 * @param reg -the register, from portInputRegister\(\)
+	 * @return uint8_t
+	 */
+	uint8_t readPort(const volatile uint8_t* reg);
+
+
+	/**
+	 * Sets how long each readPort\(\) takes, the time of one pass of a tight loop around a port read
+	 * @param ns -nanoseconds, 500 by default, 8 cycles at 16 MHz
+	 */
+	void setPortReadNanos(unsigned long ns);
+
+
+	/**
+	 * Reads the virtual clock to the nanosecond, it only moves in steps finer than a microsecond on readPort\(\)
+	 * @return unsigned long long
+	 */
+	unsigned long long nowNanos(void);
+
+
+	/**
+	 * Calls a function every time readPort\(\) reads the port a pin is on, so a model of something that changes faster than a microsecond, e.g. an electrode charging, can set the pin first
+	 * @param pin -the Arduino pin
+	 * @param watcher -the function, an empty function removes it
+	 */
+	void watchPortReads(uint8_t pin, std::function<void(void)> watcher);
+}
+
+#endif
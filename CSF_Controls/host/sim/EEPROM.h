@@ -0,0 +1,49 @@
+/**
+ * @file
+ * @section description Description
+ * The simulated board's EEPROM, the part of the Arduino EEPROM library CSF_Controls uses.\n
+ * Like the real thing it keeps its contents through Sim::reset\(\), so a sketch can save, be "restarted" and load again. Sim::clearEEPROM\(\) wipes it back to the 0xFF of a new chip.
+ */
+
+
+#ifndef CSF_Sim_EEPROM_h
+#define CSF_Sim_EEPROM_h
+
+#include "Arduino.h"
+
+#define SIM_EEPROM_SIZE 1024	///< Bytes of EEPROM, as on an Uno
+
+
+
+
+/**
+ * Reads and writes the simulated EEPROM a byte at a time, standing in for EEPROMClass
+ */
+class EEPROMClass{
+	public:
+		uint8_t read(int address);
+		void write(int address, uint8_t value);
+		void update(int address, uint8_t value);
+		uint16_t length(void);
+};
+
+extern EEPROMClass EEPROM;
+
+
+
+
+namespace Sim{
+	/**
+	 * Sets every byte of the EEPROM back to 0xFF and the write count to 0
+	 */
+	void clearEEPROM(void);
+
+
+	/**
+	 * Gets the number of bytes actually written to the EEPROM since the last clearEEPROM\(\), update\(\) only counts when the byte changes, to keep an eye on wear
+	 * @return unsigned long
+	 */
+	unsigned long getEEPROMWrites(void);
+}
+
+#endif
@@ -0,0 +1,13 @@
+/**
+ * @file
+ * @section description Description
+ * The simulated board's Serial lives in Arduino.h with the rest of the core, this is here so code that includes HardwareSerial.h builds unchanged.
+ */
+
+
+#ifndef CSF_Sim_HardwareSerial_h
+#define CSF_Sim_HardwareSerial_h
+
+#include "Arduino.h"
+
+#endif
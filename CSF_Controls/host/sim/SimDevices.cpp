@@ -0,0 +1,376 @@
+#include "SimDevices.h"
+#include <algorithm>
+
+
+using namespace Sim;
+
+
+
+
+// Mux
+
+Mux::Mux(uint8_t common, std::vector<uint8_t> selects, unsigned long settleMicros){
+	commonPin = common;
+	selectPins = selects;
+	settle = settleMicros;
+	channels.assign((size_t)1 << selectPins.size(), 0);
+	current = 0;
+	previous = 0;
+	changedAt = 0;
+	switches = 0;
+}//end constructor
+
+
+void Mux::connect(){
+	current = selected();
+	previous = current;
+	changedAt = 0;
+	switches = 0;
+	for(size_t i = 0; i < selectPins.size(); i++){
+		watchOutput(selectPins[i], [this](int){
+			uint8_t channel = selected();
+			if(channel != current){
+				previous = current;
+				current = channel;
+				changedAt = Sim::now();
+				switches++;
+			}
+		});
+	}
+	scriptAnalog(commonPin, [this](unsigned long t){
+		return channels[(t - changedAt) < settle ? previous : current];
+	});
+}//end connect()
+
+
+void Mux::setChannel(uint8_t channel, int value){
+	if(channel < channels.size()){
+		channels[channel] = value;
+	}
+}//end setChannel()
+
+
+unsigned long Mux::getSwitches() const{
+	return switches;
+}//end getSwitches()
+
+
+uint8_t Mux::selected() const{
+	uint8_t channel = 0;
+	for(size_t i = 0; i < selectPins.size(); i++){
+		if(getDigitalOutput(selectPins[i]) == HIGH){
+			channel |= 1 << i;
+		}
+	}
+	return channel;
+}//end selected()
+
+
+
+
+// ShiftRegister
+
+ShiftRegister::ShiftRegister(uint8_t load, uint8_t clock, uint8_t data, uint8_t chips){
+	loadPin = load;
+	clockPin = clock;
+	dataPin = data;
+	chipCount = chips;
+	inputs = 0;
+	chain.assign(chips * 8, LOW);
+	loadLevel = HIGH;
+	clockLevel = LOW;
+	shifts = 0;
+}//end constructor
+
+
+void ShiftRegister::connect(){
+	loadLevel = getDigitalOutput(loadPin);
+	clockLevel = getDigitalOutput(clockPin);
+	shifts = 0;
+	watchOutput(loadPin, [this](int level){
+		loadLevel = level;
+		if(level == LOW){
+			for(uint8_t chip = 0; chip < chipCount; chip++){
+				for(uint8_t k = 0; k < 8; k++){
+					chain[chip * 8 + k] = (inputs >> (chip * 8 + 7 - k)) & 0x01 ? HIGH : LOW;	//H comes out first
+				}
+			}
+			output();
+		}
+	});
+	watchOutput(clockPin, [this](int level){
+		if(level == HIGH && clockLevel == LOW && loadLevel == HIGH){
+			chain.erase(chain.begin());
+			chain.push_back(LOW);	//SER of the last chip is tied low
+			shifts++;
+			output();
+		}
+		clockLevel = level;
+	});
+	output();
+}//end connect()
+
+
+void ShiftRegister::setInput(uint8_t index, int level){
+	if(index >= chipCount * 8){
+		return;
+	}
+	if(level == HIGH){
+		inputs |= (uint32_t)1 << index;
+	}
+	else{
+		inputs &= ~((uint32_t)1 << index);
+	}
+}//end setInput()
+
+
+void ShiftRegister::setInputs(uint32_t bits){
+	inputs = bits;
+}//end setInputs()
+
+
+unsigned long ShiftRegister::getShifts() const{
+	return shifts;
+}//end getShifts()
+
+
+void ShiftRegister::output(){
+	setDigital(dataPin, chain.front());
+}//end output()
+
+
+
+
+
+
+// Keypad
+
+Keypad::Keypad(std::vector<uint8_t> rows, std::vector<uint8_t> columns, bool diodes){
+	rowPins = rows;
+	columnPins = columns;
+	hasDiodes = diodes;
+	keys.assign(rows.size() * columns.size(), false);
+}//end constructor
+
+
+void Keypad::connect(){
+	for(size_t r = 0; r < rowPins.size(); r++){
+		watchOutput(rowPins[r], [this](int){
+			update();
+		});
+	}
+	update();
+}//end connect()
+
+
+void Keypad::press(uint8_t row, uint8_t column, bool down){
+	if(row < rowPins.size() && column < columnPins.size()){
+		keys[row * columnPins.size() + column] = down;
+		update();
+	}
+}//end press()
+
+
+void Keypad::update(){
+	size_t rows = rowPins.size();
+	size_t columns = columnPins.size();
+	std::vector<bool> rowLow(rows, false);
+	std::vector<bool> columnLow(columns, false);
+	for(size_t r = 0; r < rows; r++){
+		rowLow[r] = getPinMode(rowPins[r]) == OUTPUT && getDigitalOutput(rowPins[r]) == LOW;
+	}
+	//spread the low level through the held keys until nothing more changes, a diode only lets it go from a row to a column
+	bool spreading = true;
+	while(spreading){
+		spreading = false;
+		for(size_t r = 0; r < rows; r++){
+			for(size_t c = 0; c < columns; c++){
+				if(!keys[r * columns + c]){
+					continue;
+				}
+				if(rowLow[r] && !columnLow[c]){
+					columnLow[c] = true;
+					spreading = true;
+				}
+				if(!hasDiodes && columnLow[c] && !rowLow[r]){
+					rowLow[r] = true;
+					spreading = true;
+				}
+			}
+		}
+	}
+	for(size_t c = 0; c < columns; c++){
+		setDigital(columnPins[c], columnLow[c] ? LOW : HIGH);
+	}
+}//end update()
+
+
+
+
+
+
+// BouncySwitch
+
+BouncySwitch::BouncySwitch(uint8_t pin, unsigned long bounceMicros, uint32_t seed): random(seed){
+	switchPin = pin;
+	bounceTime = bounceMicros;
+}//end constructor
+
+
+void BouncySwitch::connect(){
+	scriptDigital(switchPin, [this](unsigned long t){
+		return levelAt(t);
+	});
+}//end connect()
+
+
+void BouncySwitch::press(unsigned long at){
+	bounce(at, HIGH);
+}//end press()
+
+
+void BouncySwitch::release(unsigned long at){
+	bounce(at, LOW);
+}//end release()
+
+
+void BouncySwitch::glitch(unsigned long at, unsigned long width){
+	int rest = levelAt(at);
+	edges.push_back(std::make_pair(at, !rest));
+	edges.push_back(std::make_pair(at + width, rest));
+}//end glitch()
+
+
+int BouncySwitch::levelAt(unsigned long t) const{
+	std::vector<std::pair<unsigned long, int> >::const_iterator after = std::upper_bound(edges.begin(), edges.end(), std::make_pair(t, 2));
+	return after == edges.begin() ? LOW : (after - 1)->second;
+}//end levelAt()
+
+
+void BouncySwitch::bounce(unsigned long at, int level){
+	std::uniform_int_distribution<unsigned long> gap(20, 400);
+	unsigned long t = at;
+	int now = level;
+	while(t - at < bounceTime){
+		edges.push_back(std::make_pair(t, now));
+		t += gap(random);
+		now = !now;
+	}
+	if(now == level){
+		edges.push_back(std::make_pair(t, level));	//the chatter ended on the wrong level, settle one gap later
+	}
+}//end bounce()
+
+
+
+
+// Electrode
+
+Electrode::Electrode(uint8_t pin, float picofarads, float pullupKOhms, uint32_t seed): random(seed){
+	electrodePin = pin;
+	capacitance = picofarads;
+	finger = 0;
+	pullup = pullupKOhms;
+	sendPin = -1;
+	resistor = 0;
+	noise = 3;
+	charging = false;
+	chargedAt = 0;
+}//end constructor
+
+
+void Electrode::connect(){
+	charging = false;
+	watchPortReads(electrodePin, [this](){
+		update();
+	});
+}//end connect()
+
+
+void Electrode::touch(float picofarads){
+	finger = picofarads;
+}//end touch()
+
+
+void Electrode::release(){
+	finger = 0;
+}//end release()
+
+
+void Electrode::setCapacitance(float picofarads){
+	capacitance = picofarads;
+}//end setCapacitance()
+
+
+float Electrode::getCapacitance() const{
+	return capacitance;
+}//end getCapacitance()
+
+
+void Electrode::setResistor(uint8_t send, float kOhms){
+	sendPin = send;
+	resistor = kOhms;
+}//end setResistor()
+
+
+void Electrode::setNoise(float nanos){
+	noise = nanos;
+}//end setNoise()
+
+
+void Electrode::update(){
+	uint8_t port = digitalPinToPort(electrodePin);
+	uint8_t mask = digitalPinToBitMask(electrodePin);
+	bool driven = (portMode[port] & mask) != 0;
+	bool high = (portOutput[port] & mask) != 0;
+	bool fed = sendPin >= 0 ? getDigitalOutput(sendPin) == HIGH : high;
+	if(driven || !fed){
+		charging = false;
+		setDigital(electrodePin, driven && high ? HIGH : LOW);
+		return;
+	}
+	if(!charging){
+		charging = true;
+		float rc = (sendPin >= 0 ? resistor : pullup) * (capacitance + finger);	//kilohms times picofarads is nanoseconds
+		float jitter = noise > 0 ? std::normal_distribution<float>(0, noise)(random) : 0;
+		float delay = 0.916 * rc + jitter;
+		chargedAt = nowNanos() + (unsigned long long)(delay > 0 ? delay : 0);
+	}
+	setDigital(electrodePin, nowNanos() >= chargedAt ? HIGH : LOW);
+}//end update()
+
+
+
+
+// TracePlayer
+
+TracePlayer::TracePlayer(const Host::Trace& trace, std::vector<uint8_t> pins): trace(trace), channelPins(pins){
+	start = 0;
+}//end constructor
+
+
+void TracePlayer::connect(){
+	start = Sim::now();
+	for(size_t i = 0; i < channelPins.size() && i < trace.getChannelCount(); i++){
+		uint8_t channel = (uint8_t)i;
+		std::function<int(unsigned long)> script = [this, channel](unsigned long t){
+			return (int)trace.valueAt(channel, t - start);
+		};
+		if(trace.getKind(channel) == Comms::FRAME_KIND_BUTTON){
+			scriptDigital(channelPins[i], script);
+		}
+		else{
+			scriptAnalog(channelPins[i], script);
+		}
+	}
+}//end connect()
+
+
+unsigned long TracePlayer::getEnd() const{
+	return trace.getRowCount() > 0 ? timeOf(trace.getIndex(trace.getRowCount() - 1)) : start;
+}//end getEnd()
+
+
+unsigned long TracePlayer::timeOf(uint32_t index) const{
+	return start + (unsigned long)index * trace.getPeriod();
+}//end timeOf()
@@ -0,0 +1,372 @@
+/**
+ * @file
+ * @section description Description
+ * Models of the chips the Expansion namespace reads, wired to the simulated board's pins so the library's scans can be checked and timed without the hardware, a switch with contact bounce, a touch electrode, and a player that feeds a recorded trace into the pins.\n
+ * Sim::reset\(\) disconnects them, call connect\(\) again after it.
+ */
+
+
+#ifndef CSF_Sim_Devices_h
+#define CSF_Sim_Devices_h
+
+#include "Arduino.h"
+#include "../CSF_Trace.h"
+#include <random>
+#include <vector>
+
+
+namespace Sim{
+
+
+	/**
+	 * A CD4051 or 74HC4067 analog multiplexer.\n
+	 * Its common pin reads the channel the select lines pick, but only once they have held still for the settle time, before that it still reads the channel selected before them. So a scan that reads too soon after switching gets the wrong channel's value, as it would on the bench.
+	 */
+	class Mux{
+		public:
+			/**
+			 * The constructor for Mux
+			 * @param common -the analog pin the common output is on
+			 * @param selects -the select pins, S0 first, 3 or 4 of them
+			 * @param settleMicros -how long the output takes to follow the select lines
+			 */
+			Mux(uint8_t common, std::vector<uint8_t> selects, unsigned long settleMicros = 5);
+
+
+			/**
+			 * Wires the model to the simulated pins
+			 */
+			void connect(void);
+
+
+			/**
+			 * Sets the voltage on one of the channels
+			 * @param channel -the channel
+			 * @param value -0 to 1023
+			 */
+			void setChannel(uint8_t channel, int value);
+
+
+			/**
+			 * Gets how many times the select lines changed since connect\(\)
+			 * @return unsigned long
+			 */
+			unsigned long getSwitches(void) const;
+		protected:
+			/**
+			 * The channel the select lines are set to now
+			 * @return uint8_t
+			 */
+			uint8_t selected(void) const;
+
+			uint8_t commonPin;
+			std::vector<uint8_t> selectPins;
+			unsigned long settle;
+			std::vector<int> channels;	///< The voltage on each channel
+			uint8_t current;	///< The channel the select lines are set to
+			uint8_t previous;	///< The channel before the last change
+			unsigned long changedAt;	///< When the select lines last changed
+			unsigned long switches;
+	};
+
+
+
+
+	/**
+	 * A chain of 74HC165 shift registers.\n
+	 * SH/LD going low copies every input into the chain, and each rising edge of CLK while SH/LD is high shifts it one place towards the board. QH of the nearest chip drives the data pin.
+	 */
+	class ShiftRegister{
+		public:
+			/**
+			 * The constructor for ShiftRegister
+			 * @param load -the pin SH/LD is on
+			 * @param clock -the pin CLK is on
+			 * @param data -the pin QH of the nearest chip drives
+			 * @param chips -how many chips are chained
+			 */
+			ShiftRegister(uint8_t load, uint8_t clock, uint8_t data, uint8_t chips = 1);
+
+
+			/**
+			 * Wires the model to the simulated pins
+			 */
+			void connect(void);
+
+
+			/**
+			 * Sets one of the parallel inputs
+			 * @param index -the input, D0 of the nearest chip is 0, D0 of the next chip is 8
+			 * @param level -HIGH or LOW
+			 */
+			void setInput(uint8_t index, int level);
+
+
+			/**
+			 * Sets every parallel input at once
+			 * @param bits -input 0 in bit 0
+			 */
+			void setInputs(uint32_t bits);
+
+
+			/**
+			 * Gets how many clock edges have shifted the chain since connect\(\)
+			 * @return unsigned long
+			 */
+			unsigned long getShifts(void) const;
+		protected:
+			/**
+			 * Drives the data pin from the end of the chain
+			 */
+			void output(void);
+
+			uint8_t loadPin;
+			uint8_t clockPin;
+			uint8_t dataPin;
+			uint8_t chipCount;
+			uint32_t inputs;	///< The parallel inputs, input 0 in bit 0
+			std::vector<int> chain;	///< What's in the registers, the next bit out first
+			int loadLevel;
+			int clockLevel;
+			unsigned long shifts;
+	};
+
+
+
+
+	/**
+	 * A grid of keys wired in rows and columns, with or without a diode on each key.\n
+	 * A column reads LOW when a row pulled low reaches it through pressed keys, so without diodes the current can go up one column, along another row and down a second column, and three keys held at the corners of a rectangle make the fourth read as pressed too, as they would on the bench.
+	 */
+	class Keypad{
+		public:
+			/**
+			 * The constructor for Keypad
+			 * @param rows -the row pins
+			 * @param columns -the column pins
+			 * @param diodes -true if every key has a diode
+			 */
+			Keypad(std::vector<uint8_t> rows, std::vector<uint8_t> columns, bool diodes = false);
+
+
+			/**
+			 * Wires the model to the simulated pins
+			 */
+			void connect(void);
+
+
+			/**
+			 * Presses or releases a key
+			 * @param row -the row
+			 * @param column -the column
+			 * @param down -true to press
+			 */
+			void press(uint8_t row, uint8_t column, bool down);
+		protected:
+			/**
+			 * Works out every column's level from the rows being driven and the keys held down
+			 */
+			void update(void);
+
+			std::vector<uint8_t> rowPins;
+			std::vector<uint8_t> columnPins;
+			bool hasDiodes;
+			std::vector<bool> keys;	///< Row by row, true when held down
+	};
+
+
+
+
+	/**
+	 * A mechanical switch with contact bounce, pulling its pin HIGH while pressed.\n
+	 * Each press and release chatters between the two levels before it settles, the contacts opening and closing a random 20 to 400 microseconds apart until the bounce time is used up. The same seed gives the same chatter every run. A glitch is a single spike with the switch at rest, as from noise picked up on a long wire.
+	 */
+	class BouncySwitch{
+		public:
+			/**
+			 * The constructor for BouncySwitch
+			 * @param pin -the Arduino pin the switch drives
+			 * @param bounceMicros -the longest a press or release chatters for
+			 * @param seed -seeds the chatter
+			 */
+			BouncySwitch(uint8_t pin, unsigned long bounceMicros = 3000, uint32_t seed = 1);
+
+
+			/**
+			 * Scripts the pin to follow the switch
+			 */
+			void connect(void);
+
+
+			/**
+			 * Presses the switch at a moment to come
+			 * @param at -the simulated time, micros\(\), later than any press or release already scheduled
+			 */
+			void press(unsigned long at);
+
+
+			/**
+			 * Releases the switch at a moment to come
+			 * @param at -the simulated time, micros\(\), later than any press or release already scheduled
+			 */
+			void release(unsigned long at);
+
+
+			/**
+			 * Puts a spike on the line with the switch at rest
+			 * @param at -the simulated time, micros\(\), later than any press or release already scheduled
+			 * @param width -how long the spike lasts, microseconds
+			 */
+			void glitch(unsigned long at, unsigned long width);
+
+
+			/**
+			 * Gets the level on the pin at a moment
+			 * @param t -the simulated time, micros\(\)
+			 * @return int -HIGH or LOW
+			 */
+			int levelAt(unsigned long t) const;
+		protected:
+			/**
+			 * Schedules the chatter of one press or release
+			 * @param at -when it starts
+			 * @param level -the level it settles at
+			 */
+			void bounce(unsigned long at, int level);
+
+			uint8_t switchPin;
+			unsigned long bounceTime;
+			std::mt19937 random;
+			std::vector<std::pair<unsigned long, int> > edges;	///< Every change of level and when, in time order
+	};
+
+
+
+
+	/**
+	 * A bare touch electrode on a pin, for Expansion::CapSense to measure.\n
+	 * While the pin is an input with its pull-up on, or with setResistor\(\) while the send pin is HIGH, the electrode charges through that resistance and the pin reads HIGH once it passes the input threshold, 0.92 RC after the charging started \(the AVR's 0.6 VCC\). Driving the pin discharges it at once. A finger adds to the capacitance, and setCapacitance\(\) lets the electrode drift the way it does with temperature and humidity. Each charge is off by a random few nanoseconds of noise, the same seed gives the same noise every run.\n
+	 * It watches the port through Sim::watchPortReads\(\), so it only works with code that reads the port with CSF_PORT_READ.
+	 */
+	class Electrode{
+		public:
+			/**
+			 * The constructor for Electrode
+			 * @param pin -the Arduino pin the electrode is on
+			 * @param picofarads -the electrode and its wiring on their own
+			 * @param pullupKOhms -the pin's pull-up, 20 to 50 on an AVR
+			 * @param seed -seeds the noise
+			 */
+			Electrode(uint8_t pin, float picofarads = 20, float pullupKOhms = 35, uint32_t seed = 1);
+
+
+			/**
+			 * Starts following the pin
+			 */
+			void connect(void);
+
+
+			/**
+			 * Puts a finger on the electrode
+			 * @param picofarads -how much the finger adds
+			 */
+			void touch(float picofarads = 20);
+
+
+			/**
+			 * Takes the finger off
+			 */
+			void release(void);
+
+
+			/**
+			 * Changes the electrode's own capacitance, e.g. a little at a time for drift
+			 * @param picofarads -the electrode and its wiring on their own
+			 */
+			void setCapacitance(float picofarads);
+
+
+			/**
+			 * Getter for the electrode's own capacitance
+			 * @return float -picofarads
+			 */
+			float getCapacitance(void) const;
+
+
+			/**
+			 * Charges the electrode from a send pin through a resistor instead of the pull-up
+			 * @param send -the Arduino pin the resistor goes to
+			 * @param kOhms -the resistor, 1000 for 1 megohm
+			 */
+			void setResistor(uint8_t send, float kOhms);
+
+
+			/**
+			 * Sets how much each charge time varies
+			 * @param nanos -the standard deviation, nanoseconds, 0 for none
+			 */
+			void setNoise(float nanos);
+		protected:
+			/**
+			 * Brings the pin up to date, called on every read of its port
+			 */
+			void update(void);
+
+			uint8_t electrodePin;
+			float capacitance;	///< picofarads
+			float finger;	///< picofarads, 0 while not touched
+			float pullup;	///< kilohms
+			int sendPin;	///< The pin the resistor goes to, or -1 for the pull-up
+			float resistor;	///< kilohms
+			float noise;	///< nanoseconds
+			bool charging;
+			unsigned long long chargedAt;	///< Sim::nowNanos\(\) when this charge passes the threshold
+			std::mt19937 random;
+	};
+
+
+
+
+	/**
+	 * Plays a Host::Trace into the simulated pins, so a capture from the field drives the library exactly as the real controls did.\n
+	 * Each sensor channel becomes a scripted analog input and each button channel a scripted digital one. Sample 0 of the trace lands at the moment connect\(\) is called and the values follow the simulated clock from there, held between samples.
+	 */
+	class TracePlayer{
+		public:
+			/**
+			 * The constructor for TracePlayer
+			 * @param trace -the trace, it has to outlive the player
+			 * @param pins -the pin for each channel of the trace, in channel order
+			 */
+			TracePlayer(const Host::Trace& trace, std::vector<uint8_t> pins);
+
+
+			/**
+			 * Scripts the pins, starting the trace at the current simulated time
+			 */
+			void connect(void);
+
+
+			/**
+			 * Gets the simulated time the last row of the trace is due
+			 * @return unsigned long -micros\(\)
+			 */
+			unsigned long getEnd(void) const;
+
+
+			/**
+			 * Gets the simulated time a sample is due
+			 * @param index -the sample number
+			 * @return unsigned long -micros\(\)
+			 */
+			unsigned long timeOf(uint32_t index) const;
+		protected:
+			const Host::Trace& trace;
+			std::vector<uint8_t> channelPins;
+			unsigned long start;	///< The simulated time of sample 0
+	};
+
+
+}
+
+#endif
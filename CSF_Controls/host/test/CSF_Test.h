@@ -0,0 +1,80 @@
+/**
+ * @file
+ * @section description Description
+ * The few lines the host tests share: CSF_CHECK\(\) to check a condition and Test::finish\(\) to report at the end of main\(\).\n
+ * Each test is a program of its own, built and run by ctest from CMakeLists.txt, against the simulated board in host/sim. A failed check prints where it was and carries on, so one run shows every failure, and the program exits with 1 if there were any.
+ */
+
+
+#ifndef CSF_Test_h
+#define CSF_Test_h
+
+#include <stdio.h>
+
+
+/**
+ * Checks a condition, printing the file, line and the condition itself if it doesn't hold
+ */
+#define CSF_CHECK(condition) Test::check((condition), #condition, __FILE__, __LINE__)
+
+
+/**
+ * Checks two whole numbers are equal, printing both if they aren't
+ */
+#define CSF_CHECK_EQUAL(actual, expected) Test::checkEqual((long long)(actual), (long long)(expected), #actual, __FILE__, __LINE__)
+
+
+namespace Test{
+	static int checks = 0;	///< How many checks have run
+	static int failures = 0;	///< How many of them failed
+
+
+	/**
+	 * Counts a check and prints it if it failed
+	 * @param passed -the condition
+	 * @param text -the condition as written
+	 * @param file -where it is
+	 * @param line -where it is
+	 * @return bool -passed
+	 */
+	inline bool check(bool passed, const char* text, const char* file, int line){
+		checks++;
+		if(!passed){
+			failures++;
+			printf("%s:%d: failed: %s\n", file, line, text);
+		}
+		return passed;
+	}//end check()
+
+
+	/**
+	 * Counts a check of two numbers and prints both if they differ
+	 * @param actual -what the code gave
+	 * @param expected -what it should have
+	 * @param text -the expression for actual as written
+	 * @param file -where it is
+	 * @param line -where it is
+	 * @return bool -true if they're equal
+	 */
+	inline bool checkEqual(long long actual, long long expected, const char* text, const char* file, int line){
+		checks++;
+		if(actual != expected){
+			failures++;
+			printf("%s:%d: failed: %s is %lld, expected %lld\n", file, line, text, actual, expected);
+		}
+		return actual == expected;
+	}//end checkEqual()
+
+
+	/**
+	 * Prints the totals, return it from main\(\)
+	 * @param name -the test
+	 * @return int -0 if every check passed, 1 if not
+	 */
+	inline int finish(const char* name){
+		printf("%s: %d checks, %d failed\n", name, checks, failures);
+		return failures == 0 ? 0 : 1;
+	}//end finish()
+}
+
+#endif
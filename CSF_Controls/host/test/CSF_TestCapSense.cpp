@@ -0,0 +1,121 @@
+/**
+ * @file
+ * @section description Description
+ * Checks Expansion::CapSense on two simulated Sim::Electrode on one port, charged from a send pin through 1 megohm: a touch on one has to show on the next scan and only on that one, and let go just as soon, while the baselines follow slow drift up and down without a false touch, hold still under a long touch, and can be taken again with recalibrate\(\).
+ */
+
+
+#include "CSF_Test.h"
+#include <Arduino.h>
+#include <CSF_Controls.h>
+#include <SimDevices.h>
+
+using namespace Expansion;
+
+
+
+
+namespace{
+	int falses = 0;	///< Scans that read an electrode touched that wasn't
+
+
+	/**
+	 * Scans a number of times, counting every read of a touch that isn't there
+	 * @param caps -the CapSense
+	 * @param scans -how many
+	 * @param touching -the electrode being touched, or -1
+	 * @param drifting -an electrode to move a little each scan, or NULL
+	 * @param step -picofarads to move it each scan
+	 */
+	void run(CapSense& caps, int scans, int touching, Sim::Electrode* drifting = NULL, float step = 0){
+		for(int i = 0; i < scans; i++){
+			if(drifting != NULL){
+				drifting->setCapacitance(drifting->getCapacitance() + step);
+			}
+			caps.scan();
+			for(uint8_t e = 0; e < caps.getPinCount(); e++){
+				if(caps.read(e) == HIGH && e != touching){
+					falses++;
+				}
+			}
+			Sim::advanceMillis(10);
+		}
+	}//end run()
+}
+
+
+
+
+int main(){
+	Sim::reset();
+	VirtualPins::detachAll();
+	Sim::Electrode first(8, 18, 35, 3);
+	Sim::Electrode second(9, 22, 35, 4);
+	first.setResistor(4, 1000);
+	second.setResistor(4, 1000);
+	first.setNoise(100);
+	second.setNoise(100);
+	first.connect();
+	second.connect();
+	CapSense caps(4);
+	CSF_CHECK_EQUAL(caps.add(8), 0);
+	CSF_CHECK_EQUAL(caps.add(9), 1);
+	caps.begin();
+	CSF_CHECK_EQUAL(caps.getPinCount(), 2);
+	CSF_CHECK(caps.getBaseline(0) > 0);
+	CSF_CHECK(caps.getBaseline(1) > caps.getBaseline(0));	//the bigger electrode takes longer to charge
+	CSF_CHECK_EQUAL(caps.getTimeouts(), 0);
+
+	//untouched, nothing reads touched
+	run(caps, 50, -1);
+	CSF_CHECK_EQUAL(falses, 0);
+	CSF_CHECK(caps.readAnalog(0) < 20);
+
+	//a touch shows on the next scan, on that electrode only, and lets go as soon
+	first.touch(5);
+	run(caps, 1, 0);
+	CSF_CHECK_EQUAL(caps.read(0), HIGH);
+	CSF_CHECK(caps.readAnalog(0) > caps.readAnalog(1));
+	run(caps, 5, 0);
+	first.release();
+	run(caps, 1, -1);
+	CSF_CHECK_EQUAL(caps.read(0), LOW);
+	second.touch(5);
+	run(caps, 3, 1);
+	CSF_CHECK_EQUAL(caps.read(1), HIGH);
+	second.release();
+	run(caps, 1, -1);
+	CSF_CHECK_EQUAL(falses, 0);
+
+	//the baseline follows drift up and back down without a touch, and a touch still shows after
+	uint16_t before = caps.getBaseline(0);
+	run(caps, 2000, -1, &first, 10.0 / 2000);
+	CSF_CHECK(caps.getBaseline(0) > before + before / 4);
+	run(caps, 500, -1, &first, -10.0 / 500);
+	CSF_CHECK(caps.getBaseline(0) < before + before / 20);
+	CSF_CHECK_EQUAL(falses, 0);
+	first.touch(5);
+	run(caps, 2, 0);
+	CSF_CHECK_EQUAL(caps.read(0), HIGH);
+
+	//a long touch doesn't become the baseline
+	run(caps, 300, 0);
+	CSF_CHECK_EQUAL(caps.read(0), HIGH);
+	first.release();
+	run(caps, 1, -1);
+	CSF_CHECK_EQUAL(caps.read(0), LOW);
+
+	//recalibrate() takes a finger left on as the baseline, and the next touch is read from there
+	first.touch(5);
+	run(caps, 1, 0);
+	caps.recalibrate();
+	CSF_CHECK_EQUAL(caps.read(0), LOW);
+	run(caps, 5, -1);
+	first.touch(10);
+	run(caps, 1, 0);
+	CSF_CHECK_EQUAL(caps.read(0), HIGH);
+	CSF_CHECK_EQUAL(falses, 0);
+	CSF_CHECK_EQUAL(caps.getTimeouts(), 0);
+
+	return Test::finish("cap sense");
+}
@@ -0,0 +1,148 @@
+/**
+ * @file
+ * @section description Description
+ * Checks that Host::Client can be used again after the board hangs up: frames from the simulated board go in through a pipe, the write end is closed so the reader thread ends on its own, and attaching a second pipe, or opening a pseudo-terminal again after its master side closes, has to start a new reader rather than abort, without leaking the port the Client opened.
+ */
+
+
+#include "CSF_Test.h"
+#include <Arduino.h>
+#include <CSF_Controls.h>
+#include "../CSF_Client.h"
+#include <dirent.h>
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+#include <chrono>
+#include <thread>
+
+using namespace Switches;
+using namespace Comms;
+
+
+
+
+namespace{
+	int boardOut = -1;	///< Where the simulated board's serial output goes
+
+
+	/**
+	 * Waits up to a second for something to come true
+	 * @param done -checked every millisecond
+	 * @return bool -whether it did
+	 */
+	template<class Condition> bool waitFor(Condition done){
+		for(int i = 0; i < 1000 && !done(); i++){
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return done();
+	}//end waitFor()
+
+
+	/**
+	 * Counts the file descriptors this process has open
+	 * @return int
+	 */
+	int openDescriptors(){
+		int count = 0;
+		DIR* dir = opendir("/proc/self/fd");
+		while(dir != NULL && readdir(dir) != NULL){
+			count++;
+		}
+		if(dir != NULL){
+			closedir(dir);
+		}
+		return count;
+	}//end openDescriptors()
+
+
+	/**
+	 * Whether the Client has decoded the last frame the board sent
+	 * @param client -the client
+	 * @param streamer -the board's streamer
+	 * @return bool
+	 */
+	bool caughtUp(const Host::Client& client, FrameStreamer& streamer){
+		Host::Snapshot snapshot;
+		return client.snapshot(snapshot) && (uint16_t)(snapshot.sequence + 1) == streamer.getSequence();
+	}//end caughtUp()
+
+
+	/**
+	 * Sends a number of frames from the board to boardOut
+	 * @param streamer -the board's streamer
+	 * @param frames -how many
+	 */
+	void sendFrames(FrameStreamer& streamer, int frames){
+		for(int i = 0; i < frames; i++){
+			Sim::advanceMillis(10);
+			streamer.update();
+		}
+	}//end sendFrames()
+}
+
+
+
+
+int main(){
+	Sim::reset();
+	Sim::setSerialSink([](const uint8_t* data, size_t len){
+		if(boardOut >= 0 && write(boardOut, data, len) < 0){
+			boardOut = -1;
+		}
+	});
+	Momentary button(8);
+	button.begin();
+	FrameStreamer streamer(10);
+	CSF_CHECK(streamer.add(button));
+	streamer.begin();
+
+	//a pipe the board hangs up
+	Host::Client client;
+	int first[2];
+	CSF_CHECK_EQUAL(pipe(first), 0);
+	CSF_CHECK(client.attach(first[0]));
+	CSF_CHECK(!client.attach(first[0]));	//already running
+	boardOut = first[1];
+	sendFrames(streamer, 3);
+	CSF_CHECK(waitFor([&](){ return caughtUp(client, streamer); }));
+	close(first[1]);
+	CSF_CHECK(waitFor([&](){ return !client.isRunning(); }));
+
+	//attached again, the old reader is joined and a new one reads
+	int second[2];
+	CSF_CHECK_EQUAL(pipe(second), 0);
+	CSF_CHECK(client.attach(second[0]));
+	CSF_CHECK(client.isRunning());
+	boardOut = second[1];
+	sendFrames(streamer, 3);
+	CSF_CHECK(waitFor([&](){ return caughtUp(client, streamer); }));
+	CSF_CHECK_EQUAL(client.getFrames(), 3);	//counted from the attach
+	client.stop();
+	close(first[0]);
+	close(second[0]);
+	close(second[1]);
+
+	//opened again after a pseudo-terminal hangs up, and the one it opened closed
+	int descriptors = openDescriptors();
+	struct termios raw;
+	cfmakeraw(&raw);
+	for(int i = 0; i < 3; i++){
+		int master;
+		int slave;
+		char name[128];
+		CSF_CHECK_EQUAL(openpty(&master, &slave, name, &raw, NULL), 0);
+		close(slave);
+		CSF_CHECK(client.open(name));
+		boardOut = master;
+		sendFrames(streamer, 2);
+		CSF_CHECK(waitFor([&](){ return caughtUp(client, streamer); }));
+		boardOut = -1;
+		close(master);
+		CSF_CHECK(waitFor([&](){ return !client.isRunning(); }));
+	}
+	client.stop();
+	CSF_CHECK_EQUAL(openDescriptors(), descriptors);
+
+	return Test::finish("client");
+}
@@ -0,0 +1,125 @@
+/**
+ * @file
+ * @section description Description
+ * Checks Comms::CommandParser answering lines the simulated PC sends: bound names, get by name or number, map with ints and floats, rate, list and commands added with on\(\) each answer their own line, and every other line, an empty one, one of only spaces or one past CSF_COMMAND_LENGTH included, gets exactly one ? line back. Half a line is kept until its newline comes in.
+ */
+
+
+#include "CSF_Test.h"
+#include <Arduino.h>
+#include <CSF_Controls.h>
+#include <string>
+
+using namespace Sensors;
+using namespace Switches;
+using namespace Comms;
+
+
+
+
+namespace{
+	int echoed = -1;	///< The argc the echo command last got
+
+
+	/**
+	 * A command for on\(\), answers with its first word
+	 * @param argc -how many words follow the command
+	 * @param argv -the words
+	 */
+	void echo(uint8_t argc, char** argv){
+		echoed = argc;
+		Serial.println(argc > 0 ? argv[0] : "-");
+	}//end echo()
+
+
+	/**
+	 * Sends a line from the PC and runs the parser over it
+	 * @param parser -the parser
+	 * @param text -what the PC sends, newline and all
+	 * @return std::string -what the board answered
+	 */
+	std::string send(CommandParser& parser, const char* text){
+		Sim::clearSerialOutput();
+		Sim::serialInput(text);
+		parser.update();
+		return Sim::serialOutput();
+	}//end send()
+}
+
+
+
+
+int main(){
+	Sim::reset();
+	Pot slide(2, 3, A0);
+	Momentary button(4);
+	slide.begin();
+	button.begin();
+	slide.toggleIsSensorOn();
+	Sim::setAnalog(A0, 1023);
+	Sim::setDigital(4, HIGH);
+	CommandParser parser;
+	CSF_CHECK(parser.bind("Slide", slide));
+	CSF_CHECK(parser.bind("Go", button));
+	CSF_CHECK(parser.on("echo", echo));
+
+	//bound names, by name or number
+	CSF_CHECK(send(parser, "Slide\n") == "1023\r\n");
+	CSF_CHECK(send(parser, "get Slide\r\n") == "1023\r\n");
+	CSF_CHECK(send(parser, "get 1\n") == "1\r\n");
+	CSF_CHECK(send(parser, "list\n") == "Slide Go\r\n");
+	CSF_CHECK_EQUAL(parser.getErrors(), 0);
+
+	//map takes ints or floats, then sends the reading in the new range
+	CSF_CHECK(send(parser, "map Slide -20 20\n") == "20\r\n");
+	CSF_CHECK(send(parser, "map 0 0 1.5\n") == "1.50\r\n");
+	CSF_CHECK(send(parser, "map 0 0 1023\n") == "1023\r\n");
+	CSF_CHECK(send(parser, "map Go 0 10\n") == "? map\r\n");
+	CSF_CHECK(send(parser, "map Slide 0 x\n") == "? map\r\n");
+	CSF_CHECK_EQUAL(parser.getErrors(), 2);
+
+	//rate needs a streamer
+	CSF_CHECK(send(parser, "rate 50\n") == "? rate\r\n");
+	FrameStreamer streamer(10);
+	CSF_CHECK(streamer.add(slide));
+	parser.attach(streamer);
+	CSF_CHECK(send(parser, "rate 50\n") == "ok\r\n");
+	CSF_CHECK(send(parser, "rate 0\n") == "? rate\r\n");
+
+	//commands added with on() get their words
+	CSF_CHECK(send(parser, "echo  hello there\n") == "hello\r\n");
+	CSF_CHECK_EQUAL(echoed, 2);
+	CSF_CHECK(send(parser, "echo\n") == "-\r\n");
+	CSF_CHECK_EQUAL(echoed, 0);
+
+	//everything else gets exactly one line back
+	unsigned int errors = parser.getErrors();
+	CSF_CHECK(send(parser, "nope 1 2\n") == "? nope\r\n");
+	CSF_CHECK(send(parser, "Slide 1\n") == "? Slide\r\n");
+	CSF_CHECK(send(parser, "get 9\n") == "? get\r\n");
+	CSF_CHECK(send(parser, "\n") == "? \r\n");
+	CSF_CHECK(send(parser, "   \t \r\n") == "? \r\n");
+	std::string longLine = "toolong" + std::string(CSF_COMMAND_LENGTH, 'x') + " 1\n";
+	CSF_CHECK(send(parser, longLine.c_str()) == "? toolong" + std::string(CSF_COMMAND_LENGTH - 7, 'x') + "\r\n");
+	CSF_CHECK(send(parser, "Slide\n") == "1023\r\n");	//and the next line is read as usual
+	CSF_CHECK_EQUAL(parser.getErrors(), errors + 6);
+
+	//half a line waits for the rest
+	CSF_CHECK(send(parser, "get Sl") == "");
+	CSF_CHECK(send(parser, "ide\n") == "1023\r\n");
+	Sim::clearSerialOutput();
+	CSF_CHECK(!parser.push('l'));
+	CSF_CHECK(!parser.push('i'));
+	CSF_CHECK(!parser.push('s'));
+	CSF_CHECK(!parser.push('t'));
+	CSF_CHECK(parser.push('\n'));
+	CSF_CHECK(Sim::serialOutput() == "Slide Go\r\n");
+
+	//there are only so many names
+	for(int i = 3; i < CSF_COMMAND_BINDINGS; i++){
+		CSF_CHECK(parser.on("echo", echo));
+	}
+	CSF_CHECK(!parser.bind("More", slide));
+
+	return Test::finish("command parser");
+}
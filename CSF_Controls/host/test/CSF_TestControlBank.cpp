@@ -0,0 +1,98 @@
+/**
+ * @file
+ * @section description Description
+ * Checks Sensors::ControlBank's whole number mapping against a long double reference over all 1024 ADC codes, and against a Pot on the same pin.\n
+ * The bank rounds its slope to 1/65536, so a code may land one step from the reference, but 0 and 1023 have to map to the ends exactly, for spans well past the 32767 the products used to overflow at. A low end that doesn't fit the bank's 16 bits is clamped rather than wrapped.
+ */
+
+
+#include "CSF_Test.h"
+#include <Arduino.h>
+#include <CSF_Controls.h>
+#include <math.h>
+
+using namespace Sensors;
+
+
+
+
+namespace{
+	/**
+	 * Exactly where a reading falls on the line, rounded to nearest
+	 * @param outMin -what 0 maps to
+	 * @param outMax -what 1023 maps to
+	 * @param reading -the reading
+	 * @return long
+	 */
+	long reference(long outMin, long outMax, long reading){
+		return (long)floorl(outMin + reading * ((long double)outMax - outMin) / 1023 + 0.5L);
+	}//end reference()
+
+
+	/**
+	 * Counts the codes a bank control maps more than a step from the reference, or not exactly at the ends
+	 * @param bank -the bank
+	 * @param i -the control's number
+	 * @param outMin -what 0 maps to
+	 * @param outMax -what 1023 maps to
+	 * @return long
+	 */
+	template<uint16_t N> long mismatches(ControlBank<N>& bank, uint8_t i, int outMin, int outMax){
+		bank.mapData(i, outMin, outMax);
+		long wrong = 0;
+		for(long reading = 0; reading <= 1023; reading++){
+			long error = labs(bank.toInt(i, reading) - reference(outMin, outMax, reading));
+			if(error > 1 || ((reading == 0 || reading == 1023) && error != 0)){
+				wrong++;
+			}
+		}
+		return wrong;
+	}//end mismatches()
+}
+
+
+
+
+int main(){
+	Sim::reset();
+	ControlBank<4> bank;
+	CSF_CHECK_EQUAL(bank.add(2, 3, A0), 0);
+	CSF_CHECK_EQUAL(bank.add(4, 5, A1), 1);
+	bank.begin();
+
+	//from a few steps to far past 16 bits, either way round
+	CSF_CHECK_EQUAL(mismatches(bank, 0, 0, 100), 0);
+	CSF_CHECK_EQUAL(mismatches(bank, 0, 100, -100), 0);
+	CSF_CHECK_EQUAL(mismatches(bank, 0, -3, 3), 0);
+	CSF_CHECK_EQUAL(mismatches(bank, 0, 0, 32767), 0);
+	CSF_CHECK_EQUAL(mismatches(bank, 0, -20000, 20000), 0);
+	CSF_CHECK_EQUAL(mismatches(bank, 0, -32768, 32767), 0);
+	CSF_CHECK_EQUAL(mismatches(bank, 0, 32767, -32768), 0);
+	CSF_CHECK_EQUAL(mismatches(bank, 0, 0, 1000000), 0);
+	CSF_CHECK_EQUAL(mismatches(bank, 0, 30000, -30000000), 0);
+
+	//the same as a Pot on the same pin at full scale
+	Pot pot(6, 7, A1);
+	pot.begin();
+	bank.toggleIsSensorOn(1);
+	Sim::setAnalog(A1, 1023);
+	CSF_CHECK_EQUAL(bank.mapData(1, -20000, 20000), 20000);
+	CSF_CHECK_EQUAL(pot.mapData(-20000, 20000), 20000);
+	Sim::setAnalog(A1, 0);
+	CSF_CHECK_EQUAL(bank.mapData(1, -20000, 20000), -20000);
+	Sim::setAnalog(A1, 512);
+	CSF_CHECK(labs(bank.mapData(1, -20000, 20000) - pot.mapData(-20000, 20000)) <= 1);
+
+	//a low end past 16 bits is clamped, a span past the slope's 32 bits too
+	bank.mapData(0, 100000, 200000);
+	CSF_CHECK_EQUAL(bank.toInt(0, 0), 32767);
+	CSF_CHECK_EQUAL(bank.toInt(0, 1023), 200000);
+	bank.mapData(0, -100000, 0);
+	CSF_CHECK_EQUAL(bank.toInt(0, 0), -32768);
+	CSF_CHECK_EQUAL(bank.toInt(0, 1023), 0);
+	bank.mapData(0, 0, 2000000000);
+	CSF_CHECK(bank.toInt(0, 1023) > 0);
+	CSF_CHECK(bank.toInt(0, 1023) <= 2000000000);
+
+	return Test::finish("control bank");
+}
@@ -0,0 +1,195 @@
+/**
+ * @file
+ * @section description Description
+ * Checks Utility::Debouncer through a Momentary on a simulated switch with 3 milliseconds of contact bounce: every press, click, double click and long press played has to come out once, with no extra presses for the spikes of noise on the line once it has a confirm time, it has to see a press on the first read without one, and the lockout a Momentary is made with has to keep presses apart without holding back a release. Reporting by exception, and anything holding it as a plain Button, has to get the debounced state too, so one bouncing press and release sends two lines.
+ */
+
+
+#include "CSF_Test.h"
+#include <Arduino.h>
+#include <CSF_Controls.h>
+#include <SimDevices.h>
+
+using namespace Switches;
+
+
+
+
+namespace{
+	/**
+	 * Reads a button every 100 microseconds up to a moment, counting its events
+	 * @param button -the button
+	 * @param until -the simulated time to stop at, micros\(\)
+	 * @param seen -a count for each of the 8 event bits, added to
+	 */
+	void play(Momentary& button, unsigned long until, int* seen){
+		while(Sim::now() < until){
+			button.getState();
+			uint8_t events = button.getEvents();
+			for(int bit = 0; bit < 8; bit++){
+				if(events & (1 << bit)){
+					seen[bit]++;
+				}
+			}
+			Sim::advanceMicros(100);
+		}
+	}//end play()
+
+
+	/**
+	 * Gets the index into play\(\)'s counts for an event
+	 * @param event -one Utility::Debouncer event bit
+	 * @return int
+	 */
+	int bitOf(uint8_t event){
+		int bit = 0;
+		while(!(event & (1 << bit))){
+			bit++;
+		}
+		return bit;
+	}//end bitOf()
+
+
+	/**
+	 * Reads a button as a plain Button every 100 microseconds up to a moment, reporting it on change
+	 * @param button -the button
+	 * @param until -the simulated time to stop at, micros\(\)
+	 * @param states -how often each state was read, added to
+	 */
+	void report(Button& button, unsigned long until, int* states){
+		while(Sim::now() < until){
+			button.toSerialOnChange();
+			states[button.getState() ? 1 : 0]++;
+			Sim::advanceMicros(100);
+		}
+	}//end report()
+}
+
+
+
+
+int main(){
+	//every gesture comes out once, and with a confirm time the spikes of noise don't
+	Sim::reset();
+	Sim::BouncySwitch contact(2, 3000, 11);
+	Momentary button(2);
+	button.getDebouncer().setConfirm(2);
+	button.begin();
+	int presses = 0;
+	int clicks = 0;
+	int doubles = 0;
+	int longs = 0;
+	unsigned long t = 100000;
+	for(int i = 0; i < 40; i++){
+		int gesture = i % 4;
+		contact.glitch(t, 150 + 50 * (i % 3));
+		t += 300000;
+		if(gesture == 1){
+			contact.press(t);
+			contact.release(t + 80000);
+			contact.press(t + 200000);
+			contact.release(t + 280000);
+			presses += 2;
+			clicks += 2;
+			doubles++;
+			t += 280000;
+		}
+		else if(gesture == 2){
+			contact.press(t);
+			contact.release(t + 1200000);
+			presses++;
+			longs++;
+			t += 1200000;
+		}
+		else if(gesture == 3){
+			contact.glitch(t, 900);	//another right after, still under the confirm time
+			t += 1000;
+		}
+		else{
+			contact.press(t);
+			contact.release(t + 120000);
+			presses++;
+			clicks++;
+			t += 120000;
+		}
+		t += 600000;
+	}
+	contact.connect();
+	int seen[8] = {0};
+	play(button, t, seen);
+	CSF_CHECK_EQUAL(seen[bitOf(Utility::Debouncer::PRESSED)], presses);
+	CSF_CHECK_EQUAL(seen[bitOf(Utility::Debouncer::RELEASED)], presses);
+	CSF_CHECK_EQUAL(seen[bitOf(Utility::Debouncer::CLICKED)], clicks);
+	CSF_CHECK_EQUAL(seen[bitOf(Utility::Debouncer::DOUBLE_CLICKED)], doubles);
+	CSF_CHECK_EQUAL(seen[bitOf(Utility::Debouncer::LONG_PRESSED)], longs);
+	CSF_CHECK(seen[bitOf(Utility::Debouncer::BOUNCED)] > 0);
+	CSF_CHECK_EQUAL(button.getState(), LOW);
+
+	//without one, as by default, a spike that's read is taken as a press, and so is a press on the first read
+	Sim::reset();
+	Sim::BouncySwitch noisy(2, 3000, 11);
+	Momentary unfiltered(2);
+	unfiltered.begin();
+	noisy.glitch(100000, 300);
+	noisy.connect();
+	int spikes[8] = {0};
+	play(unfiltered, 200000, spikes);
+	CSF_CHECK_EQUAL(spikes[bitOf(Utility::Debouncer::PRESSED)], 1);
+	Momentary plain(3);
+	plain.begin();
+	Sim::setDigital(3, HIGH);
+	CSF_CHECK_EQUAL(plain.getState(), HIGH);
+
+	//the lockout keeps presses apart and doesn't hold back the release
+	Sim::reset();
+	Sim::BouncySwitch tap(2, 3000, 5);
+	Momentary slow(2, 500);
+	slow.begin();
+	tap.press(100000);
+	tap.release(130000);
+	tap.press(300000);	//inside the lockout, let go before it's over
+	tap.release(330000);
+	tap.press(400000);	//inside the lockout, still held once it's over
+	tap.release(900000);
+	tap.connect();
+	int taps[8] = {0};
+	play(slow, 100000 + 10000, taps);
+	CSF_CHECK_EQUAL(slow.getState(), HIGH);
+	play(slow, 130000 + 10000, taps);
+	CSF_CHECK_EQUAL(slow.getState(), LOW);	//released with the tap, not 500 milliseconds after it
+	CSF_CHECK_EQUAL(taps[bitOf(Utility::Debouncer::CLICKED)], 1);
+	play(slow, 330000 + 10000, taps);
+	CSF_CHECK_EQUAL(taps[bitOf(Utility::Debouncer::PRESSED)], 1);
+	play(slow, 590000, taps);
+	CSF_CHECK_EQUAL(slow.getState(), LOW);
+	play(slow, 610000, taps);
+	CSF_CHECK_EQUAL(slow.getState(), HIGH);
+	CSF_CHECK_EQUAL(taps[bitOf(Utility::Debouncer::PRESSED)], 2);
+	play(slow, 1000000, taps);
+	CSF_CHECK_EQUAL(taps[bitOf(Utility::Debouncer::RELEASED)], 2);
+
+	//reported by exception, the bounce doesn't go out as changes
+	Sim::reset();
+	int lines = 0;
+	Sim::setSerialSink([&](const uint8_t* data, size_t len){
+		for(size_t i = 0; i < len; i++){
+			lines += data[i] == '\n' ? 1 : 0;
+		}
+	});
+	Sim::BouncySwitch chatter(2, 3000, 7);
+	Momentary reported(2);
+	reported.begin();
+	reported.setReportByException(0);
+	chatter.press(100000);
+	chatter.release(300000);
+	chatter.connect();
+	int states[2] = {0};
+	report(reported, 90000, states);
+	lines = 0;
+	report(reported, 500000, states);
+	CSF_CHECK_EQUAL(lines, 2);
+	CSF_CHECK_EQUAL(states[1], 2000);	//high from the first edge to the release, with no reads of the bounce in between
+	Sim::setSerialSink(nullptr);
+
+	return Test::finish("debouncer");
+}
@@ -0,0 +1,107 @@
+/**
+ * @file
+ * @section description Description
+ * Checks Switches::EventCapture by injecting edges on the simulated pins, which fire the interrupts it attached as a real board would: every edge has to come out of drain\(\) once, in order, with its pin, level and time, and once the queue is full the rest have to be counted as overflows rather than overwrite it.
+ */
+
+
+#include "CSF_Test.h"
+#include <Arduino.h>
+#include <CSF_Controls.h>
+
+using namespace Switches;
+
+
+
+
+namespace{
+	/**
+	 * Toggles a pin a number of times, a fixed time apart
+	 * @param pin -the pin
+	 * @param edges -how many times to toggle it
+	 * @param apart -microseconds between edges
+	 */
+	void toggle(uint8_t pin, int edges, unsigned long apart){
+		for(int i = 0; i < edges; i++){
+			Sim::advanceMicros(apart);
+			Sim::setDigital(pin, digitalRead(pin) == HIGH ? LOW : HIGH);
+		}
+	}//end toggle()
+}
+
+
+
+
+int main(){
+	Sim::reset();
+	EventCapture::detachAll();
+
+	//one slot for each of CSF_EVENT_PINS pins, and only real pins
+	for(uint8_t slot = 0; slot < CSF_EVENT_PINS; slot++){
+		CSF_CHECK(EventCapture::attach(2 + slot));
+	}
+	CSF_CHECK(!EventCapture::attach(2 + CSF_EVENT_PINS));
+	EventCapture::detachAll();
+	CSF_CHECK(!EventCapture::attach(CSF_VIRTUAL_PIN_BASE));
+	Button button(3);
+	button.begin();
+	CSF_CHECK(EventCapture::attach(2));
+	CSF_CHECK(EventCapture::attach(button));
+
+	//every edge comes out once, oldest first, stamped when it happened
+	unsigned long start = micros();
+	toggle(2, 5, 100);
+	toggle(9, 3, 100);	//not attached
+	CSF_CHECK_EQUAL(EventCapture::available(), 5);
+	EdgeEvent events[CSF_EVENT_QUEUE];
+	CSF_CHECK_EQUAL(EventCapture::drain(events, 2), 2);
+	CSF_CHECK_EQUAL(EventCapture::drain(events + 2, CSF_EVENT_QUEUE), 3);
+	for(uint8_t i = 0; i < 5; i++){
+		CSF_CHECK_EQUAL(events[i].pin, 2);
+		CSF_CHECK_EQUAL(events[i].level, i % 2 == 0 ? HIGH : LOW);
+		CSF_CHECK_EQUAL(events[i].time, start + 100 * (i + 1));
+	}
+	CSF_CHECK_EQUAL(EventCapture::drain(events, CSF_EVENT_QUEUE), 0);
+
+	//two pins interleaved keep their order
+	Sim::setDigital(3, HIGH);
+	Sim::setDigital(2, LOW);	//left HIGH by the five edges above
+	Sim::setDigital(3, LOW);
+	CSF_CHECK_EQUAL(EventCapture::drain(events, CSF_EVENT_QUEUE), 3);
+	CSF_CHECK_EQUAL(events[0].pin, 3);
+	CSF_CHECK_EQUAL(events[1].pin, 2);
+	CSF_CHECK_EQUAL(events[1].level, LOW);
+	CSF_CHECK_EQUAL(events[2].pin, 3);
+	CSF_CHECK_EQUAL(events[2].level, LOW);
+
+	//nothing is captured with interrupts off, or for a slot nothing is attached in
+	noInterrupts();
+	toggle(2, 2, 100);
+	interrupts();
+	EventCapture::onInterrupt(CSF_EVENT_PINS - 1);
+	CSF_CHECK_EQUAL(EventCapture::available(), 0);
+
+	//a full queue keeps the oldest edges and counts the rest
+	uint16_t overflows = EventCapture::getOverflows();
+	start = micros();
+	toggle(3, 39, 10);
+	CSF_CHECK_EQUAL(EventCapture::available(), CSF_EVENT_QUEUE - 1);
+	CSF_CHECK_EQUAL((uint16_t)(EventCapture::getOverflows() - overflows), 39 - (CSF_EVENT_QUEUE - 1));
+	CSF_CHECK_EQUAL(EventCapture::drain(events, CSF_EVENT_QUEUE), CSF_EVENT_QUEUE - 1);
+	CSF_CHECK_EQUAL(events[0].time, start + 10);
+	CSF_CHECK_EQUAL(events[CSF_EVENT_QUEUE - 2].time, start + 10 * (CSF_EVENT_QUEUE - 1));
+	toggle(3, 1, 10);
+	CSF_CHECK_EQUAL(EventCapture::available(), 1);	//room again once drained
+
+	//a sketch's own pin change interrupt feeds edges in the same way
+	EventCapture::capture(11, HIGH);
+	CSF_CHECK_EQUAL(EventCapture::drain(events, CSF_EVENT_QUEUE), 2);
+	CSF_CHECK_EQUAL(events[1].pin, 11);
+
+	//detached, the pins are left alone
+	EventCapture::detachAll();
+	toggle(2, 4, 100);
+	CSF_CHECK_EQUAL(EventCapture::available(), 0);
+
+	return Test::finish("events");
+}
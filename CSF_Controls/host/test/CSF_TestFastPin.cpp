@@ -0,0 +1,159 @@
+/**
+ * @file
+ * @section description Description
+ * Checks Utility::FastPin against the simulated board's port registers: each call has to set or clear exactly its own bit in the DDR, PORT or PIN register digitalRead\(\)/digitalWrite\(\)/pinMode\(\) use, on pins spread over several ports, and the Fast controls built on it have to behave like the ones taking their pins at run time.
+ */
+
+
+#include "CSF_Test.h"
+#include <Arduino.h>
+#include <CSF_Controls.h>
+
+using namespace Sensors;
+using namespace Switches;
+using namespace Utility;
+
+
+
+
+namespace{
+	/**
+	 * Copies every port's three registers
+	 * @param registers -room for 3 * SIM_PORTS bytes
+	 */
+	void snapshot(uint8_t* registers){
+		for(uint8_t port = 0; port < SIM_PORTS; port++){
+			registers[port] = Sim::portMode[port];
+			registers[SIM_PORTS + port] = Sim::portOutput[port];
+			registers[2 * SIM_PORTS + port] = Sim::portInput[port];
+		}
+	}//end snapshot()
+
+
+	/**
+	 * Counts the bits that differ between two snapshots
+	 * @param before -from snapshot\(\)
+	 * @param after -from snapshot\(\)
+	 * @return int
+	 */
+	int changedBits(const uint8_t* before, const uint8_t* after){
+		int bits = 0;
+		for(int i = 0; i < 3 * SIM_PORTS; i++){
+			for(uint8_t diff = before[i] ^ after[i]; diff != 0; diff &= diff - 1){
+				bits++;
+			}
+		}
+		return bits;
+	}//end changedBits()
+
+
+	/**
+	 * Runs one pin through every FastPin call, checking each touches only its own bit of the right register
+	 * @tparam N -the pin
+	 */
+	template<uint8_t N> void checkPin(void){
+		const uint8_t port = digitalPinToPort(N);
+		const uint8_t mask = digitalPinToBitMask(N);
+		CSF_CHECK_EQUAL(fastPortOf(N), port);
+		CSF_CHECK_EQUAL(fastMaskOf(N), mask);
+
+		uint8_t before[3 * SIM_PORTS];
+		uint8_t after[3 * SIM_PORTS];
+		for(uint8_t other = 0; other < SIM_PORTS; other++){
+			Sim::portMode[other] = 0x5A;	//a pattern on the other pins so a stray write shows
+			Sim::portOutput[other] = 0xA5;
+		}
+		Sim::portMode[port] &= ~mask;
+		Sim::portOutput[port] &= ~mask;
+
+		snapshot(before);
+		FastPin<N>::output();
+		snapshot(after);
+		CSF_CHECK(Sim::portMode[port] & mask);
+		CSF_CHECK_EQUAL(changedBits(before, after), 1);
+
+		snapshot(before);
+		FastPin<N>::high();
+		snapshot(after);
+		CSF_CHECK(Sim::portOutput[port] & mask);
+		CSF_CHECK_EQUAL(Sim::getDigitalOutput(N), HIGH);
+		CSF_CHECK_EQUAL(changedBits(before, after), 1);
+
+		snapshot(before);
+		FastPin<N>::write(false);
+		snapshot(after);
+		CSF_CHECK(!(Sim::portOutput[port] & mask));
+		CSF_CHECK_EQUAL(Sim::getDigitalOutput(N), LOW);
+		CSF_CHECK_EQUAL(changedBits(before, after), 1);
+
+		FastPin<N>::high();
+		snapshot(before);
+		FastPin<N>::input();	//clears the direction bit and the pull-up with it, as pinMode(INPUT) does
+		snapshot(after);
+		CSF_CHECK(!(Sim::portMode[port] & mask));
+		CSF_CHECK(!(Sim::portOutput[port] & mask));
+		CSF_CHECK_EQUAL(changedBits(before, after), 2);
+
+		Sim::setDigital(N, HIGH);
+		CSF_CHECK(Sim::portInput[port] & mask);
+		CSF_CHECK(FastPin<N>::read());
+		CSF_CHECK_EQUAL(digitalRead(N), HIGH);
+		Sim::setDigital(N, LOW);
+		CSF_CHECK(!FastPin<N>::read());
+		CSF_CHECK_EQUAL(digitalRead(N), LOW);
+		Sim::portInput[port] = (uint8_t)~mask;	//every other pin on the port HIGH
+		CSF_CHECK(!FastPin<N>::read());
+		Sim::portInput[port] = mask;
+		CSF_CHECK(FastPin<N>::read());
+		Sim::portInput[port] = 0;
+	}//end checkPin()
+}
+
+
+
+
+int main(){
+	Sim::reset();
+	checkPin<0>();
+	checkPin<7>();
+	checkPin<8>();
+	checkPin<13>();
+	checkPin<A0>();
+	checkPin<A5>();
+	checkPin<NUM_DIGITAL_PINS - 1>();
+
+	//the Fast controls on the registers, next to the ones that take their pins at run time
+	Sim::reset();
+	FastPot<2, 3, A0> fast;
+	Pot plain(4, 5, A1);
+	fast.begin();
+	plain.begin();
+	fast.activateControl();
+	plain.activateControl();
+	CSF_CHECK_EQUAL(Sim::getDigitalOutput(3), HIGH);
+	CSF_CHECK_EQUAL(Sim::getDigitalOutput(5), HIGH);
+	fast.deactivateControl();
+	CSF_CHECK_EQUAL(Sim::getDigitalOutput(3), LOW);
+	Sim::advanceMillis(1000);
+	Sim::setDigital(2, HIGH);
+	Sim::setDigital(4, HIGH);
+	fast.isButtonPressed();
+	plain.isButtonPressed();
+	CSF_CHECK(fast.getIsSensorOn());
+	CSF_CHECK_EQUAL(fast.getIsSensorOn(), plain.getIsSensorOn());
+	Sim::setAnalog(A0, 300);
+	CSF_CHECK_EQUAL(fast.getSensorValue(), 300);
+
+	FastButton<9> button;
+	FastMomentary<10> momentary;
+	button.begin();
+	momentary.begin();
+	CSF_CHECK(!(Sim::portMode[digitalPinToPort(9)] & digitalPinToBitMask(9)));
+	CSF_CHECK_EQUAL(button.getState(), LOW);
+	Sim::setDigital(9, HIGH);
+	Sim::setDigital(10, HIGH);
+	CSF_CHECK_EQUAL(button.getState(), HIGH);
+	CSF_CHECK_EQUAL(momentary.getState(), HIGH);
+
+	return Test::finish("fast pin");
+}
@@ -0,0 +1,132 @@
+/**
+ * @file
+ * @section description Description
+ * Checks Switches::KeyMatrix on a simulated 3 by 3 Sim::Keypad: without diodes, three keys held at the corners of a rectangle make the fourth read as pressed, and the keys of the rectangle have to keep the state they had until it's broken, so the ghost is never reported and a real press blocked behind it comes through once it clears. With diodes the same keys are all real and nothing is blocked.
+ */
+
+
+#include "CSF_Test.h"
+#include <Arduino.h>
+#include <CSF_Controls.h>
+#include <SimDevices.h>
+#include <vector>
+
+using namespace Switches;
+
+
+
+
+namespace{
+	/**
+	 * Scans a matrix enough times for every settled key to get through the debounce counters
+	 * @param matrix -the matrix
+	 */
+	void settle(KeyMatrix& matrix){
+		for(int i = 0; i < 8; i++){
+			matrix.scan();
+			Sim::advanceMillis(5);
+		}
+	}//end settle()
+
+
+	/**
+	 * Counts the events waiting for one key, and takes every event off the queue
+	 * @param matrix -the matrix
+	 * @param key -the key number
+	 * @return int
+	 */
+	int eventsFor(KeyMatrix& matrix, uint8_t key){
+		KeyEvent events[CSF_MATRIX_QUEUE];
+		uint8_t count = matrix.drain(events, CSF_MATRIX_QUEUE);
+		int found = 0;
+		for(uint8_t i = 0; i < count; i++){
+			found += events[i].key == key ? 1 : 0;
+		}
+		return found;
+	}//end eventsFor()
+
+
+	/**
+	 * Sets up a matrix on rows 2 to 4 and columns 5 to 7
+	 * @param matrix -the matrix
+	 * @param diodes -whether the keys have diodes
+	 */
+	void wire(KeyMatrix& matrix, bool diodes){
+		for(uint8_t p = 2; p <= 4; p++){
+			matrix.addRow(p);
+		}
+		for(uint8_t p = 5; p <= 7; p++){
+			matrix.addColumn(p);
+		}
+		matrix.setDiodes(diodes);
+		matrix.begin();
+	}//end wire()
+}
+
+
+
+
+int main(){
+	std::vector<uint8_t> rows = {2, 3, 4};
+	std::vector<uint8_t> columns = {5, 6, 7};
+
+	//a ghost at the fourth corner is never reported, and the real keys around it hold still
+	Sim::reset();
+	Sim::Keypad pad(rows, columns);
+	KeyMatrix matrix;
+	wire(matrix, false);
+	pad.connect();
+	uint8_t ghost = matrix.keyOf(1, 1);
+	pad.press(0, 0, true);
+	pad.press(0, 1, true);
+	settle(matrix);
+	CSF_CHECK(matrix.isPressed(matrix.keyOf(0, 0)));
+	CSF_CHECK(matrix.isPressed(matrix.keyOf(0, 1)));
+	CSF_CHECK(!matrix.isGhosted());
+	eventsFor(matrix, 0);
+	pad.press(1, 0, true);
+	settle(matrix);
+	CSF_CHECK(matrix.isGhosted());
+	CSF_CHECK(matrix.getGhostedScans() > 0);
+	CSF_CHECK(!matrix.isPressed(ghost));
+	CSF_CHECK(!matrix.isPressed(matrix.keyOf(1, 0)));	//can't be told from a ghost yet
+	CSF_CHECK(matrix.isPressed(matrix.keyOf(0, 0)));
+	CSF_CHECK(matrix.isPressed(matrix.keyOf(0, 1)));
+	CSF_CHECK_EQUAL(matrix.available(), 0);
+	CSF_CHECK(!matrix.isPressed(matrix.keyOf(2, 2)));
+
+	//breaking the rectangle lets the real press through, and the ghost goes with it
+	pad.press(0, 1, false);
+	settle(matrix);
+	CSF_CHECK(!matrix.isGhosted());
+	CSF_CHECK(matrix.isPressed(matrix.keyOf(1, 0)));
+	CSF_CHECK(!matrix.isPressed(matrix.keyOf(0, 1)));
+	CSF_CHECK(!matrix.isPressed(ghost));
+	CSF_CHECK_EQUAL(matrix.available(), 2);
+	CSF_CHECK_EQUAL(eventsFor(matrix, ghost), 0);
+
+	//a key held on its own in another row and column isn't caught up in it
+	pad.press(2, 2, true);
+	settle(matrix);
+	CSF_CHECK(matrix.isPressed(matrix.keyOf(2, 2)));
+	CSF_CHECK(!matrix.isGhosted());
+
+	//with diodes the three keys are all there is
+	Sim::reset();
+	Sim::Keypad diodes(rows, columns, true);
+	KeyMatrix fitted;
+	wire(fitted, true);
+	diodes.connect();
+	diodes.press(0, 0, true);
+	diodes.press(0, 1, true);
+	diodes.press(1, 0, true);
+	settle(fitted);
+	CSF_CHECK(!fitted.isGhosted());
+	CSF_CHECK(fitted.isPressed(fitted.keyOf(0, 0)));
+	CSF_CHECK(fitted.isPressed(fitted.keyOf(0, 1)));
+	CSF_CHECK(fitted.isPressed(fitted.keyOf(1, 0)));
+	CSF_CHECK(!fitted.isPressed(fitted.keyOf(1, 1)));
+	CSF_CHECK_EQUAL(fitted.available(), 3);
+
+	return Test::finish("key matrix");
+}
@@ -0,0 +1,155 @@
+/**
+ * @file
+ * @section description Description
+ * Checks Sensors::LinearMap and Sensors::FixedMap against a long double reference over all 1024 ADC codes.\n
+ * Whole number ranges have to round every code exactly as the reference does, floor\(x + 0.5\), from a few steps wide to the whole range of a long. Decimal ranges have to stay within a few millionths of their span, and a range too wide for 64 bits has to be pulled in rather than overflow.
+ */
+
+
+#include "CSF_Test.h"
+#include <Arduino.h>
+#include <CSF_Controls.h>
+
+using namespace Sensors;
+
+
+
+
+namespace{
+	/**
+	 * Exactly where a reading falls on the line
+	 * @param outMin -what 0 maps to
+	 * @param outMax -what inMax maps to
+	 * @param reading -the reading
+	 * @param inMax -the top reading
+	 * @return long double
+	 */
+	long double reference(long double outMin, long double outMax, long reading, long inMax = 1023){
+		return outMin + reading * (outMax - outMin) / inMax;
+	}//end reference()
+
+
+	/**
+	 * Counts the codes setWhole\(\) rounds differently from the reference, or that would overflow a 32 bit long on a board when it isn't using 64 bit math
+	 * @param outMin -what 0 maps to
+	 * @param outMax -what 1023 maps to
+	 * @return long
+	 */
+	long wholeMismatches(long outMin, long outMax){
+		LinearMap mapping;
+		mapping.setWhole(outMin, outMax);
+		long wrong = 0;
+		for(long reading = 0; reading <= 1023; reading++){
+			long long fixed = mapping.apply(reading);
+			bool fits = mapping.isWide() || (llabs(fixed) + (1LL << mapping.getShift()) < (1LL << 31) && llabs(fixed - mapping.apply(0)) < (1LL << 31));
+			if(!fits || mapping.toInt(reading) != (long)floorl(reference(outMin, outMax, reading) + 0.5L)){
+				wrong++;
+			}
+		}
+		return wrong;
+	}//end wholeMismatches()
+
+
+	/**
+	 * Counts the codes a FixedMap rounds differently from the reference
+	 * @return long
+	 */
+	template<long OutMin, long OutMax> long fixedMismatches(void){
+		long wrong = 0;
+		for(long reading = 0; reading <= 1023; reading++){
+			if(FixedMap<OutMin, OutMax>::map(reading) != (long)floorl(reference(OutMin, OutMax, reading) + 0.5L)){
+				wrong++;
+			}
+		}
+		return wrong;
+	}//end fixedMismatches()
+
+
+	/**
+	 * Finds the furthest set\(\) and toFloat\(\) get from the reference, as a fraction of the span
+	 * @param outMin -what 0 maps to
+	 * @param outMax -what inMax maps to
+	 * @param inMax -the top reading
+	 * @return double
+	 */
+	double floatError(float outMin, float outMax, long inMax = 1023){
+		LinearMap mapping;
+		mapping.set(outMin, outMax, inMax);
+		double worst = 0;
+		for(long reading = 0; reading <= inMax; reading++){
+			double error = fabsl(mapping.toFloat(reading) - reference(outMin, outMax, reading, inMax)) / fabs((double)outMax - outMin);
+			worst = error > worst ? error : worst;
+		}
+		return worst;
+	}//end floatError()
+}
+
+
+
+
+int main(){
+	//whole numbers, every code exact
+	CSF_CHECK_EQUAL(wholeMismatches(0, 100), 0);
+	CSF_CHECK_EQUAL(wholeMismatches(-100, 100), 0);
+	CSF_CHECK_EQUAL(wholeMismatches(0, 1023), 0);
+	CSF_CHECK_EQUAL(wholeMismatches(100, 0), 0);
+	CSF_CHECK_EQUAL(wholeMismatches(-32768, 32767), 0);
+	CSF_CHECK_EQUAL(wholeMismatches(-1000000, 1000000), 0);
+	CSF_CHECK_EQUAL(wholeMismatches(1000000, -1000000), 0);
+	CSF_CHECK_EQUAL(wholeMismatches(123456789, 123456800), 0);
+	CSF_CHECK_EQUAL(wholeMismatches(-2147483647L - 1, 2147483647L), 0);
+	CSF_CHECK_EQUAL(wholeMismatches(7, 7), 0);
+
+	//32 bit math where it's enough, 64 where it isn't
+	LinearMap mapping;
+	mapping.setWhole(0, 100);
+	CSF_CHECK(!mapping.isWide());
+	mapping.setWhole(-500, 500);
+	CSF_CHECK(!mapping.isWide());
+	mapping.setWhole(-32768, 32767);
+	CSF_CHECK(mapping.isWide());
+	mapping.set(-3.14f, 3.14f);
+	CSF_CHECK(!mapping.isWide());
+	mapping.set(0.001f, 0.002f);
+	CSF_CHECK(mapping.isWide());
+
+	//the same at compile time
+	CSF_CHECK_EQUAL((fixedMismatches<0, 100>()), 0);
+	CSF_CHECK_EQUAL((fixedMismatches<-200, 200>()), 0);
+	CSF_CHECK_EQUAL((fixedMismatches<1023, 0>()), 0);
+	CSF_CHECK_EQUAL((fixedMismatches<-32768, 32767>()), 0);
+	CSF_CHECK_EQUAL((fixedMismatches<-1000000, 1000000>()), 0);
+	CSF_CHECK_EQUAL((fixedMismatches<-2147483647L - 1, 2147483647L>()), 0);
+	CSF_CHECK(!(FixedMap<-200, 200>::WIDE));
+	CSF_CHECK((FixedMap<-32768, 32767>::WIDE));
+
+	//decimals, within a few millionths of the span
+	CSF_CHECK(floatError(-3.14f, 3.14f) < 4e-6);
+	CSF_CHECK(floatError(0, 5) < 4e-6);
+	CSF_CHECK(floatError(0.001f, 0.002f) < 4e-6);
+	CSF_CHECK(floatError(-1e6f, 1e6f) < 4e-6);
+	CSF_CHECK(floatError(5e17f, -5e17f) < 4e-6);
+	CSF_CHECK(floatError(-3.14f, 3.14f, 1023L << 3) < 4e-6);
+
+	//too wide for 64 bits, pulled in
+	CSF_CHECK(!mapping.set(-1e20f, 1e20f));
+	CSF_CHECK(mapping.toFloat(0) < -1e18f && mapping.toFloat(1023) > 1e18f);
+	CSF_CHECK(mapping.set(-1e18f, 1e18f));
+
+	//and through a Pot on the simulated board
+	Sim::reset();
+	Pot pot(2, 3, A0);
+	pot.begin();
+	long wrong = 0;
+	for(int reading = 0; reading <= 1023; reading++){
+		Sim::setAnalog(A0, reading);
+		if(pot.mapData(-32768, 32767) != (long)floorl(reference(-32768, 32767, reading) + 0.5L)){
+			wrong++;
+		}
+	}
+	CSF_CHECK_EQUAL(wrong, 0);
+	Sim::setAnalog(A0, 1023);
+	CSF_CHECK(fabs(pot.mapData(-3.14f, 3.14f) - 3.14f) < 1e-5);
+
+	return Test::finish("linear map");
+}
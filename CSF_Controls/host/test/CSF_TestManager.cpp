@@ -0,0 +1,129 @@
+/**
+ * @file
+ * @section description Description
+ * Checks Scheduling::ControlManager running controls on the simulated board: taps on a Pot's Activation Button shorter than its interval have to toggle it and its power line once each, as the interval only keeps presses apart, and a managed button has to see a press within one POLL_INTERVAL, also when it's added with a Utility::RateController and has gone idle, which a tap has to wake.
+ */
+
+
+#include "CSF_Test.h"
+#include <Arduino.h>
+#include <CSF_Controls.h>
+#include <SimDevices.h>
+
+using namespace Sensors;
+using namespace Switches;
+using namespace Scheduling;
+
+
+
+
+namespace{
+	/**
+	 * Ticks a manager every millisecond up to a moment
+	 * @param manager -the manager
+	 * @param until -the simulated time to stop at, micros\(\)
+	 */
+	void run(ControlManager& manager, unsigned long until){
+		while(Sim::now() < until){
+			manager.tick();
+			Sim::advanceMillis(1);
+		}
+	}//end run()
+}
+
+
+
+
+int main(){
+	//every tap toggles the Pot once, clean or bouncing
+	Sim::reset();
+	Pot pot(2, 3, A0);
+	Pot bouncing(4, 5, A1);
+	pot.begin();
+	bouncing.begin();
+	ControlManager manager;
+	CSF_CHECK(manager.add(pot));
+	CSF_CHECK(manager.add(bouncing));
+	manager.begin();
+	CSF_CHECK_EQUAL(Sim::getDigitalOutput(3), LOW);
+	Sim::BouncySwitch contact(4, 3000, 9);
+	unsigned long t = 100000;
+	for(int i = 0; i < 5; i++){
+		contact.press(t);
+		contact.release(t + 150000);
+		t += 600000;
+	}
+	contact.connect();
+	int toggles = 0;
+	bool wasOn = false;
+	t = 100000;
+	for(int i = 0; i < 5; i++){
+		run(manager, t);
+		Sim::setDigital(2, HIGH);
+		run(manager, t + 150000);
+		CSF_CHECK_EQUAL(pot.getIsSensorOn(), i % 2 == 0);
+		CSF_CHECK_EQUAL(Sim::getDigitalOutput(3), i % 2 == 0 ? HIGH : LOW);
+		Sim::setDigital(2, LOW);
+		if(bouncing.getIsSensorOn() != wasOn){
+			wasOn = !wasOn;
+			toggles++;
+		}
+		t += 600000;
+	}
+	CSF_CHECK_EQUAL(toggles, 5);
+	CSF_CHECK_EQUAL(Sim::getDigitalOutput(5), HIGH);
+
+	//a tap inside the interval is kept from toggling it again
+	run(manager, t);
+	Sim::setDigital(2, HIGH);
+	run(manager, t + 50000);
+	Sim::setDigital(2, LOW);
+	run(manager, t + 100000);
+	Sim::setDigital(2, HIGH);
+	run(manager, t + 150000);
+	Sim::setDigital(2, LOW);
+	CSF_CHECK(!pot.getIsSensorOn());
+
+	//a managed button sees a press within one poll
+	Sim::reset();
+	Momentary button(6);
+	button.begin();
+	ControlManager buttons;
+	CSF_CHECK(buttons.add(button));
+	buttons.begin();
+	run(buttons, 100000);
+	Sim::setDigital(6, HIGH);
+	run(buttons, 100000 + 1000UL * ControlManager::POLL_INTERVAL);
+	CSF_CHECK_EQUAL(button.getLastState(), HIGH);
+	CSF_CHECK(button.getEvents() & Utility::Debouncer::PRESSED);
+
+	//an idle button on a RateController still sees a tap shorter than the idle interval, and wakes on it, glitch filter and all
+	Sim::reset();
+	Momentary idle(7);
+	idle.getDebouncer().setConfirm(2);
+	idle.begin();
+	Utility::RateController rate;
+	ControlManager adaptive;
+	CSF_CHECK(adaptive.add(idle, rate));
+	adaptive.begin();
+	run(adaptive, 3000000);
+	CSF_CHECK(!rate.isActive());
+	CSF_CHECK(rate.getInterval() > ControlManager::POLL_INTERVAL);
+	int pressed = 0;
+	t = 3000000;
+	for(int i = 0; i < 10; i++){
+		run(adaptive, t + 13000UL * i);	//somewhere different between the idle samples each time
+		Sim::setDigital(7, HIGH);
+		run(adaptive, t + 13000UL * i + 40000);
+		CSF_CHECK(rate.isActive());
+		CSF_CHECK_EQUAL(adaptive.getActiveCount(), 1);
+		pressed += (idle.getEvents() & Utility::Debouncer::PRESSED) ? 1 : 0;
+		Sim::setDigital(7, LOW);
+		t += 3000000;
+		run(adaptive, t);
+	}
+	CSF_CHECK_EQUAL(pressed, 10);
+	CSF_CHECK(!rate.isActive());
+
+	return Test::finish("manager");
+}
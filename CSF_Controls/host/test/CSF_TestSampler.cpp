@@ -0,0 +1,187 @@
+/**
+ * @file
+ * @section description Description
+ * Checks Sensors::Sampler both ways it's fed: from loop\(\) with service\(\), and from the ADC interrupt, which is mocked here by a function converting the simulated pins in the order the hardware would and handing each result to Sampler::onConversion\(\) as the CSF_SAMPLER_ISR\(\) handler does. An Expansion::AnalogMux has to keep off the ADC while the interrupt has it, and a Static::Sensors::Pot attached next to a Pot has to read and print the same. Oversampling from the Sampler's history is capped at the bits the readings it keeps can give.
+ */
+
+
+#include "CSF_Test.h"
+#include <Arduino.h>
+#include <CSF_Controls.h>
+#include <CSF_Static.h>
+
+using namespace Sensors;
+
+
+
+
+namespace{
+	const uint8_t PINS[] = {A0, A1, A2};	///< The Pots' sensor pins, in the order they're attached
+	uint8_t converting = 0;	///< The mocked ADC's multiplexer, the channel it converts next
+
+
+	/**
+	 * One conversion finishing on the mocked ADC, the interrupt firing with its result
+	 */
+	void adcInterrupt(void){
+		Sampler::onConversion(analogRead(PINS[converting]));
+		converting = (converting + 1) % 3;
+	}//end adcInterrupt()
+}
+
+
+
+
+int main(){
+	Sim::reset();
+	Pot pots[3] = {Pot(2, 3, A0), Pot(4, 5, A1), Pot(6, 7, A2)};
+	for(uint8_t i = 0; i < 3; i++){
+		pots[i].begin();
+		Sim::setAnalog(PINS[i], 100 * (i + 1));
+		CSF_CHECK_EQUAL(Sampler::attach(pots[i]), i);
+	}
+	CSF_CHECK_EQUAL(Sampler::attach(pots[1]), 1);	//attaching again keeps the channel
+	CSF_CHECK_EQUAL(Sampler::latest(2), 300);	//attach() takes a first reading
+
+	//served from loop(), a Pot a call
+	Sampler::begin();
+	CSF_CHECK(Sampler::isRunning());
+	CSF_CHECK(!Sampler::isInterruptDriven());
+	Sim::setAnalog(A0, 11);
+	Sim::setAnalog(A1, 22);
+	Sim::setAnalog(A2, 33);
+	Sampler::service();
+	Sampler::service();
+	CSF_CHECK_EQUAL(pots[0].getSensorValue(), 11);
+	CSF_CHECK_EQUAL(pots[1].getSensorValue(), 22);
+	CSF_CHECK_EQUAL(pots[2].getSensorValue(), 300);
+	Sampler::service();
+	CSF_CHECK_EQUAL(pots[2].getSensorValue(), 33);
+	CSF_CHECK_EQUAL(Sampler::getConversions(), 3);
+	Expansion::AnalogMux between(A3, 8, 9, 10);	//served from loop() the two take turns at the ADC
+	between.begin();
+	Sim::setAnalog(A3, 640);
+	between.scan();
+	CSF_CHECK_EQUAL(between.readAnalog(5), 640);
+	Sampler::end();
+	Sampler::service();
+	CSF_CHECK_EQUAL(Sampler::getConversions(), 3);
+
+	//fed from the mocked interrupt, service() leaves it alone
+	Sampler::hookInterrupt();
+	Sampler::begin();
+	CSF_CHECK(Sampler::isInterruptDriven());
+	Sampler::service();
+	CSF_CHECK_EQUAL(Sampler::getConversions(), 0);
+	converting = 0;
+	for(int step = 0; step < 4; step++){
+		for(uint8_t i = 0; i < 3; i++){
+			Sim::setAnalog(PINS[i], 200 * i + step * 4);
+		}
+		for(uint8_t i = 0; i < 3; i++){
+			adcInterrupt();
+		}
+	}
+	CSF_CHECK_EQUAL(Sampler::getConversions(), 12);
+	unsigned long reads = Sim::getAnalogReads();
+	for(uint8_t i = 0; i < 3; i++){
+		CSF_CHECK_EQUAL(pots[i].getSensorValue(), 200 * i + 12);
+		CSF_CHECK_EQUAL(pots[i].getRawValue(), 200 * i + 12);
+	}
+	CSF_CHECK_EQUAL(Sim::getAnalogReads(), reads);	//the Pots never touched the ADC
+	Expansion::AnalogMux mux(A3, 8, 9, 10);
+	mux.begin();
+	Sim::setAnalog(A3, 700);
+	mux.scan();
+	CSF_CHECK_EQUAL(Sim::getAnalogReads(), reads);	//nor did a mux, it leaves the ADC to the interrupt
+	CSF_CHECK_EQUAL(mux.readAnalog(0), 0);
+
+	uint16_t recent[CSF_SAMPLER_DEPTH];
+	CSF_CHECK_EQUAL(Sampler::recent(1, recent, CSF_SAMPLER_DEPTH), 4);
+	CSF_CHECK_EQUAL(recent[0], 212);
+	CSF_CHECK_EQUAL(recent[3], 200);
+	pots[1].setOversampling(1);
+	CSF_CHECK_EQUAL(pots[1].getSensorValue(), 412);	//the four readings the Sampler has, 206 on average, doubled
+	pots[1].setOversampling(3);
+	CSF_CHECK_EQUAL(pots[1].getSensorValue(), 412);	//capped at the bit four readings give, not scaled up to 3
+	pots[1].setOversampling(0);
+
+	//a conversion finishing after end() is still filed, nothing new is started
+	Sampler::end();
+	CSF_CHECK(!Sampler::isInterruptDriven());
+	Sim::setAnalog(A0, 999);
+	adcInterrupt();
+	CSF_CHECK_EQUAL(pots[0].getSensorValue(), 999);
+	Sampler::hookInterrupt(false);
+
+	//detached, the Pots read the pin themselves again
+	Sampler::detachAll();
+	Sim::setAnalog(A2, 77);
+	CSF_CHECK_EQUAL(pots[2].getSensorValue(), 77);
+	CSF_CHECK_EQUAL(Sim::getAnalogReads(), reads + 2);
+
+	//a Static Pot goes through the same reader, Sampler and all
+	Sim::reset();
+	Pot plain(2, 3, A0);
+	Static::Sensors::Pot lean(4, 5, A1);
+	plain.begin();
+	lean.begin();
+	Sim::setAnalog(A0, 500);
+	Sim::setAnalog(A1, 500);
+	CSF_CHECK_EQUAL(Sampler::attach(plain), 0);
+	CSF_CHECK_EQUAL(Sampler::attach(lean), 1);
+	CSF_CHECK_EQUAL(Sampler::attach(lean), 1);
+	Sampler::begin();
+	Sim::setAnalog(A0, 620);
+	Sim::setAnalog(A1, 620);
+	Sampler::service();
+	Sampler::service();
+	reads = Sim::getAnalogReads();
+	CSF_CHECK_EQUAL(lean.getSensorValue(), 620);
+	CSF_CHECK_EQUAL(lean.getRawValue(), 620);
+	CSF_CHECK_EQUAL(Sim::getAnalogReads(), reads);
+	plain.setOversampling(1);
+	lean.setOversampling(1);
+	CSF_CHECK_EQUAL(lean.mapData(-1000, 1000), plain.mapData(-1000, 1000));
+	CSF_CHECK_EQUAL(lean.getLastValue(), 1120);	//500 and 620, averaged and doubled
+	plain.toggleIsSensorOn();
+	lean.toggleIsSensorOn();
+	Sim::clearSerialOutput();
+	plain.toSerial();
+	std::string printed = Sim::serialOutput();
+	Sim::clearSerialOutput();
+	lean.toSerial();
+	CSF_CHECK(Sim::serialOutput() == printed);
+	Sampler::detachAll();
+	Sim::setAnalog(A1, 40);
+	CSF_CHECK_EQUAL(lean.getRawValue(), 40);
+
+	//oversampling set before attaching is lowered to what the history holds, and back on its own it reads 4^bits times
+	Sim::reset();
+	Pot deep(2, 3, A0);
+	deep.begin();
+	deep.setOversampling(3);
+	Sim::setAnalog(A0, 300);
+	reads = Sim::getAnalogReads();
+	CSF_CHECK_EQUAL(deep.getSensorValue(), 2400);
+	CSF_CHECK_EQUAL(Sim::getAnalogReads(), reads + 64);
+	Sampler::attach(deep);
+	CSF_CHECK_EQUAL(deep.mapData(0, 100), 29);	//300 of 1023, from 600 of 2046
+	CSF_CHECK_EQUAL(deep.getLastValue(), 600);
+	Sampler::detachAll();
+
+	//there are only so many channels, and a mux input can't be one
+	Sim::reset();
+	Pot many[CSF_SAMPLER_CHANNELS + 1] = {
+		Pot(2, 3, A0), Pot(2, 3, A1), Pot(2, 3, A2), Pot(2, 3, A3), Pot(2, 3, A4), Pot(2, 3, A5), Pot(2, 3, A6), Pot(2, 3, A7), Pot(2, 3, A0)
+	};
+	for(uint8_t i = 0; i < CSF_SAMPLER_CHANNELS; i++){
+		CSF_CHECK_EQUAL(Sampler::attach(many[i]), i);
+	}
+	CSF_CHECK_EQUAL(Sampler::attach(many[CSF_SAMPLER_CHANNELS]), -1);
+	Sampler::detachAll();
+	Pot virtualPot(2, 3, CSF_VIRTUAL_PIN_BASE);
+	CSF_CHECK_EQUAL(Sampler::attach(virtualPot), -1);
+
+	return Test::finish("sampler");
+}
@@ -0,0 +1,115 @@
+/**
+ * @file
+ * @section description Description
+ * Checks the simulated board the other tests and the benchmarks stand on: the virtual clock, scripted pins and their interrupts, the port registers behind digitalRead\(\) and digitalWrite\(\), and the captured Serial, then a Pot and a Momentary read through all of it.
+ */
+
+
+#include "CSF_Test.h"
+#include <Arduino.h>
+#include <CSF_Controls.h>
+
+using namespace Sensors;
+using namespace Switches;
+
+
+
+
+namespace{
+	int edges = 0;	///< Counted by the interrupt handler
+
+
+	/**
+	 * The interrupt handler attached in the test
+	 */
+	void countEdge(void){
+		edges++;
+	}//end countEdge()
+}
+
+
+
+
+int main(){
+	//the clock only moves when it's told to, or by the step on every read
+	Sim::reset();
+	CSF_CHECK_EQUAL(micros(), 0);
+	Sim::advanceMillis(3);
+	CSF_CHECK_EQUAL(millis(), 3);
+	CSF_CHECK_EQUAL(micros(), 3000);
+	Sim::setClockStep(10);
+	CSF_CHECK_EQUAL(micros(), 3010);
+	CSF_CHECK_EQUAL(micros(), 3020);
+	CSF_CHECK_EQUAL(Sim::now(), 3020);
+	Sim::setClockStep(0);
+
+	//pins and the registers behind them
+	Sim::reset();
+	pinMode(10, OUTPUT);
+	CSF_CHECK(Sim::portMode[digitalPinToPort(10)] & digitalPinToBitMask(10));
+	digitalWrite(10, HIGH);
+	CSF_CHECK(Sim::portOutput[digitalPinToPort(10)] & digitalPinToBitMask(10));
+	CSF_CHECK_EQUAL(digitalRead(10), HIGH);
+	CSF_CHECK_EQUAL(Sim::getDigitalOutput(10), HIGH);
+	pinMode(4, INPUT);
+	Sim::setDigital(4, HIGH);
+	CSF_CHECK(Sim::portInput[digitalPinToPort(4)] & digitalPinToBitMask(4));
+	CSF_CHECK_EQUAL(digitalRead(4), HIGH);
+	pinMode(5, INPUT_PULLUP);
+	CSF_CHECK_EQUAL(digitalRead(5), HIGH);
+	Sim::setAnalog(A2, 517);
+	CSF_CHECK_EQUAL(analogRead(A2), 517);
+	CSF_CHECK_EQUAL(analogRead(2), 517);
+	CSF_CHECK_EQUAL(Sim::getAnalogReads(), 2);
+
+	//scripts run as the clock moves and fire the interrupts
+	Sim::reset();
+	edges = 0;
+	attachInterrupt(digitalPinToInterrupt(3), countEdge, CHANGE);
+	Sim::scriptDigital(3, [](unsigned long t){ return (t / 1000) % 2 == 1 ? HIGH : LOW; });
+	for(int i = 0; i < 10; i++){
+		Sim::advanceMicros(500);
+	}
+	CSF_CHECK_EQUAL(edges, 5);
+	noInterrupts();
+	Sim::advanceMillis(1);
+	interrupts();
+	CSF_CHECK_EQUAL(edges, 5);
+	Sim::scriptAnalog(A0, [](unsigned long t){ return (int)(t / 1000); });
+	Sim::advanceMillis(40);
+	CSF_CHECK_EQUAL(analogRead(A0), 46);
+
+	//Serial is captured, and input queued for the board
+	Sim::reset();
+	Serial.print("value ");
+	Serial.println(-42);
+	Serial.println(1.5);
+	CSF_CHECK(Sim::serialOutput() == "value -42\r\n1.50\r\n");
+	Sim::clearSerialOutput();
+	CSF_CHECK(Sim::serialOutput().empty());
+	Sim::serialInput("ab");
+	CSF_CHECK_EQUAL(Serial.available(), 2);
+	CSF_CHECK_EQUAL(Serial.read(), 'a');
+	CSF_CHECK_EQUAL(Serial.peek(), 'b');
+
+	//the library on top of it
+	Sim::reset();
+	Pot pot(2, 3, A1);
+	pot.begin();
+	CSF_CHECK_EQUAL(Sim::getPinMode(3), OUTPUT);
+	pot.activateControl();
+	CSF_CHECK_EQUAL(Sim::getDigitalOutput(3), HIGH);
+	Sim::setAnalog(A1, 1023);
+	CSF_CHECK_EQUAL(pot.getSensorValue(), 1023);
+	CSF_CHECK_EQUAL(pot.mapData(0, 100), 100);
+	Momentary button(6, 20);
+	button.begin();
+	Sim::advanceMillis(100);
+	Sim::setDigital(6, HIGH);
+	CSF_CHECK_EQUAL(button.getState(), HIGH);
+	Sim::setDigital(6, LOW);
+	Sim::advanceMillis(100);
+	CSF_CHECK_EQUAL(button.getState(), LOW);
+
+	return Test::finish("sim");
+}
@@ -0,0 +1,72 @@
+/**
+ * @file
+ * @section description Description
+ * Checks Comms::TraceCapture both ways it's timed: from loop\(\) with service\(\), and from the Timer1 interrupt, which is mocked here by calling TraceCapture::onTick\(\) as the CSF_TRACE_ISR\(\) handler does. Hooked to the interrupt it has to refuse Pots the Sampler doesn't have, so the interrupt never waits on the ADC.
+ */
+
+
+#include "CSF_Test.h"
+#include <Arduino.h>
+#include <CSF_Controls.h>
+
+using namespace Sensors;
+using namespace Switches;
+using namespace Comms;
+
+
+
+
+int main(){
+	Sim::reset();
+	Pot pot(2, 3, A0);
+	Button button(6);
+	pot.begin();
+	button.begin();
+	CSF_CHECK(TraceCapture::add(pot));
+	CSF_CHECK(TraceCapture::add(button));
+
+	//taken from loop(), every sample that has come due
+	CSF_CHECK(TraceCapture::begin(1000));
+	CSF_CHECK(!TraceCapture::isInterruptDriven());
+	CSF_CHECK_EQUAL(TraceCapture::getPeriod(), 1000);
+	Sim::advanceMicros(3500);
+	TraceCapture::service();
+	CSF_CHECK_EQUAL(TraceCapture::getSamples(), 4);
+	CSF_CHECK_EQUAL(TraceCapture::available(), 4);
+	CSF_CHECK(TraceCapture::dump() > 0);
+	CSF_CHECK_EQUAL(TraceCapture::available(), 0);
+	TraceCapture::end();
+
+	//from the interrupt, only with the Pots on the Sampler
+	TraceCapture::hookInterrupt();
+	CSF_CHECK(!TraceCapture::isRunning());
+	CSF_CHECK(!TraceCapture::begin(1000));
+	CSF_CHECK(Sampler::attach(pot) >= 0);
+	CSF_CHECK(TraceCapture::begin(1000));
+	CSF_CHECK(TraceCapture::isInterruptDriven());
+	Sim::advanceMicros(5000);
+	TraceCapture::service();
+	CSF_CHECK_EQUAL(TraceCapture::getSamples(), 0);	//the timer takes them
+	unsigned long reads = Sim::getAnalogReads();
+	for(int i = 0; i < 3; i++){
+		TraceCapture::onTick();
+	}
+	CSF_CHECK_EQUAL(TraceCapture::getSamples(), 3);
+	CSF_CHECK_EQUAL(TraceCapture::available(), 3);
+	CSF_CHECK_EQUAL(Sim::getAnalogReads(), reads);	//the interrupt never touched the ADC
+
+	//unhooked, back to loop()
+	TraceCapture::hookInterrupt(false);
+	CSF_CHECK(!TraceCapture::isRunning());
+	Sampler::detachAll();
+	CSF_CHECK(TraceCapture::begin(1000));
+	TraceCapture::service();
+	CSF_CHECK_EQUAL(TraceCapture::getSamples(), 1);
+	TraceCapture::detachAll();
+
+	//sensors made with new go away through their base
+	ControlUnit* made = new Pot(2, 3, A1);
+	delete made;
+
+	return Test::finish("trace");
+}
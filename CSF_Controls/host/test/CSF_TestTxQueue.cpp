@@ -0,0 +1,118 @@
+/**
+ * @file
+ * @section description Description
+ * Checks Comms::TxQueue's lines of channels on the simulated serial port: every channel at its longest has to fit the line it's built in, and when the ring hasn't room for all the changed channels the ones that fit go out and the rest follow on later lines, each value sent once and none held back for good.
+ */
+
+
+#include "CSF_Test.h"
+#include <Arduino.h>
+#include <CSF_Controls.h>
+#include <limits.h>
+#include <string>
+
+using namespace Comms;
+
+
+
+
+namespace{
+	/**
+	 * Hands the serial port everything queued
+	 * @param queue -the queue
+	 */
+	void drainAll(TxQueue& queue){
+		while(queue.getPending() > 0){
+			queue.drain();
+		}
+	}//end drainAll()
+
+
+	/**
+	 * Counts how many times some text turns up in the serial output
+	 * @param text -the text
+	 * @return int
+	 */
+	int occurrences(const std::string& text){
+		int count = 0;
+		for(size_t at = Sim::serialOutput().find(text); at != std::string::npos; at = Sim::serialOutput().find(text, at + 1)){
+			count++;
+		}
+		return count;
+	}//end occurrences()
+}
+
+
+
+
+int main(){
+	Sim::reset();
+	TxQueue queue;
+	for(uint8_t i = 0; i < CSF_TX_CHANNELS; i++){
+		CSF_CHECK_EQUAL(queue.addChannel(), i);
+	}
+	CSF_CHECK_EQUAL(queue.addChannel(), -1);
+
+	//every channel goes out once to start with, then only the ones that change
+	CSF_CHECK(queue.flush());
+	drainAll(queue);
+	CSF_CHECK(Sim::serialOutput() == "0:0 1:0 2:0 3:0 4:0 5:0 6:0 7:0\r\n");
+	Sim::clearSerialOutput();
+	queue.set(1, 5);
+	queue.set(6, -12);
+	CSF_CHECK(queue.flush());
+	CSF_CHECK(queue.flush());	//nothing new
+	drainAll(queue);
+	CSF_CHECK(Sim::serialOutput() == "1:5 6:-12\r\n");
+
+	//every channel at its longest still builds one whole line
+	Sim::clearSerialOutput();
+	std::string longest;
+	for(uint8_t i = 0; i < CSF_TX_CHANNELS; i++){
+		queue.set(i, INT_MIN);
+		longest += (i > 0 ? " " : "") + std::to_string(i) + ":" + std::to_string(INT_MIN);
+	}
+	CSF_CHECK(queue.flush());
+	drainAll(queue);
+	CSF_CHECK(Sim::serialOutput() == longest + "\r\n");
+	CSF_CHECK_EQUAL(queue.getSplit(), 0);
+
+	//with the ring mostly taken the channels that fit go first and the rest follow
+	Sim::clearSerialOutput();
+	Sim::setSerialTxSpace(0);
+	CSF_CHECK(queue.println(std::string(90, '.').c_str()));
+	for(uint8_t i = 0; i < CSF_TX_CHANNELS; i++){
+		queue.set(i, INT_MAX - i);
+	}
+	CSF_CHECK(!queue.flush());
+	CSF_CHECK_EQUAL(queue.getSplit(), 1);
+	CSF_CHECK(!queue.flush());	//the first part is still waiting
+	int lines = 1;
+	Sim::setSerialTxSpace(63);
+	for(int tries = 0; tries < 10; tries++){
+		drainAll(queue);
+		bool done = queue.flush();
+		lines++;
+		if(done){
+			break;
+		}
+	}
+	drainAll(queue);
+	CSF_CHECK_EQUAL(lines, 2);	//the rest all fit once the first part had gone
+	for(uint8_t i = 0; i < CSF_TX_CHANNELS; i++){
+		CSF_CHECK_EQUAL(occurrences(std::to_string(i) + ":" + std::to_string(INT_MAX - i)), 1);
+	}
+	CSF_CHECK(queue.flush());
+	CSF_CHECK_EQUAL(queue.getPending(), 0);
+
+	//anything else goes in whole or is dropped and counted
+	Sim::setSerialTxSpace(0);
+	uint8_t block[CSF_TX_BUFFER];
+	CSF_CHECK(!queue.write(block, sizeof(block)));
+	CSF_CHECK_EQUAL(queue.getDropped(), 1);
+	CSF_CHECK(queue.write(block, CSF_TX_BUFFER - 1));
+	CSF_CHECK(!queue.println("x"));
+	CSF_CHECK_EQUAL(queue.getDropped(), 2);
+
+	return Test::finish("tx queue");
+}
@@ -0,0 +1,192 @@
+/**
+ * @file
+ * @section description Description
+ * Runs a Host::Aggregator as a daemon, reading every board given on the command line and serving the merged feed on a Unix socket for as many programs on the PC as want it.\n
+ * Usage: csf_aggregated [--socket path] [--baud b] [--window ms] [--depth n] [--stats seconds] [--print] /dev/ttyACM0 /dev/ttyACM1 ...\n
+ * The socket is /tmp/csf_controls.sock unless --socket says otherwise. --print writes the feed to stdout as well, a line of CSV per frame: the record index, the board, its sequence number and timestamp, the time in milliseconds on the PC's clock since the first record, then the channel values. --stats prints each board's counts to stderr that often, they're printed once more on the way out.\n
+ * It runs until it's sent SIGINT or SIGTERM, or every board has hung up.\n
+ * csf_aggregated --tail [path] connects to a running daemon and prints its feed the same way, the other end of the socket in a dozen lines, see Host::connectFeed\(\).
+ */
+
+
+#include "../CSF_Aggregator.h"
+#include <chrono>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+
+
+
+namespace{
+	volatile sig_atomic_t stopping = 0;	///< Set by the signal handler
+
+
+	/**
+	 * The options from the command line
+	 */
+	struct Options{
+		const char* socket = "/tmp/csf_controls.sock";
+		unsigned long baud = 115200;
+		unsigned long window = 10;
+		size_t depth = 64;
+		double stats = 0;
+		bool print = false;
+		bool tail = false;
+		std::vector<const char*> ports;
+	};
+
+
+	/**
+	 * Reads the command line
+	 * @param argc -from main\(\)
+	 * @param argv -from main\(\)
+	 * @param options -filled in
+	 * @return bool -false if it doesn't make sense
+	 */
+	bool parse(int argc, char** argv, Options& options){
+		for(int i = 1; i < argc; i++){
+			bool more = i + 1 < argc;
+			if(strcmp(argv[i], "--socket") == 0 && more){
+				options.socket = argv[++i];
+			}
+			else if(strcmp(argv[i], "--baud") == 0 && more){
+				options.baud = strtoul(argv[++i], NULL, 10);
+			}
+			else if(strcmp(argv[i], "--window") == 0 && more){
+				options.window = strtoul(argv[++i], NULL, 10);
+			}
+			else if(strcmp(argv[i], "--depth") == 0 && more){
+				options.depth = strtoul(argv[++i], NULL, 10);
+			}
+			else if(strcmp(argv[i], "--stats") == 0 && more){
+				options.stats = atof(argv[++i]);
+			}
+			else if(strcmp(argv[i], "--print") == 0){
+				options.print = true;
+			}
+			else if(strcmp(argv[i], "--tail") == 0){
+				options.tail = true;
+				if(more && argv[i + 1][0] != '-'){
+					options.socket = argv[++i];
+				}
+			}
+			else if(argv[i][0] != '-'){
+				options.ports.push_back(argv[i]);
+			}
+			else{
+				return false;
+			}
+		}
+		return options.tail ? options.ports.empty() : (!options.ports.empty() && options.ports.size() <= CSF_AGGREGATOR_DEVICES && options.depth > 0);
+	}//end parse()
+
+
+	/**
+	 * Prints a record as a line of CSV
+	 * @param record -the record
+	 * @param context -the time to count from, set by the first record
+	 */
+	void print(const Host::FeedRecord& record, void* context){
+		int64_t* start = (int64_t*)context;
+		if(*start == INT64_MIN){
+			*start = record.time;
+		}
+		printf("%u,%u,%u,%u,%.3f", record.index, record.device, record.sequence, record.timestamp, (record.time - *start) / 1e6);
+		for(uint8_t i = 0; i < record.count; i++){
+			printf(",%d", record.channels[i].value);
+		}
+		printf("\n");
+	}//end print()
+
+
+	/**
+	 * Prints every board's counts
+	 * @param aggregator -the Aggregator
+	 * @param ports -the boards' paths
+	 */
+	void report(const Host::Aggregator& aggregator, const std::vector<const char*>& ports){
+		fprintf(stderr, "%-24s %12s %10s %8s %8s %8s %9s\n", "board", "bytes", "frames", "errors", "dropped", "late", "overflows");
+		for(size_t i = 0; i < ports.size(); i++){
+			Host::DeviceStats stats = aggregator.getStats(i);
+			fprintf(stderr, "%-24s %12lu %10lu %8lu %8lu %8lu %9lu%s\n", ports[i], stats.bytes, stats.frames, stats.errors, stats.dropped, stats.late, stats.overflows, stats.open ? "" : " (hung up)");
+		}
+		fprintf(stderr, "%lu records sent, %zu clients, %lu records lost to slow clients\n", aggregator.getRecords(), aggregator.getClientCount(), aggregator.getClientDrops());
+	}//end report()
+
+
+	/**
+	 * The SIGINT and SIGTERM handler
+	 * @param signal -which
+	 */
+	void stop(int){
+		stopping = 1;
+	}//end stop()
+}
+
+
+
+
+int main(int argc, char** argv){
+	Options options;
+	if(!parse(argc, argv, options)){
+		fprintf(stderr, "usage: csf_aggregated [--socket path] [--baud b] [--window ms] [--depth n] [--stats seconds] [--print] port...\n       csf_aggregated --tail [socket]\n");
+		return 2;
+	}
+	int64_t start = INT64_MIN;
+
+	if(options.tail){
+		int fd = Host::connectFeed(options.socket);
+		if(fd < 0){
+			fprintf(stderr, "csf_aggregated: nothing is listening on %s\n", options.socket);
+			return 1;
+		}
+		Host::FeedRecord record;
+		while(Host::readFeed(fd, record)){
+			print(record, &start);
+		}
+		close(fd);
+		return 0;
+	}
+
+	Host::Aggregator aggregator(options.window * 1000, options.depth);
+	for(const char* port : options.ports){
+		if(aggregator.add(port, options.baud) < 0){
+			fprintf(stderr, "csf_aggregated: couldn't open %s\n", port);
+			return 1;
+		}
+	}
+	if(!aggregator.listen(options.socket)){
+		fprintf(stderr, "csf_aggregated: couldn't listen on %s\n", options.socket);
+		return 1;
+	}
+	if(options.print){
+		aggregator.onRecord(print, &start);
+	}
+	signal(SIGINT, stop);
+	signal(SIGTERM, stop);
+	signal(SIGPIPE, SIG_IGN);
+
+	std::chrono::steady_clock::time_point nextReport = std::chrono::steady_clock::now() + std::chrono::microseconds((long)(options.stats * 1e6));
+	while(!stopping){
+		aggregator.poll(200);
+		bool open = false;
+		for(size_t i = 0; i < aggregator.getDeviceCount(); i++){
+			open = open || aggregator.getStats(i).open;
+		}
+		if(!open){
+			break;
+		}
+		if(options.stats > 0 && std::chrono::steady_clock::now() >= nextReport){
+			report(aggregator, options.ports);
+			nextReport += std::chrono::microseconds((long)(options.stats * 1e6));
+		}
+	}
+	aggregator.flush();
+	fflush(stdout);
+	report(aggregator, options.ports);
+	return 0;
+}//end main()
@@ -0,0 +1,169 @@
+/**
+ * @file
+ * @section description Description
+ * Generates a Sensors::CurveTable on the PC, printed as a PROGMEM array to paste into a sketch, and checks it against the exact curve so the table size can be picked knowing how far off it is.\n
+ * Usage: csf_curve [--range min max] [--decimals d] [--bits b] [--taper t | --audio | --reverse-audio] [--points r0,r1,...] [--name name] [--max-error e]\n
+ * --points is a Calibration, the readings at evenly spaced marks along the travel, two of them for just the endpoints of a worn slide, e.g. --points 21,1002.\n
+ * The table goes to stdout. The check goes to stderr: every reading the pot can give, plain and at each level of oversampling, through CurveTable::lookup\(\) against CurveTable::evaluate\(\), then through a Pot on the simulated board to make sure mapData\(\) gives the same. It exits with 1 if the range doesn't fit in the table or the error is over --max-error.
+ */
+
+
+#include <Arduino.h>
+#include <CSF_Controls.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+using namespace Sensors;
+
+
+
+
+namespace{
+	/**
+	 * The options from the command line
+	 */
+	struct Options{
+		float outMin = 0;
+		float outMax = 1023;
+		int decimals = 0;
+		int bits = 5;
+		float taper = TAPER_LINEAR;
+		std::vector<int> points;
+		const char* name = "curve";
+		float maxError = -1;
+	};
+
+
+	/**
+	 * Reads the command line
+	 * @param argc -from main\(\)
+	 * @param argv -from main\(\)
+	 * @param options -filled in
+	 * @return bool -false if it doesn't make sense
+	 */
+	bool parse(int argc, char** argv, Options& options){
+		for(int i = 1; i < argc; i++){
+			bool more = i + 1 < argc;
+			if(strcmp(argv[i], "--range") == 0 && i + 2 < argc){
+				options.outMin = atof(argv[++i]);
+				options.outMax = atof(argv[++i]);
+			}
+			else if(strcmp(argv[i], "--decimals") == 0 && more){
+				options.decimals = atoi(argv[++i]);
+			}
+			else if(strcmp(argv[i], "--bits") == 0 && more){
+				options.bits = atoi(argv[++i]);
+			}
+			else if(strcmp(argv[i], "--taper") == 0 && more){
+				options.taper = atof(argv[++i]);
+			}
+			else if(strcmp(argv[i], "--audio") == 0){
+				options.taper = TAPER_AUDIO;
+			}
+			else if(strcmp(argv[i], "--reverse-audio") == 0){
+				options.taper = TAPER_REVERSE_AUDIO;
+			}
+			else if(strcmp(argv[i], "--points") == 0 && more){
+				for(const char* point = argv[++i]; point != NULL; point = strchr(point, ',')){
+					point += (*point == ',') ? 1 : 0;
+					options.points.push_back(atoi(point));
+				}
+			}
+			else if(strcmp(argv[i], "--name") == 0 && more){
+				options.name = argv[++i];
+			}
+			else if(strcmp(argv[i], "--max-error") == 0 && more){
+				options.maxError = atof(argv[++i]);
+			}
+			else{
+				return false;
+			}
+		}
+		return options.bits >= 1 && options.bits <= 8 && options.decimals >= 0 && options.decimals <= 4 && options.taper > 0 && options.taper < 1 && (options.points.empty() || (options.points.size() >= 2 && options.points.size() <= CSF_CALIBRATION_POINTS));
+	}//end parse()
+}
+
+
+
+
+int main(int argc, char** argv){
+	Options options;
+	if(!parse(argc, argv, options)){
+		fprintf(stderr, "usage: csf_curve [--range min max] [--decimals d] [--bits 1-8] [--taper t | --audio | --reverse-audio] [--points r0,r1,...] [--name name] [--max-error e]\n");
+		return 2;
+	}
+	Calibration calibration;
+	const Calibration* calibrated = NULL;
+	if(!options.points.empty()){
+		calibration.start(options.points.size());
+		for(size_t i = 0; i < options.points.size(); i++){
+			calibration.setPoint(i, options.points[i]);
+		}
+		if(!calibration.isValid()){
+			fprintf(stderr, "csf_curve: the points have to run steadily up or steadily down\n");
+			return 2;
+		}
+		calibrated = &calibration;
+	}
+
+	size_t entries = (1 << options.bits) + 1;
+	std::vector<int16_t> values(entries);
+	bool fits = CurveTable::generate(values.data(), options.bits, options.outMin, options.outMax, options.decimals, options.taper, calibrated);
+
+	//the table, ready to paste
+	printf("// csf_curve");
+	for(int i = 1; i < argc; i++){
+		printf(" %s", argv[i]);
+	}
+	printf("\nconst int16_t %sTable[%zu] PROGMEM = {", options.name, entries);
+	for(size_t i = 0; i < entries; i++){
+		printf("%s%s%d", i > 0 ? "," : "", i % 8 == 0 ? "\n\t" : " ", values[i]);
+	}
+	printf("\n};\nSensors::CurveTable %s(%sTable, %d, %d);\n", options.name, options.name, options.bits, options.decimals);
+
+	//every reading against the exact curve, in the table's units
+	CurveTable table(values.data(), options.bits, options.decimals, false);
+	float unit = pow(10.0, options.decimals);
+	float worst = 0;
+	fprintf(stderr, "%zu entries, %zu bytes of flash%s\n", entries, entries * 2, fits ? "" : ", THE RANGE DOESN'T FIT IN 16 BITS");
+	fprintf(stderr, "%-12s %10s %10s %10s\n", "oversample", "mean err", "max err", "at");
+	for(uint8_t extra = 0; extra <= 3; extra++){
+		long top = 1023L << extra;
+		double total = 0;
+		float largest = 0;
+		long at = 0;
+		for(long reading = 0; reading <= top; reading++){
+			float exact = CurveTable::evaluate(reading / (float)(1 << extra), options.outMin, options.outMax, options.taper, calibrated) * unit;
+			float error = fabs(table.lookup(reading, extra) - exact);
+			total += error;
+			if(error > largest){
+				largest = error;
+				at = reading;
+			}
+		}
+		fprintf(stderr, "%-12u %10.3f %10.3f %10ld\n", extra, total / (top + 1), largest, at);
+		worst = largest > worst ? largest : worst;
+	}
+
+	//and through a Pot, which should be exactly the lookup
+	Sim::reset();
+	Pot pot(2, 3, A0);
+	pot.begin();
+	pot.activateControl();
+	long mismatches = 0;
+	for(int reading = 0; reading <= 1023; reading++){
+		Sim::setAnalog(A0, reading);
+		if(pot.mapData(table) != table.lookup(reading)){
+			mismatches++;
+		}
+	}
+	fprintf(stderr, "Pot::mapData() disagreed with the table on %ld of 1024 readings\n", mismatches);
+
+	if(!fits || mismatches > 0 || (options.maxError >= 0 && worst > options.maxError)){
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file
+ * @section description Description
+ * Replays a trace recorded by Comms::TraceCapture into the simulated board and runs it through a Pot, so a field problem can be reproduced and filters and mapping compared offline on exactly the same input.\n
+ * The trace file is the raw bytes saved from the serial port, e.g. with cat /dev/ttyACM0 > pots.trace while the sketch dumps, anything in it that isn't a trace block is skipped.\n
+ * Usage: csf_replay pots.trace [--ema k] [--median w] [--deadband w] [--oversample bits] [--map min max] [--quiet]\n
+ * Each row of the trace is printed as a line of CSV, the sample number, the time in microseconds, then for each channel the recorded value and what the Pot made of it \(buttons are printed as recorded\). A summary with the cost of the Pot calls goes to stderr.
+ */
+
+
+#include <Arduino.h>
+#include <CSF_Controls.h>
+#include <SimDevices.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+using namespace Sensors;
+
+
+
+
+namespace{
+	/**
+	 * The options from the command line
+	 */
+	struct Options{
+		const char* path = NULL;
+		int ema = 0;
+		int median = 0;
+		int deadband = 0;
+		int oversample = 0;
+		bool map = false;
+		int mapMin = 0;
+		int mapMax = 0;
+		bool quiet = false;
+	};
+
+
+	/**
+	 * Reads the command line
+	 * @param argc -from main\(\)
+	 * @param argv -from main\(\)
+	 * @param options -filled in
+	 * @return bool -false if it doesn't make sense
+	 */
+	bool parse(int argc, char** argv, Options& options){
+		for(int i = 1; i < argc; i++){
+			bool more = i + 1 < argc;
+			if(strcmp(argv[i], "--ema") == 0 && more){
+				options.ema = atoi(argv[++i]);
+			}
+			else if(strcmp(argv[i], "--median") == 0 && more){
+				options.median = atoi(argv[++i]);
+			}
+			else if(strcmp(argv[i], "--deadband") == 0 && more){
+				options.deadband = atoi(argv[++i]);
+			}
+			else if(strcmp(argv[i], "--oversample") == 0 && more){
+				options.oversample = atoi(argv[++i]);
+			}
+			else if(strcmp(argv[i], "--map") == 0 && i + 2 < argc){
+				options.map = true;
+				options.mapMin = atoi(argv[++i]);
+				options.mapMax = atoi(argv[++i]);
+			}
+			else if(strcmp(argv[i], "--quiet") == 0){
+				options.quiet = true;
+			}
+			else if(argv[i][0] != '-' && options.path == NULL){
+				options.path = argv[i];
+			}
+			else{
+				return false;
+			}
+		}
+		return options.path != NULL;
+	}//end parse()
+}
+
+
+
+
+int main(int argc, char** argv){
+	Options options;
+	if(!parse(argc, argv, options)){
+		fprintf(stderr, "usage: csf_replay trace [--ema k] [--median w] [--deadband w] [--oversample bits] [--map min max] [--quiet]\n");
+		return 2;
+	}
+	Host::Trace trace;
+	if(!trace.load(options.path)){
+		fprintf(stderr, "csf_replay: no usable trace in %s\n", options.path);
+		return 1;
+	}
+	uint8_t count = trace.getChannelCount();
+
+	//sensors on A0 up with their power buttons on 2 up, buttons on 40 up
+	Sim::reset();
+	std::vector<uint8_t> pins;
+	std::vector<Pot*> pots(count, (Pot*)NULL);
+	std::vector<FilterChain> filters(count);
+	for(uint8_t i = 0; i < count; i++){
+		if(trace.getKind(i) == Comms::FRAME_KIND_BUTTON){
+			pins.push_back(40 + i);
+			continue;
+		}
+		pins.push_back(A0 + i);
+		pots[i] = new Pot(2 + 2 * i, 3 + 2 * i, A0 + i);
+		pots[i]->begin();
+		pots[i]->activateControl();
+		pots[i]->setOversampling(options.oversample);
+		if(options.median > 0){
+			filters[i].addMedian(options.median);
+		}
+		if(options.ema > 0){
+			filters[i].addEMA(options.ema);
+		}
+		if(options.deadband > 0){
+			filters[i].addDeadband(options.deadband);
+		}
+		if(filters[i].getStageCount() > 0){
+			pots[i]->setFilter(filters[i]);
+		}
+	}
+	Sim::TracePlayer player(trace, pins);
+	player.connect();
+
+	typedef std::chrono::steady_clock Clock;
+	Clock::duration spent = Clock::duration::zero();
+	unsigned long calls = 0;
+	for(size_t row = 0; row < trace.getRowCount(); row++){
+		uint32_t index = trace.getIndex(row);
+		unsigned long due = player.timeOf(index);
+		if(due > Sim::now()){
+			Sim::advanceMicros(due - Sim::now());
+		}
+		if(!options.quiet){
+			printf("%lu,%lu", (unsigned long)index, due);
+		}
+		for(uint8_t i = 0; i < count; i++){
+			int out = trace.getValue(row, i);
+			if(pots[i] != NULL){
+				Clock::time_point before = Clock::now();
+				out = options.map ? pots[i]->mapData(options.mapMin, options.mapMax) : pots[i]->getSensorValue();
+				spent += Clock::now() - before;
+				calls++;
+			}
+			if(!options.quiet){
+				printf(",%d,%d", trace.getValue(row, i), out);
+			}
+		}
+		if(!options.quiet){
+			printf("\n");
+		}
+	}
+
+	double nanos = std::chrono::duration<double, std::nano>(spent).count();
+	fprintf(stderr, "%zu rows, %u channels, %lu us period, %lu samples lost\n", trace.getRowCount(), (unsigned)count, (unsigned long)trace.getPeriod(), trace.getLost());
+	if(calls > 0){
+		fprintf(stderr, "%lu Pot calls, %.1f ns each\n", calls, nanos / calls);
+	}
+	for(uint8_t i = 0; i < count; i++){
+		delete pots[i];
+	}
+	return 0;
+}//end main()